@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "cli/cli_app.h"
+#include "core/batch_processor.h"
 #include "core/config.h"
 #include "core/error_handler.h"
 #include "core/i18n.h"
@@ -11,6 +12,12 @@ namespace fs = std::filesystem;
 
 int main(int argc, char **argv)
 {
+    // 多进程批量处理的工作进程，不需要下面的初始化
+    int workerExitCode = 0;
+    if (neumann::BatchProcessor::runShardWorkerIfRequested(argc, argv, workerExitCode)) {
+        return workerExitCode;
+    }
+
     try {
         // 获取可执行文件所在目录
         fs::path exePath = fs::canonical(argv[0]);
@@ -5,6 +5,7 @@
 #include <string>
 #include <thread>
 
+#include "core/batch_processor.h"
 #include "core/config.h"
 #include "core/i18n.h"
 #include "core/standard_values.h"
@@ -34,6 +35,12 @@ void signalHandler(int signal)
 
 int main(int argc, char **argv)
 {
+    // 多进程批量处理的工作进程，不需要下面的初始化
+    int workerExitCode = 0;
+    if (neumann::BatchProcessor::runShardWorkerIfRequested(argc, argv, workerExitCode)) {
+        return workerExitCode;
+    }
+
     try {
         // 在Windows平台上设置控制台为UTF-8模式
 #ifdef _WIN32
@@ -83,6 +90,15 @@ int main(int argc, char **argv)
         int port = 8080;                                         // 默认端口
         std::string webRootDir = (releaseDir / "web").string();  // release文件结构下的Web资源目录
         std::string dataDir = (releaseDir / "data").string();    // release文件结构下的数据目录
+        int assetReloadInterval = 0;  // 静态文件检查间隔（毫秒，0表示不检查）
+
+        // 监听和并发设置，命令行参数优先于配置文件
+        neumann::web::ServerOptions serverOptions;
+        serverOptions.bindAddress = config.getWebBindAddress();
+        serverOptions.threadCount = config.getWebThreadCount();
+        serverOptions.idleTimeout = config.getWebIdleTimeout();
+        serverOptions.maxRequestSize = static_cast<size_t>(config.getWebMaxRequestSize());
+        serverOptions.unixSocketPath = config.getWebUnixSocket();
 
         for (int i = 1; i < argc; ++i) {
             std::string arg = argv[i];
@@ -99,6 +115,34 @@ int main(int argc, char **argv)
                 webRootDir = argv[++i];
             } else if ((arg == "--data-dir") && i + 1 < argc) {
                 dataDir = argv[++i];
+            } else if (arg == "--watch") {
+                assetReloadInterval = 1000;
+            } else if (arg == "--bind" && i + 1 < argc) {
+                serverOptions.bindAddress = argv[++i];
+            } else if (arg == "--unix-socket" && i + 1 < argc) {
+                serverOptions.unixSocketPath = argv[++i];
+            } else if ((arg == "--threads" || arg == "--idle-timeout" ||
+                        arg == "--max-request-size") &&
+                       i + 1 < argc) {
+                int value = 0;
+                try {
+                    value = std::stoi(argv[++i]);
+                }
+                catch (...) {
+                    value = -1;
+                }
+                if (value < 0 || (arg == "--idle-timeout" && (value < 1 || value > 255))) {
+                    std::cerr << i18n.getText("web.app.invalid_option") << ": " << arg << " "
+                              << argv[i] << std::endl;
+                    return 1;
+                }
+                if (arg == "--threads") {
+                    serverOptions.threadCount = value;
+                } else if (arg == "--idle-timeout") {
+                    serverOptions.idleTimeout = value;
+                } else {
+                    serverOptions.maxRequestSize = static_cast<size_t>(value);
+                }
             } else if (arg == "-h" || arg == "--help") {
                 std::cout << i18n.getText("web.app.title") << std::endl;
                 std::cout << i18n.getTextf("web.app.help_usage", argv[0]) << std::endl;
@@ -106,6 +150,12 @@ int main(int argc, char **argv)
                 std::cout << i18n.getText("web.app.help_port") << std::endl;
                 std::cout << i18n.getText("web.app.help_dir") << std::endl;
                 std::cout << i18n.getText("web.app.help_data_dir") << std::endl;
+                std::cout << i18n.getText("web.app.help_watch") << std::endl;
+                std::cout << i18n.getText("web.app.help_bind") << std::endl;
+                std::cout << i18n.getText("web.app.help_unix_socket") << std::endl;
+                std::cout << i18n.getText("web.app.help_threads") << std::endl;
+                std::cout << i18n.getText("web.app.help_idle_timeout") << std::endl;
+                std::cout << i18n.getText("web.app.help_max_request_size") << std::endl;
                 std::cout << i18n.getText("web.app.help_help") << std::endl;
                 return 0;
             }
@@ -200,6 +250,8 @@ int main(int argc, char **argv)
         // 创建并启动Web服务器
         std::cout << i18n.getText("web.app.initializing_web_server") << std::endl;
         neumann::web::WebServer server(port, webRootDir);
+        server.setAssetReloadInterval(assetReloadInterval);
+        server.setServerOptions(serverOptions);
         g_server = &server;
 
         std::cout << std::endl;
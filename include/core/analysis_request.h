@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 趋势分析请求
+ */
+struct AnalysisRequest {
+    std::vector<double> dataPoints;
+    std::vector<double> timePoints;  // 请求中没有time时为空
+    double confidenceLevel = 0.95;
+    bool echo = true;  // 是否在响应中回显输入数组
+};
+
+/**
+ * @brief 流式解析趋势分析请求
+ *
+ * 请求体是包含data、time、confidenceLevel和echo的JSON对象，其他字段被忽略。
+ * 解析时不构建JSON文档树，data和time数组中的数值直接写入预先分配的double缓冲区，
+ * 数组超过maxPoints时立即停止解析。
+ * @param body 请求体
+ * @param maxPoints data和time数组各自的最大长度
+ * @return 解析后的请求
+ * @throws NeumannException JSON格式或字段类型错误、缺少data（DATA_PARSING_ERROR），
+ *         数组超过长度限制（DATA_OUT_OF_RANGE）
+ */
+AnalysisRequest parseAnalysisRequest(const std::string &body,
+                                     size_t maxPoints = std::numeric_limits<size_t>::max());
+
+}  // namespace neumann
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "batch_processor.h"
+#include "cancellation.h"
+#include "thread_pool.h"
+
+namespace neumann {
+
+/**
+ * @brief 批量作业状态
+ */
+enum class BatchJobState {
+    QUEUED,     // 等待执行
+    RUNNING,    // 正在执行
+    COMPLETED,  // 已完成（单个文件的错误记录在结果中）
+    FAILED,     // 作业本身失败（如目录不存在）
+    CANCELLED   // 已取消
+};
+
+/**
+ * @brief 批量作业请求：处理一个目录或一组文件
+ */
+struct BatchJobRequest {
+    std::string directory;           // 目录路径（为空时处理files）
+    std::vector<std::string> files;  // 文件路径列表
+    double confidenceLevel = 0.95;
+    FileDiscoveryOptions discoveryOptions;  // 目录文件发现配置
+    int workerProcesses = 0;  // 工作进程数（见BatchPipelineOptions::workerProcesses）
+};
+
+/**
+ * @brief 批量作业的状态快照
+ */
+struct BatchJobStatus {
+    std::string id;
+    BatchJobState state = BatchJobState::QUEUED;
+    int processedFiles = 0;
+    int totalFiles = 0;           // 处理目录时为截至目前已发现的文件数
+    double elapsedSeconds = 0.0;  // 开始执行以来的时间（排队时为0）
+    double filesPerSecond = 0.0;  // 处理速度
+    std::string errorMessage;     // 作业失败的原因
+    size_t resultCount = 0;       // 已完成的结果总数
+    std::vector<BatchProcessResult> results;  // 从请求的偏移开始的结果（只含汇总统计）
+};
+
+/**
+ * @brief 异步批量作业服务
+ *
+ * 提交作业后立即返回作业ID，作业在专用线程池中由BatchProcessor执行，
+ * 调用者通过轮询获取进度、处理速度和已完成的结果，不需要在请求线程中等待。
+ * 等待执行的作业数有上限，已结束的作业只保留最近的若干个。
+ */
+class BatchJobService
+{
+public:
+    static constexpr size_t kDefaultWorkerCount = 2;
+    static constexpr size_t kDefaultQueueCapacity = 16;
+    static constexpr size_t kDefaultRetainedJobs = 64;
+
+    /**
+     * @brief 构造函数
+     * @param workerCount 同时执行的作业数
+     * @param queueCapacity 等待执行的作业上限
+     * @param retainedJobs 保留的已结束作业数
+     */
+    explicit BatchJobService(size_t workerCount = kDefaultWorkerCount,
+                             size_t queueCapacity = kDefaultQueueCapacity,
+                             size_t retainedJobs = kDefaultRetainedJobs);
+
+    /**
+     * @brief 析构函数，取消所有未结束的作业并等待执行中的作业停止
+     */
+    ~BatchJobService();
+
+    BatchJobService(const BatchJobService &) = delete;
+    BatchJobService &operator=(const BatchJobService &) = delete;
+
+    /**
+     * @brief 获取BatchJobService单例实例
+     */
+    static BatchJobService &getInstance();
+
+    /**
+     * @brief 提交作业
+     * @return 作业ID
+     * @throws NeumannException 请求中没有目录和文件（INVALID_CONFIG_VALUE）或等待队列已满（SERVICE_BUSY）
+     */
+    std::string submit(const BatchJobRequest &request);
+
+    /**
+     * @brief 查询作业状态
+     * @param id 作业ID
+     * @param status 输出的状态
+     * @param resultOffset 只返回第resultOffset个之后的结果，便于增量轮询
+     * @return 作业不存在（或已被淘汰）时返回false
+     */
+    bool getStatus(const std::string &id, BatchJobStatus &status, size_t resultOffset = 0) const;
+
+    /**
+     * @brief 取消作业：排队的作业不再执行，执行中的作业在下一个检查点停止
+     * @return 作业不存在或已结束时返回false
+     */
+    bool cancel(const std::string &id);
+
+    /**
+     * @brief 等待执行的作业数
+     */
+    size_t getQueuedJobCount() const;
+
+    /**
+     * @brief 状态名称（"queued"、"running"、"completed"、"failed"、"cancelled"）
+     */
+    static const char *stateName(BatchJobState state);
+
+private:
+    struct Job;
+
+    void run(const std::shared_ptr<Job> &job);
+    void retireFinishedJobs();
+
+    const size_t queueCapacity;
+    const size_t retainedJobs;
+
+    mutable std::mutex mutex;
+    std::map<std::string, std::shared_ptr<Job>> jobs;
+    std::deque<std::string> finishedOrder;  // 已结束作业的ID，最早结束的在前
+    size_t queuedJobs = 0;
+    uint64_t nextJobNumber = 1;
+
+    // 最后声明，析构时最先等待工作线程退出
+    ThreadPool workers;
+};
+
+}  // namespace neumann
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "batch_processor.h"
+
+namespace neumann {
+
+/**
+ * @brief 清单中单个文件的记录
+ */
+struct ManifestEntry {
+    uint64_t size = 0;               // 文件大小（字节）
+    int64_t modifiedTime = 0;        // 最后修改时间（文件系统时钟计数）
+    std::string contentHash;         // 文件内容的FNV-1a哈希
+    double confidenceLevel = 0.0;    // 计算时使用的置信度水平
+    BatchProcessResult result;       // 缓存的处理结果（只含汇总统计，不含逐点数据）
+};
+
+/**
+ * @brief 增量批量处理使用的变更清单
+ *
+ * 记录每个已处理文件的大小、修改时间、内容哈希、置信度水平和结果摘要。
+ * 再次处理时，大小和修改时间未变的文件直接复用上次的结果；
+ * 修改时间变化但内容哈希相同的文件同样复用结果，只需读取不需重新计算。
+ * 查询可以在流水线工作线程中并发进行，所有操作都是线程安全的。
+ */
+class BatchManifest
+{
+public:
+    /**
+     * @brief 从文件加载清单
+     * @param manifestPath 清单文件路径
+     * @return 文件不存在或格式无效时返回false（此时清单为空）
+     */
+    bool load(const std::string &manifestPath);
+
+    /**
+     * @brief 保存清单（先写临时文件再替换，避免中断时损坏原清单）
+     * @param manifestPath 清单文件路径
+     * @return 是否成功保存
+     */
+    bool save(const std::string &manifestPath) const;
+
+    /**
+     * @brief 查找文件记录
+     * @param key 文件键（见makeKey）
+     * @param entry 输出的记录
+     * @return 是否找到
+     */
+    bool find(const std::string &key, ManifestEntry &entry) const;
+
+    /**
+     * @brief 添加或更新文件记录，并标记为本次运行已处理
+     */
+    void update(const std::string &key, const ManifestEntry &entry);
+
+    /**
+     * @brief 删除本次运行没有处理到的记录（例如已删除的文件）
+     */
+    void pruneUnseen();
+
+    /**
+     * @brief 获取记录数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 生成文件在清单中的键（规范化的绝对路径）
+     */
+    static std::string makeKey(const std::string &filePath);
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, ManifestEntry> entries;
+    std::unordered_set<std::string> seenKeys;
+};
+
+}  // namespace neumann
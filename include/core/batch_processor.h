@@ -1,37 +1,100 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <vector>
 
+#include "cancellation.h"
 #include "data_manager.h"
+#include "file_discovery.h"
 #include "neumann_calculator.h"
+#include "timing_histogram.h"
 
 namespace neumann {
 
+class BatchManifest;
+class BatchResultSink;
+
+/**
+ * @brief 单个文件各处理阶段的耗时（微秒）
+ */
+struct BatchStageTimings {
+    double discoverMicros = 0.0;  // 文件发现（目录遍历或读取文件列表）
+    double openMicros = 0.0;      // 检查、打开并读取文件（增量模式下含清单比对）
+    double sniffMicros = 0.0;     // 内容探测（如CSV表头检测）
+    double parseMicros = 0.0;     // 解析数据集
+    double computeMicros = 0.0;   // 执行诺依曼趋势测试
+    double exportMicros = 0.0;    // 写出到结果输出（仅流式处理）
+};
+
 /**
  * @brief 批量处理结果结构
  */
 struct BatchProcessResult {
     std::string filename;
-    std::string status;  // "success", "error", "skipped"
+    std::string status;  // "success", "error", "skipped", "timeout", "cancelled"
     std::string errorMessage;
     NeumannTestResults testResults;
-    double processingTime;  // 处理时间（秒）
+    double processingTime = 0.0;  // 处理时间（秒，打开、探测、解析和计算阶段之和）
+    size_t dataPointCount = 0;    // 数据点数
+    bool reused = false;          // 是否复用了增量清单中的结果（此时testResults只含汇总统计）
+    BatchStageTimings timings;    // 各阶段耗时
 };
 
 /**
  * @brief 批量处理统计信息
  */
 struct BatchProcessStats {
-    int totalFiles;
-    int processedFiles;
-    int successfulFiles;
-    int errorFiles;
-    int skippedFiles;
-    int filesWithTrend;
-    double totalProcessingTime;
+    int totalFiles = 0;
+    int processedFiles = 0;
+    int successfulFiles = 0;
+    int errorFiles = 0;
+    int skippedFiles = 0;
+    int timeoutFiles = 0;    // 超出时间预算或整体截止时间的文件
+    int cancelledFiles = 0;  // 因取消而未处理完的文件
+    int filesWithTrend = 0;
+    double totalProcessingTime = 0.0;
     std::vector<std::string> supportedFormats;
+
+    // 各阶段耗时分布（微秒），用于定位批量处理的瓶颈
+    TimingHistogram discoverTimes;
+    TimingHistogram openTimes;
+    TimingHistogram sniffTimes;
+    TimingHistogram parseTimes;
+    TimingHistogram computeTimes;
+    TimingHistogram exportTimes;
+    TimingHistogram processingTimes;  // 单个文件的总处理时间
+};
+
+/**
+ * @brief 批量处理流水线配置
+ *
+ * 批量处理按读取、解析、计算三个阶段组成流水线，阶段之间通过有界队列衔接，
+ * 由调用线程负责汇总结果。每个阶段的工作线程数和队列容量可以单独设置，
+ * 使慢速磁盘读取与CPU计算能够重叠进行。
+ *
+ * workerProcesses大于0时改为多进程模式（仅POSIX系统）：调用线程作为协调者，
+ * 把文件逐个分派给工作进程，某个文件导致解析器崩溃只会影响该工作进程，
+ * 协调者会重启工作进程并继续处理其余文件。多进程模式不使用增量清单。
+ * 工作进程以--batch-shard-worker参数重新执行workerExecutable（默认为当前程序）
+ * 启动，而不是直接fork，避免子进程继承其他线程持有的锁。因此该程序的main()
+ * 需要先调用BatchProcessor::runShardWorkerIfRequested()。
+ */
+struct BatchPipelineOptions {
+    int readWorkers = 2;                 // 读取阶段线程数
+    int parseWorkers = 2;                // 解析阶段线程数
+    int computeWorkers = 0;              // 计算阶段线程数（0表示按硬件并发数自动设置）
+    size_t readQueueCapacity = 64;       // 待读取文件队列容量
+    size_t parseQueueCapacity = 8;       // 已读取待解析队列容量（限制内存中的文件内容数量）
+    size_t computeQueueCapacity = 16;    // 已解析待计算队列容量
+    size_t resultQueueCapacity = 64;     // 待汇总结果队列容量
+    size_t readChunkSize = 1024 * 1024;  // 顺序读取的块大小（字节）
+    int workerProcesses = 0;             // 工作进程数（0表示在当前进程内处理）
+    int maxWorkerAttempts = 2;           // 文件导致工作进程崩溃时的最大尝试次数
+    std::chrono::milliseconds fileTimeBudget{0};  // 单个文件的时间预算（0表示不限制）
+    std::string workerExecutable;        // 工作进程的可执行文件（为空表示当前程序）
 };
 
 /**
@@ -44,9 +107,12 @@ class BatchProcessor
 public:
     /**
      * @brief 进度回调函数类型
-     * @param current 当前处理文件数
+     *
+     * 回调始终在调用processDirectory/processFiles的线程中执行。
+     * 处理目录时文件是边发现边处理的，total为截至目前已发现的文件数。
+     * @param current 已完成文件数
      * @param total 总文件数
-     * @param filename 当前处理的文件名
+     * @param filename 刚完成处理的文件路径
      */
     using ProgressCallback =
         std::function<void(int current, int total, const std::string& filename)>;
@@ -62,8 +128,61 @@ public:
      */
     void setConfidenceLevel(double level);
 
+    /**
+     * @brief 设置流水线配置
+     */
+    void setPipelineOptions(const BatchPipelineOptions& options);
+
+    /**
+     * @brief 获取流水线配置
+     */
+    const BatchPipelineOptions& getPipelineOptions() const;
+
+    /**
+     * @brief 设置目录文件发现配置（递归、过滤模式、深度和符号链接策略）
+     */
+    void setDiscoveryOptions(const FileDiscoveryOptions& options);
+
+    /**
+     * @brief 获取目录文件发现配置
+     */
+    const FileDiscoveryOptions& getDiscoveryOptions() const;
+
+    /**
+     * @brief 设置取消令牌
+     *
+     * 令牌被取消（或到达其截止时间）后，尚未开始的文件不再处理：处理文件列表时
+     * 这些文件记为"cancelled"（截止时间到达时为"timeout"），处理目录时停止遍历。
+     * 正在处理的文件在下一个检查点停止。整体截止时间通过令牌的setDeadline()/
+     * setTimeout()设置。令牌取消后不会自动复位，再次处理前需要设置新的令牌。
+     * @param token 取消令牌
+     */
+    void setCancellationToken(const CancellationToken& token);
+
+    /**
+     * @brief 获取取消令牌
+     */
+    const CancellationToken& getCancellationToken() const;
+
+    /**
+     * @brief 设置增量处理清单路径
+     *
+     * 设置后处理目录或文件列表时启用增量模式：大小、修改时间（或内容哈希）
+     * 和置信度水平都未变化的文件直接复用清单中的上次结果，不再重新解析和计算。
+     * 运行结束后清单会被更新，已不存在的文件的记录会被删除。
+     * @param manifestPath 清单文件路径（为空表示关闭增量模式）
+     */
+    void setManifestPath(const std::string& manifestPath);
+
+    /**
+     * @brief 获取增量处理清单路径
+     */
+    const std::string& getManifestPath() const;
+
     /**
      * @brief 处理指定目录中的所有数据文件
+     *
+     * 按发现配置遍历目录，发现的文件直接送入处理流水线，无需等待遍历结束。
      * @param directoryPath 目录路径
      * @param progressCallback 进度回调函数
      * @return 批量处理结果
@@ -80,6 +199,32 @@ public:
     std::vector<BatchProcessResult> processFiles(const std::vector<std::string>& filePaths,
                                                  ProgressCallback progressCallback = nullptr);
 
+    /**
+     * @brief 处理指定目录中的所有数据文件，并将结果流式写出
+     *
+     * 每个文件完成后立即写入输出并丢弃，内存占用不随文件数量增长。
+     * 结果按完成顺序写出，且不含逐点数据（只保留汇总统计）。
+     * @param directoryPath 目录路径
+     * @param sink 结果输出
+     * @param progressCallback 进度回调函数
+     * @return 统计信息
+     * @throws NeumannException 输出写入失败时抛出
+     */
+    BatchProcessStats processDirectory(const std::string& directoryPath, BatchResultSink& sink,
+                                       ProgressCallback progressCallback = nullptr);
+
+    /**
+     * @brief 处理指定的文件列表，并将结果流式写出
+     * @param filePaths 文件路径列表
+     * @param sink 结果输出
+     * @param progressCallback 进度回调函数
+     * @return 统计信息
+     * @throws NeumannException 输出写入失败时抛出
+     */
+    BatchProcessStats processFiles(const std::vector<std::string>& filePaths,
+                                   BatchResultSink& sink,
+                                   ProgressCallback progressCallback = nullptr);
+
     /**
      * @brief 处理单个文件
      * @param filePath 文件路径
@@ -87,6 +232,28 @@ public:
      */
     BatchProcessResult processSingleFile(const std::string& filePath);
 
+    /**
+     * @brief 对多个数据集执行诺依曼趋势测试
+     *
+     * 计算在computeWorkers个线程中并行进行，取消令牌和单文件时间预算对每个数据集生效。
+     * @param dataSets 数据集列表
+     * @param progressCallback 进度回调函数（filename为数据集名称）
+     * @return 按输入顺序排列的结果，filename为数据集名称
+     */
+    std::vector<BatchProcessResult> analyzeDataSets(const std::vector<DataSet>& dataSets,
+                                                    ProgressCallback progressCallback = nullptr);
+
+    /**
+     * @brief 导入Excel工作簿中所有工作表的所有数值列并逐列分析
+     *
+     * 见ExcelReader::importAllSeries。导入失败时返回该文件的一个错误结果。
+     * @param filePath xlsx或xls文件路径
+     * @param progressCallback 进度回调函数
+     * @return 每个数值列一个结果
+     */
+    std::vector<BatchProcessResult> processWorkbook(const std::string& filePath,
+                                                    ProgressCallback progressCallback = nullptr);
+
     /**
      * @brief 生成批量处理统计信息
      * @param results 批量处理结果
@@ -94,6 +261,13 @@ public:
      */
     static BatchProcessStats generateStatistics(const std::vector<BatchProcessResult>& results);
 
+    /**
+     * @brief 将单个结果累加到统计信息中
+     * @param stats 统计信息
+     * @param result 处理结果
+     */
+    static void accumulateStatistics(BatchProcessStats& stats, const BatchProcessResult& result);
+
     /**
      * @brief 导出批量处理结果到CSV文件
      * @param results 批量处理结果
@@ -112,31 +286,125 @@ public:
     static bool exportResultsToHTML(const std::vector<BatchProcessResult>& results,
                                     const std::string& outputPath);
 
+    /**
+     * @brief 导出批量处理结果到JSON Lines文件（每行一个结果）
+     * @param results 批量处理结果
+     * @param outputPath 输出文件路径
+     * @return 是否成功导出
+     */
+    static bool exportResultsToJSONLines(const std::vector<BatchProcessResult>& results,
+                                         const std::string& outputPath);
+
     /**
      * @brief 获取支持的文件格式
      * @return 支持的文件扩展名列表
      */
     static std::vector<std::string> getSupportedFormats();
 
+    /**
+     * @brief 多进程模式的工作进程入口
+     *
+     * 命令行第一个参数为--batch-shard-worker时，从协调者传来的套接字读取配置和文件路径，
+     * 逐个处理后返回结果，直到协调者关闭套接字。使用多进程模式的程序应在main()开始处调用。
+     * @param argc 命令行参数个数
+     * @param argv 命令行参数
+     * @param exitCode 以工作进程运行时的退出码
+     * @return 以工作进程运行时返回true，调用者应以exitCode退出
+     */
+    static bool runShardWorkerIfRequested(int argc, char* argv[], int& exitCode);
+
 private:
     double confidenceLevel;
+    BatchPipelineOptions pipelineOptions;
+    FileDiscoveryOptions discoveryOptions;
+    std::string manifestPath;
+    CancellationToken cancellationToken;
+
+    // 在流水线各阶段之间传递的单个文件的处理状态
+    struct FileWorkItem;
+
+    // 流水线文件来源，每次调用产出一个文件路径，没有更多文件时返回false
+    using FileSource = std::function<bool(std::string& filePath)>;
+
+    // 流水线结果处理函数，按完成顺序在调用线程中执行
+    using ResultHandler = std::function<void(size_t index, BatchProcessResult& result)>;
 
     /**
-     * @brief 检查文件是否为支持的格式
+     * @brief 运行流水线处理来源产出的文件
+     * @param nextFile 文件来源（在独立线程中调用）
+     * @param expectedTotal 已知的文件总数（-1表示未知，进度按已发现文件数报告）
+     * @param onResult 结果处理函数
+     * @param progressCallback 进度回调函数
      */
-    static bool isSupportedFile(const std::string& filePath);
+    void runPipeline(const FileSource& nextFile, int expectedTotal, const ResultHandler& onResult,
+                     ProgressCallback progressCallback);
+
+    /**
+     * @brief 以多进程模式处理来源产出的文件（参数与runPipeline相同）
+     *
+     * 每个工作进程同时只处理一个文件，崩溃时可以准确定位到导致崩溃的文件：
+     * 该文件重新排队，达到最大尝试次数后记为错误。
+     */
+    void runSharded(const FileSource& nextFile, int expectedTotal, const ResultHandler& onResult,
+                    ProgressCallback progressCallback);
+
+    /**
+     * @brief 收集流水线结果到按输入顺序排列的列表
+     */
+    std::vector<BatchProcessResult> collectResults(const FileSource& nextFile, int expectedTotal,
+                                                   ProgressCallback progressCallback);
 
     /**
-     * @brief 获取目录中的所有支持文件
+     * @brief 将流水线结果流式写出到输出
      */
-    static std::vector<std::string> findSupportedFiles(const std::string& directoryPath);
+    BatchProcessStats streamResults(const FileSource& nextFile, int expectedTotal,
+                                    BatchResultSink& sink, ProgressCallback progressCallback);
+
+    /**
+     * @brief 将已有结果依次写出到输出
+     */
+    static bool writeResults(const std::vector<BatchProcessResult>& results,
+                             BatchResultSink& sink);
+
+    /**
+     * @brief 为文件创建取消令牌（在整体令牌基础上附加单文件时间预算）
+     */
+    CancellationToken makeFileToken() const;
+
+    /**
+     * @brief 检查文件是否需要停止处理，需要时记录"cancelled"或"timeout"结果
+     * @return 需要停止时返回true
+     */
+    bool stopIfRequested(FileWorkItem& item) const;
+
+    /**
+     * @brief 读取阶段：检查文件并顺序读取文件内容
+     * @param item 处理状态
+     * @param manifest 增量清单（为空表示不使用增量模式），文件未变化时直接复用结果
+     */
+    void readStage(FileWorkItem& item, const BatchManifest* manifest) const;
+
+    /**
+     * @brief 解析阶段：从内存内容解析出数据集
+     */
+    void parseStage(FileWorkItem& item) const;
+
+    /**
+     * @brief 计算阶段：执行诺依曼趋势测试
+     */
+    void computeStage(FileWorkItem& item) const;
+
+    /**
+     * @brief 检查文件是否为支持的格式
+     */
+    static bool isSupportedFile(const std::string& filePath);
 
     /**
-     * @brief 智能检测CSV文件是否有表头
-     * @param filePath CSV文件路径
+     * @brief 智能检测CSV内容是否有表头
+     * @param content CSV文件内容
      * @return true表示有表头，false表示没有表头
      */
-    static bool detectCSVHeader(const std::string& filePath);
+    static bool detectCSVHeader(const std::string& content);
 };
 
 }  // namespace neumann
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "batch_processor.h"
+
+namespace neumann {
+
+/**
+ * @brief 批量处理结果输出接口
+ *
+ * 与批量处理的流式接口配合使用：每个文件处理完成后立即写出一行，
+ * 不在内存中保留全部结果。写出的结果只含汇总统计，不含逐点数据。
+ * 流式处理时结果按完成顺序写出，index为文件在输入中的位置。
+ */
+class BatchResultSink
+{
+public:
+    virtual ~BatchResultSink() = default;
+
+    /**
+     * @brief 开始输出（写出文件头等）
+     * @return 是否成功
+     */
+    virtual bool begin() = 0;
+
+    /**
+     * @brief 写出一个结果
+     * @param index 文件在输入中的位置
+     * @param result 处理结果
+     * @return 是否成功
+     */
+    virtual bool write(size_t index, const BatchProcessResult &result) = 0;
+
+    /**
+     * @brief 结束输出（写出汇总信息并关闭）
+     * @param stats 全部结果的统计信息
+     * @return 是否成功
+     */
+    virtual bool end(const BatchProcessStats &stats) = 0;
+};
+
+/**
+ * @brief 基于文件的结果输出基类
+ *
+ * 每写出一个结果都会刷新文件，便于其他工具在处理过程中实时读取。
+ */
+class FileResultSink : public BatchResultSink
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param outputPath 输出文件路径
+     */
+    explicit FileResultSink(const std::string &outputPath);
+
+    bool end(const BatchProcessStats &stats) override;
+
+protected:
+    /**
+     * @brief 打开输出文件
+     */
+    bool open();
+
+    /**
+     * @brief 刷新文件并检查写入状态
+     */
+    bool flush();
+
+    std::string outputPath;
+    std::ofstream file;
+};
+
+/**
+ * @brief CSV格式结果输出（带UTF-8 BOM，表头使用当前语言）
+ */
+class CsvResultSink : public FileResultSink
+{
+public:
+    explicit CsvResultSink(const std::string &outputPath);
+
+    bool begin() override;
+    bool write(size_t index, const BatchProcessResult &result) override;
+
+private:
+    std::string statusSuccess;
+    std::string statusError;
+    std::string statusSkipped;
+    std::string statusTimeout;
+    std::string statusCancelled;
+    std::string trendYes;
+    std::string trendNo;
+};
+
+/**
+ * @brief HTML报告结果输出
+ *
+ * 表格行随处理进度逐行写出；统计卡片要等全部结果完成后才能确定，
+ * 因此写在文档末尾，通过CSS的order属性显示在表格上方。
+ */
+class HtmlResultSink : public FileResultSink
+{
+public:
+    explicit HtmlResultSink(const std::string &outputPath);
+
+    bool begin() override;
+    bool write(size_t index, const BatchProcessResult &result) override;
+    bool end(const BatchProcessStats &stats) override;
+
+private:
+    std::string statusSuccess;
+    std::string statusError;
+    std::string statusSkipped;
+    std::string statusTimeout;
+    std::string statusCancelled;
+    std::string trendYes;
+    std::string trendNo;
+};
+
+/**
+ * @brief JSON Lines格式结果输出，每行一个JSON对象
+ */
+class JsonLinesResultSink : public FileResultSink
+{
+public:
+    explicit JsonLinesResultSink(const std::string &outputPath);
+
+    bool begin() override;
+    bool write(size_t index, const BatchProcessResult &result) override;
+};
+
+}  // namespace neumann
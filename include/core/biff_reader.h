@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "spreadsheet_xml.h"
+
+namespace neumann {
+
+/**
+ * @brief BIFF记录遍历器
+ *
+ * 依次给出Workbook流中每条记录的类型和数据，数据直接引用流的内存，不复制。
+ */
+class BiffRecordReader
+{
+public:
+    /**
+     * @param stream Workbook流
+     * @param offset 开始位置（工作表子流的BOF记录偏移）
+     */
+    explicit BiffRecordReader(std::string_view stream, size_t offset = 0);
+
+    /**
+     * @brief 移动到下一条记录
+     * @return 已到流末尾时返回false
+     * @throws std::runtime_error 记录被截断
+     */
+    bool next();
+
+    uint16_t type() const { return recordType; }
+    std::string_view data() const { return recordData; }
+
+    /**
+     * @brief 下一条记录的类型（没有下一条记录时返回0）
+     */
+    uint16_t peekType() const;
+
+private:
+    std::string_view stream;
+    size_t position;
+    uint16_t recordType = 0;
+    std::string_view recordData;
+};
+
+/**
+ * @brief 工作表在Workbook流中的位置
+ */
+struct BiffSheetInfo {
+    std::string name;     // 工作表名称（UTF-8）
+    uint32_t offset = 0;  // 工作表子流BOF记录的偏移
+};
+
+/**
+ * @brief 工作簿全局信息
+ */
+struct BiffWorkbookInfo {
+    std::vector<BiffSheetInfo> sheets;       // 工作表（不含图表和宏表）
+    std::vector<std::string> sharedStrings;  // 共享字符串表（SST）
+};
+
+/**
+ * @brief 读取工作簿全局子流中的工作表列表和共享字符串表
+ * @throws std::runtime_error 不是BIFF8格式、工作簿已加密或数据损坏
+ */
+BiffWorkbookInfo readBiffWorkbook(std::string_view stream);
+
+/**
+ * @brief 流式读取工作表子流中的单元格
+ *
+ * 不建立工作表模型，逐条记录产生与WorksheetXmlReader相同的单元格事件：
+ * 数值（NUMBER、RK、MULRK）格式化为最短往返文本，LABELSST为共享字符串索引，
+ * 公式取缓存的结果。BIFF中单元格按行存放，行号变化和子流结束时调用onRowEnd。
+ * @return 读完子流返回true，回调要求停止时返回false
+ * @throws std::runtime_error 数据损坏
+ */
+bool readBiffSheet(std::string_view stream, uint32_t offset,
+                   const std::function<bool(const CellEvent &)> &onCell,
+                   const std::function<bool(uint32_t row)> &onRowEnd);
+
+}  // namespace neumann
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace neumann {
+
+/**
+ * @brief 有界阻塞队列
+ *
+ * 用于批量处理流水线各阶段之间的数据传递：队列满时生产者阻塞，
+ * 队列空时消费者阻塞，从而限制在途数据量并让上下游自然形成背压。
+ * 调用close()后不再接受新元素，消费者取完剩余元素后返回false。
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 队列容量（至少为1）
+     */
+    explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1), closed(false)
+    {
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    /**
+     * @brief 放入元素，队列满时阻塞
+     * @param item 要放入的元素
+     * @return 队列已关闭时返回false
+     */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 取出元素，队列空时阻塞
+     * @param item 取出的元素
+     * @return 队列已关闭且为空时返回false
+     */
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列，唤醒所有等待的生产者和消费者
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief 获取当前队列中的元素数量
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+private:
+    const size_t capacity;
+    bool closed;
+    std::deque<T> items;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+}  // namespace neumann
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace neumann {
+
+/**
+ * @brief 协作式取消令牌
+ *
+ * 令牌的副本共享同一状态：在任意线程调用cancel()后，所有副本都会观察到取消。
+ * 可以设置截止时间，到期后视为超时。通过withDeadline()派生的子令牌
+ * 在父令牌取消时同样被取消，但自身的截止时间不影响父令牌，
+ * 用于在整体截止时间之外为单个文件设置时间预算。
+ * cancel()只写入原子变量，可以在信号处理函数中调用。
+ */
+class CancellationToken
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 停止原因
+     */
+    enum class State {
+        ACTIVE,     // 未停止
+        CANCELLED,  // 被显式取消
+        TIMED_OUT   // 超过截止时间
+    };
+
+    /**
+     * @brief 创建一个新的未取消、无截止时间的令牌
+     */
+    CancellationToken();
+
+    /**
+     * @brief 请求取消
+     */
+    void cancel() const;
+
+    /**
+     * @brief 设置截止时间
+     */
+    void setDeadline(Clock::time_point deadline) const;
+
+    /**
+     * @brief 设置从现在开始的超时时长
+     */
+    void setTimeout(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief 获取当前状态（会检查本令牌及所有父令牌）
+     */
+    State getState() const;
+
+    /**
+     * @brief 是否应当停止（已取消或已超时）
+     */
+    bool isStopRequested() const;
+
+    /**
+     * @brief 已停止时抛出NeumannException（OPERATION_CANCELLED或OPERATION_TIMEOUT）
+     * @param context 错误上下文
+     */
+    void throwIfStopped(const std::string &context = "") const;
+
+    /**
+     * @brief 派生子令牌，父令牌取消时子令牌同样被取消，取消子令牌不影响父令牌
+     */
+    CancellationToken createChild() const;
+
+    /**
+     * @brief 派生带有自身截止时间的子令牌
+     * @param deadline 子令牌的截止时间
+     */
+    CancellationToken withDeadline(Clock::time_point deadline) const;
+
+private:
+    struct SharedState {
+        std::atomic<bool> cancelled{false};
+        std::atomic<Clock::rep> deadline{0};  // 截止时间（0表示无截止时间）
+        std::shared_ptr<SharedState> parent;
+    };
+
+    explicit CancellationToken(std::shared_ptr<SharedState> state);
+
+    std::shared_ptr<SharedState> state;
+};
+
+}  // namespace neumann
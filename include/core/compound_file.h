@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 复合文档（OLE2 Compound File Binary）中的一个目录项
+ */
+struct CompoundFileEntry {
+    std::string name;         // 名称（UTF-8）
+    uint8_t type = 0;         // 类型（1为存储，2为流，5为根存储）
+    uint32_t startSector = 0; // 第一个扇区
+    uint64_t size = 0;        // 流大小（字节）
+};
+
+/**
+ * @brief 只读复合文档
+ *
+ * 旧版Office文档（.xls、.doc）使用的容器格式：文件被分成固定大小的扇区，
+ * 由FAT把扇区串成流，小于阈值的流存放在迷你流中。支持版本3（512字节扇区）
+ * 和版本4（4096字节扇区）。整个文件一次读入内存，用于读取.xls中的Workbook流。
+ */
+class CompoundFile
+{
+public:
+    /**
+     * @brief 打开磁盘上的复合文档
+     * @throws std::runtime_error 文件无法读取或不是有效的复合文档
+     */
+    static CompoundFile openFile(const std::string &path);
+
+    /**
+     * @brief 从内存数据创建复合文档
+     * @throws std::runtime_error 数据不是有效的复合文档
+     */
+    static CompoundFile fromBuffer(std::string data);
+
+    /**
+     * @brief 检查数据是否以复合文档签名开头
+     */
+    static bool hasSignature(const std::string &data);
+
+    /**
+     * @brief 获取所有目录项
+     */
+    const std::vector<CompoundFileEntry> &getEntries() const { return entries; }
+
+    /**
+     * @brief 查找流（名称不区分大小写）
+     * @return 目录项指针，不存在时返回nullptr
+     */
+    const CompoundFileEntry *findStream(const std::string &name) const;
+
+    /**
+     * @brief 读取整个流
+     * @throws std::runtime_error 流不存在或扇区链损坏
+     */
+    std::string readStream(const std::string &name) const;
+
+private:
+    CompoundFile() = default;
+
+    void parse();
+    std::vector<uint32_t> readChain(const std::vector<uint32_t> &table, uint32_t start,
+                                    size_t maxLength) const;
+    const char *sectorData(uint32_t sector) const;
+
+    std::shared_ptr<const std::string> buffer;
+    size_t sectorSize = 512;
+    size_t miniSectorSize = 64;
+    uint32_t miniStreamCutoff = 4096;
+    std::vector<uint32_t> fat;      // 扇区分配表
+    std::vector<uint32_t> miniFat;  // 迷你扇区分配表
+    std::string miniStream;         // 根目录项指向的迷你流
+    std::vector<CompoundFileEntry> entries;
+};
+
+}  // namespace neumann
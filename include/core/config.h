@@ -51,6 +51,10 @@ public:
     std::string getWebRootDirectory() const;
     void setWebRootDirectory(const std::string &path);
 
+    // Web批量作业可以访问的根目录（为空表示数据目录）
+    std::string getBatchRootDirectory() const;
+    void setBatchRootDirectory(const std::string &path);
+
     // 默认参数设置
     double getDefaultConfidenceLevel() const;
     void setDefaultConfidenceLevel(double level);
@@ -58,6 +62,37 @@ public:
     int getDefaultWebPort() const;
     void setDefaultWebPort(int port);
 
+    // API响应压缩设置（级别0表示不压缩，小于最小字节数的响应不压缩）
+    int getApiCompressionLevel() const;
+    void setApiCompressionLevel(int level);
+
+    int getApiCompressionMinSize() const;
+    void setApiCompressionMinSize(int bytes);
+
+    // 单个分析请求中data或time数组的最大长度（0表示由webMaxRequestSize推出）
+    int getApiMaxDataPoints() const;
+    void setApiMaxDataPoints(int points);
+
+    // 分析结果缓存的内存上限（字节，0表示只合并同时到达的相同请求）
+    int getApiResponseCacheSize() const;
+    void setApiResponseCacheSize(int bytes);
+
+    // Web服务器设置（线程数0表示使用硬件线程数，Unix域套接字路径非空时不监听TCP端口）
+    std::string getWebBindAddress() const;
+    void setWebBindAddress(const std::string &address);
+
+    int getWebThreadCount() const;
+    void setWebThreadCount(int threads);
+
+    int getWebIdleTimeout() const;
+    void setWebIdleTimeout(int seconds);
+
+    int getWebMaxRequestSize() const;
+    void setWebMaxRequestSize(int bytes);
+
+    std::string getWebUnixSocket() const;
+    void setWebUnixSocket(const std::string &path);
+
     // 界面设置
     bool getShowWelcomeMessage() const;
     void setShowWelcomeMessage(bool show);
@@ -72,6 +107,10 @@ public:
     bool getAutoSaveResults() const;
     void setAutoSaveResults(bool autoSave);
 
+    // 批量处理的工作进程数（0表示在当前进程内处理，见BatchPipelineOptions::workerProcesses）
+    int getBatchWorkerProcesses() const;
+    void setBatchWorkerProcesses(int processes);
+
     // 获取配置文件路径
     std::string getConfigFilePath() const;
 
@@ -161,12 +200,23 @@ private:
     Language language;
     std::string dataDirectory;
     std::string webRootDirectory;
+    std::string batchRootDirectory;
     double defaultConfidenceLevel;
     int defaultWebPort;
+    int apiCompressionLevel;
+    int apiCompressionMinSize;
+    int apiMaxDataPoints;
+    int apiResponseCacheSize;
+    std::string webBindAddress;
+    int webThreadCount;
+    int webIdleTimeout;
+    int webMaxRequestSize;
+    std::string webUnixSocket;
     bool showWelcomeMessage;
     bool enableColorOutput;
     int maxDataPoints;
     bool autoSaveResults;
+    int batchWorkerProcesses;
 
     // 配置文件路径
     std::string configFilePath;
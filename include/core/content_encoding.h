@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "deflate.h"
+
+namespace neumann {
+
+/**
+ * @brief HTTP响应的内容编码
+ */
+enum class ContentEncoding {
+    IDENTITY,  // 不压缩
+    GZIP,      // gzip（RFC 1952）
+    DEFLATE    // HTTP中的deflate，即zlib格式（RFC 1950）
+};
+
+/**
+ * @brief 根据Accept-Encoding头选择内容编码
+ *
+ * 在gzip和deflate中按q值选择，q值相同时优先gzip；"*"为未列出的编码提供q值，
+ * q=0表示拒绝。头为空或两者都不接受时不压缩。
+ */
+ContentEncoding negotiateContentEncoding(const std::string &acceptEncoding);
+
+/**
+ * @brief Content-Encoding头中的编码名称（不压缩时为空字符串）
+ */
+const char *contentEncodingName(ContentEncoding encoding);
+
+/**
+ * @brief 按选定的编码压缩响应体
+ *
+ * 直接从body压缩到新的缓冲区后与body交换，不复制原始内容。
+ * body小于minSize或压缩后没有变小时保持不变。
+ * @param body 响应体，压缩后被替换为压缩数据
+ * @param encoding 选定的编码
+ * @param minSize 需要压缩的最小字节数
+ * @param level 压缩级别（1到9，0表示不压缩）
+ * @return 实际使用的编码
+ */
+ContentEncoding compressBody(std::string &body, ContentEncoding encoding, size_t minSize,
+                             int level = kDefaultDeflateLevel);
+
+}  // namespace neumann
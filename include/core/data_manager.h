@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "cancellation.h"
+
 namespace neumann {
 
 /**
@@ -19,6 +25,39 @@ struct DataSet {
     std::string createdAt;           // 创建时间
 };
 
+/**
+ * @brief 单个数据集在某个置信水平下的测试摘要
+ */
+struct DataSetSummary {
+    size_t pointCount = 0;      // 数据点数
+    bool tested = false;        // 数据点不少于4个时才进行测试
+    bool overallTrend = false;  // 整体趋势
+    double avgPG = 0.0;
+    double minPG = 0.0;
+    double maxPG = 0.0;
+};
+
+/**
+ * @brief 所有已保存数据集的汇总统计
+ */
+struct DataSetStatistics {
+    double confidenceLevel = 0.95;
+    int totalDatasets = 0;         // 数据集总数
+    int testedDatasets = 0;        // 参与测试的数据集数
+    int datasetsWithTrend = 0;     // 整体有趋势的数据集数
+    double totalDataPoints = 0.0;  // 参与测试的数据集的数据点总数
+    double totalAvgPG = 0.0;       // 参与测试的数据集的平均PG值之和
+    double minPG = 0.0;            // 所有数据集中最小的PG值（没有测试时为0）
+    double maxPG = 0.0;            // 所有数据集中最大的PG值（没有测试时为0）
+
+    double avgDataPoints() const
+    {
+        return testedDatasets > 0 ? totalDataPoints / testedDatasets : 0.0;
+    }
+
+    double avgPGValue() const { return testedDatasets > 0 ? totalAvgPG / testedDatasets : 0.0; }
+};
+
 /**
  * @brief 数据管理器类
  *
@@ -41,6 +80,29 @@ public:
    */
     DataSet importFromCSV(const std::string &filename, bool hasHeader = true);
 
+    /**
+   * @brief 从内存中的CSV内容解析数据
+   * @param content CSV文件内容
+   * @param filename 来源文件路径（用于数据集名称和来源信息）
+   * @param hasHeader 内容是否包含表头
+   * @param cancellationToken 取消令牌（为空时不检查），停止后抛出NeumannException
+   * @return 解析得到的数据集
+   */
+    DataSet importFromCSVContent(const std::string &content, const std::string &filename,
+                                 bool hasHeader = true,
+                                 const CancellationToken *cancellationToken = nullptr);
+
+    /**
+   * @brief 从文本开头取出下一个以分隔符结束的片段，切分规则与std::getline一致
+   *
+   * 文本为空时返回false，因此末尾的换行（或行末的分隔符）不会产生多余的空片段。
+   * @param text 待切分的文本，取出的片段和分隔符会从开头移除
+   * @param delimiter 分隔符
+   * @param token 输出的片段（引用text中的字符，不复制）
+   * @return 是否取到片段
+   */
+    static bool nextCSVToken(std::string_view &text, char delimiter, std::string_view &token);
+
     /**
    * @brief 导出数据到CSV文件
    * @param dataSet 要导出的数据集
@@ -76,6 +138,42 @@ public:
    */
     bool deleteDataSet(const std::string &name);
 
+    /**
+   * @brief 获取所有已保存数据集的汇总统计
+   *
+   * 每个置信水平第一次查询时测试所有数据集，之后在保存和删除数据集时增量更新，
+   * 标准值表变化后重新计算。查询本身不再加载数据或重新测试。
+   * @param confidenceLevel 判断趋势使用的置信水平
+   * @return 汇总统计
+   */
+    DataSetStatistics getStatistics(double confidenceLevel);
+
+    /**
+   * @brief 获取每个数据集的测试摘要（与getStatistics()共用增量维护的结果）
+   * @param confidenceLevel 判断趋势使用的置信水平
+   * @return 数据集名称到测试摘要的映射
+   */
+    std::map<std::string, DataSetSummary> getDataSetSummaries(double confidenceLevel);
+
+    /**
+   * @brief 获取当前本地时间字符串（线程安全）
+   * @return 格式为"%Y-%m-%d %H:%M:%S"的时间字符串
+   */
+    static std::string currentTimestamp();
+
+    /**
+   * @brief 切换数据集的保存目录，清空已加载的数据集和统计
+   *
+   * 用于配置变更后和测试，不应与其他操作同时调用。
+   * @param directory 新的数据目录，不存在时创建
+   */
+    void setDataDirectory(const std::string &directory);
+
+    /**
+   * @brief 获取数据集的保存目录
+   */
+    const std::string &getDataDirectory() const;
+
 private:
     // 私有构造函数，防止外部实例化
     DataManager();
@@ -84,11 +182,33 @@ private:
     DataManager(const DataManager &) = delete;
     DataManager &operator=(const DataManager &) = delete;
 
+    // 某个置信水平下的增量统计
+    struct StatisticsIndex {
+        uint64_t standardValuesVersion = 0;
+        std::map<std::string, DataSetSummary> summaries;
+        DataSetStatistics totals;
+        std::multiset<double> minPGs;  // 各数据集的最小PG值，删除后仍能得到整体最小值
+        std::multiset<double> maxPGs;
+    };
+
+    static DataSetSummary summarize(const DataSet &dataSet, double confidenceLevel);
+
+    // 以下方法要求调用者持有statisticsMutex
+    StatisticsIndex &statisticsFor(double confidenceLevel);
+    static void addSummary(StatisticsIndex &index, const std::string &name,
+                           const DataSetSummary &summary);
+    static void removeSummary(StatisticsIndex &index, const std::string &name);
+
     // 保存路径
     std::string dataDir;
 
     // 缓存已加载的数据集
+    std::mutex cacheMutex;
     std::map<std::string, DataSet> loadedDataSets;
+
+    // 按置信水平保存的统计，锁的顺序为先statisticsMutex后cacheMutex
+    std::mutex statisticsMutex;
+    std::map<double, StatisticsIndex> statistics;
 };
 
 }  // namespace neumann
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace neumann {
+
+/**
+ * @brief 默认压缩级别（与zlib的默认级别相当）
+ */
+const int kDefaultDeflateLevel = 6;
+
+/**
+ * @brief 压缩为原始DEFLATE数据流（RFC 1951，不含zlib/gzip头）
+ *
+ * LZ77使用哈希链查找匹配，级别越高查找的候选越多，4级以上启用延迟匹配。
+ * 每个块在动态哈夫曼、固定哈夫曼和不压缩三种编码中选择最短的一种，
+ * 因此不可压缩的数据最多只增加少量块头。
+ *
+ * @param data 待压缩数据
+ * @param size 数据字节数
+ * @param level 压缩级别（0为不压缩，1最快，9压缩率最高）
+ * @param out 压缩结果追加到out末尾
+ */
+void deflateRaw(const char *data, size_t size, int level, std::string &out);
+
+/**
+ * @brief 压缩为gzip格式（RFC 1952）
+ * @param data 待压缩数据
+ * @param size 数据字节数
+ * @param level 压缩级别（0到9）
+ * @return gzip数据
+ */
+std::string gzipCompress(const char *data, size_t size, int level = kDefaultDeflateLevel);
+
+/**
+ * @brief 压缩为zlib格式（RFC 1950），即HTTP中的deflate内容编码
+ * @param data 待压缩数据
+ * @param size 数据字节数
+ * @param level 压缩级别（0到9）
+ * @return zlib数据
+ */
+std::string zlibCompress(const char *data, size_t size, int level = kDefaultDeflateLevel);
+
+}  // namespace neumann
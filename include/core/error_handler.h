@@ -44,6 +44,9 @@ enum class ErrorCode {
     MEMORY_ERROR = 600,
     SYSTEM_ERROR = 601,
     PERMISSION_DENIED = 602,
+    OPERATION_CANCELLED = 603,
+    OPERATION_TIMEOUT = 604,
+    SERVICE_BUSY = 605,
 
     // 未知错误
     UNKNOWN_ERROR = 999
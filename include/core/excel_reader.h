@@ -1,17 +1,28 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "cancellation.h"
 #include "data_manager.h"
 
 namespace neumann {
 
+class XmlTokenizer;
+class ZipArchive;
+struct CellEvent;
+struct XlsxWorkbook;
+
 /**
  * @brief Excel文件读取器类
  * 
- * 提供读取Excel文件(.xlsx)的功能，支持多种数据格式
+ * 提供读取Excel文件(.xlsx、.xls)的功能，支持多种数据格式
  */
 class ExcelReader
 {
@@ -33,6 +44,14 @@ public:
      */
     static bool isExcelFile(const std::string& filename);
 
+    /**
+     * @brief 设置取消令牌
+     *
+     * 解压和解析过程中会检查令牌，令牌取消或超时后抛出
+     * OPERATION_CANCELLED或OPERATION_TIMEOUT异常。
+     */
+    void setCancellationToken(const CancellationToken& token);
+
     /**
      * @brief 从Excel文件导入数据
      * @param filename Excel文件路径
@@ -43,6 +62,20 @@ public:
     DataSet importFromExcel(const std::string& filename, const std::string& sheetName = "",
                             bool hasHeader = true);
 
+    /**
+     * @brief 导入工作簿中所有工作表的所有数值列
+     *
+     * 各工作表在多个线程中并行解码。每个工作表的第一个数值列作为时间列
+     * （只有一个数值列时使用行索引），其余每个数值列各生成一个数据集，
+     * 名称为"文件名/工作表/列标题"。没有数值列的工作表被跳过。
+     * @param filename xlsx或xls文件路径
+     * @param hasHeader 是否包含表头
+     * @param threadCount 并行解码的线程数（0表示按硬件并发数设置）
+     * @return 数据集列表（按工作表和列的顺序）
+     */
+    std::vector<DataSet> importAllSeries(const std::string& filename, bool hasHeader = true,
+                                         int threadCount = 0);
+
     /**
      * @brief 获取Excel文件中所有工作表名称
      * @param filename Excel文件路径
@@ -93,53 +126,139 @@ private:
                            bool hasHeader);
 
     /**
-     * @brief 解压xlsx文件到临时目录
+     * @brief 按块解压归档中的XML成员并交给读取器解析，期间检查取消令牌
      */
-    std::string extractXlsxToTemp(const std::string& filename);
+    void parseArchiveXml(const ZipArchive& archive, const std::string& name,
+                         XmlTokenizer& reader);
 
     /**
      * @brief 读取共享字符串表
      */
-    std::vector<std::string> readSharedStrings(const std::string& filePath);
+    std::vector<std::string> readSharedStrings(const ZipArchive& archive);
+
+    /**
+     * @brief 只读取指定索引的共享字符串，读到最大索引后停止解压
+     * @return 索引到字符串的映射（超出表范围的索引不包含在内）
+     */
+    std::map<uint32_t, std::string> readSharedStrings(const ZipArchive& archive,
+                                                      const std::set<uint32_t>& indices);
 
     /**
-     * @brief 查找工作表文件
+     * @brief 流式读取共享字符串表，按顺序交给回调，回调返回false时停止
      */
-    std::string findWorksheet(const std::string& tempDir, const std::string& sheetName);
+    void streamSharedStrings(const ZipArchive& archive,
+                             const std::function<bool(std::string&& text)>& onString);
 
     /**
-     * @brief 读取工作表数据
+     * @brief 列出工作表名称及其在归档中的成员路径
      */
-    std::vector<std::vector<std::string>> readWorksheetData(
-        const std::string& worksheetPath, const std::vector<std::string>& sharedStrings);
+    std::vector<std::pair<std::string, std::string>> listWorksheets(const ZipArchive& archive);
 
     /**
-     * @brief 解析行中的单元格
+     * @brief 打开工作簿（优先使用缓存，文件变化后重新解析）
      */
-    std::vector<std::string> parseCellsInRow(const std::string& rowContent,
-                                             const std::vector<std::string>& sharedStrings);
+    std::shared_ptr<const XlsxWorkbook> openWorkbook(const std::string& filename);
 
     /**
-     * @brief 提取单元格值
+     * @brief 获取工作簿的共享字符串表，首次加载后存入缓存并更新workbook
      */
-    std::string extractCellValue(const std::string& cellXml,
-                                 const std::vector<std::string>& sharedStrings);
+    std::shared_ptr<const std::vector<std::string>> loadSharedStrings(
+        const std::string& filename, std::shared_ptr<const XlsxWorkbook>& workbook);
 
     /**
-     * @brief 处理工作表数据
+     * @brief 查找工作表成员路径
      */
-    DataSet processWorksheetData(const std::vector<std::vector<std::string>>& rawData,
-                                 bool hasHeader);
+    std::string findWorksheet(const XlsxWorkbook& workbook, const std::string& sheetName);
 
     /**
-     * @brief 解码XML实体
+     * @brief 单元格取值回调，把单元格事件转换为行中的文本（如解析共享字符串引用）
      */
-    std::string decodeXmlEntities(const std::string& text);
+    using CellResolver = std::function<void(const CellEvent& cell, std::string& value)>;
 
     /**
-     * @brief 清理临时目录
+     * @brief 行回调，row只在回调期间有效，返回false停止读取
      */
-    void cleanupTempDir(const std::string& tempDir);
+    using RowConsumer = std::function<bool(const std::vector<std::string>& row)>;
+
+    /**
+     * @brief 工作表行来源，对应readWorksheetRows或readXlsRows
+     */
+    using RowSource =
+        std::function<bool(const CellResolver& resolveCell, const RowConsumer& onRow)>;
+
+    /**
+     * @brief 流式读取工作表，逐行交给回调
+     *
+     * 边解压边解析，单元格按列位置放置（缺失的单元格为空字符串），没有值的行被跳过。
+     * @return 读完整个工作表返回true，回调要求停止时返回false
+     */
+    bool readWorksheetRows(const ZipArchive& archive, const std::string& worksheetPath,
+                           const CellResolver& resolveCell, const RowConsumer& onRow);
+
+    /**
+     * @brief 流式读取xls工作表子流，逐行交给回调（行的组织方式与readWorksheetRows相同）
+     */
+    bool readXlsRows(std::string_view stream, uint32_t offset, const CellResolver& resolveCell,
+                     const RowConsumer& onRow);
+
+    using LeadingRowsHandler =
+        std::function<void(const std::vector<std::vector<std::string>>& leadingRows)>;
+    using DataRowHandler = std::function<void(const std::vector<std::string>& row, size_t index)>;
+
+    /**
+     * @brief 流式读取工作表的数据行
+     *
+     * 先缓存检测列类型所需的前20行交给onLeadingRows，然后把所有行（包括缓存的行）
+     * 按顺序交给onRow，index为行在工作表中的序号（跳过的空行不计）。
+     * @return 读取的行数
+     */
+    size_t readDataRows(const RowSource& readRows, const std::vector<std::string>& sharedStrings,
+                        const LeadingRowsHandler& onLeadingRows, const DataRowHandler& onRow);
+
+    /**
+     * @brief 读取并处理工作表数据
+     *
+     * 只缓存检测列类型所需的前几行，其余行直接转换为数据点。
+     */
+    DataSet processWorksheetData(const RowSource& readRows,
+                                 const std::vector<std::string>& sharedStrings, bool hasHeader);
+
+    /**
+     * @brief 把工作表中的每个数值列转换为一个数据集（名称为列标题）
+     */
+    std::vector<DataSet> processWorksheetSeries(const RowSource& readRows,
+                                                const std::vector<std::string>& sharedStrings,
+                                                bool hasHeader);
+
+    /**
+     * @brief 在多个线程中解码各工作表的数值列，结果按工作表顺序排列
+     * @param sheets 工作表名称和行来源
+     */
+    std::vector<DataSet> decodeAllSeries(
+        const std::vector<std::pair<std::string, RowSource>>& sheets,
+        const std::vector<std::string>& sharedStrings, const std::string& prefix, bool hasHeader,
+        int threadCount);
+
+    // xls文件处理方法
+    /**
+     * @brief 从xls文件导入数据
+     *
+     * 从复合文档中取出Workbook流，逐条读取工作表的BIFF记录，不建立工作簿模型。
+     */
+    DataSet importFromXls(const std::string& filename, const std::string& sheetName,
+                          bool hasHeader);
+
+    /**
+     * @brief 获取xls文件的工作表名称
+     */
+    std::vector<std::string> getXlsSheetNames(const std::string& filename);
+
+    /**
+     * @brief 预览xls数据，读到maxRows行后停止
+     */
+    std::vector<std::vector<std::string>> previewXlsData(const std::string& filename,
+                                                         const std::string& sheetName,
+                                                         int maxRows);
 
     /**
      * @brief 获取xlsx文件的工作表名称
@@ -153,10 +272,14 @@ private:
 
     /**
      * @brief 预览xlsx数据
+     *
+     * 读到maxRows行后停止解压，共享字符串只读取这些行引用到的部分。
      */
     std::vector<std::vector<std::string>> previewXlsxData(const std::string& filename,
                                                           const std::string& sheetName,
                                                           int maxRows);
+
+    CancellationToken cancellationToken;
 };
 
 }  // namespace neumann
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 符号链接处理策略
+ */
+enum class SymlinkPolicy {
+    SKIP,          // 忽略所有符号链接
+    FOLLOW_FILES,  // 跟随指向文件的符号链接，不进入链接目录
+    FOLLOW_ALL     // 跟随所有符号链接（检测并跳过目录环路）
+};
+
+/**
+ * @brief 文件发现配置
+ *
+ * 模式使用以'/'分隔的相对于根目录的路径进行匹配，支持'*'、'?'和'**'；
+ * 不含'/'的模式只匹配文件名（或目录名）。
+ */
+struct FileDiscoveryOptions {
+    bool recursive = false;                    // 是否递归子目录
+    int maxDepth = -1;                         // 最大目录深度（-1不限制，0仅根目录）
+    std::vector<std::string> includePatterns;  // 文件包含模式（为空表示全部包含）
+    std::vector<std::string> excludePatterns;  // 文件和目录排除模式
+    SymlinkPolicy symlinkPolicy = SymlinkPolicy::FOLLOW_FILES;  // 符号链接策略
+    bool sortEntries = false;  // 每个目录内按名称排序（需要缓存该目录中通过过滤的条目）
+};
+
+/**
+ * @brief 流式文件发现器
+ *
+ * 按深度优先顺序逐个产出文件路径，不预先构建完整的文件列表。
+ * 默认按文件系统返回的顺序遍历，内存占用只与目录深度有关，
+ * 因此可以在包含海量文件的目录树上边发现边处理；
+ * 开启排序时还需要缓存单个目录中通过过滤的条目。
+ */
+class FileDiscovery
+{
+public:
+    /**
+     * @brief 文件过滤函数类型，返回false的文件不会被产出
+     */
+    using FileFilter = std::function<bool(const std::string &filePath)>;
+
+    /**
+     * @brief 构造函数
+     * @param rootDirectory 根目录
+     * @param options 发现配置
+     * @param fileFilter 额外的文件过滤函数
+     */
+    FileDiscovery(const std::string &rootDirectory, const FileDiscoveryOptions &options,
+                  FileFilter fileFilter = nullptr);
+
+    /**
+     * @brief 获取下一个文件
+     * @param filePath 输出的文件路径
+     * @return 没有更多文件时返回false
+     */
+    bool next(std::string &filePath);
+
+    /**
+     * @brief 获取已产出的文件数
+     */
+    size_t getDiscoveredCount() const;
+
+    /**
+     * @brief 检查路径是否匹配通配模式
+     * @param pattern 通配模式
+     * @param path 以'/'分隔的相对路径
+     * @return 是否匹配
+     */
+    static bool matchGlob(const std::string &pattern, const std::string &path);
+
+    /**
+     * @brief 将路径解析为根目录下的规范路径
+     *
+     * 相对路径相对于根目录解析；".."和已存在部分中的符号链接都会被展开，
+     * 因此经由符号链接指向根目录之外的路径同样会被拒绝。
+     * @param rootDirectory 根目录
+     * @param path 待解析的路径
+     * @param resolvedPath 输出的规范路径
+     * @return 路径位于根目录（或就是根目录）之内时返回true
+     */
+    static bool resolveUnderRoot(const std::string &rootDirectory, const std::string &path,
+                                 std::string &resolvedPath);
+
+private:
+    // 正在遍历的目录
+    struct DirectoryFrame {
+        std::string relativePath;  // 相对于根目录的路径（'/'分隔，根目录为空）
+        int depth;
+        std::filesystem::directory_iterator iterator;           // 不排序时逐项遍历
+        std::vector<std::filesystem::directory_entry> entries;  // 排序时的目录条目
+        size_t position;
+    };
+
+    /**
+     * @brief 将目录压入遍历栈
+     */
+    void pushDirectory(const std::filesystem::path &directory, const std::string &relativePath,
+                       int depth);
+
+    /**
+     * @brief 取出栈顶目录的下一个条目
+     */
+    bool nextEntry(DirectoryFrame &frame, std::filesystem::directory_entry &entry);
+
+    /**
+     * @brief 检查条目是否可能产出文件或需要进入（不含环路检测和额外的过滤函数）
+     * @param entry 目录条目
+     * @param relativePath 条目的相对路径
+     * @param depth 条目所在目录的深度
+     */
+    bool isCandidate(const std::filesystem::directory_entry &entry,
+                     const std::string &relativePath, int depth) const;
+
+    /**
+     * @brief 检查相对路径是否匹配任意模式
+     */
+    static bool matchesAny(const std::vector<std::string> &patterns,
+                           const std::string &relativePath);
+
+    FileDiscoveryOptions options;
+    FileFilter fileFilter;
+    std::vector<DirectoryFrame> stack;
+    std::set<std::string> visitedDirectories;  // FOLLOW_ALL策略下已访问目录的规范路径
+    size_t discoveredCount;
+};
+
+}  // namespace neumann
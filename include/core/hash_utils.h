@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace neumann {
+
+/**
+ * @brief FNV-1a 64位哈希
+ *
+ * 计算速度快、实现简单，用于判断文件内容是否发生变化等非加密场景。
+ * 支持分块调用update()，结果与一次性计算整段数据相同。
+ */
+class Fnv1a64
+{
+public:
+    Fnv1a64() : state(kOffsetBasis) {}
+
+    /**
+     * @brief 追加数据
+     * @param data 数据指针
+     * @param size 数据字节数
+     */
+    void update(const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            state ^= bytes[i];
+            state *= kPrime;
+        }
+    }
+
+    /**
+     * @brief 追加字符串
+     */
+    void update(const std::string &data) { update(data.data(), data.size()); }
+
+    /**
+     * @brief 获取哈希值
+     */
+    uint64_t digest() const { return state; }
+
+    /**
+     * @brief 获取16位十六进制字符串形式的哈希值
+     */
+    std::string hexDigest() const
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(16, '0');
+        uint64_t value = state;
+        for (int i = 15; i >= 0; --i) {
+            hex[static_cast<size_t>(i)] = digits[value & 0xF];
+            value >>= 4;
+        }
+        return hex;
+    }
+
+    /**
+     * @brief 计算字符串的十六进制哈希值
+     */
+    static std::string hashHex(const std::string &data)
+    {
+        Fnv1a64 hash;
+        hash.update(data);
+        return hash.hexDigest();
+    }
+
+private:
+    static constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+    static constexpr uint64_t kPrime = 1099511628211ULL;
+
+    uint64_t state;
+};
+
+/**
+ * @brief CRC-32（IEEE 802.3多项式，与ZIP和gzip一致）
+ *
+ * 用于校验解压后的数据，支持分块调用update()。
+ */
+class Crc32
+{
+public:
+    Crc32() : state(0xFFFFFFFFu) {}
+
+    /**
+     * @brief 追加数据
+     * @param data 数据指针
+     * @param size 数据字节数
+     */
+    void update(const void *data, size_t size)
+    {
+        static const std::array<uint32_t, 256> table = makeTable();
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        uint32_t crc = state;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        state = crc;
+    }
+
+    /**
+     * @brief 获取校验值
+     */
+    uint32_t digest() const { return state ^ 0xFFFFFFFFu; }
+
+private:
+    static std::array<uint32_t, 256> makeTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1u) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            }
+            table[i] = value;
+        }
+        return table;
+    }
+
+    uint32_t state;
+};
+
+}  // namespace neumann
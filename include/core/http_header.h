@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 带q值的HTTP头列表项（Accept、Accept-Encoding等）
+ */
+struct QualityItem {
+    std::string value;     // 去掉参数并转为小写的值，如"gzip"或"application/json"
+    double quality = 1.0;  // q参数，未给出时为1，0表示拒绝
+};
+
+/**
+ * @brief 转为小写（只处理ASCII字母）
+ */
+std::string toLowerAscii(std::string text);
+
+/**
+ * @brief 按逗号拆分HTTP头的列表值
+ * @param header 头的值
+ * @return 去掉首尾空白后的非空项，保持原有顺序
+ */
+std::vector<std::string> splitHeaderList(const std::string &header);
+
+/**
+ * @brief 解析带q值的HTTP头列表
+ *
+ * 每项的值在第一个分号之前，其余参数中只读取q（大小写不敏感），无法解析的q值视为0。
+ * @param header 头的值
+ * @return 按原有顺序排列的列表项
+ */
+std::vector<QualityItem> parseQualityList(const std::string &header);
+
+}  // namespace neumann
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -17,7 +20,10 @@ enum class Language {
 /**
  * @brief 轻量级国际化系统
  *
- * 提供多语言文本支持，支持运行时语言切换
+ * 提供多语言文本支持，支持运行时语言切换。
+ * 翻译表在加载完成后不再修改，查找时只通过原子指针读取当前快照，不修改引用计数，
+ * 可以在多个线程中无锁并发调用；重新加载时构造新表并整体替换，旧表保留到程序结束，
+ * 正在进行的查找不受影响。
  */
 class I18n
 {
@@ -47,6 +53,14 @@ public:
      */
     std::string getText(const std::string &key) const;
 
+    /**
+     * @brief 获取指定语言的翻译文本，不读取也不修改当前语言
+     * @param key 文本键
+     * @param lang 目标语言
+     * @return 对应语言的文本，找不到时依次回退到英文和键本身
+     */
+    std::string getText(const std::string &key, Language lang) const;
+
     /**
      * @brief 获取格式化翻译文本
      * @param key 文本键
@@ -91,14 +105,24 @@ private:
     I18n(const I18n &) = delete;
     I18n &operator=(const I18n &) = delete;
 
+    // 翻译数据：map<语言, map<键, 文本>>
+    using TranslationTables = std::map<Language, std::map<std::string, std::string>>;
+
     // 初始化内置翻译
-    void initializeBuiltinTranslations();
+    static void initializeBuiltinTranslations(TranslationTables &translations);
 
     // 当前语言
-    Language currentLanguage;
+    std::atomic<Language> currentLanguage;
 
-    // 翻译数据：map<语言, map<键, 文本>>
-    std::map<Language, std::map<std::string, std::string>> translations;
+    // 当前的不可变翻译表，查找时只读取此指针
+    std::atomic<const TranslationTables *> tables;
+
+    // 所有创建过的翻译表（由loadMutex保护），替换后仍可能有线程在读取旧表，
+    // 因此不释放；翻译文件只在启动或切换配置时加载，累积的副本很少
+    std::vector<std::unique_ptr<const TranslationTables>> snapshots;
+
+    // 串行化翻译表的替换，避免并发加载时丢失更新
+    std::mutex loadMutex;
 };
 
 // 便利宏定义
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace neumann {
+
+/**
+ * @brief 解压输出回调
+ *
+ * 每次收到一段已解压的数据，返回false时停止解压。
+ */
+using InflateConsumer = std::function<bool(const char *data, size_t size)>;
+
+/**
+ * @brief 压缩数据输入回调
+ *
+ * 每次把data指向下一段压缩数据并返回其字节数，数据在下一次调用前保持有效；
+ * 返回0表示输入结束。
+ */
+using InflateSource = std::function<size_t(const unsigned char *&data)>;
+
+/**
+ * @brief 解压原始DEFLATE数据流（RFC 1951，不含zlib/gzip头）
+ *
+ * 输入需完整位于内存中，输出按块（约64KB）交给回调，
+ * 内存占用与解压后的大小无关，可以在读到需要的内容后提前停止。
+ *
+ * @param data 压缩数据
+ * @param size 压缩数据字节数
+ * @param maxOutput 允许的最大输出字节数，超出时视为数据损坏
+ * @param consumer 输出回调
+ * @return 解压到数据流末尾返回true，回调要求停止时返回false
+ * @throws std::runtime_error 数据损坏或截断
+ */
+bool inflateRaw(const unsigned char *data, size_t size, uint64_t maxOutput,
+                const InflateConsumer &consumer);
+
+/**
+ * @brief 解压按块提供的原始DEFLATE数据流
+ *
+ * 压缩数据按需从source读取，提前停止时不再读取剩余的输入。
+ * @throws std::runtime_error 数据损坏或截断
+ */
+bool inflateRaw(const InflateSource &source, uint64_t maxOutput, const InflateConsumer &consumer);
+
+}  // namespace neumann
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 指标的标签（名称和值）
+ */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief 每个指标的分片数
+ *
+ * 线程首次记录指标时按顺序轮流分配一个分片（序号对分片数取模），之后只更新该分片上的计数。
+ * 分片是条带化的：线程数超过分片数时多个线程共用一个分片，更新仍是原子操作，
+ * 只是争用减少到约1/kMetricShards；读取时再把所有分片相加。
+ */
+const size_t kMetricShards = 16;
+
+/**
+ * @brief 当前线程使用的分片序号
+ */
+size_t metricShardIndex();
+
+/**
+ * @brief 单调递增的计数器
+ */
+class Counter
+{
+public:
+    Counter();
+
+    void increment(uint64_t amount = 1)
+    {
+        cells[metricShardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value;
+    };
+    std::array<Cell, kMetricShards> cells;
+};
+
+/**
+ * @brief 可增可减的计量值（如正在处理的请求数）
+ */
+class Gauge
+{
+public:
+    Gauge();
+
+    void add(int64_t delta)
+    {
+        cells[metricShardIndex()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void increment() { add(1); }
+    void decrement() { add(-1); }
+
+    int64_t value() const;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<int64_t> value;
+    };
+    std::array<Cell, kMetricShards> cells;
+};
+
+/**
+ * @brief 固定分桶的直方图
+ */
+class Histogram
+{
+public:
+    /**
+     * @brief 直方图的快照
+     */
+    struct Snapshot {
+        std::vector<uint64_t> buckets;  // 各桶的计数（不累计），最后一个为+Inf
+        uint64_t count = 0;
+        double sum = 0.0;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param bounds 各桶的上界（升序，不含+Inf）
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+
+    Snapshot snapshot() const;
+
+    const std::vector<double> &getBounds() const { return bounds; }
+
+    /**
+     * @brief 请求耗时的默认分桶（秒，从100微秒到10秒）
+     */
+    static std::vector<double> latencyBuckets();
+
+    /**
+     * @brief 数据大小的默认分桶（字节，从64字节到16MB）
+     */
+    static std::vector<double> sizeBuckets();
+
+private:
+    static constexpr size_t kBucketsPerLine = 8;
+
+    // 每个分片的桶占用整数个缓存行
+    struct alignas(64) BucketLine {
+        std::atomic<uint64_t> counts[kBucketsPerLine];
+    };
+
+    struct alignas(64) SumCell {
+        std::atomic<double> value;
+    };
+
+    const std::vector<double> bounds;
+    const size_t linesPerShard;
+    std::unique_ptr<BucketLine[]> lines;
+    std::array<SumCell, kMetricShards> sums;
+};
+
+/**
+ * @brief 指标注册表
+ *
+ * 注册（按名称和标签查找指标）需要加锁，调用者应保存返回的引用，之后的记录都是无锁的。
+ * 指标在注册表的生命周期内一直有效。render()按Prometheus文本格式输出所有指标。
+ */
+class MetricsRegistry
+{
+public:
+    MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry &) = delete;
+    MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+    /**
+     * @brief 进程内共享的注册表
+     */
+    static MetricsRegistry &getInstance();
+
+    /**
+     * @brief 获取或创建计数器
+     * @param name 指标名称
+     * @param help 说明（第一次注册时的说明生效）
+     * @param labels 标签
+     * @throws NeumannException 同名指标已注册为其他类型（SYSTEM_ERROR）
+     */
+    Counter &counter(const std::string &name, const std::string &help,
+                     const MetricLabels &labels = {});
+
+    /**
+     * @brief 获取或创建计量值
+     */
+    Gauge &gauge(const std::string &name, const std::string &help,
+                 const MetricLabels &labels = {});
+
+    /**
+     * @brief 获取或创建直方图（同名指标使用第一次注册时的分桶）
+     */
+    Histogram &histogram(const std::string &name, const std::string &help,
+                         const std::vector<double> &bounds, const MetricLabels &labels = {});
+
+    /**
+     * @brief 注册在输出时才读取的计量值（如队列长度），同名同标签的回调会被替换
+     */
+    void gaugeCallback(const std::string &name, const std::string &help,
+                       std::function<double()> callback, const MetricLabels &labels = {});
+
+    /**
+     * @brief 按Prometheus文本格式（0.0.4）输出所有指标
+     */
+    std::string render() const;
+
+private:
+    enum class MetricType { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Series {
+        MetricLabels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> callback;
+    };
+
+    struct Family {
+        std::string help;
+        MetricType type;
+        std::map<std::string, Series> series;  // 按标签文本排序
+    };
+
+    // 要求调用者持有锁
+    Series &findSeries(const std::string &name, const std::string &help, MetricType type,
+                       const MetricLabels &labels);
+
+    mutable std::mutex mutex;
+    std::map<std::string, Family> families;
+};
+
+/**
+ * @brief 趋势计算器处理的数据点数（neumann_calculator_points_total）
+ *
+ * 批量计算和在线计算共用同一个计数器，吞吐量由采集端按时间求变化率。
+ */
+Counter &calculatorPointsCounter();
+
+/**
+ * @brief 缓存查找次数（neumann_cache_requests_total）
+ * @param cache 缓存名称，如"workbook"、"api_responses"
+ * @param result 查找结果，如"hit"、"miss"
+ */
+Counter &cacheLookupCounter(const std::string &cache, const std::string &result);
+
+}  // namespace neumann
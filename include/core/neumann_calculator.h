@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "cancellation.h"
+
 namespace neumann {
 
 /**
@@ -25,10 +27,10 @@ struct NeumannTestResults {
     std::vector<NeumannResult> results;  // 每个测试点的结果
 
     // 汇总统计信息
-    bool overallTrend;  // 整体是否存在趋势
-    double minPG;       // 最小PG值
-    double maxPG;       // 最大PG值
-    double avgPG;       // 平均PG值
+    bool overallTrend = false;  // 整体是否存在趋势
+    double minPG = 0.0;         // 最小PG值
+    double maxPG = 0.0;         // 最大PG值
+    double avgPG = 0.0;         // 平均PG值
 };
 
 /**
@@ -73,6 +75,15 @@ public:
    */
     double getConfidenceLevel() const;
 
+    /**
+   * @brief 设置取消令牌
+   *
+   * 计算每个测试点前检查令牌，令牌取消或超时后抛出
+   * OPERATION_CANCELLED或OPERATION_TIMEOUT异常。
+   * @param token 取消令牌
+   */
+    void setCancellationToken(const CancellationToken &token);
+
 private:
     /**
    * @brief 计算诺依曼趋势统计量
@@ -92,6 +103,9 @@ private:
 
     // 当前使用的置信水平
     double confidenceLevel;
+
+    // 取消令牌（默认永不取消）
+    CancellationToken cancellationToken;
 };
 
 }  // namespace neumann
\ No newline at end of file
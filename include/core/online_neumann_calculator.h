@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+
+#include "neumann_calculator.h"
+
+namespace neumann {
+
+/**
+ * @brief 增量式诺依曼趋势测试计算器
+ *
+ * 逐个接收观测值，每追加一个点只需O(1)的计算即可得到该点的PG值和趋势判断，
+ * 不保存历史数据。均值和离差平方和用Welford方法更新，相邻差的平方和直接累加，
+ * 结果与NeumannCalculator对同一序列的批量计算一致（在浮点舍入误差范围内）。
+ * 整体趋势的判断规则与NeumannCalculator相同。
+ */
+class OnlineNeumannCalculator
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param confidenceLevel 使用的置信水平 (默认0.95)
+     */
+    explicit OnlineNeumannCalculator(double confidenceLevel = 0.95);
+
+    /**
+     * @brief 追加一个观测值
+     * @param value 观测值
+     * @param result 从第4个点开始输出该点的测试结果
+     * @return 是否产生了测试结果（前3个点返回false）
+     */
+    bool addPoint(double value, NeumannResult &result);
+
+    /**
+     * @brief 清空已接收的数据，重新开始
+     * @param confidenceLevel 新的置信水平
+     */
+    void reset(double confidenceLevel);
+
+    /**
+     * @brief 获取当前置信水平
+     */
+    double getConfidenceLevel() const { return confidenceLevel; }
+
+    /**
+     * @brief 已接收的数据点数
+     */
+    size_t getPointCount() const { return pointCount; }
+
+    /**
+     * @brief 已产生的测试结果数
+     */
+    size_t getResultCount() const { return resultCount; }
+
+    /**
+     * @brief 整体是否存在趋势
+     */
+    bool hasOverallTrend() const;
+
+    /**
+     * @brief PG值的汇总统计（尚无测试结果时为0）
+     */
+    double getMinPG() const;
+    double getMaxPG() const;
+    double getAvgPG() const;
+
+private:
+    double confidenceLevel;
+
+    // 数据的增量统计
+    size_t pointCount = 0;
+    double mean = 0.0;
+    double squaredDeviations = 0.0;   // 与均值之差的平方和（PG的分母）
+    double squaredDifferences = 0.0;  // 相邻点之差的平方和（PG的分子）
+    double lastValue = 0.0;
+
+    // 测试结果的增量统计
+    size_t resultCount = 0;
+    size_t trendCount = 0;          // 存在趋势的测试点数
+    size_t trailingTrendCount = 0;  // 末端连续存在趋势的测试点数
+    double sumPG = 0.0;
+    double minPG = 0.0;
+    double maxPG = 0.0;
+};
+
+}  // namespace neumann
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "hash_utils.h"
+
+namespace neumann {
+
+/**
+ * @brief 缓存的响应
+ */
+struct CachedResponse {
+    std::string contentType;
+    std::string body;
+    std::string contentEncoding;  // body的Content-Encoding，未压缩时为空
+};
+
+/**
+ * @brief 相同请求的合并计算和响应缓存
+ *
+ * 请求由键和请求内容共同确定：键较短（如路由、参数和请求内容的摘要），用于定位；
+ * 请求内容在未命中时复制一份保存，命中时逐字节比较确认，摘要碰撞的请求不会共享结果。
+ * 同时到达的相同请求只计算一次，其余请求等待并共享同一个结果；
+ * 计算完成的响应按最近最少使用的顺序保存在内存上限之内。
+ * 所有操作都是线程安全的，计算本身在锁外进行。
+ */
+class ResponseCache
+{
+public:
+    static constexpr size_t kDefaultMemoryLimit = 32 * 1024 * 1024;
+
+    /**
+     * @brief 构造函数
+     * @param memoryLimit 缓存的内存上限（字节，0表示只合并同时到达的请求，不缓存结果）
+     */
+    explicit ResponseCache(size_t memoryLimit = kDefaultMemoryLimit);
+
+    ResponseCache(const ResponseCache &) = delete;
+    ResponseCache &operator=(const ResponseCache &) = delete;
+
+    /**
+     * @brief 获取缓存的响应，不存在时计算
+     *
+     * 已有相同的请求正在计算时等待它的结果；compute抛出的异常会传递给所有等待者，
+     * 失败的结果不缓存。键相同但请求内容不同（摘要碰撞）时直接计算，不使用也不替换缓存。
+     * @param key 请求的键（需要包含影响结果的所有参数）
+     * @param content 请求内容，与键一起确认是否为相同的请求
+     * @param compute 计算响应的函数
+     * @return 响应
+     */
+    std::shared_ptr<const CachedResponse> getOrCompute(
+        const std::string &key, const std::string &content,
+        const std::function<CachedResponse()> &compute);
+
+    /**
+     * @brief 获取缓存的响应，键已经包含完整的请求内容
+     */
+    std::shared_ptr<const CachedResponse> getOrCompute(
+        const std::string &key, const std::function<CachedResponse()> &compute);
+
+    /**
+     * @brief 清空缓存（不影响正在进行的计算）
+     */
+    void clear();
+
+    /**
+     * @brief 设置内存上限（字节），立即淘汰超出的部分
+     */
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+
+    /**
+     * @brief 缓存的估计内存占用（字节）
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief 缓存的响应数
+     */
+    size_t size() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const std::string &key) const
+        {
+            Fnv1a64 hash;
+            hash.update(key);
+            return static_cast<size_t>(hash.digest());
+        }
+    };
+
+    struct Entry {
+        std::shared_ptr<const std::string> content;  // 请求内容，命中时比较
+        std::shared_ptr<const CachedResponse> response;
+        size_t memoryUsage = 0;
+        std::list<const std::string *>::iterator position;  // 在usageOrder中的位置
+    };
+
+    struct Pending {
+        const std::string *content;  // 正在计算的调用者持有的请求内容，计算结束前有效
+        std::shared_future<std::shared_ptr<const CachedResponse>> result;
+    };
+
+    // 以下方法要求调用者持有锁
+    void store(const std::string &key, std::shared_ptr<const std::string> content,
+               std::shared_ptr<const CachedResponse> response);
+    void evict();
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry, KeyHash> entries;
+    std::list<const std::string *> usageOrder;  // 指向entries中的键，最近使用的在前
+    std::unordered_map<std::string, Pending, KeyHash> pending;
+    size_t memoryLimit;
+    size_t memoryUsage = 0;
+};
+
+}  // namespace neumann
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+#include "neumann_calculator.h"
+
+namespace neumann {
+
+/**
+ * @brief 趋势测试结果的响应编码
+ */
+enum class ResultEncoding {
+    JSON,     // 每个测试点一个对象（兼容原有接口）
+    COLUMNAR  // 列式二进制，每个字段一个连续的小端序数组
+};
+
+/**
+ * @brief 列式二进制编码的媒体类型
+ */
+extern const char *const kColumnarContentType;
+
+/**
+ * @brief 根据HTTP Accept头选择编码
+ *
+ * 按q值选择JSON或列式二进制（application/vnd.neumann.columnar或
+ * application/octet-stream），q值相同时取先出现的类型。
+ * Accept头为空或不包含支持的类型时使用JSON。
+ */
+ResultEncoding negotiateResultEncoding(const std::string &acceptHeader);
+
+/**
+ * @brief 把测试结果编码为JSON
+ * @param echoInput 是否在响应中附带输入的data和time数组
+ */
+std::string encodeResultsJson(const NeumannTestResults &results, bool echoInput = true);
+
+/**
+ * @brief 把测试结果编码为列式二进制
+ *
+ * 所有数值均为小端序，头部48字节：
+ *   0  char[4] 标识"NTR1"
+ *   4  uint16  版本（1）
+ *   6  uint16  标志（位0：整体存在趋势；位1：附带输入数组）
+ *   8  uint32  测试点数m
+ *   12 uint32  输入点数n（未附带输入时为0）
+ *   16 double  置信水平、最小PG、最大PG、平均PG
+ * 随后依次为m个double的pgValue、wpThreshold列，n个double的data、time列，
+ * 最后是m个uint8的hasTrend列。第i个测试点对应输入的第i+3个点，不再重复存放。
+ * double列都从8字节对齐的偏移开始，客户端可以直接映射为Float64Array。
+ * @param echoInput 是否附带输入的data和time数组
+ */
+std::string encodeResultsColumnar(const NeumannTestResults &results, bool echoInput = true);
+
+}  // namespace neumann
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace neumann {
+
+/**
+ * @brief 单元格类型（对应SpreadsheetML中<c>元素的t属性）
+ */
+enum class CellType {
+    NUMBER,          // 数值（无t属性或t="n"）
+    SHARED_STRING,   // 共享字符串索引（t="s"）
+    INLINE_STRING,   // 内联字符串（t="inlineStr"）
+    FORMULA_STRING,  // 公式计算得到的字符串（t="str"）
+    BOOLEAN,         // 布尔值（t="b"）
+    ERROR,           // 错误值（t="e"）
+    DATE             // ISO 8601日期（t="d"）
+};
+
+/**
+ * @brief 单元格事件
+ *
+ * value只在回调期间有效，已完成XML实体解码。
+ */
+struct CellEvent {
+    uint32_t row = 0;     // 行号（从1开始）
+    uint32_t column = 0;  // 列索引（从0开始）
+    CellType type = CellType::NUMBER;
+    std::string_view value;  // 数值、共享字符串索引或字符串内容
+};
+
+/**
+ * @brief 前向、分块的XML标记解析器
+ *
+ * 不构建DOM，也不要求完整文档在内存中：数据可以按任意边界分块输入，
+ * 只有跨块的不完整标签会被暂存，内存占用与文档大小无关。
+ * 只支持xlsx中出现的XML子集（元素、属性、文本、注释、CDATA和处理指令）。
+ */
+class XmlTokenizer
+{
+public:
+    virtual ~XmlTokenizer() = default;
+
+    /**
+     * @brief 输入一块数据
+     * @return 处理函数要求停止时返回false
+     */
+    bool feed(const char *data, size_t size);
+
+    /**
+     * @brief 输入结束
+     * @throws std::runtime_error 文档在标签中间截断
+     */
+    void finish();
+
+protected:
+    /**
+     * @brief 开始标签（名称已去掉命名空间前缀）
+     * @param attributes 标签名之后的原始属性文本
+     * @return false表示停止解析
+     */
+    virtual bool onStartTag(std::string_view name, std::string_view attributes,
+                            bool selfClosing) = 0;
+
+    /**
+     * @brief 结束标签
+     */
+    virtual bool onEndTag(std::string_view name) = 0;
+
+    /**
+     * @brief 标签之间的原始文本（未解码实体，可能被分成多段）
+     */
+    virtual bool onText(std::string_view text) = 0;
+
+    /**
+     * @brief CDATA内容（无需解码）
+     */
+    virtual bool onCData(std::string_view text) { return onText(text); }
+
+private:
+    // 处理一段数据，返回未处理的尾部（不完整的标签）的起始位置
+    size_t process(std::string_view data, bool &stopped);
+
+    std::string pending;  // 跨块的不完整标签
+};
+
+/**
+ * @brief 工作表XML读取器，逐个产生单元格事件
+ */
+class WorksheetXmlReader : public XmlTokenizer
+{
+public:
+    using CellHandler = std::function<bool(const CellEvent &)>;
+    using RowEndHandler = std::function<bool(uint32_t row)>;
+
+    /**
+     * @param onCell 每个有值的单元格调用一次，返回false停止解析
+     * @param onRowEnd 每行结束时调用，返回false停止解析
+     */
+    WorksheetXmlReader(CellHandler onCell, RowEndHandler onRowEnd);
+
+protected:
+    bool onStartTag(std::string_view name, std::string_view attributes, bool selfClosing) override;
+    bool onEndTag(std::string_view name) override;
+    bool onText(std::string_view text) override;
+
+private:
+    CellHandler onCell;
+    RowEndHandler onRowEnd;
+
+    uint32_t currentRow = 0;
+    uint32_t nextColumn = 0;
+    bool inCell = false;
+    bool capturing = false;  // 是否在<v>或内联字符串的<t>中
+    int phoneticDepth = 0;   // 位于注音<rPh>中时不收集文本
+    CellEvent cell;
+    std::string rawValue;
+    std::string decodedValue;
+};
+
+/**
+ * @brief 共享字符串表XML读取器，按顺序产生每个字符串
+ */
+class SharedStringsXmlReader : public XmlTokenizer
+{
+public:
+    using StringHandler = std::function<bool(std::string &&text)>;
+
+    explicit SharedStringsXmlReader(StringHandler onString);
+
+protected:
+    bool onStartTag(std::string_view name, std::string_view attributes, bool selfClosing) override;
+    bool onEndTag(std::string_view name) override;
+    bool onText(std::string_view text) override;
+
+private:
+    StringHandler onString;
+
+    bool inItem = false;
+    bool capturing = false;
+    int phoneticDepth = 0;
+    std::string rawText;
+};
+
+/**
+ * @brief 关系表（.rels）读取器，按顺序产生每个关系的Id和Target（已解码）
+ */
+class RelationshipsXmlReader : public XmlTokenizer
+{
+public:
+    using RelationshipHandler = std::function<bool(std::string &&id, std::string &&target)>;
+
+    explicit RelationshipsXmlReader(RelationshipHandler onRelationship);
+
+protected:
+    bool onStartTag(std::string_view name, std::string_view attributes, bool selfClosing) override;
+    bool onEndTag(std::string_view) override { return true; }
+    bool onText(std::string_view) override { return true; }
+
+private:
+    RelationshipHandler onRelationship;
+};
+
+/**
+ * @brief 工作簿（workbook.xml）读取器，按顺序产生每个工作表的名称和r:id（已解码）
+ *
+ * 缺少name属性的工作表也会产生事件（名称为空），以保持工作表的序号。
+ */
+class WorkbookXmlReader : public XmlTokenizer
+{
+public:
+    using SheetHandler = std::function<bool(std::string &&name, std::string &&relationshipId)>;
+
+    explicit WorkbookXmlReader(SheetHandler onSheet);
+
+protected:
+    bool onStartTag(std::string_view name, std::string_view attributes, bool selfClosing) override;
+    bool onEndTag(std::string_view) override { return true; }
+    bool onText(std::string_view) override { return true; }
+
+private:
+    SheetHandler onSheet;
+};
+
+/**
+ * @brief 解码XML文本中的实体（预定义实体和数字字符引用），追加到out
+ */
+void appendDecodedXml(std::string_view text, std::string &out);
+
+/**
+ * @brief 查找属性值（未解码）
+ * @return 属性存在时返回true
+ */
+bool findXmlAttribute(std::string_view attributes, std::string_view name, std::string_view &value);
+
+/**
+ * @brief 解析单元格引用（如"AB12"）
+ * @param column 输出列索引（从0开始）
+ * @param row 输出行号（没有行号部分时为0）
+ * @return 格式正确时返回true
+ */
+bool parseCellReference(std::string_view reference, uint32_t &column, uint32_t &row);
+
+/**
+ * @brief 解析数值文本（与区域设置无关，允许首尾空白）
+ * @return 整个文本都是有效数值时返回true
+ */
+bool parseCellNumber(std::string_view text, double &value);
+
+}  // namespace neumann
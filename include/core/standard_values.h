@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -89,6 +91,27 @@ public:
    */
     void setUserFilePath(const std::string &filePath);
 
+    /**
+   * @brief 标准值表的版本号，每次加载、导入或删除置信度后递增
+   *
+   * 依赖阈值的缓存结果（如数据集统计）通过比较版本号判断是否需要重新计算。
+   */
+    uint64_t getVersion() const;
+
+    /**
+   * @brief 获取完整的标准值表
+   * @return 置信水平 -> (样本数 -> W(P)值)
+   */
+    std::map<double, std::map<int, double>> getAllWPValues() const;
+
+    /**
+   * @brief 用给定的标准值表替换当前标准值（不读写文件）
+   *
+   * 用于把协调者进程的标准值传给批量处理的工作进程。
+   * @param values 置信水平 -> (样本数 -> W(P)值)
+   */
+    void setAllWPValues(const std::map<double, std::map<int, double>> &values);
+
 private:
     // 私有构造函数，防止外部实例化
     StandardValues();
@@ -109,6 +132,9 @@ private:
 
     // 当前标准值文件路径
     std::string currentFilePath;
+
+    // 标准值表的版本号
+    std::atomic<uint64_t> version{0};
 };
 
 }  // namespace neumann
\ No newline at end of file
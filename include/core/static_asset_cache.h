@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace neumann {
+
+/**
+ * @brief 缓存在内存中的静态文件
+ */
+struct StaticAsset {
+    std::string path;         // 相对于根目录的路径（使用'/'分隔）
+    std::string contentType;  // 含字符集的媒体类型
+    std::string content;      // 原始内容
+    std::string gzipContent;  // 预压缩的gzip内容（压缩无收益时为空）
+    std::string etag;         // 基于内容哈希的强ETag（含引号）
+    std::string gzipEtag;     // gzip内容的强ETag（引号内加"-gz"后缀），不同编码不共用校验器
+    std::filesystem::file_time_type modified;
+};
+
+/**
+ * @brief 静态文件缓存
+ *
+ * 启动时把根目录下的文件全部读入内存并预先压缩，之后的请求不再访问文件系统。
+ * 可选的后台线程按间隔检查文件的修改时间和大小，只重新加载发生变化的文件。
+ * 查找返回不可变的共享快照，重新加载时正在发送的响应不受影响。
+ */
+class StaticAssetCache
+{
+public:
+    static constexpr uintmax_t kMaxCachedFileSize = 8 * 1024 * 1024;  // 超过此大小的文件不缓存
+    static constexpr size_t kMinCompressSize = 256;  // 小于此大小的文件不压缩
+
+    /**
+     * @brief 构造函数
+     * @param rootDirectory 静态文件根目录
+     */
+    explicit StaticAssetCache(const std::string &rootDirectory);
+
+    /**
+     * @brief 析构函数，停止后台检查线程
+     */
+    ~StaticAssetCache();
+
+    StaticAssetCache(const StaticAssetCache &) = delete;
+    StaticAssetCache &operator=(const StaticAssetCache &) = delete;
+
+    /**
+     * @brief 扫描根目录，加载新增或变化的文件并移除已删除的文件
+     * @return 是否有文件发生变化
+     */
+    bool refresh();
+
+    /**
+     * @brief 查找文件
+     * @param path 相对于根目录的路径
+     * @return 缓存的文件，未缓存时返回nullptr
+     */
+    std::shared_ptr<const StaticAsset> find(const std::string &path) const;
+
+    /**
+     * @brief 已缓存的文件数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 启动后台线程，按间隔调用refresh()
+     * @param interval 检查间隔
+     */
+    void startWatching(std::chrono::milliseconds interval);
+
+    /**
+     * @brief 停止后台检查线程
+     */
+    void stopWatching();
+
+    /**
+     * @brief 根据扩展名确定媒体类型
+     */
+    static std::string contentTypeFor(const std::string &path);
+
+    /**
+     * @brief If-None-Match头是否与ETag匹配（支持逗号分隔的列表、弱比较和"*"）
+     *
+     * etag为原始内容的ETag，对应的gzip ETag同样视为匹配：两者来自同一个文件版本。
+     */
+    static bool etagMatches(const std::string &ifNoneMatch, const std::string &etag);
+
+    /**
+     * @brief 由原始内容的ETag得到gzip内容的ETag
+     */
+    static std::string gzipEtagFor(const std::string &etag);
+
+private:
+    std::shared_ptr<const StaticAsset> loadAsset(const std::filesystem::path &filePath,
+                                                 const std::string &relativePath) const;
+
+    const std::filesystem::path root;
+
+    mutable std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const StaticAsset>> assets;
+
+    std::mutex watchMutex;
+    std::condition_variable watchCondition;
+    bool watching = false;
+    std::thread watchThread;
+};
+
+}  // namespace neumann
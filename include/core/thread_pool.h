@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 固定大小的线程池
+ *
+ * 线程在构造时创建并一直复用，避免每个请求都创建和销毁线程。
+ * 析构时先执行完队列中已提交的任务，再等待所有线程退出。
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 线程数（0表示按硬件并发数设置）
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief 进程内共享的线程池（线程数为硬件并发数）
+     */
+    static ThreadPool &shared();
+
+    /**
+     * @brief 线程数
+     */
+    size_t size() const { return threads.size(); }
+
+    /**
+     * @brief 提交任务
+     * @return 任务结果，任务抛出的异常在get()时重新抛出
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F &&task)
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        post([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * @brief 提交不需要结果的任务
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief 并行执行body(0)到body(count - 1)，全部完成后返回
+     *
+     * 调用线程也参与执行，线程池中的线程都在忙时退化为在调用线程中顺序执行，
+     * 因此可以在线程池的任务中嵌套调用而不会死锁。
+     * 任一调用抛出异常时，剩余的索引不再执行，第一个异常在调用线程中重新抛出。
+     */
+    void parallelFor(size_t count, const std::function<void(size_t index)> &body);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    bool stopping = false;
+};
+
+}  // namespace neumann
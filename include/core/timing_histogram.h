@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief 耗时分位数
+ */
+struct TimingPercentiles {
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief 对数分桶的耗时直方图
+ *
+ * 以约5%的相对精度统计耗时分布，内存占用固定（与样本数无关），
+ * 适合在流式批量处理中逐个累加数百万个文件的耗时。
+ * 单位由调用者决定（批量处理中为微秒）。
+ */
+class TimingHistogram
+{
+public:
+    TimingHistogram() : buckets(kBucketCount, 0), total(0), maxValue(0.0) {}
+
+    /**
+     * @brief 记录一个样本
+     */
+    void record(double value)
+    {
+        if (!(value > 0.0)) {
+            value = 0.0;
+        }
+        buckets[bucketIndex(value)]++;
+        total++;
+        maxValue = std::max(maxValue, value);
+    }
+
+    /**
+     * @brief 合并另一个直方图
+     */
+    void merge(const TimingHistogram &other)
+    {
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        total += other.total;
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    /**
+     * @brief 获取样本数
+     */
+    uint64_t count() const { return total; }
+
+    /**
+     * @brief 获取分位数（返回所在桶的上界，不超过最大值）
+     * @param quantile 分位（0~1）
+     */
+    double percentile(double quantile) const
+    {
+        if (total == 0) {
+            return 0.0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total)));
+        rank = std::max<uint64_t>(rank, 1);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(bucketUpperBound(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    /**
+     * @brief 获取常用分位数汇总
+     */
+    TimingPercentiles summary() const
+    {
+        TimingPercentiles result;
+        result.p50 = percentile(0.50);
+        result.p90 = percentile(0.90);
+        result.p99 = percentile(0.99);
+        result.max = maxValue;
+        return result;
+    }
+
+private:
+    // 第0桶为[0, 1)，之后每个桶的上界按kGrowth倍增长，可覆盖到约1e10
+    static constexpr size_t kBucketCount = 480;
+    static constexpr double kGrowth = 1.05;
+
+    static size_t bucketIndex(double value)
+    {
+        if (value < 1.0) {
+            return 0;
+        }
+        size_t index = 1 + static_cast<size_t>(std::log(value) / std::log(kGrowth));
+        return std::min(index, kBucketCount - 1);
+    }
+
+    static double bucketUpperBound(size_t index)
+    {
+        return std::pow(kGrowth, static_cast<double>(index));
+    }
+
+    std::vector<uint64_t> buckets;
+    uint64_t total;
+    double maxValue;
+};
+
+}  // namespace neumann
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "biff_reader.h"
+#include "zip_archive.h"
+
+namespace neumann {
+
+/**
+ * @brief 已解析的xlsx工作簿
+ *
+ * 创建后不再修改，可以在多个线程之间共享。
+ */
+struct XlsxWorkbook {
+    uint64_t fileSize = 0;     // 打开时的文件大小（字节）
+    int64_t modifiedTime = 0;  // 打开时的修改时间（文件系统时钟计数）
+    std::shared_ptr<const ZipArchive> archive;                     // ZIP中央目录
+    std::vector<std::pair<std::string, std::string>> worksheets;  // 工作表名称和成员路径
+    std::shared_ptr<const std::vector<std::string>> sharedStrings;  // 共享字符串表，未加载时为空
+};
+
+/**
+ * @brief 已读取Workbook流和全局信息的xls工作簿
+ *
+ * 创建后不再修改，可以在多个线程之间共享。
+ */
+struct XlsWorkbook {
+    uint64_t fileSize = 0;     // 打开时的文件大小（字节）
+    int64_t modifiedTime = 0;  // 打开时的修改时间（文件系统时钟计数）
+    std::string stream;        // Workbook流
+    BiffWorkbookInfo info;     // 工作表位置和共享字符串表
+};
+
+/**
+ * @brief 工作簿缓存
+ *
+ * 按文件路径缓存已解析的xlsx或xls工作簿，文件大小或修改时间变化后缓存失效。
+ * 获取工作表名称、预览和导入同一个文件时只需解析一次ZIP目录、工作表索引和共享字符串，
+ * xls文件只需读取一次复合文档中的Workbook流。
+ * 超出内存上限时按最近最少使用的顺序淘汰，所有操作都是线程安全的。
+ */
+class WorkbookCache
+{
+public:
+    static constexpr size_t kDefaultMemoryLimit = 128 * 1024 * 1024;
+
+    /**
+     * @brief 获取WorkbookCache单例实例
+     */
+    static WorkbookCache &getInstance();
+
+    /**
+     * @brief 查找工作簿
+     * @param path 文件路径
+     * @return 缓存的工作簿，不存在或文件已变化时返回nullptr
+     */
+    std::shared_ptr<const XlsxWorkbook> find(const std::string &path);
+
+    /**
+     * @brief 查找xls工作簿
+     * @param path 文件路径
+     * @return 缓存的工作簿，不存在或文件已变化时返回nullptr
+     */
+    std::shared_ptr<const XlsWorkbook> findXls(const std::string &path);
+
+    /**
+     * @brief 添加或替换工作簿（超过内存上限的工作簿不缓存）
+     */
+    void store(const std::string &path, std::shared_ptr<const XlsxWorkbook> workbook);
+    void store(const std::string &path, std::shared_ptr<const XlsWorkbook> workbook);
+
+    /**
+     * @brief 删除文件的缓存
+     */
+    void remove(const std::string &path);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 设置内存上限（字节），立即淘汰超出的部分
+     */
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+
+    /**
+     * @brief 当前缓存的估计内存占用（字节）
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief 缓存的工作簿数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 读取文件当前的大小和修改时间
+     * @return 文件不存在或无法访问时返回false
+     */
+    static bool statFile(const std::string &path, uint64_t &fileSize, int64_t &modifiedTime);
+
+private:
+    WorkbookCache() = default;
+
+    // 每个条目只保存其中一种工作簿
+    struct Entry {
+        std::shared_ptr<const XlsxWorkbook> workbook;
+        std::shared_ptr<const XlsWorkbook> xlsWorkbook;
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        size_t memoryUsage = 0;
+        std::list<std::string>::iterator position;  // 在usageOrder中的位置
+    };
+
+    static std::string makeKey(const std::string &path);
+    static size_t estimateMemoryUsage(const XlsxWorkbook &workbook);
+    static size_t estimateMemoryUsage(const XlsWorkbook &workbook);
+
+    /**
+     * @brief 查找文件未变化的条目并标记为最近使用（会更新命中统计）
+     * @param path 文件路径
+     * @param legacy 是否查找xls工作簿，条目中没有对应格式的工作簿时视为未命中
+     * @return 条目的副本，未命中时两个工作簿指针都为空
+     */
+    Entry findEntry(const std::string &path, bool legacy);
+
+    /**
+     * @brief 添加或替换条目
+     */
+    void storeEntry(const std::string &path, Entry entry);
+
+    // 以下方法要求调用者持有锁
+    void eraseEntry(std::unordered_map<std::string, Entry>::iterator it);
+    void evict();
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> usageOrder;  // 最近使用的在前
+    size_t memoryLimit = kDefaultMemoryLimit;
+    size_t memoryUsage = 0;
+};
+
+}  // namespace neumann
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace neumann {
+
+/**
+ * @brief ZIP中央目录中的一个成员
+ */
+struct ZipEntry {
+    std::string name;                // 成员路径（使用'/'分隔）
+    uint16_t method = 0;             // 压缩方法（0为存储，8为DEFLATE）
+    uint16_t flags = 0;              // 通用标志位
+    uint32_t crc32 = 0;              // 解压后数据的CRC-32
+    uint64_t compressedSize = 0;     // 压缩后字节数
+    uint64_t uncompressedSize = 0;   // 解压后字节数
+    uint64_t localHeaderOffset = 0;  // 本地文件头在归档中的偏移
+};
+
+/**
+ * @brief 只读ZIP归档
+ *
+ * 只读取中央目录，成员按需解压到内存，不创建临时文件，也不调用外部程序。
+ * 支持存储和DEFLATE两种压缩方法以及ZIP64扩展，用于读取xlsx等基于ZIP的文档。
+ * 读取成员的方法都是const的，可以在多个线程中同时读取同一个归档。
+ */
+class ZipArchive
+{
+public:
+    /**
+     * @brief 解压输出回调，返回false时停止解压
+     */
+    using ChunkConsumer = std::function<bool(const char *data, size_t size)>;
+
+    /**
+     * @brief 打开磁盘上的ZIP文件（只读取中央目录）
+     * @throws std::runtime_error 文件无法读取或不是有效的ZIP文件
+     */
+    static ZipArchive openFile(const std::string &path);
+
+    /**
+     * @brief 从内存中的ZIP数据创建归档
+     * @throws std::runtime_error 数据不是有效的ZIP文件
+     */
+    static ZipArchive fromBuffer(std::string data);
+
+    /**
+     * @brief 获取所有成员
+     */
+    const std::vector<ZipEntry> &getEntries() const { return entries; }
+
+    /**
+     * @brief 查找成员（名称区分大小写，找不到时再按不区分大小写匹配）
+     * @return 成员指针，不存在时返回nullptr
+     */
+    const ZipEntry *findEntry(const std::string &name) const;
+
+    /**
+     * @brief 是否包含成员
+     */
+    bool hasEntry(const std::string &name) const { return findEntry(name) != nullptr; }
+
+    /**
+     * @brief 解压整个成员到内存
+     * @throws std::runtime_error 成员不存在、压缩方法不支持或数据损坏
+     */
+    std::string readEntry(const std::string &name) const;
+
+    /**
+     * @brief 流式解压成员，按块交给回调
+     *
+     * 压缩数据按块从文件读取，回调提前停止时不再读取和解压剩余部分。
+     * 完整解压时校验CRC-32和大小，回调提前停止时不校验。
+     * @return 完整解压返回true，回调要求停止时返回false
+     * @throws std::runtime_error 成员不存在、压缩方法不支持或数据损坏
+     */
+    bool streamEntry(const std::string &name, const ChunkConsumer &consumer) const;
+
+private:
+    ZipArchive() = default;
+
+    void readCentralDirectory();
+    std::string readRange(uint64_t offset, uint64_t size) const;
+
+    std::string path;                           // 文件路径（内存归档为空）
+    std::shared_ptr<const std::string> buffer;  // 内存归档的数据
+    uint64_t archiveSize = 0;
+    std::vector<ZipEntry> entries;
+    std::unordered_map<std::string, size_t> entryIndex;
+};
+
+}  // namespace neumann
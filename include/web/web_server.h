@@ -1,13 +1,29 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
+namespace neumann {
+class OnlineNeumannCalculator;
+}
+
 namespace neumann { namespace web {
 
 // 前向声明Impl类
 class WebServerImpl;
 
+/**
+ * @brief Web服务器的监听和并发设置
+ */
+struct ServerOptions {
+    std::string bindAddress = "0.0.0.0";       // 监听的TCP地址
+    int threadCount = 0;                       // 工作线程数（0表示使用硬件线程数）
+    int idleTimeout = 5;                       // 空闲连接的超时（秒，1到255）
+    size_t maxRequestSize = 16 * 1024 * 1024;  // 请求体的最大字节数（0表示不限制）
+    std::string unixSocketPath;                // 非空时监听该Unix域套接字而不是TCP端口
+};
+
 /**
  * @brief Web服务器类
  *
@@ -45,6 +61,18 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief 设置静态文件的检查间隔，文件变化后自动重新加载
+     * @param milliseconds 检查间隔（毫秒，0表示不检查）
+     */
+    void setAssetReloadInterval(int milliseconds);
+
+    /**
+     * @brief 设置监听地址、线程数和请求限制，需要在start()之前调用
+     * @param options 服务器设置
+     */
+    void setServerOptions(const ServerOptions &options);
+
     /**
      * @brief 获取服务器URL
      * @return 服务器访问URL
@@ -61,6 +89,9 @@ private:
     // 运行状态
     bool running;
 
+    // 监听和并发设置
+    ServerOptions options;
+
     // PIMPL实现
     std::unique_ptr<WebServerImpl> impl;
 
@@ -74,6 +105,11 @@ private:
      */
     void registerApiEndpoints();
 
+    /**
+     * @brief 注册实时结果推送的WebSocket端点
+     */
+    void registerStreamEndpoints();
+
     /**
      * @brief 处理静态文件请求
      * @param path 文件路径
@@ -84,10 +120,41 @@ private:
     // 核心功能API处理函数
     /**
      * @brief 处理诺依曼趋势测试请求
+     *
+     * 请求体中的echo为false时响应不再附带输入的data和time数组。
      * @param requestBody 请求体
+     * @param acceptHeader 请求的Accept头，用于选择JSON或列式二进制编码
+     * @param contentType 输出响应的Content-Type
+     * @return JSON或列式二进制响应
+     */
+    std::string handleNeumannTestRequest(const std::string &requestBody,
+                                         const std::string &acceptHeader,
+                                         std::string &contentType);
+
+    /**
+     * @brief 处理多序列诺依曼趋势测试请求
+     *
+     * 请求体给出series数组（每项含name、data和可选的time）或matrix
+     * （共用的time、columns数据列和可选的names），以及confidenceLevels列表。
+     * 所有序列和置信水平的组合在共享线程池中并行计算，每个序列返回各置信水平的汇总，
+     * detail为true时附带逐点的PG值、阈值和趋势判断。
+     * @param requestBody 请求体
+     * @return JSON响应
+     */
+    std::string handleNeumannBatchRequest(const std::string &requestBody);
+
+    /**
+     * @brief 处理实时推送通道上的一条消息
+     *
+     * 每个通道对应一个序列，消息给出新的观测值value或data数组（可选time或time数组），
+     * 由通道的增量计算器逐点计算，响应只包含新增测试点的结果和当前的汇总统计。
+     * reset为true时清空序列，confidenceLevel只在重置时或序列为空时生效。
+     * @param calculator 通道的增量计算器
+     * @param message 消息内容（JSON）
      * @return JSON响应
      */
-    std::string handleNeumannTestRequest(const std::string &requestBody);
+    std::string handleStreamMessage(OnlineNeumannCalculator &calculator,
+                                    const std::string &message);
 
     // 数据集管理API处理函数
     /**
@@ -236,6 +303,13 @@ private:
      */
     std::string handleBatchStatusRequest(const std::string &requestBody);
 
+    /**
+     * @brief 处理批量作业取消请求
+     * @param requestBody 请求体
+     * @return JSON响应
+     */
+    std::string handleBatchCancelRequest(const std::string &requestBody);
+
     // 文件导入API处理函数
     /**
      * @brief 处理CSV导入请求
@@ -1,8 +1,10 @@
 #include "cli/terminal_ui.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
+#include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
@@ -47,6 +49,40 @@ static bool endsWith(const std::string &str, const std::string &suffix)
     return str.substr(str.length() - suffix.length()) == suffix;
 }
 
+// 批量处理期间Ctrl+C取消的令牌（信号处理函数中只调用cancel()）
+static std::atomic<const CancellationToken *> activeBatchToken{nullptr};
+
+static void handleBatchInterrupt(int)
+{
+    const CancellationToken *token = activeBatchToken.load();
+    if (token) {
+        token->cancel();
+    }
+}
+
+// 批量处理期间把Ctrl+C转换为取消请求，结束后恢复原来的信号处理
+class BatchInterruptScope
+{
+public:
+    explicit BatchInterruptScope(const CancellationToken &token)
+    {
+        activeBatchToken.store(&token);
+        previousHandler = std::signal(SIGINT, handleBatchInterrupt);
+    }
+
+    ~BatchInterruptScope()
+    {
+        std::signal(SIGINT, previousHandler == SIG_ERR ? SIG_DFL : previousHandler);
+        activeBatchToken.store(nullptr);
+    }
+
+    BatchInterruptScope(const BatchInterruptScope &) = delete;
+    BatchInterruptScope &operator=(const BatchInterruptScope &) = delete;
+
+private:
+    void (*previousHandler)(int);
+};
+
 // 获取浏览器实际安装路径的辅助函数
 static std::string getBrowserPath(const std::string &browserName)
 {
@@ -1919,6 +1955,11 @@ void TerminalUI::runBatchProcessing()
         std::vector<BatchProcessResult> results;
         auto &config = Config::getInstance();
         BatchProcessor processor(config.getDefaultConfidenceLevel());
+        BatchPipelineOptions pipelineOptions;
+        pipelineOptions.workerProcesses = config.getBatchWorkerProcesses();
+        processor.setPipelineOptions(pipelineOptions);
+        CancellationToken cancelToken;
+        processor.setCancellationToken(cancelToken);
 
         switch (choice) {
             case 1: {
@@ -1933,7 +1974,8 @@ void TerminalUI::runBatchProcessing()
                 }
 
                 std::cout << std::endl;
-                std::cout << _("batch.processing") << "..." << std::endl;
+                std::cout << _("batch.processing") << "... (" << _("batch.cancel_hint") << ")"
+                          << std::endl;
 
                 // 进度回调
                 auto progressCallback = [](int current, int total, const std::string &filename) {
@@ -1956,7 +1998,10 @@ void TerminalUI::runBatchProcessing()
                     std::cout << progressInfo << std::endl;
                 };
 
-                results = processor.processDirectory(directory, progressCallback);
+                {
+                    BatchInterruptScope interruptScope(cancelToken);
+                    results = processor.processDirectory(directory, progressCallback);
+                }
                 std::cout << std::endl;
                 break;
             }
@@ -1986,7 +2031,8 @@ void TerminalUI::runBatchProcessing()
                 }
 
                 std::cout << std::endl;
-                std::cout << _("batch.processing") << "..." << std::endl;
+                std::cout << _("batch.processing") << "... (" << _("batch.cancel_hint") << ")"
+                          << std::endl;
 
                 auto progressCallback = [](int current, int total, const std::string &filename) {
                     // 只显示文件名，不显示完整路径
@@ -2008,7 +2054,10 @@ void TerminalUI::runBatchProcessing()
                     std::cout << progressInfo << std::endl;
                 };
 
-                results = processor.processFiles(files, progressCallback);
+                {
+                    BatchInterruptScope interruptScope(cancelToken);
+                    results = processor.processFiles(files, progressCallback);
+                }
                 std::cout << std::endl;
                 break;
             }
@@ -2021,6 +2070,10 @@ void TerminalUI::runBatchProcessing()
                 continue;  // 重新显示菜单
         }
 
+        if (cancelToken.getState() == CancellationToken::State::CANCELLED) {
+            TerminalUtils::getInstance().printWarning(_("batch.cancelled"));
+        }
+
         // 显示处理结果
         if (results.empty()) {
             std::cout << _("batch.no_files_processed") << std::endl;
@@ -2032,10 +2085,28 @@ void TerminalUI::runBatchProcessing()
             std::cout << _("batch.total_files") << ": " << stats.totalFiles << std::endl;
             std::cout << _("batch.successful_files") << ": " << stats.successfulFiles << std::endl;
             std::cout << _("batch.error_files") << ": " << stats.errorFiles << std::endl;
+            if (stats.timeoutFiles > 0) {
+                std::cout << _("batch.timeout_files") << ": " << stats.timeoutFiles << std::endl;
+            }
             std::cout << _("batch.files_with_trend") << ": " << stats.filesWithTrend << std::endl;
             std::cout << _("batch.total_processing_time") << ": " << std::fixed
                       << std::setprecision(2) << stats.totalProcessingTime << "s" << std::endl;
 
+            // 各阶段耗时分布，便于定位慢批次的瓶颈
+            std::cout << std::endl << _("batch.stage_timings") << std::endl;
+            auto printStage = [](const std::string &name, const TimingHistogram &times) {
+                TimingPercentiles p = times.summary();
+                std::cout << "  " << std::left << std::setw(16) << name << std::right
+                          << std::setprecision(3) << p.p50 / 1000.0 << " / " << p.p90 / 1000.0
+                          << " / " << p.p99 / 1000.0 << " / " << p.max / 1000.0 << std::endl;
+            };
+            printStage(_("batch.stage.discover"), stats.discoverTimes);
+            printStage(_("batch.stage.open"), stats.openTimes);
+            printStage(_("batch.stage.sniff"), stats.sniffTimes);
+            printStage(_("batch.stage.parse"), stats.parseTimes);
+            printStage(_("batch.stage.compute"), stats.computeTimes);
+            printStage(_("batch.stage.total"), stats.processingTimes);
+
             // 询问是否保存结果
             std::cout << std::endl;
             std::cout << _("batch.save_results_prompt") << " [y/n]: ";
@@ -2252,43 +2323,22 @@ void TerminalUI::showStatisticsAnalysis()
     std::cout << _("statistics.analyzing_all_datasets") << std::endl;
     std::cout << std::endl;
 
-    auto &config = Config::getInstance();
-    int totalDatasets = 0;
-    int datasetsWithTrend = 0;
-    double totalDataPoints = 0;
-    double totalPGSum = 0;
-    double minOverallPG = std::numeric_limits<double>::max();
-    double maxOverallPG = std::numeric_limits<double>::min();
-
-    // 分析所有数据集
-    for (const auto &datasetName : datasets) {
-        try {
-            DataSet dataSet = DataManager::getInstance().loadDataSet(datasetName);
-            if (dataSet.dataPoints.size() >= 4) {
-                NeumannCalculator calculator(config.getDefaultConfidenceLevel());
-                NeumannTestResults results =
-                    calculator.performTest(dataSet.dataPoints, dataSet.timePoints);
-
-                totalDatasets++;
-                if (results.overallTrend) {
-                    datasetsWithTrend++;
-                }
-
-                totalDataPoints += dataSet.dataPoints.size();
-                totalPGSum += results.avgPG;
-                minOverallPG = std::min(minOverallPG, results.minPG);
-                maxOverallPG = std::max(maxOverallPG, results.maxPG);
-
-                std::cout << "✓ " << datasetName << " (" << dataSet.dataPoints.size()
-                          << " points, trend: " << (results.overallTrend ? "YES" : "NO") << ")"
-                          << std::endl;
-            }
-        }
-        catch (const std::exception &e) {
-            std::cout << "✗ " << datasetName << " (Error: " << e.what() << ")" << std::endl;
+    // 统计由DataManager增量维护，只有第一次查询时才测试所有数据集
+    auto &dataManager = DataManager::getInstance();
+    double confidenceLevel = Config::getInstance().getDefaultConfidenceLevel();
+    for (const auto &item : dataManager.getDataSetSummaries(confidenceLevel)) {
+        const DataSetSummary &summary = item.second;
+        if (summary.tested) {
+            std::cout << "✓ " << item.first << " (" << summary.pointCount
+                      << " points, trend: " << (summary.overallTrend ? "YES" : "NO") << ")"
+                      << std::endl;
         }
     }
 
+    DataSetStatistics statistics = dataManager.getStatistics(confidenceLevel);
+    int totalDatasets = statistics.testedDatasets;
+    int datasetsWithTrend = statistics.datasetsWithTrend;
+
     std::cout << std::endl;
     std::cout << "===== " << _("statistics.overall_summary") << " =====" << std::endl;
     std::cout << _("statistics.total_datasets") << ": " << totalDatasets << std::endl;
@@ -2297,13 +2347,13 @@ void TerminalUI::showStatisticsAnalysis()
               << (totalDatasets > 0 ? (datasetsWithTrend * 100.0 / totalDatasets) : 0) << "%)"
               << std::endl;
     std::cout << _("statistics.avg_data_points") << ": " << std::setprecision(1)
-              << (totalDatasets > 0 ? (totalDataPoints / totalDatasets) : 0) << std::endl;
+              << statistics.avgDataPoints() << std::endl;
     std::cout << _("statistics.avg_pg_value") << ": " << std::setprecision(4)
-              << (totalDatasets > 0 ? (totalPGSum / totalDatasets) : 0) << std::endl;
+              << statistics.avgPGValue() << std::endl;
 
     if (totalDatasets > 0) {
-        std::cout << _("statistics.pg_range") << ": " << std::setprecision(4) << minOverallPG
-                  << " - " << maxOverallPG << std::endl;
+        std::cout << _("statistics.pg_range") << ": " << std::setprecision(4) << statistics.minPG
+                  << " - " << statistics.maxPG << std::endl;
     }
 
     std::cout << std::endl;
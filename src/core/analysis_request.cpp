@@ -0,0 +1,342 @@
+#include "core/analysis_request.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+#include <system_error>
+
+#include "core/error_handler.h"
+
+using json = nlohmann::json;
+
+namespace neumann {
+
+namespace {
+
+/**
+ * @brief 分析请求的流式解析器
+ *
+ * 按JSON语法逐个扫描请求体，不构建文档树：data和time数组中的数值直接转换后追加到缓冲区，
+ * 数值用from_chars转换，不复制数值文本。未知字段的值只确定其范围，
+ * 再交给nlohmann/json校验，保证接受的请求与完整解析一致。
+ */
+class AnalysisRequestParser
+{
+public:
+    AnalysisRequestParser(const std::string &body, size_t maxPoints)
+        : begin(body.data()), pos(body.data()), end(body.data() + body.size()),
+          maxPoints(maxPoints)
+    {
+    }
+
+    AnalysisRequest parse()
+    {
+        AnalysisRequest request;
+        bool hasData = false;
+
+        skipSpace();
+        if (peek() != '{') {
+            fail(std::string("request must be a JSON object, but is ") + valueType());
+        }
+        ++pos;
+        skipSpace();
+        if (peek() == '}') {
+            ++pos;
+        } else {
+            while (true) {
+                skipSpace();
+                std::string name = parseKey();
+                skipSpace();
+                expect(':');
+                skipSpace();
+
+                // 重复的字段以最后一次为准，与DOM解析一致
+                if (name == "data") {
+                    parseNumberArray(request.dataPoints, request.timePoints, "data");
+                    hasData = true;
+                } else if (name == "time") {
+                    parseNumberArray(request.timePoints, request.dataPoints, "time");
+                } else if (name == "confidenceLevel") {
+                    if (peek() != '-' && !isDigit(peek())) {
+                        fail(std::string("confidenceLevel must be number, but is ") + valueType());
+                    }
+                    request.confidenceLevel = parseNumber();
+                } else if (name == "echo") {
+                    request.echo = parseBoolean();
+                } else {
+                    skipValue(name);
+                }
+
+                skipSpace();
+                if (peek() == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect('}');
+                break;
+            }
+        }
+
+        skipSpace();
+        if (pos != end) {
+            fail("unexpected characters after the request object");
+        }
+        if (!hasData) {
+            throw NeumannException(ErrorCode::DATA_PARSING_ERROR, "request has no data array");
+        }
+        return request;
+    }
+
+private:
+    static bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+    char peek() const { return pos < end ? *pos : '\0'; }
+
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw NeumannException(ErrorCode::DATA_PARSING_ERROR,
+                               message + " (offset " + std::to_string(pos - begin) + ")");
+    }
+
+    void skipSpace()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) {
+            ++pos;
+        }
+    }
+
+    void expect(char ch)
+    {
+        if (peek() != ch) {
+            fail(std::string("expected '") + ch + "'");
+        }
+        ++pos;
+    }
+
+    const char *valueType() const
+    {
+        switch (peek()) {
+            case '{':
+                return "object";
+            case '[':
+                return "array";
+            case '"':
+                return "string";
+            case 't':
+            case 'f':
+                return "boolean";
+            case 'n':
+                return "null";
+            default:
+                return peek() == '-' || isDigit(peek()) ? "number" : "invalid";
+        }
+    }
+
+    // 跳过字符串，只检查转义和控制字符，返回是否需要完整解码
+    bool skipString()
+    {
+        expect('"');
+        bool needsDecoding = false;
+        while (true) {
+            if (pos == end) {
+                fail("unterminated string");
+            }
+            unsigned char ch = static_cast<unsigned char>(*pos++);
+            if (ch == '"') {
+                return needsDecoding;
+            }
+            if (ch < 0x20) {
+                fail("control character in string");
+            }
+            if (ch == '\\') {
+                if (pos == end) {
+                    fail("unterminated string");
+                }
+                ++pos;
+                needsDecoding = true;
+            } else if (ch >= 0x80) {
+                needsDecoding = true;
+            }
+        }
+    }
+
+    std::string parseKey()
+    {
+        if (peek() != '"') {
+            fail("expected a field name");
+        }
+        const char *start = pos;
+        if (!skipString()) {
+            return std::string(start + 1, pos - 1);
+        }
+        // 含转义或非ASCII字符的名称很少见，交给nlohmann/json解码并校验UTF-8
+        try {
+            return json::parse(start, pos).get<std::string>();
+        }
+        catch (const json::exception &e) {
+            pos = start;
+            fail(std::string("invalid field name: ") + e.what());
+        }
+    }
+
+    double parseNumber()
+    {
+        // 按JSON的数值语法确定范围：-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        const char *start = pos;
+        if (peek() == '-') {
+            ++pos;
+        }
+        if (peek() == '0') {
+            ++pos;
+        } else if (isDigit(peek())) {
+            while (isDigit(peek())) {
+                ++pos;
+            }
+        } else {
+            fail("invalid number");
+        }
+        if (peek() == '.') {
+            ++pos;
+            if (!isDigit(peek())) {
+                fail("invalid number");
+            }
+            while (isDigit(peek())) {
+                ++pos;
+            }
+        }
+        if (peek() == 'e' || peek() == 'E') {
+            ++pos;
+            if (peek() == '+' || peek() == '-') {
+                ++pos;
+            }
+            if (!isDigit(peek())) {
+                fail("invalid number");
+            }
+            while (isDigit(peek())) {
+                ++pos;
+            }
+        }
+
+        double value = 0.0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto result = std::from_chars(start, pos, value);
+        if (result.ec != std::errc() || result.ptr != pos) {
+            fail("number out of range");
+        }
+#else
+        // 标准库未提供浮点from_chars时退回strtod（程序使用默认的"C"区域设置）
+        std::string copy(start, pos);
+        value = std::strtod(copy.c_str(), nullptr);
+#endif
+        return value;
+    }
+
+    bool parseBoolean()
+    {
+        if (end - pos >= 4 && std::equal(pos, pos + 4, "true")) {
+            pos += 4;
+            return true;
+        }
+        if (end - pos >= 5 && std::equal(pos, pos + 5, "false")) {
+            pos += 5;
+            return false;
+        }
+        fail(std::string("echo must be boolean, but is ") + valueType());
+    }
+
+    void parseNumberArray(std::vector<double> &values, const std::vector<double> &other,
+                          const char *name)
+    {
+        if (peek() != '[') {
+            fail(std::string(name) + " must be an array of numbers, but is " + valueType());
+        }
+        ++pos;
+
+        values.clear();
+        values.reserve(reserveHint(other));
+        skipSpace();
+        if (peek() == ']') {
+            ++pos;
+            return;
+        }
+        while (true) {
+            skipSpace();
+            if (peek() != '-' && !isDigit(peek())) {
+                fail(std::string(name) + " must be an array of numbers, but contains " +
+                     valueType());
+            }
+            // 超过上限时立即停止，不再读取剩余的请求
+            if (values.size() >= maxPoints) {
+                throw NeumannException(ErrorCode::DATA_OUT_OF_RANGE,
+                                       std::string(name) + " has more than " +
+                                           std::to_string(maxPoints) + " points");
+            }
+            values.push_back(parseNumber());
+            skipSpace();
+            if (peek() == ',') {
+                ++pos;
+                continue;
+            }
+            expect(']');
+            return;
+        }
+    }
+
+    size_t reserveHint(const std::vector<double> &other)
+    {
+        // 另一个数组已经解析时两者长度应当相同，否则以逗号数加一作为元素数的上界，
+        // 预留但未写入的内存不会实际占用物理页
+        if (!other.empty()) {
+            return std::min(other.size(), maxPoints);
+        }
+        if (separators == 0) {
+            separators = static_cast<size_t>(std::count(pos, end, ',')) + 1;
+        }
+        return std::min(separators, maxPoints);
+    }
+
+    void skipValue(const std::string &name)
+    {
+        // 先按括号和字符串确定值的范围，再完整校验
+        const char *start = pos;
+        int depth = 0;
+        while (pos < end) {
+            char ch = *pos;
+            if (ch == '"') {
+                skipString();
+                continue;
+            }
+            if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if (ch == '}' || ch == ']') {
+                if (depth == 0) {
+                    break;
+                }
+                --depth;
+            } else if (ch == ',' && depth == 0) {
+                break;
+            }
+            ++pos;
+        }
+        if (depth != 0 || !json::accept(start, pos)) {
+            pos = start;
+            fail("invalid value for field " + name);
+        }
+    }
+
+    const char *const begin;
+    const char *pos;
+    const char *const end;
+    const size_t maxPoints;
+    size_t separators = 0;  // 请求体中的逗号数加一，第一次预分配时计算
+};
+
+}  // namespace
+
+AnalysisRequest parseAnalysisRequest(const std::string &body, size_t maxPoints)
+{
+    return AnalysisRequestParser(body, maxPoints).parse();
+}
+
+}  // namespace neumann
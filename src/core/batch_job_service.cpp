@@ -0,0 +1,269 @@
+#include "core/batch_job_service.h"
+
+#include <exception>
+#include <filesystem>
+
+#include "core/batch_result_sink.h"
+#include "core/error_handler.h"
+
+namespace neumann {
+
+/**
+ * @brief 单个作业的状态，由服务和执行它的工作线程共同持有
+ */
+struct BatchJobService::Job {
+    using Clock = std::chrono::steady_clock;
+
+    std::string id;
+    BatchJobRequest request;
+    CancellationToken token;
+
+    // 以下字段由job的mutex保护
+    mutable std::mutex mutex;
+    BatchJobState state = BatchJobState::QUEUED;
+    int processedFiles = 0;
+    int totalFiles = 0;
+    std::vector<BatchProcessResult> results;
+    std::string errorMessage;
+    Clock::time_point startTime;
+    Clock::time_point finishTime;
+
+    bool isFinished() const
+    {
+        return state == BatchJobState::COMPLETED || state == BatchJobState::FAILED ||
+               state == BatchJobState::CANCELLED;
+    }
+};
+
+namespace {
+
+// 把流式处理的每个结果追加到作业中，供轮询时读取
+class JobResultSink : public BatchResultSink
+{
+public:
+    JobResultSink(std::mutex &mutex, std::vector<BatchProcessResult> &results)
+        : mutex(mutex), results(results)
+    {
+    }
+
+    bool begin() override { return true; }
+
+    bool write(size_t /*index*/, const BatchProcessResult &result) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(result);
+        return true;
+    }
+
+    bool end(const BatchProcessStats & /*stats*/) override { return true; }
+
+private:
+    std::mutex &mutex;
+    std::vector<BatchProcessResult> &results;
+};
+
+}  // namespace
+
+BatchJobService::BatchJobService(size_t workerCount, size_t queueCapacity, size_t retainedJobs)
+    : queueCapacity(queueCapacity), retainedJobs(retainedJobs), workers(workerCount)
+{
+}
+
+BatchJobService::~BatchJobService()
+{
+    // 排队的作业被取消后立即结束，执行中的作业在下一个检查点停止，
+    // 随后workers析构时等待它们退出
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &entry : jobs) {
+        entry.second->token.cancel();
+    }
+}
+
+BatchJobService &BatchJobService::getInstance()
+{
+    static BatchJobService instance;
+    return instance;
+}
+
+std::string BatchJobService::submit(const BatchJobRequest &request)
+{
+    if (request.directory.empty() && request.files.empty()) {
+        THROW_ERROR(ErrorCode::INVALID_CONFIG_VALUE, "Batch job needs a directory or files");
+    }
+
+    auto job = std::make_shared<Job>();
+    job->request = request;
+    job->totalFiles = static_cast<int>(request.files.size());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queuedJobs >= queueCapacity) {
+            THROW_ERROR(ErrorCode::SERVICE_BUSY,
+                        "Batch job queue is full (" + std::to_string(queueCapacity) + " jobs)");
+        }
+        job->id = "batch-" + std::to_string(nextJobNumber++);
+        jobs[job->id] = job;
+        queuedJobs++;
+    }
+
+    workers.post([this, job]() { run(job); });
+    return job->id;
+}
+
+void BatchJobService::run(const std::shared_ptr<Job> &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queuedJobs--;
+    }
+
+    bool cancelledBeforeStart;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->startTime = Job::Clock::now();
+        cancelledBeforeStart = job->token.isStopRequested();
+        if (!cancelledBeforeStart) {
+            job->state = BatchJobState::RUNNING;
+        }
+    }
+
+    std::string errorMessage;
+    if (!cancelledBeforeStart) {
+        BatchProcessor processor(job->request.confidenceLevel);
+        processor.setCancellationToken(job->token);
+        processor.setDiscoveryOptions(job->request.discoveryOptions);
+        BatchPipelineOptions pipelineOptions;
+        pipelineOptions.workerProcesses = job->request.workerProcesses;
+        processor.setPipelineOptions(pipelineOptions);
+
+        JobResultSink sink(job->mutex, job->results);
+        auto progress = [&job](int current, int total, const std::string & /*filename*/) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->processedFiles = current;
+            job->totalFiles = total;
+        };
+
+        try {
+            if (!job->request.directory.empty()) {
+                // 目录发现会跳过无法访问的目录，这里把整个目录不存在视为作业失败
+                if (!std::filesystem::is_directory(job->request.directory)) {
+                    THROW_ERROR(ErrorCode::FILE_NOT_FOUND,
+                                "Directory not found: " + job->request.directory);
+                }
+                processor.processDirectory(job->request.directory, sink, progress);
+            } else {
+                processor.processFiles(job->request.files, sink, progress);
+            }
+        }
+        catch (const std::exception &e) {
+            errorMessage = e.what();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->token.isStopRequested()) {
+            job->state = BatchJobState::CANCELLED;
+        } else if (!errorMessage.empty()) {
+            job->state = BatchJobState::FAILED;
+            job->errorMessage = errorMessage;
+        } else {
+            job->state = BatchJobState::COMPLETED;
+        }
+        job->finishTime = Job::Clock::now();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finishedOrder.push_back(job->id);
+    retireFinishedJobs();
+}
+
+void BatchJobService::retireFinishedJobs()
+{
+    while (finishedOrder.size() > retainedJobs) {
+        jobs.erase(finishedOrder.front());
+        finishedOrder.pop_front();
+    }
+}
+
+bool BatchJobService::getStatus(const std::string &id, BatchJobStatus &status,
+                                size_t resultOffset) const
+{
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(id);
+        if (it == jobs.end()) {
+            return false;
+        }
+        job = it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    status.id = job->id;
+    status.state = job->state;
+    status.processedFiles = job->processedFiles;
+    status.totalFiles = job->totalFiles;
+    status.errorMessage = job->errorMessage;
+    status.resultCount = job->results.size();
+
+    status.elapsedSeconds = 0.0;
+    if (job->state != BatchJobState::QUEUED) {
+        Job::Clock::time_point end = job->isFinished() ? job->finishTime : Job::Clock::now();
+        status.elapsedSeconds = std::chrono::duration<double>(end - job->startTime).count();
+    }
+    status.filesPerSecond =
+        status.elapsedSeconds > 0.0 ? job->processedFiles / status.elapsedSeconds : 0.0;
+
+    status.results.clear();
+    if (resultOffset < job->results.size()) {
+        status.results.assign(job->results.begin() + static_cast<std::ptrdiff_t>(resultOffset),
+                              job->results.end());
+    }
+    return true;
+}
+
+size_t BatchJobService::getQueuedJobCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedJobs;
+}
+
+bool BatchJobService::cancel(const std::string &id)
+{
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(id);
+        if (it == jobs.end()) {
+            return false;
+        }
+        job = it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (job->isFinished()) {
+        return false;
+    }
+    job->token.cancel();
+    return true;
+}
+
+const char *BatchJobService::stateName(BatchJobState state)
+{
+    switch (state) {
+        case BatchJobState::QUEUED:
+            return "queued";
+        case BatchJobState::RUNNING:
+            return "running";
+        case BatchJobState::COMPLETED:
+            return "completed";
+        case BatchJobState::FAILED:
+            return "failed";
+        case BatchJobState::CANCELLED:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+}  // namespace neumann
@@ -0,0 +1,174 @@
+#include "core/batch_manifest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+// 清单格式版本，格式不兼容时递增
+const int kManifestVersion = 1;
+
+json entryToJson(const ManifestEntry &entry)
+{
+    const BatchProcessResult &result = entry.result;
+    json j;
+    j["size"] = entry.size;
+    j["mtime"] = entry.modifiedTime;
+    j["hash"] = entry.contentHash;
+    j["confidenceLevel"] = entry.confidenceLevel;
+    j["filename"] = result.filename;
+    j["status"] = result.status;
+    j["errorMessage"] = result.errorMessage;
+    j["processingTime"] = result.processingTime;
+    j["dataPoints"] = result.dataPointCount;
+    j["overallTrend"] = result.testResults.overallTrend;
+    j["minPG"] = result.testResults.minPG;
+    j["maxPG"] = result.testResults.maxPG;
+    j["avgPG"] = result.testResults.avgPG;
+    return j;
+}
+
+ManifestEntry entryFromJson(const json &j)
+{
+    ManifestEntry entry;
+    entry.size = j.at("size").get<uint64_t>();
+    entry.modifiedTime = j.at("mtime").get<int64_t>();
+    entry.contentHash = j.at("hash").get<std::string>();
+    entry.confidenceLevel = j.at("confidenceLevel").get<double>();
+
+    BatchProcessResult &result = entry.result;
+    result.filename = j.value("filename", "");
+    result.status = j.at("status").get<std::string>();
+    result.errorMessage = j.value("errorMessage", "");
+    result.processingTime = j.value("processingTime", 0.0);
+    result.dataPointCount = j.value("dataPoints", static_cast<size_t>(0));
+    result.testResults.overallTrend = j.value("overallTrend", false);
+    result.testResults.minPG = j.value("minPG", 0.0);
+    result.testResults.maxPG = j.value("maxPG", 0.0);
+    result.testResults.avgPG = j.value("avgPG", 0.0);
+    return entry;
+}
+
+}  // namespace
+
+bool BatchManifest::load(const std::string &manifestPath)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    seenKeys.clear();
+
+    std::ifstream file(manifestPath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        json data = json::parse(file);
+        if (data.value("version", 0) != kManifestVersion) {
+            return false;
+        }
+        for (auto &item : data.at("files").items()) {
+            entries[item.key()] = entryFromJson(item.value());
+        }
+        return true;
+    }
+    catch (const std::exception &) {
+        // 清单损坏时当作首次运行处理
+        entries.clear();
+        return false;
+    }
+}
+
+bool BatchManifest::save(const std::string &manifestPath) const
+{
+    try {
+        json files = json::object();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &item : entries) {
+                files[item.first] = entryToJson(item.second);
+            }
+        }
+
+        json data;
+        data["version"] = kManifestVersion;
+        data["files"] = std::move(files);
+
+        fs::path target(manifestPath);
+        if (target.has_parent_path()) {
+            fs::create_directories(target.parent_path());
+        }
+
+        std::string tempPath = manifestPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file << data.dump();
+            if (!file.good()) {
+                return false;
+            }
+        }
+
+        fs::rename(tempPath, target);
+        return true;
+    }
+    catch (const std::exception &) {
+        return false;
+    }
+}
+
+bool BatchManifest::find(const std::string &key, ManifestEntry &entry) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+void BatchManifest::update(const std::string &key, const ManifestEntry &entry)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[key] = entry;
+    seenKeys.insert(key);
+}
+
+void BatchManifest::pruneUnseen()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (seenKeys.count(it->first) == 0) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t BatchManifest::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+std::string BatchManifest::makeKey(const std::string &filePath)
+{
+    std::error_code ec;
+    fs::path absolutePath = fs::absolute(filePath, ec);
+    if (ec) {
+        absolutePath = filePath;
+    }
+    return absolutePath.lexically_normal().generic_string();
+}
+
+}  // namespace neumann
@@ -1,21 +1,254 @@
 #include "core/batch_processor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
-
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string_view>
+#include <thread>
+
+#include "core/batch_manifest.h"
+#include "core/batch_result_sink.h"
+#include "core/bounded_queue.h"
 #include "core/data_manager.h"
+#include "core/error_handler.h"
 #include "core/excel_reader.h"
+#include "core/hash_utils.h"
 #include "core/i18n.h"
 
+using json = nlohmann::json;
 namespace fs = std::filesystem;
 
 namespace neumann {
 
+/**
+ * @brief 单个文件在流水线中的处理状态
+ */
+struct BatchProcessor::FileWorkItem {
+    size_t index = 0;                                 // 在输入列表中的位置
+    std::string path;                                 // 文件路径
+    std::string extension;                            // 小写扩展名
+    std::string content;                              // 读取阶段载入的文件内容
+    DataSet dataSet;                                  // 解析阶段得到的数据集
+    BatchProcessResult result;                        // 处理结果
+    bool finished = false;                            // 已得出最终结果，后续阶段直接透传
+    CancellationToken token;                          // 文件的取消令牌（含单文件时间预算）
+
+    // 增量模式下记录到清单的文件信息（contentHash为空表示不记录）
+    std::string manifestKey;
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    std::string contentHash;
+};
+
+namespace {
+
+// 执行一个阶段并累计耗时（微秒，不含排队等待）
+template <typename Fn>
+void runTimed(double& micros, Fn&& fn)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - startTime;
+    micros += elapsed.count();
+}
+
+// 由各阶段耗时计算文件的总处理时间（秒）
+void updateProcessingTime(BatchProcessResult& result)
+{
+    const BatchStageTimings& timings = result.timings;
+    double micros =
+        timings.openMicros + timings.sniffMicros + timings.parseMicros + timings.computeMicros;
+    result.processingTime = micros / 1e6;
+}
+
+// 解析工作线程数，0或负数表示按硬件并发数设置
+int resolveWorkerCount(int requested)
+{
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? static_cast<int>(hardwareThreads) : 1;
+}
+
+/**
+ * @brief 工作线程的汇合保护
+ *
+ * 运行期间把处理器的取消令牌替换为本次运行的子令牌。正常结束时由调用者汇合线程；
+ * 调用线程中的回调抛出异常时，析构函数取消子令牌并调用stop()（如关闭队列）让线程尽快退出，
+ * 再汇合所有线程，避免销毁可汇合的std::thread导致std::terminate。最后恢复原来的令牌。
+ */
+class WorkerThreadGuard
+{
+public:
+    WorkerThreadGuard(CancellationToken& token, std::vector<std::thread>& threads,
+                      std::function<void()> stop)
+        : token(token), callerToken(token), threads(threads), stop(std::move(stop))
+    {
+        token = callerToken.createChild();
+    }
+
+    ~WorkerThreadGuard()
+    {
+        bool running = std::any_of(threads.begin(), threads.end(),
+                                   [](const std::thread& thread) { return thread.joinable(); });
+        if (running) {
+            token.cancel();
+            stop();
+            for (auto& thread : threads) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+        }
+        token = callerToken;
+    }
+
+    WorkerThreadGuard(const WorkerThreadGuard&) = delete;
+    WorkerThreadGuard& operator=(const WorkerThreadGuard&) = delete;
+
+private:
+    CancellationToken& token;
+    CancellationToken callerToken;
+    std::vector<std::thread>& threads;
+    std::function<void()> stop;
+};
+
+// 启动一个流水线阶段：从input取出元素处理后放入output，最后退出的线程负责关闭output
+template <typename T, typename Fn>
+void startStage(std::vector<std::thread>& threads, int workerCount, BoundedQueue<T>& input,
+                BoundedQueue<T>& output, Fn process)
+{
+    auto remainingWorkers = std::make_shared<std::atomic<int>>(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        threads.emplace_back([&input, &output, process, remainingWorkers]() {
+            T item;
+            while (input.pop(item)) {
+                process(item);
+                if (!output.push(std::move(item))) {
+                    break;
+                }
+            }
+            if (remainingWorkers->fetch_sub(1) == 1) {
+                output.close();
+            }
+        });
+    }
+}
+
+// 以大块顺序读取的方式载入整个文件
+std::string readFileContent(const std::string& filePath, size_t chunkSize)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file");
+    }
+
+    std::string content;
+    std::error_code ec;
+    auto fileSize = fs::file_size(filePath, ec);
+    if (!ec) {
+        content.reserve(static_cast<size_t>(fileSize));
+    }
+
+    if (chunkSize == 0) {
+        chunkSize = 1024 * 1024;
+    }
+    std::vector<char> buffer(chunkSize);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+           file.gcount() > 0) {
+        content.append(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read file");
+    }
+    return content;
+}
+
+// 解析DataManager保存格式的JSON数据集
+DataSet parseDataSetJson(const std::string& content, const std::string& filePath,
+                         const CancellationToken& token)
+{
+    // 解析回调在每个JSON事件时调用，每隔一定数量检查一次取消令牌
+    const size_t kCancellationCheckEvents = 4096;
+    size_t events = 0;
+    json j = json::parse(content, [&](int, json::parse_event_t, json&) {
+        if (++events % kCancellationCheckEvents == 0) {
+            token.throwIfStopped(filePath);
+        }
+        return true;
+    });
+
+    DataSet dataSet;
+    dataSet.name = j.value("name", fs::path(filePath).stem().string());
+    dataSet.description = j.value("description", "");
+    dataSet.source = j.value("source", filePath);
+    dataSet.createdAt = j.value("createdAt", "");
+    dataSet.dataPoints = j.value("dataPoints", std::vector<double>());
+    dataSet.timePoints = j.value("timePoints", std::vector<double>());
+
+    if (dataSet.timePoints.empty()) {
+        for (size_t i = 0; i < dataSet.dataPoints.size(); ++i) {
+            dataSet.timePoints.push_back(static_cast<double>(i));
+        }
+    }
+
+    return dataSet;
+}
+
+// 分块读取文件并计算内容哈希
+std::string hashFileContent(const std::string& filePath, size_t chunkSize)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file");
+    }
+
+    if (chunkSize == 0) {
+        chunkSize = 1024 * 1024;
+    }
+    Fnv1a64 hash;
+    std::vector<char> buffer(chunkSize);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+           file.gcount() > 0) {
+        hash.update(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read file");
+    }
+    return hash.hexDigest();
+}
+
+void finishItem(BatchProcessResult& result, bool& finished, const std::string& status,
+                const std::string& errorMessage)
+{
+    result.status = status;
+    result.errorMessage = errorMessage;
+    finished = true;
+}
+
+// 使用清单中缓存的结果，保留本次的文件名
+void reuseResult(BatchProcessResult& result, bool& finished, const ManifestEntry& entry)
+{
+    std::string filename = std::move(result.filename);
+    result = entry.result;
+    result.filename = std::move(filename);
+    result.reused = true;
+    finished = true;
+}
+
+}  // namespace
+
 BatchProcessor::BatchProcessor(double confidenceLevel) : confidenceLevel(confidenceLevel) {}
 
 void BatchProcessor::setConfidenceLevel(double level)
@@ -23,362 +256,677 @@ void BatchProcessor::setConfidenceLevel(double level)
     confidenceLevel = level;
 }
 
+void BatchProcessor::setPipelineOptions(const BatchPipelineOptions& options)
+{
+    pipelineOptions = options;
+}
+
+const BatchPipelineOptions& BatchProcessor::getPipelineOptions() const
+{
+    return pipelineOptions;
+}
+
+void BatchProcessor::setDiscoveryOptions(const FileDiscoveryOptions& options)
+{
+    discoveryOptions = options;
+}
+
+const FileDiscoveryOptions& BatchProcessor::getDiscoveryOptions() const
+{
+    return discoveryOptions;
+}
+
+void BatchProcessor::setManifestPath(const std::string& manifestPath)
+{
+    this->manifestPath = manifestPath;
+}
+
+const std::string& BatchProcessor::getManifestPath() const
+{
+    return manifestPath;
+}
+
+void BatchProcessor::setCancellationToken(const CancellationToken& token)
+{
+    cancellationToken = token;
+}
+
+const CancellationToken& BatchProcessor::getCancellationToken() const
+{
+    return cancellationToken;
+}
+
+namespace {
+
+// 按顺序产出文件列表中的路径
+std::function<bool(std::string&)> makeListSource(const std::vector<std::string>& filePaths,
+                                                 size_t& position)
+{
+    return [&filePaths, &position](std::string& filePath) {
+        if (position >= filePaths.size()) {
+            return false;
+        }
+        filePath = filePaths[position++];
+        return true;
+    };
+}
+
+}  // namespace
+
 std::vector<BatchProcessResult> BatchProcessor::processDirectory(const std::string& directoryPath,
                                                                  ProgressCallback progressCallback)
 {
-    std::vector<std::string> files = findSupportedFiles(directoryPath);
-    return processFiles(files, progressCallback);
+    FileDiscovery discovery(directoryPath, discoveryOptions,
+                            [](const std::string& filePath) { return isSupportedFile(filePath); });
+    return collectResults(
+        [&discovery](std::string& filePath) { return discovery.next(filePath); }, -1,
+        progressCallback);
+}
+
+BatchProcessStats BatchProcessor::processDirectory(const std::string& directoryPath,
+                                                   BatchResultSink& sink,
+                                                   ProgressCallback progressCallback)
+{
+    FileDiscovery discovery(directoryPath, discoveryOptions,
+                            [](const std::string& filePath) { return isSupportedFile(filePath); });
+    return streamResults(
+        [&discovery](std::string& filePath) { return discovery.next(filePath); }, -1, sink,
+        progressCallback);
 }
 
 std::vector<BatchProcessResult> BatchProcessor::processFiles(
     const std::vector<std::string>& filePaths, ProgressCallback progressCallback)
+{
+    size_t position = 0;
+    return collectResults(makeListSource(filePaths, position),
+                          static_cast<int>(filePaths.size()), progressCallback);
+}
+
+BatchProcessStats BatchProcessor::processFiles(const std::vector<std::string>& filePaths,
+                                               BatchResultSink& sink,
+                                               ProgressCallback progressCallback)
+{
+    size_t position = 0;
+    return streamResults(makeListSource(filePaths, position),
+                         static_cast<int>(filePaths.size()), sink, progressCallback);
+}
+
+std::vector<BatchProcessResult> BatchProcessor::collectResults(const FileSource& nextFile,
+                                                               int expectedTotal,
+                                                               ProgressCallback progressCallback)
 {
     std::vector<BatchProcessResult> results;
-    results.reserve(filePaths.size());
+    if (expectedTotal > 0) {
+        results.reserve(static_cast<size_t>(expectedTotal));
+    }
+
+    runPipeline(
+        nextFile, expectedTotal,
+        [&results](size_t index, BatchProcessResult& result) {
+            if (index >= results.size()) {
+                results.resize(index + 1);
+            }
+            results[index] = std::move(result);
+        },
+        progressCallback);
+
+    return results;
+}
 
-    for (size_t i = 0; i < filePaths.size(); ++i) {
+BatchProcessStats BatchProcessor::streamResults(const FileSource& nextFile, int expectedTotal,
+                                                BatchResultSink& sink,
+                                                ProgressCallback progressCallback)
+{
+    if (!sink.begin()) {
+        THROW_ERROR(ErrorCode::FILE_WRITE_ERROR, "Failed to open batch result output");
+    }
+
+    BatchProcessStats stats;
+    stats.supportedFormats = getSupportedFormats();
+    bool writeFailed = false;
+
+    runPipeline(
+        nextFile, expectedTotal,
+        [&](size_t index, BatchProcessResult& result) {
+            // 只保留汇总统计，逐点数据不再需要
+            result.testResults.data = std::vector<double>();
+            result.testResults.timePoints = std::vector<double>();
+            result.testResults.results = std::vector<NeumannResult>();
+
+            if (!writeFailed) {
+                try {
+                    runTimed(result.timings.exportMicros,
+                             [&]() { writeFailed = !sink.write(index, result); });
+                }
+                catch (const std::exception&) {
+                    // 写入失败后继续处理剩余文件以便正常结束流水线，最后统一报告错误
+                    writeFailed = true;
+                }
+            }
+            accumulateStatistics(stats, result);
+        },
+        progressCallback);
+
+    if (!sink.end(stats) || writeFailed) {
+        THROW_ERROR(ErrorCode::FILE_WRITE_ERROR, "Failed to write batch results");
+    }
+    return stats;
+}
+
+void BatchProcessor::runPipeline(const FileSource& nextFile, int expectedTotal,
+                                 const ResultHandler& onResult, ProgressCallback progressCallback)
+{
+#ifndef _WIN32
+    if (pipelineOptions.workerProcesses > 0) {
+        runSharded(nextFile, expectedTotal, onResult, progressCallback);
+        return;
+    }
+#endif
+
+    std::atomic<int> discovered{0};
+    auto currentTotal = [&]() { return expectedTotal >= 0 ? expectedTotal : discovered.load(); };
+
+    // 增量模式：加载上次运行的清单，清单不存在或无效时所有文件都重新处理
+    std::unique_ptr<BatchManifest> manifest;
+    if (!manifestPath.empty()) {
+        manifest = std::make_unique<BatchManifest>();
+        manifest->load(manifestPath);
+    }
+    const BatchManifest* manifestView = manifest.get();
+
+    BoundedQueue<FileWorkItem> readQueue(pipelineOptions.readQueueCapacity);
+    BoundedQueue<FileWorkItem> parseQueue(pipelineOptions.parseQueueCapacity);
+    BoundedQueue<FileWorkItem> computeQueue(pipelineOptions.computeQueueCapacity);
+    BoundedQueue<FileWorkItem> resultQueue(pipelineOptions.resultQueueCapacity);
+
+    std::vector<std::thread> threads;
+    WorkerThreadGuard guard(cancellationToken, threads, [&]() {
+        readQueue.close();
+        parseQueue.close();
+        computeQueue.close();
+        resultQueue.close();
+    });
+
+    // 投递线程：按来源产出的顺序把文件放入读取队列，读取队列满时自然暂停文件发现
+    threads.emplace_back([this, &nextFile, &readQueue, &discovered, expectedTotal]() {
+        std::string filePath;
+        size_t index = 0;
+        try {
+            while (true) {
+                // 取消后目录不再继续遍历；文件列表的剩余文件直接记为已取消，保证结果完整
+                bool stopped = cancellationToken.isStopRequested();
+                if (stopped && expectedTotal < 0) {
+                    break;
+                }
+
+                double discoverMicros = 0.0;
+                bool hasFile = false;
+                runTimed(discoverMicros, [&]() { hasFile = nextFile(filePath); });
+                if (!hasFile) {
+                    break;
+                }
+
+                FileWorkItem item;
+                item.index = index++;
+                item.path = filePath;
+                item.result.timings.discoverMicros = discoverMicros;
+                item.result.filename = fs::path(filePath).filename().string();
+                if (stopped) {
+                    item.token = cancellationToken;
+                    stopIfRequested(item);
+                }
+                discovered.store(static_cast<int>(index));
+                if (!readQueue.push(std::move(item))) {
+                    break;
+                }
+            }
+        }
+        catch (const std::exception&) {
+            // 文件发现出错时停止投递，已投递的文件继续处理
+        }
+        readQueue.close();
+    });
+
+    startStage(threads, resolveWorkerCount(pipelineOptions.readWorkers), readQueue, parseQueue,
+               [this, manifestView](FileWorkItem& item) {
+                   if (item.finished) {
+                       return;
+                   }
+                   // 时间预算从开始处理时计算，不含在队列中等待的时间
+                   item.token = makeFileToken();
+                   if (!stopIfRequested(item)) {
+                       runTimed(item.result.timings.openMicros,
+                                [&]() { readStage(item, manifestView); });
+                   }
+               });
+    startStage(threads, resolveWorkerCount(pipelineOptions.parseWorkers), parseQueue,
+               computeQueue, [this](FileWorkItem& item) {
+                   if (!item.finished && !stopIfRequested(item)) {
+                       parseStage(item);
+                   }
+               });
+    startStage(threads, resolveWorkerCount(pipelineOptions.computeWorkers), computeQueue,
+               resultQueue, [this](FileWorkItem& item) {
+                   if (!item.finished && !stopIfRequested(item)) {
+                       runTimed(item.result.timings.computeMicros, [&]() { computeStage(item); });
+                       // 计算完成但已超出预算的文件同样记为超时
+                       if (!item.finished) {
+                           stopIfRequested(item);
+                       }
+                   }
+               });
+
+    // 汇总阶段在调用线程中执行，保证进度回调不会并发调用
+    int completed = 0;
+    FileWorkItem item;
+    while (resultQueue.pop(item)) {
+        updateProcessingTime(item.result);
+
+        // 超时和取消的结果与文件内容无关，不写入清单
+        bool cacheable = item.result.status != "timeout" && item.result.status != "cancelled";
+        if (manifest && cacheable && !item.contentHash.empty()) {
+            ManifestEntry entry;
+            entry.size = item.fileSize;
+            entry.modifiedTime = item.modifiedTime;
+            entry.contentHash = item.contentHash;
+            entry.confidenceLevel = confidenceLevel;
+            entry.result.filename = item.result.filename;
+            entry.result.status = item.result.status;
+            entry.result.errorMessage = item.result.errorMessage;
+            entry.result.processingTime = item.result.processingTime;
+            entry.result.dataPointCount = item.result.dataPointCount;
+            entry.result.testResults.overallTrend = item.result.testResults.overallTrend;
+            entry.result.testResults.minPG = item.result.testResults.minPG;
+            entry.result.testResults.maxPG = item.result.testResults.maxPG;
+            entry.result.testResults.avgPG = item.result.testResults.avgPG;
+            manifest->update(item.manifestKey, entry);
+        }
+
+        onResult(item.index, item.result);
+
+        completed++;
         if (progressCallback) {
-            progressCallback(static_cast<int>(i), static_cast<int>(filePaths.size()), filePaths[i]);
+            progressCallback(completed, currentTotal(), item.path);
         }
+    }
 
-        BatchProcessResult result = processSingleFile(filePaths[i]);
-        results.push_back(std::move(result));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (manifest) {
+        // 被取消的运行没有处理到所有文件，保留未处理文件的记录
+        if (!cancellationToken.isStopRequested()) {
+            manifest->pruneUnseen();
+        }
+        manifest->save(manifestPath);
     }
 
     // 最终进度回调
     if (progressCallback) {
-        progressCallback(static_cast<int>(filePaths.size()), static_cast<int>(filePaths.size()),
-                         "Complete");
+        int total = currentTotal();
+        progressCallback(total, total, "Complete");
+    }
+}
+
+BatchProcessResult BatchProcessor::processSingleFile(const std::string& filePath)
+{
+    FileWorkItem item;
+    item.path = filePath;
+    item.result.filename = fs::path(filePath).filename().string();
+
+    BatchStageTimings& timings = item.result.timings;
+    item.token = makeFileToken();
+    if (!stopIfRequested(item)) {
+        runTimed(timings.openMicros, [&]() { readStage(item, nullptr); });
+    }
+    if (!item.finished && !stopIfRequested(item)) {
+        parseStage(item);
+    }
+    if (!item.finished && !stopIfRequested(item)) {
+        runTimed(timings.computeMicros, [&]() { computeStage(item); });
+        if (!item.finished) {
+            stopIfRequested(item);
+        }
+    }
+
+    updateProcessingTime(item.result);
+    return std::move(item.result);
+}
+
+std::vector<BatchProcessResult> BatchProcessor::analyzeDataSets(
+    const std::vector<DataSet>& dataSets, ProgressCallback progressCallback)
+{
+    std::vector<BatchProcessResult> results(dataSets.size());
+    if (dataSets.empty()) {
+        return results;
+    }
+
+    // 工作线程依次领取数据集，完成的序号交给调用线程报告进度
+    std::atomic<size_t> nextIndex{0};
+    BoundedQueue<size_t> completed(dataSets.size());
+    auto analyze = [&]() {
+        for (size_t index = nextIndex++; index < dataSets.size(); index = nextIndex++) {
+            FileWorkItem item;
+            item.index = index;
+            item.path = dataSets[index].name;
+            item.result.filename = dataSets[index].name;
+            item.dataSet = dataSets[index];
+            item.token = makeFileToken();
+            if (!stopIfRequested(item)) {
+                runTimed(item.result.timings.computeMicros, [&]() { computeStage(item); });
+                if (!item.finished) {
+                    stopIfRequested(item);
+                }
+            }
+            updateProcessingTime(item.result);
+            results[index] = std::move(item.result);
+            completed.push(index);
+        }
+    };
+
+    size_t workerCount = std::min(
+        static_cast<size_t>(resolveWorkerCount(pipelineOptions.computeWorkers)), dataSets.size());
+    std::vector<std::thread> threads;
+    WorkerThreadGuard guard(cancellationToken, threads,
+                            [&]() { nextIndex.store(dataSets.size()); });
+    for (size_t i = 0; i < workerCount; ++i) {
+        threads.emplace_back(analyze);
     }
 
+    int total = static_cast<int>(dataSets.size());
+    for (int current = 1; current <= total; ++current) {
+        size_t index = 0;
+        completed.pop(index);
+        if (progressCallback) {
+            progressCallback(current, total, results[index].filename);
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
     return results;
 }
 
-BatchProcessResult BatchProcessor::processSingleFile(const std::string& filePath)
+std::vector<BatchProcessResult> BatchProcessor::processWorkbook(const std::string& filePath,
+                                                                ProgressCallback progressCallback)
 {
-    BatchProcessResult result;
-    result.filename = fs::path(filePath).filename().string();
+    std::vector<DataSet> dataSets;
+    try {
+        ExcelReader reader;
+        reader.setCancellationToken(cancellationToken);
+        dataSets = reader.importAllSeries(filePath, true, pipelineOptions.parseWorkers);
+    }
+    catch (const std::exception& e) {
+        FileWorkItem item;
+        item.path = filePath;
+        item.result.filename = fs::path(filePath).filename().string();
+        item.token = cancellationToken;
+        if (!stopIfRequested(item)) {
+            finishItem(item.result, item.finished, "error", e.what());
+        }
+        return {std::move(item.result)};
+    }
 
-    auto startTime = std::chrono::high_resolution_clock::now();
+    return analyzeDataSets(dataSets, progressCallback);
+}
 
+CancellationToken BatchProcessor::makeFileToken() const
+{
+    if (pipelineOptions.fileTimeBudget.count() <= 0) {
+        return cancellationToken;
+    }
+    return cancellationToken.withDeadline(CancellationToken::Clock::now() +
+                                          pipelineOptions.fileTimeBudget);
+}
+
+bool BatchProcessor::stopIfRequested(FileWorkItem& item) const
+{
+    switch (item.token.getState()) {
+        case CancellationToken::State::ACTIVE:
+            return false;
+        case CancellationToken::State::CANCELLED:
+            finishItem(item.result, item.finished, "cancelled", "Batch processing cancelled");
+            break;
+        case CancellationToken::State::TIMED_OUT:
+            if (cancellationToken.getState() == CancellationToken::State::TIMED_OUT) {
+                finishItem(item.result, item.finished, "timeout", "Batch deadline exceeded");
+            } else {
+                finishItem(item.result, item.finished, "timeout", "File time budget exceeded");
+            }
+            break;
+    }
+
+    // 丢弃已读取和已计算的内容
+    std::string().swap(item.content);
+    item.dataSet = DataSet();
+    item.result.testResults = NeumannTestResults();
+    item.result.dataPointCount = 0;
+    return true;
+}
+
+void BatchProcessor::readStage(FileWorkItem& item, const BatchManifest* manifest) const
+{
     try {
-        if (!fs::exists(filePath)) {
-            result.status = "error";
-            result.errorMessage = "File not found";
-            return result;
+        if (!fs::exists(item.path)) {
+            finishItem(item.result, item.finished, "error", "File not found");
+            return;
         }
 
-        if (!isSupportedFile(filePath)) {
-            result.status = "skipped";
-            result.errorMessage = "Unsupported file format";
-            return result;
+        if (!isSupportedFile(item.path)) {
+            finishItem(item.result, item.finished, "skipped", "Unsupported file format");
+            return;
         }
 
-        // 根据文件类型选择相应的加载方法
-        DataSet dataSet;
-        std::string extension = fs::path(filePath).extension().string();
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        item.extension = fs::path(item.path).extension().string();
+        std::transform(item.extension.begin(), item.extension.end(), item.extension.begin(),
+                       ::tolower);
+
+        bool textFormat = item.extension == ".csv" || item.extension == ".json";
+
+        if (manifest) {
+            item.manifestKey = BatchManifest::makeKey(item.path);
+            item.fileSize = static_cast<uint64_t>(fs::file_size(item.path));
+            item.modifiedTime =
+                static_cast<int64_t>(fs::last_write_time(item.path).time_since_epoch().count());
 
-        if (extension == ".csv") {
+            ManifestEntry entry;
+            bool known = manifest->find(item.manifestKey, entry) &&
+                         entry.confidenceLevel == confidenceLevel && entry.size == item.fileSize;
+
+            // 大小和修改时间都未变化，无需读取文件
+            if (known && entry.modifiedTime == item.modifiedTime) {
+                item.contentHash = entry.contentHash;
+                reuseResult(item.result, item.finished, entry);
+                return;
+            }
+
+            // 修改时间变化时按内容哈希判断（例如文件被重新复制但内容相同）
+            if (textFormat) {
+                item.content = readFileContent(item.path, pipelineOptions.readChunkSize);
+                item.contentHash = Fnv1a64::hashHex(item.content);
+            } else {
+                item.contentHash = hashFileContent(item.path, pipelineOptions.readChunkSize);
+            }
+
+            if (known && entry.contentHash == item.contentHash) {
+                std::string().swap(item.content);
+                reuseResult(item.result, item.finished, entry);
+            }
+            return;
+        }
+
+        // Excel文件由ExcelReader按路径解压读取，这里只预先载入文本格式的内容
+        if (textFormat) {
+            item.content = readFileContent(item.path, pipelineOptions.readChunkSize);
+        }
+    }
+    catch (const std::exception& e) {
+        // 由取消或超时引起的异常按停止原因记录
+        if (!stopIfRequested(item)) {
+            finishItem(item.result, item.finished, "error", e.what());
+        }
+    }
+}
+
+void BatchProcessor::parseStage(FileWorkItem& item) const
+{
+    BatchStageTimings& timings = item.result.timings;
+    auto startTime = std::chrono::steady_clock::now();
+
+    try {
+        // 根据文件类型选择相应的解析方法
+        if (item.extension == ".csv") {
             // 智能检测CSV文件是否有表头
-            bool hasHeader = detectCSVHeader(filePath);
-            dataSet = DataManager::getInstance().importFromCSV(filePath, hasHeader);
-        } else if (extension == ".xlsx" || extension == ".xls") {
+            bool hasHeader = false;
+            runTimed(timings.sniffMicros, [&]() { hasHeader = detectCSVHeader(item.content); });
+            item.dataSet = DataManager::getInstance().importFromCSVContent(item.content, item.path,
+                                                                           hasHeader, &item.token);
+        } else if (item.extension == ".xlsx" || item.extension == ".xls") {
             ExcelReader reader;
-            dataSet = reader.importFromExcel(filePath, "", true);  // 假设有表头
-        } else if (extension == ".json") {
-            // 加载JSON数据集文件
-            fs::path jsonPath(filePath);
-            std::string datasetName = jsonPath.stem().string();
-            dataSet = DataManager::getInstance().loadDataSet(datasetName);
+            reader.setCancellationToken(item.token);
+            item.dataSet = reader.importFromExcel(item.path, "", true);  // 假设有表头
+        } else if (item.extension == ".json") {
+            // 解析JSON数据集文件
+            item.dataSet = parseDataSetJson(item.content, item.path, item.token);
 
             // 检查是否成功加载
-            if (dataSet.dataPoints.empty()) {
-                result.status = "error";
-                result.errorMessage = "Failed to load JSON dataset or dataset is empty";
-                return result;
+            if (item.dataSet.dataPoints.empty()) {
+                finishItem(item.result, item.finished, "error",
+                           "Failed to load JSON dataset or dataset is empty");
             }
         } else {
-            result.status = "error";
-            result.errorMessage = "Unsupported file format: " + extension;
-            return result;
+            finishItem(item.result, item.finished, "error",
+                       "Unsupported file format: " + item.extension);
         }
+    }
+    catch (const std::exception& e) {
+        // 由取消或超时引起的异常按停止原因记录
+        if (!stopIfRequested(item)) {
+            finishItem(item.result, item.finished, "error", e.what());
+        }
+    }
 
+    // 内容已解析完毕，尽早释放内存
+    std::string().swap(item.content);
+
+    // 解析阶段耗时不含内容探测
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - startTime;
+    timings.parseMicros += std::max(0.0, elapsed.count() - timings.sniffMicros);
+}
+
+void BatchProcessor::computeStage(FileWorkItem& item) const
+{
+    try {
         // 检查数据有效性
-        if (dataSet.dataPoints.size() < 4) {
-            result.status = "error";
-            result.errorMessage = "Insufficient data points (minimum 4 required)";
-            return result;
+        if (item.dataSet.dataPoints.size() < 4) {
+            finishItem(item.result, item.finished, "error",
+                       "Insufficient data points (minimum 4 required)");
+            return;
         }
 
         // 执行诺依曼趋势测试
         NeumannCalculator calculator(confidenceLevel);
-        result.testResults = calculator.performTest(dataSet.dataPoints, dataSet.timePoints);
+        calculator.setCancellationToken(item.token);
+        item.result.testResults =
+            calculator.performTest(item.dataSet.dataPoints, item.dataSet.timePoints);
 
-        result.status = "success";
-        result.errorMessage = "";
+        item.result.dataPointCount = item.dataSet.dataPoints.size();
+        item.result.status = "success";
+        item.result.errorMessage = "";
     }
     catch (const std::exception& e) {
-        result.status = "error";
-        result.errorMessage = e.what();
+        // 由取消或超时引起的异常按停止原因记录
+        if (!stopIfRequested(item)) {
+            finishItem(item.result, item.finished, "error", e.what());
+        }
     }
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-    result.processingTime = duration.count() / 1000.0;
-
-    return result;
+    item.dataSet = DataSet();
 }
 
 BatchProcessStats BatchProcessor::generateStatistics(const std::vector<BatchProcessResult>& results)
 {
     BatchProcessStats stats;
-    stats.totalFiles = static_cast<int>(results.size());
-    stats.processedFiles = 0;
-    stats.successfulFiles = 0;
-    stats.errorFiles = 0;
-    stats.skippedFiles = 0;
-    stats.filesWithTrend = 0;
-    stats.totalProcessingTime = 0.0;
     stats.supportedFormats = getSupportedFormats();
 
     for (const auto& result : results) {
-        stats.totalProcessingTime += result.processingTime;
-
-        if (result.status == "success") {
-            stats.successfulFiles++;
-            stats.processedFiles++;
-            if (result.testResults.overallTrend) {
-                stats.filesWithTrend++;
-            }
-        } else if (result.status == "error") {
-            stats.errorFiles++;
-            stats.processedFiles++;
-        } else if (result.status == "skipped") {
-            stats.skippedFiles++;
-        }
+        accumulateStatistics(stats, result);
     }
 
     return stats;
 }
 
-bool BatchProcessor::exportResultsToCSV(const std::vector<BatchProcessResult>& results,
-                                        const std::string& outputPath)
+void BatchProcessor::accumulateStatistics(BatchProcessStats& stats,
+                                          const BatchProcessResult& result)
 {
-    try {
-        std::ofstream file(outputPath, std::ios::binary);
-        if (!file.is_open()) {
-            return false;
+    stats.totalFiles++;
+    stats.totalProcessingTime += result.processingTime;
+
+    const BatchStageTimings& timings = result.timings;
+    stats.discoverTimes.record(timings.discoverMicros);
+    stats.openTimes.record(timings.openMicros);
+    stats.sniffTimes.record(timings.sniffMicros);
+    stats.parseTimes.record(timings.parseMicros);
+    stats.computeTimes.record(timings.computeMicros);
+    stats.exportTimes.record(timings.exportMicros);
+    stats.processingTimes.record(result.processingTime * 1e6);
+
+    if (result.status == "success") {
+        stats.successfulFiles++;
+        stats.processedFiles++;
+        if (result.testResults.overallTrend) {
+            stats.filesWithTrend++;
         }
-
-        // 写入UTF-8 BOM，解决Excel中文乱码问题
-        const char utf8_bom[] = {static_cast<char>(0xEF), static_cast<char>(0xBB),
-                                 static_cast<char>(0xBF)};
-        file.write(utf8_bom, 3);
-
-        // 获取国际化实例
-        auto& i18n = I18n::getInstance();
-
-        // CSV标题行 - 使用国际化文本
-        file << i18n.getText("batch.csv.filename") << "," << i18n.getText("batch.csv.status") << ","
-             << i18n.getText("batch.csv.processing_time") << ","
-             << i18n.getText("batch.csv.data_points") << ","
-             << i18n.getText("batch.csv.overall_trend") << "," << i18n.getText("batch.csv.min_pg")
-             << "," << i18n.getText("batch.csv.max_pg") << "," << i18n.getText("batch.csv.avg_pg")
-             << "," << i18n.getText("batch.csv.error_message") << "\n";
-
-        for (const auto& result : results) {
-            file << result.filename << ",";
-
-            // 状态翻译
-            std::string statusText;
-            if (result.status == "success") {
-                statusText = i18n.getText("batch.csv.status_success");
-            } else if (result.status == "error") {
-                statusText = i18n.getText("batch.csv.status_error");
-            } else if (result.status == "skipped") {
-                statusText = i18n.getText("batch.csv.status_skipped");
-            } else {
-                statusText = result.status;
-            }
-            file << statusText << ",";
-
-            file << std::fixed << std::setprecision(3) << result.processingTime << ",";
-
-            if (result.status == "success") {
-                file << result.testResults.data.size() << ",";
-                file << (result.testResults.overallTrend ? i18n.getText("batch.csv.trend_yes")
-                                                         : i18n.getText("batch.csv.trend_no"))
-                     << ",";
-                file << std::setprecision(6) << result.testResults.minPG << ",";
-                file << result.testResults.maxPG << ",";
-                file << result.testResults.avgPG << ",";
-                file << "\n";
-            } else {
-                file << ",,,,," << result.errorMessage << "\n";
-            }
-        }
-
-        file.close();
-        return true;
-    }
-    catch (const std::exception&) {
-        return false;
+    } else if (result.status == "error") {
+        stats.errorFiles++;
+        stats.processedFiles++;
+    } else if (result.status == "skipped") {
+        stats.skippedFiles++;
+    } else if (result.status == "timeout") {
+        stats.timeoutFiles++;
+        stats.processedFiles++;
+    } else if (result.status == "cancelled") {
+        stats.cancelledFiles++;
     }
 }
 
+bool BatchProcessor::exportResultsToCSV(const std::vector<BatchProcessResult>& results,
+                                        const std::string& outputPath)
+{
+    CsvResultSink sink(outputPath);
+    return writeResults(results, sink);
+}
+
 bool BatchProcessor::exportResultsToHTML(const std::vector<BatchProcessResult>& results,
                                          const std::string& outputPath)
+{
+    HtmlResultSink sink(outputPath);
+    return writeResults(results, sink);
+}
+
+bool BatchProcessor::exportResultsToJSONLines(const std::vector<BatchProcessResult>& results,
+                                              const std::string& outputPath)
+{
+    JsonLinesResultSink sink(outputPath);
+    return writeResults(results, sink);
+}
+
+bool BatchProcessor::writeResults(const std::vector<BatchProcessResult>& results,
+                                  BatchResultSink& sink)
 {
     try {
-        std::ofstream file(outputPath);
-        if (!file.is_open()) {
+        if (!sink.begin()) {
             return false;
         }
-
-        // 获取国际化实例
-        auto& i18n = I18n::getInstance();
-
-        // 根据当前语言设置HTML语言属性
-        std::string htmlLang = (i18n.getCurrentLanguage() == Language::CHINESE) ? "zh-CN" : "en-US";
-
-        // 生成HTML报告
-        file << "<!DOCTYPE html>\n";
-        file << "<html lang='" << htmlLang << "'>\n";
-        file << "<head>\n";
-        file << "    <meta charset='UTF-8'>\n";
-        file << "    <meta name='viewport' content='width=device-width, initial-scale=1.0'>\n";
-        file << "    <title>" << i18n.getText("batch.html.title") << "</title>\n";
-        file << "    <style>\n";
-        file << "        body { font-family: Arial, sans-serif; margin: 20px; }\n";
-        file << "        .header { background-color: #f0f8ff; padding: 20px; border-radius: 8px; "
-                "margin-bottom: 20px; }\n";
-        file << "        .stats { display: flex; gap: 20px; margin-bottom: 20px; }\n";
-        file << "        .stat-card { background: #f9f9f9; padding: 15px; border-radius: 5px; "
-                "flex: 1; }\n";
-        file << "        table { width: 100%; border-collapse: collapse; }\n";
-        file << "        th, td { padding: 8px; text-align: left; border-bottom: 1px solid #ddd; "
-                "}\n";
-        file << "        th { background-color: #f2f2f2; }\n";
-        file << "        .success { color: green; }\n";
-        file << "        .error { color: red; }\n";
-        file << "        .skipped { color: orange; }\n";
-        file << "        .trend-yes { background-color: #ffebee; }\n";
-        file << "        .trend-no { background-color: #e8f5e8; }\n";
-        file << "    </style>\n";
-        file << "</head>\n";
-        file << "<body>\n";
-
-        // 报告标题
-        file << "    <div class='header'>\n";
-        file << "        <h1>" << i18n.getText("batch.html.header_title") << "</h1>\n";
-        auto now = std::time(nullptr);
-        file << "        <p>" << i18n.getText("batch.html.generated_time") << ": "
-             << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << "</p>\n";
-        file << "    </div>\n";
-
-        // 统计信息
-        BatchProcessStats stats = generateStatistics(results);
-        file << "    <div class='stats'>\n";
-        file << "        <div class='stat-card'>\n";
-        file << "            <h3>" << i18n.getText("batch.html.total_files") << "</h3>\n";
-        file << "            <h2>" << stats.totalFiles << "</h2>\n";
-        file << "        </div>\n";
-        file << "        <div class='stat-card'>\n";
-        file << "            <h3>" << i18n.getText("batch.html.successful_processing") << "</h3>\n";
-        file << "            <h2 class='success'>" << stats.successfulFiles << "</h2>\n";
-        file << "        </div>\n";
-        file << "        <div class='stat-card'>\n";
-        file << "            <h3>" << i18n.getText("batch.html.processing_errors") << "</h3>\n";
-        file << "            <h2 class='error'>" << stats.errorFiles << "</h2>\n";
-        file << "        </div>\n";
-        file << "        <div class='stat-card'>\n";
-        file << "            <h3>" << i18n.getText("batch.html.trends_found") << "</h3>\n";
-        file << "            <h2>" << stats.filesWithTrend << "</h2>\n";
-        file << "        </div>\n";
-        file << "        <div class='stat-card'>\n";
-        file << "            <h3>" << i18n.getText("batch.html.total_processing_time") << "</h3>\n";
-        file << "            <h2>" << std::fixed << std::setprecision(2)
-             << stats.totalProcessingTime << "s</h2>\n";
-        file << "        </div>\n";
-        file << "    </div>\n";
-
-        // 详细结果表格
-        file << "    <h2>" << i18n.getText("batch.html.detailed_results") << "</h2>\n";
-        file << "    <table>\n";
-        file << "        <thead>\n";
-        file << "            <tr>\n";
-        file << "                <th>" << i18n.getText("batch.html.filename") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.status") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.processing_time") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.data_points") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.overall_trend") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.min_pg") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.max_pg") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.avg_pg") << "</th>\n";
-        file << "                <th>" << i18n.getText("batch.html.error_message") << "</th>\n";
-        file << "            </tr>\n";
-        file << "        </thead>\n";
-        file << "        <tbody>\n";
-
-        for (const auto& result : results) {
-            std::string rowClass = "";
-            if (result.status == "success" && result.testResults.overallTrend) {
-                rowClass = "trend-yes";
-            } else if (result.status == "success") {
-                rowClass = "trend-no";
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!sink.write(i, results[i])) {
+                return false;
             }
-
-            file << "            <tr class='" << rowClass << "'>\n";
-            file << "                <td>" << result.filename << "</td>\n";
-
-            // 状态翻译
-            std::string statusText;
-            if (result.status == "success") {
-                statusText = i18n.getText("batch.html.status_success");
-            } else if (result.status == "error") {
-                statusText = i18n.getText("batch.html.status_error");
-            } else if (result.status == "skipped") {
-                statusText = i18n.getText("batch.html.status_skipped");
-            } else {
-                statusText = result.status;
-            }
-            file << "                <td class='" << result.status << "'>" << statusText
-                 << "</td>\n";
-
-            file << "                <td>" << std::fixed << std::setprecision(3)
-                 << result.processingTime << "</td>\n";
-
-            if (result.status == "success") {
-                file << "                <td>" << result.testResults.data.size() << "</td>\n";
-                file << "                <td>"
-                     << (result.testResults.overallTrend ? i18n.getText("batch.html.trend_yes")
-                                                         : i18n.getText("batch.html.trend_no"))
-                     << "</td>\n";
-                file << "                <td>" << std::setprecision(6) << result.testResults.minPG
-                     << "</td>\n";
-                file << "                <td>" << result.testResults.maxPG << "</td>\n";
-                file << "                <td>" << result.testResults.avgPG << "</td>\n";
-                file << "                <td></td>\n";
-            } else {
-                file << "                <td>-</td>\n";
-                file << "                <td>-</td>\n";
-                file << "                <td>-</td>\n";
-                file << "                <td>-</td>\n";
-                file << "                <td>-</td>\n";
-                file << "                <td>" << result.errorMessage << "</td>\n";
-            }
-
-            file << "            </tr>\n";
         }
-
-        file << "        </tbody>\n";
-        file << "    </table>\n";
-        file << "</body>\n";
-        file << "</html>";
-
-        file.close();
-        return true;
+        return sink.end(generateStatistics(results));
     }
     catch (const std::exception&) {
         return false;
@@ -400,51 +948,24 @@ bool BatchProcessor::isSupportedFile(const std::string& filePath)
            supportedFormats.end();
 }
 
-std::vector<std::string> BatchProcessor::findSupportedFiles(const std::string& directoryPath)
+bool BatchProcessor::detectCSVHeader(const std::string& content)
 {
-    std::vector<std::string> supportedFiles;
-
-    try {
-        if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath)) {
-            return supportedFiles;
-        }
-
-        for (const auto& entry : fs::directory_iterator(directoryPath)) {
-            if (entry.is_regular_file() && isSupportedFile(entry.path().string())) {
-                supportedFiles.push_back(entry.path().string());
-            }
-        }
-
-        // 按文件名排序
-        std::sort(supportedFiles.begin(), supportedFiles.end());
-    }
-    catch (const std::exception&) {
-        // 出错时返回空列表
-    }
-
-    return supportedFiles;
-}
-
-bool BatchProcessor::detectCSVHeader(const std::string& filePath)
-{
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return false;  // 默认假设没有表头
-    }
-
-    std::string firstLine;
-    if (!std::getline(file, firstLine)) {
+    // 只查看第一行，不复制整个内容
+    std::string_view input(content);
+    std::string_view firstLine;
+    if (!DataManager::nextCSVToken(input, '\n', firstLine)) {
         return false;  // 空文件，没有表头
     }
 
     // 检查第一行是否包含数字
-    std::stringstream ss(firstLine);
+    std::string_view field;
     std::string cell;
     int numericCells = 0;
     int totalCells = 0;
 
-    while (std::getline(ss, cell, ',')) {
+    while (DataManager::nextCSVToken(firstLine, ',', field)) {
         totalCells++;
+        cell.assign(field.data(), field.size());
         // 尝试解析为数字
         try {
             std::stod(cell);
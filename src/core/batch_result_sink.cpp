@@ -0,0 +1,335 @@
+#include "core/batch_result_sink.h"
+
+#include <iomanip>
+#include <nlohmann/json.hpp>
+
+#include "core/data_manager.h"
+#include "core/i18n.h"
+
+using json = nlohmann::json;
+
+namespace neumann {
+
+namespace {
+
+const std::string &selectStatusText(const BatchProcessResult &result, const std::string &success,
+                                    const std::string &error, const std::string &skipped,
+                                    const std::string &timeout, const std::string &cancelled)
+{
+    if (result.status == "success") {
+        return success;
+    } else if (result.status == "error") {
+        return error;
+    } else if (result.status == "skipped") {
+        return skipped;
+    } else if (result.status == "timeout") {
+        return timeout;
+    } else if (result.status == "cancelled") {
+        return cancelled;
+    }
+    return result.status;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// FileResultSink
+// ---------------------------------------------------------------------------
+
+FileResultSink::FileResultSink(const std::string &outputPath) : outputPath(outputPath) {}
+
+bool FileResultSink::end(const BatchProcessStats &)
+{
+    if (!file.is_open()) {
+        return false;
+    }
+    file.close();
+    return !file.fail();
+}
+
+bool FileResultSink::open()
+{
+    file.open(outputPath, std::ios::binary | std::ios::trunc);
+    return file.is_open();
+}
+
+bool FileResultSink::flush()
+{
+    file.flush();
+    return file.good();
+}
+
+// ---------------------------------------------------------------------------
+// CsvResultSink
+// ---------------------------------------------------------------------------
+
+CsvResultSink::CsvResultSink(const std::string &outputPath) : FileResultSink(outputPath) {}
+
+bool CsvResultSink::begin()
+{
+    if (!open()) {
+        return false;
+    }
+
+    // 写入UTF-8 BOM，解决Excel中文乱码问题
+    const char utf8_bom[] = {static_cast<char>(0xEF), static_cast<char>(0xBB),
+                             static_cast<char>(0xBF)};
+    file.write(utf8_bom, 3);
+
+    // 获取国际化实例
+    auto &i18n = I18n::getInstance();
+    statusSuccess = i18n.getText("batch.csv.status_success");
+    statusError = i18n.getText("batch.csv.status_error");
+    statusSkipped = i18n.getText("batch.csv.status_skipped");
+    statusTimeout = i18n.getText("batch.csv.status_timeout");
+    statusCancelled = i18n.getText("batch.csv.status_cancelled");
+    trendYes = i18n.getText("batch.csv.trend_yes");
+    trendNo = i18n.getText("batch.csv.trend_no");
+
+    // CSV标题行 - 使用国际化文本
+    file << i18n.getText("batch.csv.filename") << "," << i18n.getText("batch.csv.status") << ","
+         << i18n.getText("batch.csv.processing_time") << ","
+         << i18n.getText("batch.csv.data_points") << ","
+         << i18n.getText("batch.csv.overall_trend") << "," << i18n.getText("batch.csv.min_pg")
+         << "," << i18n.getText("batch.csv.max_pg") << "," << i18n.getText("batch.csv.avg_pg")
+         << "," << i18n.getText("batch.csv.error_message") << "\n";
+
+    return flush();
+}
+
+bool CsvResultSink::write(size_t, const BatchProcessResult &result)
+{
+    file << result.filename << ",";
+
+    // 状态翻译
+    file << selectStatusText(result, statusSuccess, statusError, statusSkipped, statusTimeout,
+                             statusCancelled)
+         << ",";
+
+    file << std::fixed << std::setprecision(3) << result.processingTime << ",";
+
+    if (result.status == "success") {
+        file << result.dataPointCount << ",";
+        file << (result.testResults.overallTrend ? trendYes : trendNo) << ",";
+        file << std::setprecision(6) << result.testResults.minPG << ",";
+        file << result.testResults.maxPG << ",";
+        file << result.testResults.avgPG << ",";
+        file << "\n";
+    } else {
+        file << ",,,,," << result.errorMessage << "\n";
+    }
+
+    return flush();
+}
+
+// ---------------------------------------------------------------------------
+// HtmlResultSink
+// ---------------------------------------------------------------------------
+
+HtmlResultSink::HtmlResultSink(const std::string &outputPath) : FileResultSink(outputPath) {}
+
+bool HtmlResultSink::begin()
+{
+    if (!open()) {
+        return false;
+    }
+
+    // 获取国际化实例
+    auto &i18n = I18n::getInstance();
+    statusSuccess = i18n.getText("batch.html.status_success");
+    statusError = i18n.getText("batch.html.status_error");
+    statusSkipped = i18n.getText("batch.html.status_skipped");
+    statusTimeout = i18n.getText("batch.html.status_timeout");
+    statusCancelled = i18n.getText("batch.html.status_cancelled");
+    trendYes = i18n.getText("batch.html.trend_yes");
+    trendNo = i18n.getText("batch.html.trend_no");
+
+    // 根据当前语言设置HTML语言属性
+    std::string htmlLang = (i18n.getCurrentLanguage() == Language::CHINESE) ? "zh-CN" : "en-US";
+
+    // 生成HTML报告
+    file << "<!DOCTYPE html>\n";
+    file << "<html lang='" << htmlLang << "'>\n";
+    file << "<head>\n";
+    file << "    <meta charset='UTF-8'>\n";
+    file << "    <meta name='viewport' content='width=device-width, initial-scale=1.0'>\n";
+    file << "    <title>" << i18n.getText("batch.html.title") << "</title>\n";
+    file << "    <style>\n";
+    file << "        body { font-family: Arial, sans-serif; margin: 20px; display: flex; "
+            "flex-direction: column; }\n";
+    file << "        .header { background-color: #f0f8ff; padding: 20px; border-radius: 8px; "
+            "margin-bottom: 20px; order: 1; }\n";
+    file << "        .stats { display: flex; gap: 20px; margin-bottom: 20px; order: 2; }\n";
+    file << "        .details { order: 3; }\n";
+    file << "        .stat-card { background: #f9f9f9; padding: 15px; border-radius: 5px; "
+            "flex: 1; }\n";
+    file << "        table { width: 100%; border-collapse: collapse; }\n";
+    file << "        th, td { padding: 8px; text-align: left; border-bottom: 1px solid #ddd; "
+            "}\n";
+    file << "        th { background-color: #f2f2f2; }\n";
+    file << "        .success { color: green; }\n";
+    file << "        .error { color: red; }\n";
+    file << "        .skipped { color: orange; }\n";
+    file << "        .timeout { color: darkorange; }\n";
+    file << "        .cancelled { color: gray; }\n";
+    file << "        .trend-yes { background-color: #ffebee; }\n";
+    file << "        .trend-no { background-color: #e8f5e8; }\n";
+    file << "    </style>\n";
+    file << "</head>\n";
+    file << "<body>\n";
+
+    // 报告标题
+    file << "    <div class='header'>\n";
+    file << "        <h1>" << i18n.getText("batch.html.header_title") << "</h1>\n";
+    file << "        <p>" << i18n.getText("batch.html.generated_time") << ": "
+         << DataManager::currentTimestamp() << "</p>\n";
+    file << "    </div>\n";
+
+    // 详细结果表格
+    file << "    <div class='details'>\n";
+    file << "    <h2>" << i18n.getText("batch.html.detailed_results") << "</h2>\n";
+    file << "    <table>\n";
+    file << "        <thead>\n";
+    file << "            <tr>\n";
+    file << "                <th>" << i18n.getText("batch.html.filename") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.status") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.processing_time") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.data_points") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.overall_trend") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.min_pg") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.max_pg") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.avg_pg") << "</th>\n";
+    file << "                <th>" << i18n.getText("batch.html.error_message") << "</th>\n";
+    file << "            </tr>\n";
+    file << "        </thead>\n";
+    file << "        <tbody>\n";
+
+    return flush();
+}
+
+bool HtmlResultSink::write(size_t, const BatchProcessResult &result)
+{
+    std::string rowClass = "";
+    if (result.status == "success" && result.testResults.overallTrend) {
+        rowClass = "trend-yes";
+    } else if (result.status == "success") {
+        rowClass = "trend-no";
+    }
+
+    file << "            <tr class='" << rowClass << "'>\n";
+    file << "                <td>" << result.filename << "</td>\n";
+
+    // 状态翻译
+    file << "                <td class='" << result.status << "'>"
+         << selectStatusText(result, statusSuccess, statusError, statusSkipped, statusTimeout,
+                             statusCancelled)
+         << "</td>\n";
+
+    file << "                <td>" << std::fixed << std::setprecision(3) << result.processingTime
+         << "</td>\n";
+
+    if (result.status == "success") {
+        file << "                <td>" << result.dataPointCount << "</td>\n";
+        file << "                <td>" << (result.testResults.overallTrend ? trendYes : trendNo)
+             << "</td>\n";
+        file << "                <td>" << std::setprecision(6) << result.testResults.minPG
+             << "</td>\n";
+        file << "                <td>" << result.testResults.maxPG << "</td>\n";
+        file << "                <td>" << result.testResults.avgPG << "</td>\n";
+        file << "                <td></td>\n";
+    } else {
+        file << "                <td>-</td>\n";
+        file << "                <td>-</td>\n";
+        file << "                <td>-</td>\n";
+        file << "                <td>-</td>\n";
+        file << "                <td>-</td>\n";
+        file << "                <td>" << result.errorMessage << "</td>\n";
+    }
+
+    file << "            </tr>\n";
+    return flush();
+}
+
+bool HtmlResultSink::end(const BatchProcessStats &stats)
+{
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto &i18n = I18n::getInstance();
+
+    file << "        </tbody>\n";
+    file << "    </table>\n";
+    file << "    </div>\n";
+
+    // 统计信息（通过CSS显示在表格上方）
+    file << "    <div class='stats'>\n";
+    file << "        <div class='stat-card'>\n";
+    file << "            <h3>" << i18n.getText("batch.html.total_files") << "</h3>\n";
+    file << "            <h2>" << stats.totalFiles << "</h2>\n";
+    file << "        </div>\n";
+    file << "        <div class='stat-card'>\n";
+    file << "            <h3>" << i18n.getText("batch.html.successful_processing") << "</h3>\n";
+    file << "            <h2 class='success'>" << stats.successfulFiles << "</h2>\n";
+    file << "        </div>\n";
+    file << "        <div class='stat-card'>\n";
+    file << "            <h3>" << i18n.getText("batch.html.processing_errors") << "</h3>\n";
+    file << "            <h2 class='error'>" << stats.errorFiles << "</h2>\n";
+    file << "        </div>\n";
+    file << "        <div class='stat-card'>\n";
+    file << "            <h3>" << i18n.getText("batch.html.trends_found") << "</h3>\n";
+    file << "            <h2>" << stats.filesWithTrend << "</h2>\n";
+    file << "        </div>\n";
+    file << "        <div class='stat-card'>\n";
+    file << "            <h3>" << i18n.getText("batch.html.total_processing_time") << "</h3>\n";
+    file << "            <h2>" << std::fixed << std::setprecision(2) << stats.totalProcessingTime
+         << "s</h2>\n";
+    file << "        </div>\n";
+    file << "    </div>\n";
+
+    file << "</body>\n";
+    file << "</html>";
+
+    return FileResultSink::end(stats);
+}
+
+// ---------------------------------------------------------------------------
+// JsonLinesResultSink
+// ---------------------------------------------------------------------------
+
+JsonLinesResultSink::JsonLinesResultSink(const std::string &outputPath)
+    : FileResultSink(outputPath)
+{
+}
+
+bool JsonLinesResultSink::begin()
+{
+    return open();
+}
+
+bool JsonLinesResultSink::write(size_t index, const BatchProcessResult &result)
+{
+    json row;
+    row["index"] = index;
+    row["filename"] = result.filename;
+    row["status"] = result.status;
+    row["processingTime"] = result.processingTime;
+    if (result.status == "success") {
+        row["dataPoints"] = result.dataPointCount;
+        row["overallTrend"] = result.testResults.overallTrend;
+        row["minPG"] = result.testResults.minPG;
+        row["maxPG"] = result.testResults.maxPG;
+        row["avgPG"] = result.testResults.avgPG;
+    } else {
+        row["errorMessage"] = result.errorMessage;
+    }
+    if (result.reused) {
+        row["reused"] = true;
+    }
+
+    // 文件名可能含有非法UTF-8字节，替换而不是抛出异常
+    file << row.dump(-1, ' ', false, json::error_handler_t::replace) << "\n";
+    return flush();
+}
+
+}  // namespace neumann
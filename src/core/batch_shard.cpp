@@ -0,0 +1,780 @@
+#include "core/batch_processor.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+
+#include "core/config.h"
+#include "core/error_handler.h"
+#include "core/standard_values.h"
+
+extern char **environ;
+
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;  // 对端已退出时返回EPIPE而不是触发SIGPIPE
+#else
+const int kSendFlags = 0;
+#endif
+
+// 存在取消令牌或时间预算时，协调者至少以此间隔检查一次
+const int kStopCheckIntervalMs = 50;
+
+// 以工作进程模式启动的命令行参数
+const char kShardWorkerFlag[] = "--batch-shard-worker";
+
+// 工作进程中与协调者通信的套接字描述符
+const int kShardWorkerFd = 3;
+
+// 工作进程中的单个待处理文件
+struct ShardTask {
+    size_t index = 0;
+    std::string path;
+    int attempts = 0;             // 已导致工作进程崩溃的次数
+    double discoverMicros = 0.0;  // 文件发现耗时
+};
+
+// 协调者一侧的工作进程状态
+struct ShardWorker {
+    pid_t pid = -1;
+    int fd = -1;          // 与工作进程通信的套接字
+    bool busy = false;    // 是否有正在处理的文件
+    ShardTask task;       // 正在处理的文件
+    std::chrono::steady_clock::time_point dispatchTime;  // 分派当前文件的时间
+    std::string buffer;   // 尚未组成完整帧的已接收数据
+};
+
+// 结束所有工作进程：关闭套接字后工作进程读到EOF自行退出
+struct ShardWorkerPool {
+    std::vector<ShardWorker> workers;
+
+    ~ShardWorkerPool()
+    {
+        for (auto &worker : workers) {
+            if (worker.fd >= 0) {
+                close(worker.fd);
+            }
+        }
+        for (auto &worker : workers) {
+            if (worker.pid > 0) {
+                int status = 0;
+                while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+                }
+            }
+        }
+    }
+};
+
+// 创建与工作进程通信的套接字对，两端都设置close-on-exec，避免泄漏到其他子进程
+bool createSocketPair(int fds[2])
+{
+#ifdef SOCK_CLOEXEC
+    return socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0;
+#else
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+std::string currentExecutablePath()
+{
+#ifdef __APPLE__
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string path(size, '\0');
+    if (_NSGetExecutablePath(&path[0], &size) != 0) {
+        return "";
+    }
+    path.resize(std::strlen(path.c_str()));
+    return path;
+#else
+    std::error_code ec;
+    fs::path path = fs::read_symlink("/proc/self/exe", ec);
+    return ec ? std::string() : path.string();
+#endif
+}
+
+void disableSigpipe(int fd)
+{
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+    int enabled = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#else
+    (void)fd;
+#endif
+}
+
+bool writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = send(fd, data, size, kSendFlags);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readExact(int fd, char *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t count = read(fd, data, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// 帧格式：4字节长度（本机字节序，收发双方在同一主机）+ 内容
+bool writeFrame(int fd, const std::string &payload)
+{
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    return writeAll(fd, reinterpret_cast<const char *>(&length), sizeof(length)) &&
+           writeAll(fd, payload.data(), payload.size());
+}
+
+bool readFrame(int fd, std::string &payload)
+{
+    uint32_t length = 0;
+    if (!readExact(fd, reinterpret_cast<char *>(&length), sizeof(length))) {
+        return false;
+    }
+    payload.resize(length);
+    return length == 0 || readExact(fd, &payload[0], length);
+}
+
+// 从接收缓冲区中取出一个完整帧
+bool takeFrame(std::string &buffer, std::string &payload)
+{
+    uint32_t length = 0;
+    if (buffer.size() < sizeof(length)) {
+        return false;
+    }
+    std::memcpy(&length, buffer.data(), sizeof(length));
+    if (buffer.size() < sizeof(length) + length) {
+        return false;
+    }
+    payload.assign(buffer, sizeof(length), length);
+    buffer.erase(0, sizeof(length) + length);
+    return true;
+}
+
+// 结果按原始字节序列化，保证浮点数（包括NaN和无穷大）与进程内处理完全一致
+class ResultWriter
+{
+public:
+    template <typename T>
+    void put(const T &value)
+    {
+        data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void putString(const std::string &value)
+    {
+        put(static_cast<uint64_t>(value.size()));
+        data.append(value);
+    }
+
+    void putDoubles(const std::vector<double> &values)
+    {
+        put(static_cast<uint64_t>(values.size()));
+        data.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(double));
+    }
+
+    std::string data;
+};
+
+class ResultReader
+{
+public:
+    explicit ResultReader(const std::string &data) : data(data), position(0) {}
+
+    template <typename T>
+    T get()
+    {
+        T value;
+        require(sizeof(T));
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    std::string getString()
+    {
+        size_t size = static_cast<size_t>(get<uint64_t>());
+        require(size);
+        std::string value = data.substr(position, size);
+        position += size;
+        return value;
+    }
+
+    std::vector<double> getDoubles()
+    {
+        size_t count = static_cast<size_t>(get<uint64_t>());
+        require(count * sizeof(double));
+        std::vector<double> values(count);
+        std::memcpy(values.data(), data.data() + position, count * sizeof(double));
+        position += count * sizeof(double);
+        return values;
+    }
+
+private:
+    void require(size_t size) const
+    {
+        if (size > data.size() - position) {
+            throw std::runtime_error("Truncated worker result");
+        }
+    }
+
+    const std::string &data;
+    size_t position;
+};
+
+std::string encodeResult(const BatchProcessResult &result)
+{
+    ResultWriter writer;
+    writer.putString(result.filename);
+    writer.putString(result.status);
+    writer.putString(result.errorMessage);
+    writer.put(result.processingTime);
+    writer.put(static_cast<uint64_t>(result.dataPointCount));
+    writer.put(result.timings);
+
+    const NeumannTestResults &test = result.testResults;
+    writer.putDoubles(test.data);
+    writer.putDoubles(test.timePoints);
+    writer.put(static_cast<uint64_t>(test.results.size()));
+    for (const auto &point : test.results) {
+        writer.put(point.pgValue);
+        writer.put(static_cast<uint8_t>(point.hasTrend));
+        writer.put(point.confidenceLevel);
+        writer.put(point.wpThreshold);
+    }
+    writer.put(static_cast<uint8_t>(test.overallTrend));
+    writer.put(test.minPG);
+    writer.put(test.maxPG);
+    writer.put(test.avgPG);
+    return writer.data;
+}
+
+BatchProcessResult decodeResult(const std::string &data)
+{
+    ResultReader reader(data);
+    BatchProcessResult result;
+    result.filename = reader.getString();
+    result.status = reader.getString();
+    result.errorMessage = reader.getString();
+    result.processingTime = reader.get<double>();
+    result.dataPointCount = static_cast<size_t>(reader.get<uint64_t>());
+    result.timings = reader.get<BatchStageTimings>();
+
+    NeumannTestResults &test = result.testResults;
+    test.data = reader.getDoubles();
+    test.timePoints = reader.getDoubles();
+    size_t pointCount = static_cast<size_t>(reader.get<uint64_t>());
+    for (size_t i = 0; i < pointCount; ++i) {
+        NeumannResult point;
+        point.pgValue = reader.get<double>();
+        point.hasTrend = reader.get<uint8_t>() != 0;
+        point.confidenceLevel = reader.get<double>();
+        point.wpThreshold = reader.get<double>();
+        test.results.push_back(point);
+    }
+    test.overallTrend = reader.get<uint8_t>() != 0;
+    test.minPG = reader.get<double>();
+    test.maxPG = reader.get<double>();
+    test.avgPG = reader.get<double>();
+    return result;
+}
+
+BatchProcessResult makeStatusResult(const std::string &filePath, const std::string &status,
+                                    const std::string &message)
+{
+    BatchProcessResult result;
+    result.filename = fs::path(filePath).filename().string();
+    result.status = status;
+    result.errorMessage = message;
+    result.processingTime = 0.0;
+    return result;
+}
+
+BatchProcessResult makeErrorResult(const std::string &filePath, const std::string &message)
+{
+    return makeStatusResult(filePath, "error", message);
+}
+
+// 整批停止时未完成文件的结果
+BatchProcessResult makeStoppedResult(const std::string &filePath, CancellationToken::State state)
+{
+    if (state == CancellationToken::State::TIMED_OUT) {
+        return makeStatusResult(filePath, "timeout", "Batch deadline exceeded");
+    }
+    return makeStatusResult(filePath, "cancelled", "Batch processing cancelled");
+}
+
+// 工作进程的初始配置：与协调者一致的处理参数、数据目录和W(P)标准值表
+std::string encodeWorkerSetup(double confidenceLevel, const BatchPipelineOptions &options)
+{
+    ResultWriter writer;
+    writer.put(confidenceLevel);
+    writer.put(static_cast<uint64_t>(options.readChunkSize));
+    writer.put(static_cast<int64_t>(options.fileTimeBudget.count()));
+    writer.putString(Config::getInstance().getDataDirectory());
+
+    auto wpValues = StandardValues::getInstance().getAllWPValues();
+    writer.put(static_cast<uint64_t>(wpValues.size()));
+    for (const auto &level : wpValues) {
+        writer.put(level.first);
+        writer.put(static_cast<uint64_t>(level.second.size()));
+        for (const auto &entry : level.second) {
+            writer.put(static_cast<int32_t>(entry.first));
+            writer.put(entry.second);
+        }
+    }
+    return writer.data;
+}
+
+void applyWorkerSetup(const std::string &data, BatchProcessor &processor)
+{
+    ResultReader reader(data);
+    processor.setConfidenceLevel(reader.get<double>());
+    BatchPipelineOptions options;
+    options.readChunkSize = static_cast<size_t>(reader.get<uint64_t>());
+    options.fileTimeBudget = std::chrono::milliseconds(reader.get<int64_t>());
+    processor.setPipelineOptions(options);
+    Config::getInstance().setDataDirectory(reader.getString());
+
+    std::map<double, std::map<int, double>> wpValues;
+    size_t levelCount = static_cast<size_t>(reader.get<uint64_t>());
+    for (size_t i = 0; i < levelCount; ++i) {
+        auto &values = wpValues[reader.get<double>()];
+        size_t valueCount = static_cast<size_t>(reader.get<uint64_t>());
+        for (size_t j = 0; j < valueCount; ++j) {
+            int sampleSize = reader.get<int32_t>();
+            values[sampleSize] = reader.get<double>();
+        }
+    }
+    StandardValues::getInstance().setAllWPValues(wpValues);
+}
+
+// 工作进程主循环：接收初始配置后逐个处理文件，协调者关闭套接字时退出
+int runShardWorker(int fd)
+{
+    disableSigpipe(fd);
+
+    std::string setup;
+    if (!readFrame(fd, setup)) {
+        return 1;
+    }
+    BatchProcessor processor;
+    try {
+        applyWorkerSetup(setup, processor);
+    }
+    catch (const std::exception &) {
+        return 1;
+    }
+
+    std::string filePath;
+    while (readFrame(fd, filePath)) {
+        BatchProcessResult result;
+        try {
+            result = processor.processSingleFile(filePath);
+        }
+        catch (const std::exception &e) {
+            result = makeErrorResult(filePath, e.what());
+        }
+        if (!writeFrame(fd, encodeResult(result))) {
+            break;
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+void BatchProcessor::runSharded(const FileSource &nextFile, int expectedTotal,
+                                const ResultHandler &onResult, ProgressCallback progressCallback)
+{
+    int workerCount = pipelineOptions.workerProcesses;
+    int maxAttempts = std::max(1, pipelineOptions.maxWorkerAttempts);
+    auto fileBudget = pipelineOptions.fileTimeBudget;
+
+    std::string executable = pipelineOptions.workerExecutable.empty()
+                                 ? currentExecutablePath()
+                                 : pipelineOptions.workerExecutable;
+    if (executable.empty()) {
+        THROW_ERROR(ErrorCode::SYSTEM_ERROR, "Failed to locate the batch worker executable");
+    }
+    std::string setup = encodeWorkerSetup(confidenceLevel, pipelineOptions);
+
+    ShardWorkerPool pool;
+    pool.workers.resize(static_cast<size_t>(workerCount));
+
+    // 启动（或重启）一个工作进程，工作进程逐个接收文件路径并返回处理结果。
+    // 以posix_spawn重新执行程序而不是fork：fork出的子进程只有调用线程，
+    // 其他线程持有的锁（内存分配器、缓存、日志等）永远不会释放，子进程可能死锁。
+    auto spawnWorker = [&](ShardWorker &worker) {
+        int fds[2];
+        if (!createSocketPair(fds)) {
+            return false;
+        }
+        // dup2到相同描述符时不会清除close-on-exec，先把子进程一端移开
+        if (fds[1] == kShardWorkerFd) {
+            int moved = fcntl(fds[1], F_DUPFD_CLOEXEC, kShardWorkerFd + 1);
+            close(fds[1]);
+            if (moved < 0) {
+                close(fds[0]);
+                return false;
+            }
+            fds[1] = moved;
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], kShardWorkerFd);
+        char *arguments[] = {const_cast<char *>(executable.c_str()),
+                             const_cast<char *>(kShardWorkerFlag), nullptr};
+        pid_t pid = -1;
+        int error = posix_spawn(&pid, executable.c_str(), &actions, nullptr, arguments, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[1]);
+        if (error != 0) {
+            close(fds[0]);
+            return false;
+        }
+
+        disableSigpipe(fds[0]);
+        if (!writeFrame(fds[0], setup)) {
+            close(fds[0]);
+            kill(pid, SIGKILL);
+            int status = 0;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            return false;
+        }
+        worker.pid = pid;
+        worker.fd = fds[0];
+        worker.busy = false;
+        worker.buffer.clear();
+        return true;
+    };
+
+    int runningWorkers = 0;
+    for (auto &worker : pool.workers) {
+        if (spawnWorker(worker)) {
+            runningWorkers++;
+        }
+    }
+    if (runningWorkers == 0) {
+        THROW_ERROR(ErrorCode::SYSTEM_ERROR, "Failed to start batch worker processes");
+    }
+
+    std::deque<ShardTask> pending;  // 需要重新分派的文件（工作进程崩溃时）
+    bool sourceDone = false;
+    size_t nextIndex = 0;
+    int completed = 0;
+    auto currentTotal = [&]() {
+        return expectedTotal >= 0 ? expectedTotal : static_cast<int>(nextIndex);
+    };
+
+    auto pullTask = [&](ShardTask &task) {
+        if (!pending.empty()) {
+            task = std::move(pending.front());
+            pending.pop_front();
+            return true;
+        }
+        if (sourceDone) {
+            return false;
+        }
+
+        std::string filePath;
+        bool hasFile = false;
+        auto startTime = std::chrono::steady_clock::now();
+        try {
+            hasFile = nextFile(filePath);
+        }
+        catch (const std::exception &) {
+            // 文件发现出错时停止分派，已分派的文件继续处理
+        }
+        if (!hasFile) {
+            sourceDone = true;
+            return false;
+        }
+
+        std::chrono::duration<double, std::micro> elapsed =
+            std::chrono::steady_clock::now() - startTime;
+
+        task = ShardTask();
+        task.index = nextIndex++;
+        task.path = std::move(filePath);
+        task.discoverMicros = elapsed.count();
+        return true;
+    };
+
+    auto deliver = [&](const ShardTask &task, BatchProcessResult &result) {
+        result.timings.discoverMicros = task.discoverMicros;
+        onResult(task.index, result);
+        completed++;
+        if (progressCallback) {
+            progressCallback(completed, currentTotal(), task.path);
+        }
+    };
+
+    auto reapWorker = [](ShardWorker &worker) {
+        close(worker.fd);
+        worker.fd = -1;
+
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        worker.pid = -1;
+        return status;
+    };
+
+    // 强制结束正在处理文件的工作进程，文件以给定结果交付（不再重试）
+    auto killWorker = [&](ShardWorker &worker, BatchProcessResult result, bool respawn) {
+        kill(worker.pid, SIGKILL);
+        reapWorker(worker);
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - worker.dispatchTime;
+        result.processingTime = elapsed.count();
+        worker.busy = false;
+        deliver(worker.task, result);
+
+        if (!respawn || !spawnWorker(worker)) {
+            runningWorkers--;
+        }
+    };
+
+    // 工作进程退出或通信失败：回收进程，正在处理的文件重新排队或记为错误，然后重启
+    auto handleWorkerExit = [&](ShardWorker &worker) {
+        int status = reapWorker(worker);
+
+        if (worker.busy) {
+            worker.busy = false;
+            ShardTask task = std::move(worker.task);
+            task.attempts++;
+            if (task.attempts >= maxAttempts) {
+                std::string message = "Worker process crashed while processing file";
+                if (WIFSIGNALED(status)) {
+                    message += " (signal " + std::to_string(WTERMSIG(status)) + ")";
+                }
+                BatchProcessResult result = makeErrorResult(task.path, message);
+                deliver(task, result);
+            } else {
+                pending.push_front(std::move(task));
+            }
+        }
+
+        if (!spawnWorker(worker)) {
+            runningWorkers--;
+        }
+    };
+
+    std::vector<pollfd> pollFds;
+    std::vector<ShardWorker *> polledWorkers;
+    std::vector<char> readBuffer(64 * 1024);
+
+    while (true) {
+        // 整批取消或超过截止时间：结束正在处理的文件，文件列表的剩余文件记为同样的状态
+        CancellationToken::State runState = cancellationToken.getState();
+        if (runState != CancellationToken::State::ACTIVE) {
+            for (auto &worker : pool.workers) {
+                if (worker.fd >= 0 && worker.busy) {
+                    killWorker(worker, makeStoppedResult(worker.task.path, runState), false);
+                }
+            }
+            if (expectedTotal < 0) {
+                sourceDone = true;
+            }
+            ShardTask task;
+            while (pullTask(task)) {
+                BatchProcessResult result = makeStoppedResult(task.path, runState);
+                deliver(task, result);
+            }
+            break;
+        }
+
+        // 超出单文件时间预算的工作进程直接结束，避免卡死的解析占用工作进程
+        auto now = std::chrono::steady_clock::now();
+        if (fileBudget.count() > 0) {
+            for (auto &worker : pool.workers) {
+                if (worker.fd >= 0 && worker.busy && now - worker.dispatchTime >= fileBudget) {
+                    killWorker(worker,
+                               makeStatusResult(worker.task.path, "timeout",
+                                                "File time budget exceeded"),
+                               true);
+                }
+            }
+        }
+
+        // 给空闲的工作进程分派文件
+        for (auto &worker : pool.workers) {
+            if (worker.fd < 0 || worker.busy) {
+                continue;
+            }
+            ShardTask task;
+            if (!pullTask(task)) {
+                break;
+            }
+            worker.task = std::move(task);
+            worker.busy = true;
+            worker.dispatchTime = std::chrono::steady_clock::now();
+            if (!writeFrame(worker.fd, worker.task.path)) {
+                handleWorkerExit(worker);
+            }
+        }
+
+        pollFds.clear();
+        polledWorkers.clear();
+        for (auto &worker : pool.workers) {
+            if (worker.fd >= 0 && worker.busy) {
+                pollFds.push_back({worker.fd, POLLIN, 0});
+                polledWorkers.push_back(&worker);
+            }
+        }
+
+        if (pollFds.empty()) {
+            if (runningWorkers > 0) {
+                if (pending.empty() && sourceDone) {
+                    break;  // 所有文件都已完成
+                }
+                // 分派时写入失败的文件已重新排队，工作进程也已重启，下一轮重新分派
+                continue;
+            }
+
+            // 无法再启动工作进程，剩余文件全部记为错误
+            ShardTask task;
+            while (pullTask(task)) {
+                BatchProcessResult result =
+                    makeErrorResult(task.path, "Failed to start batch worker process");
+                deliver(task, result);
+            }
+            break;
+        }
+
+        // 周期性唤醒以检查取消令牌和时间预算
+        int timeoutMs = kStopCheckIntervalMs;
+        if (fileBudget.count() > 0) {
+            auto earliest = fileBudget;
+            now = std::chrono::steady_clock::now();
+            for (const ShardWorker *worker : polledWorkers) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    worker->dispatchTime + fileBudget - now);
+                earliest = std::min(earliest, remaining);
+            }
+            timeoutMs = static_cast<int>(std::max<std::chrono::milliseconds::rep>(
+                0, std::min<std::chrono::milliseconds::rep>(earliest.count(), timeoutMs)));
+        }
+
+        int ready = poll(pollFds.data(), static_cast<nfds_t>(pollFds.size()), timeoutMs);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            THROW_ERROR(ErrorCode::SYSTEM_ERROR, std::string("poll failed: ") + strerror(errno));
+        }
+
+        for (size_t i = 0; i < pollFds.size(); ++i) {
+            if (pollFds[i].revents == 0) {
+                continue;
+            }
+
+            ShardWorker &worker = *polledWorkers[i];
+            ssize_t count = read(worker.fd, readBuffer.data(), readBuffer.size());
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                handleWorkerExit(worker);
+                continue;
+            }
+
+            worker.buffer.append(readBuffer.data(), static_cast<size_t>(count));
+            std::string payload;
+            if (takeFrame(worker.buffer, payload)) {
+                BatchProcessResult result;
+                try {
+                    result = decodeResult(payload);
+                }
+                catch (const std::exception &e) {
+                    result = makeErrorResult(worker.task.path, e.what());
+                }
+                worker.busy = false;
+                deliver(worker.task, result);
+            }
+        }
+    }
+
+    // 最终进度回调
+    if (progressCallback) {
+        int total = currentTotal();
+        progressCallback(total, total, "Complete");
+    }
+}
+
+bool BatchProcessor::runShardWorkerIfRequested(int argc, char *argv[], int &exitCode)
+{
+    if (argc < 2 || std::strcmp(argv[1], kShardWorkerFlag) != 0) {
+        return false;
+    }
+    exitCode = runShardWorker(kShardWorkerFd);
+    return true;
+}
+
+}  // namespace neumann
+
+#else
+
+namespace neumann {
+
+bool BatchProcessor::runShardWorkerIfRequested(int, char *[], int &)
+{
+    return false;  // 多进程模式仅支持POSIX系统
+}
+
+}  // namespace neumann
+
+#endif  // _WIN32
@@ -0,0 +1,524 @@
+#include "core/biff_reader.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace neumann {
+
+namespace {
+
+const size_t kRecordHeaderSize = 4;
+
+// 记录类型
+const uint16_t kBof = 0x0809;
+const uint16_t kEof = 0x000A;
+const uint16_t kContinue = 0x003C;
+const uint16_t kFilePass = 0x002F;
+const uint16_t kBoundSheet = 0x0085;
+const uint16_t kSst = 0x00FC;
+const uint16_t kNumber = 0x0203;
+const uint16_t kRk = 0x027E;
+const uint16_t kMulRk = 0x00BD;
+const uint16_t kLabelSst = 0x00FD;
+const uint16_t kLabel = 0x0204;
+const uint16_t kRString = 0x00D6;
+const uint16_t kBoolErr = 0x0205;
+const uint16_t kFormula = 0x0006;
+const uint16_t kString = 0x0207;
+
+const uint16_t kBiff8Version = 0x0600;
+
+uint16_t readU16(std::string_view data, size_t offset)
+{
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data.data() + offset);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t readU32(std::string_view data, size_t offset)
+{
+    return static_cast<uint32_t>(readU16(data, offset)) |
+           (static_cast<uint32_t>(readU16(data, offset + 2)) << 16);
+}
+
+double readDouble(std::string_view data, size_t offset)
+{
+    uint64_t bits = static_cast<uint64_t>(readU32(data, offset)) |
+                    (static_cast<uint64_t>(readU32(data, offset + 4)) << 32);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+[[noreturn]] void invalidWorkbook(const std::string &message)
+{
+    throw std::runtime_error("Invalid BIFF workbook: " + message);
+}
+
+void requireSize(std::string_view data, size_t size, const char *record)
+{
+    if (data.size() < size) {
+        invalidWorkbook(std::string("truncated ") + record + " record");
+    }
+}
+
+// RK编码的数值：最低两位分别表示除以100和30位整数
+double decodeRk(uint32_t rk)
+{
+    double value;
+    if (rk & 0x02) {
+        value = static_cast<double>(static_cast<int32_t>(rk) >> 2);
+    } else {
+        uint64_t bits = static_cast<uint64_t>(rk & 0xFFFFFFFCu) << 32;
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    return (rk & 0x01) ? value / 100.0 : value;
+}
+
+void appendUtf8(uint32_t codePoint, std::string &out)
+{
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+// 字符串按UTF-16存放（压缩形式省略了全为0的高字节），转换为UTF-8
+class Utf16Decoder
+{
+public:
+    explicit Utf16Decoder(std::string &out) : out(out) {}
+
+    void put(uint16_t unit)
+    {
+        if (highSurrogate != 0 && unit >= 0xDC00 && unit <= 0xDFFF) {
+            appendUtf8(0x10000 + ((highSurrogate - 0xD800) << 10) + (unit - 0xDC00), out);
+            highSurrogate = 0;
+            return;
+        }
+        flush();
+        if (unit >= 0xD800 && unit <= 0xDBFF) {
+            highSurrogate = unit;
+        } else {
+            appendUtf8(unit, out);
+        }
+    }
+
+    // 不成对的代理项替换为U+FFFD
+    void flush()
+    {
+        if (highSurrogate != 0) {
+            appendUtf8(0xFFFD, out);
+            highSurrogate = 0;
+        }
+    }
+
+private:
+    std::string &out;
+    uint32_t highSurrogate = 0;
+};
+
+// 读取记录内的XLUnicodeString（cch为16位）或ShortXLUnicodeString（cch为8位）
+std::string readUnicodeString(std::string_view data, size_t offset, bool shortLength)
+{
+    size_t headerSize = shortLength ? 2 : 3;
+    if (offset + headerSize > data.size()) {
+        invalidWorkbook("truncated string");
+    }
+    size_t count = shortLength ? static_cast<unsigned char>(data[offset]) : readU16(data, offset);
+    bool highByte = data[offset + headerSize - 1] & 0x01;
+    size_t pos = offset + headerSize;
+
+    std::string text;
+    Utf16Decoder decoder(text);
+    size_t charSize = highByte ? 2 : 1;
+    for (size_t i = 0; i < count && pos + charSize <= data.size(); ++i, pos += charSize) {
+        decoder.put(highByte ? readU16(data, pos) : static_cast<unsigned char>(data[pos]));
+    }
+    decoder.flush();
+    return text;
+}
+
+/**
+ * @brief 由一条记录及其后续CONTINUE记录组成的数据，按字节顺序读取
+ *
+ * 字符串的字符跨越记录边界时，新记录以一个选项字节开头，重新指定字符宽度。
+ */
+class ContinuedRecord
+{
+public:
+    explicit ContinuedRecord(std::vector<std::string_view> segments)
+        : segments(std::move(segments))
+    {
+    }
+
+    uint8_t readU8()
+    {
+        ensureAvailable();
+        return static_cast<uint8_t>(segments[segment][offset++]);
+    }
+
+    uint16_t readU16()
+    {
+        uint16_t low = readU8();
+        return static_cast<uint16_t>(low | (readU8() << 8));
+    }
+
+    uint32_t readU32()
+    {
+        uint32_t low = readU16();
+        return low | (static_cast<uint32_t>(readU16()) << 16);
+    }
+
+    void skip(size_t count)
+    {
+        while (count > 0) {
+            ensureAvailable();
+            size_t step = std::min(count, segments[segment].size() - offset);
+            offset += step;
+            count -= step;
+        }
+    }
+
+    void readChars(size_t count, bool highByte, std::string &out)
+    {
+        Utf16Decoder decoder(out);
+        while (count > 0) {
+            if (offset == segments[segment].size()) {
+                nextSegment();
+                highByte = readU8() & 0x01;
+            }
+            size_t charSize = highByte ? 2 : 1;
+            size_t available = (segments[segment].size() - offset) / charSize;
+            if (available == 0) {
+                invalidWorkbook("string split inside a character");
+            }
+            size_t step = std::min(count, available);
+            std::string_view data = segments[segment];
+            for (size_t i = 0; i < step; ++i, offset += charSize) {
+                decoder.put(highByte ? neumann::readU16(data, offset)
+                                     : static_cast<unsigned char>(data[offset]));
+            }
+            count -= step;
+        }
+        decoder.flush();
+    }
+
+private:
+    void ensureAvailable()
+    {
+        while (offset == segments[segment].size()) {
+            nextSegment();
+        }
+    }
+
+    void nextSegment()
+    {
+        if (segment + 1 >= segments.size()) {
+            invalidWorkbook("truncated SST record");
+        }
+        segment++;
+        offset = 0;
+    }
+
+    std::vector<std::string_view> segments;
+    size_t segment = 0;
+    size_t offset = 0;
+};
+
+std::vector<std::string> readSharedStringTable(ContinuedRecord record)
+{
+    record.readU32();  // 字符串引用总数
+    uint32_t uniqueCount = record.readU32();
+
+    std::vector<std::string> strings;
+    strings.reserve(std::min<uint32_t>(uniqueCount, 1u << 20));
+    for (uint32_t i = 0; i < uniqueCount; ++i) {
+        uint16_t count = record.readU16();
+        uint8_t flags = record.readU8();
+        uint16_t runCount = (flags & 0x08) ? record.readU16() : 0;
+        uint32_t extSize = (flags & 0x04) ? record.readU32() : 0;
+
+        std::string text;
+        record.readChars(count, flags & 0x01, text);
+        // 跳过富文本格式和东亚语言扩展信息
+        record.skip(static_cast<size_t>(runCount) * 4 + extSize);
+        strings.push_back(std::move(text));
+    }
+    return strings;
+}
+
+// 检查BOF记录：只支持BIFF8
+void checkBof(const BiffRecordReader &reader)
+{
+    if (reader.type() != kBof) {
+        invalidWorkbook("missing BOF record");
+    }
+    requireSize(reader.data(), 4, "BOF");
+    if (readU16(reader.data(), 0) != kBiff8Version) {
+        throw std::runtime_error(
+            "Only BIFF8 (Excel 97-2003) .xls workbooks are supported; please save as .xlsx");
+    }
+}
+
+// 数值格式化为能够精确还原的最短文本
+std::string_view formatNumber(double value, char (&buffer)[32])
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+#else
+    int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return std::string_view(buffer, static_cast<size_t>(length));
+#endif
+}
+
+const char *errorText(uint8_t code)
+{
+    switch (code) {
+        case 0x00:
+            return "#NULL!";
+        case 0x07:
+            return "#DIV/0!";
+        case 0x0F:
+            return "#VALUE!";
+        case 0x17:
+            return "#REF!";
+        case 0x1D:
+            return "#NAME?";
+        case 0x24:
+            return "#NUM!";
+        default:
+            return "#N/A";
+    }
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// BiffRecordReader
+// ---------------------------------------------------------------------------
+
+BiffRecordReader::BiffRecordReader(std::string_view stream, size_t offset)
+    : stream(stream), position(offset)
+{
+}
+
+bool BiffRecordReader::next()
+{
+    if (position + kRecordHeaderSize > stream.size()) {
+        return false;
+    }
+    recordType = readU16(stream, position);
+    size_t length = readU16(stream, position + 2);
+    if (position + kRecordHeaderSize + length > stream.size()) {
+        invalidWorkbook("truncated record");
+    }
+    recordData = stream.substr(position + kRecordHeaderSize, length);
+    position += kRecordHeaderSize + length;
+    return true;
+}
+
+uint16_t BiffRecordReader::peekType() const
+{
+    if (position + kRecordHeaderSize > stream.size()) {
+        return 0;
+    }
+    return readU16(stream, position);
+}
+
+// ---------------------------------------------------------------------------
+// 工作簿和工作表
+// ---------------------------------------------------------------------------
+
+BiffWorkbookInfo readBiffWorkbook(std::string_view stream)
+{
+    BiffWorkbookInfo info;
+
+    BiffRecordReader reader(stream);
+    if (!reader.next()) {
+        invalidWorkbook("empty Workbook stream");
+    }
+    checkBof(reader);
+
+    while (reader.next() && reader.type() != kEof) {
+        std::string_view data = reader.data();
+        switch (reader.type()) {
+            case kFilePass:
+                throw std::runtime_error("Encrypted .xls workbooks are not supported");
+            case kBoundSheet: {
+                requireSize(data, 8, "BOUNDSHEET");
+                // 类型0为工作表，图表和宏表没有单元格数据
+                if (static_cast<uint8_t>(data[5]) == 0) {
+                    info.sheets.push_back({readUnicodeString(data, 6, true), readU32(data, 0)});
+                }
+                break;
+            }
+            case kSst: {
+                std::vector<std::string_view> segments{data};
+                while (reader.peekType() == kContinue) {
+                    reader.next();
+                    segments.push_back(reader.data());
+                }
+                info.sharedStrings = readSharedStringTable(ContinuedRecord(std::move(segments)));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return info;
+}
+
+bool readBiffSheet(std::string_view stream, uint32_t offset,
+                   const std::function<bool(const CellEvent &)> &onCell,
+                   const std::function<bool(uint32_t row)> &onRowEnd)
+{
+    BiffRecordReader reader(stream, offset);
+    if (!reader.next()) {
+        invalidWorkbook("worksheet offset out of range");
+    }
+    checkBof(reader);
+
+    int64_t currentRow = -1;
+    char numberBuffer[32];
+    std::string text;
+    CellEvent cell;
+    // 公式的字符串结果在随后的STRING记录中
+    bool pendingFormulaString = false;
+    uint16_t formulaRow = 0;
+    uint16_t formulaColumn = 0;
+
+    // 产生单元格事件，行号变化时先结束上一行
+    auto emit = [&](uint16_t row, uint16_t column, CellType type, std::string_view value) {
+        if (currentRow >= 0 && row != currentRow &&
+            !onRowEnd(static_cast<uint32_t>(currentRow) + 1)) {
+            return false;
+        }
+        currentRow = row;
+        cell.row = static_cast<uint32_t>(row) + 1;
+        cell.column = column;
+        cell.type = type;
+        cell.value = value;
+        return onCell(cell);
+    };
+    auto emitNumber = [&](uint16_t row, uint16_t column, double value) {
+        return emit(row, column, CellType::NUMBER, formatNumber(value, numberBuffer));
+    };
+
+    int depth = 0;  // 嵌入的图表等子流
+    while (reader.next()) {
+        std::string_view data = reader.data();
+        uint16_t type = reader.type();
+
+        if (type == kBof) {
+            depth++;
+            continue;
+        }
+        if (type == kEof) {
+            if (depth-- > 0) {
+                continue;
+            }
+            break;
+        }
+        if (depth > 0) {
+            continue;
+        }
+
+        bool keepGoing = true;
+        switch (type) {
+            case kNumber:
+                requireSize(data, 14, "NUMBER");
+                keepGoing = emitNumber(readU16(data, 0), readU16(data, 2), readDouble(data, 6));
+                break;
+            case kRk:
+                requireSize(data, 10, "RK");
+                keepGoing =
+                    emitNumber(readU16(data, 0), readU16(data, 2), decodeRk(readU32(data, 6)));
+                break;
+            case kMulRk: {
+                requireSize(data, 6, "MULRK");
+                uint16_t row = readU16(data, 0);
+                uint16_t column = readU16(data, 2);
+                // 每个单元格6字节（格式索引和RK值），最后2字节为末列号
+                for (size_t pos = 4; pos + 6 + 2 <= data.size() && keepGoing; pos += 6, ++column) {
+                    keepGoing = emitNumber(row, column, decodeRk(readU32(data, pos + 2)));
+                }
+                break;
+            }
+            case kLabelSst: {
+                requireSize(data, 10, "LABELSST");
+                text = std::to_string(readU32(data, 6));
+                keepGoing = emit(readU16(data, 0), readU16(data, 2), CellType::SHARED_STRING, text);
+                break;
+            }
+            case kLabel:
+            case kRString:
+                requireSize(data, 9, "LABEL");
+                text = readUnicodeString(data, 6, false);
+                keepGoing = emit(readU16(data, 0), readU16(data, 2), CellType::INLINE_STRING, text);
+                break;
+            case kBoolErr: {
+                requireSize(data, 8, "BOOLERR");
+                uint8_t value = static_cast<uint8_t>(data[6]);
+                bool isError = data[7] != 0;
+                keepGoing = emit(readU16(data, 0), readU16(data, 2),
+                                 isError ? CellType::ERROR : CellType::BOOLEAN,
+                                 isError ? errorText(value) : (value ? "1" : "0"));
+                break;
+            }
+            case kFormula: {
+                requireSize(data, 14, "FORMULA");
+                uint16_t row = readU16(data, 0);
+                uint16_t column = readU16(data, 2);
+                // 结果的最高两个字节为0xFFFF时不是数值，第一个字节表示结果类型
+                if (readU16(data, 12) != 0xFFFF) {
+                    keepGoing = emitNumber(row, column, readDouble(data, 6));
+                } else if (data[6] == 0) {
+                    formulaRow = row;
+                    formulaColumn = column;
+                    pendingFormulaString = true;
+                } else if (data[6] == 1) {
+                    keepGoing = emit(row, column, CellType::BOOLEAN, data[8] ? "1" : "0");
+                } else if (data[6] == 2) {
+                    const char *error = errorText(static_cast<uint8_t>(data[8]));
+                    keepGoing = emit(row, column, CellType::ERROR, error);
+                }
+                break;
+            }
+            case kString:
+                if (pendingFormulaString) {
+                    pendingFormulaString = false;
+                    text = readUnicodeString(data, 0, false);
+                    keepGoing = emit(formulaRow, formulaColumn, CellType::FORMULA_STRING, text);
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (!keepGoing) {
+            return false;
+        }
+    }
+
+    if (currentRow >= 0) {
+        return onRowEnd(static_cast<uint32_t>(currentRow) + 1);
+    }
+    return true;
+}
+
+}  // namespace neumann
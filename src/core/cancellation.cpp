@@ -0,0 +1,83 @@
+#include "core/cancellation.h"
+
+#include <string>
+
+#include "core/error_handler.h"
+
+namespace neumann {
+
+CancellationToken::CancellationToken() : state(std::make_shared<SharedState>()) {}
+
+CancellationToken::CancellationToken(std::shared_ptr<SharedState> state) : state(std::move(state))
+{
+}
+
+void CancellationToken::cancel() const
+{
+    state->cancelled.store(true, std::memory_order_relaxed);
+}
+
+void CancellationToken::setDeadline(Clock::time_point deadline) const
+{
+    // 时间点计数可能为0，至少保留1以区分“无截止时间”
+    Clock::rep ticks = deadline.time_since_epoch().count();
+    state->deadline.store(ticks != 0 ? ticks : 1, std::memory_order_relaxed);
+}
+
+void CancellationToken::setTimeout(std::chrono::milliseconds timeout) const
+{
+    setDeadline(Clock::now() + timeout);
+}
+
+CancellationToken::State CancellationToken::getState() const
+{
+    Clock::rep now = 0;
+    for (const SharedState *current = state.get(); current; current = current->parent.get()) {
+        if (current->cancelled.load(std::memory_order_relaxed)) {
+            return State::CANCELLED;
+        }
+        Clock::rep deadline = current->deadline.load(std::memory_order_relaxed);
+        if (deadline != 0) {
+            if (now == 0) {
+                now = Clock::now().time_since_epoch().count();
+            }
+            if (now >= deadline) {
+                return State::TIMED_OUT;
+            }
+        }
+    }
+    return State::ACTIVE;
+}
+
+bool CancellationToken::isStopRequested() const
+{
+    return getState() != State::ACTIVE;
+}
+
+void CancellationToken::throwIfStopped(const std::string &context) const
+{
+    switch (getState()) {
+        case State::CANCELLED:
+            THROW_ERROR(ErrorCode::OPERATION_CANCELLED, context);
+        case State::TIMED_OUT:
+            THROW_ERROR(ErrorCode::OPERATION_TIMEOUT, context);
+        case State::ACTIVE:
+            break;
+    }
+}
+
+CancellationToken CancellationToken::createChild() const
+{
+    auto child = std::make_shared<SharedState>();
+    child->parent = state;
+    return CancellationToken(std::move(child));
+}
+
+CancellationToken CancellationToken::withDeadline(Clock::time_point deadline) const
+{
+    CancellationToken token = createChild();
+    token.setDeadline(deadline);
+    return token;
+}
+
+}  // namespace neumann
@@ -0,0 +1,277 @@
+#include "core/compound_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace neumann {
+
+namespace {
+
+const unsigned char kSignature[8] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+const size_t kHeaderSize = 512;
+const size_t kDirectoryEntrySize = 128;
+const size_t kHeaderDifatCount = 109;
+
+const uint32_t kMaxRegularSector = 0xFFFFFFFA;
+const uint32_t kEndOfChain = 0xFFFFFFFE;
+const uint32_t kFreeSector = 0xFFFFFFFF;
+
+const uint8_t kStreamEntry = 2;
+const uint8_t kRootEntry = 5;
+
+// 复合文档中的整数均为小端序
+uint16_t readU16(const char *data)
+{
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t readU32(const char *data)
+{
+    return static_cast<uint32_t>(readU16(data)) | (static_cast<uint32_t>(readU16(data + 2)) << 16);
+}
+
+uint64_t readU64(const char *data)
+{
+    return static_cast<uint64_t>(readU32(data)) | (static_cast<uint64_t>(readU32(data + 4)) << 32);
+}
+
+[[noreturn]] void invalidFile(const std::string &message)
+{
+    throw std::runtime_error("Invalid compound file: " + message);
+}
+
+// 目录项名称为UTF-16LE，转换为UTF-8
+std::string decodeEntryName(const char *data, size_t byteLength)
+{
+    std::string name;
+    for (size_t i = 0; i + 1 < byteLength; i += 2) {
+        uint32_t unit = readU16(data + i);
+        if (unit == 0) {
+            break;
+        }
+        if (unit < 0x80) {
+            name.push_back(static_cast<char>(unit));
+        } else if (unit < 0x800) {
+            name.push_back(static_cast<char>(0xC0 | (unit >> 6)));
+            name.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+        } else {
+            name.push_back(static_cast<char>(0xE0 | (unit >> 12)));
+            name.push_back(static_cast<char>(0x80 | ((unit >> 6) & 0x3F)));
+            name.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+        }
+    }
+    return name;
+}
+
+bool equalsIgnoreCase(const std::string &a, const std::string &b)
+{
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+}  // namespace
+
+CompoundFile CompoundFile::openFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read file: " + path);
+    }
+    return fromBuffer(std::move(data));
+}
+
+CompoundFile CompoundFile::fromBuffer(std::string data)
+{
+    CompoundFile compoundFile;
+    compoundFile.buffer = std::make_shared<const std::string>(std::move(data));
+    compoundFile.parse();
+    return compoundFile;
+}
+
+bool CompoundFile::hasSignature(const std::string &data)
+{
+    return data.size() >= sizeof(kSignature) &&
+           std::equal(std::begin(kSignature), std::end(kSignature),
+                      reinterpret_cast<const unsigned char *>(data.data()));
+}
+
+void CompoundFile::parse()
+{
+    const std::string &data = *buffer;
+    if (data.size() < kHeaderSize || !hasSignature(data)) {
+        invalidFile("missing signature");
+    }
+
+    const char *header = data.data();
+    uint16_t sectorShift = readU16(header + 0x1E);
+    uint16_t miniSectorShift = readU16(header + 0x20);
+    if ((sectorShift != 9 && sectorShift != 12) || miniSectorShift != 6) {
+        invalidFile("unsupported sector size");
+    }
+    sectorSize = size_t(1) << sectorShift;
+    miniSectorSize = size_t(1) << miniSectorShift;
+
+    uint32_t fatSectorCount = readU32(header + 0x2C);
+    uint32_t firstDirectorySector = readU32(header + 0x30);
+    miniStreamCutoff = readU32(header + 0x38);
+    uint32_t firstMiniFatSector = readU32(header + 0x3C);
+    uint32_t firstDifatSector = readU32(header + 0x44);
+    uint32_t difatSectorCount = readU32(header + 0x48);
+
+    // 头部中的计数不可信，分配内存之前先按文件实际包含的扇区数检查：
+    // FAT扇区数不能超过文件的扇区数，更长的DIFAT链一定有环
+    size_t fileSectorCount = data.size() / sectorSize;
+    if (fatSectorCount > fileSectorCount) {
+        invalidFile("FAT sector count exceeds file size");
+    }
+    if (difatSectorCount > fileSectorCount) {
+        invalidFile("DIFAT chain is longer than the file");
+    }
+
+    // 扇区分配表所在的扇区：头部列出前109个，其余在DIFAT扇区链中
+    std::vector<uint32_t> fatSectors;
+    for (size_t i = 0; i < kHeaderDifatCount && fatSectors.size() < fatSectorCount; ++i) {
+        fatSectors.push_back(readU32(header + 0x4C + i * 4));
+    }
+    size_t entriesPerSector = sectorSize / 4;
+    uint32_t difatSector = firstDifatSector;
+    for (uint32_t i = 0; i < difatSectorCount && fatSectors.size() < fatSectorCount; ++i) {
+        if (difatSector > kMaxRegularSector) {
+            invalidFile("truncated DIFAT chain");
+        }
+        const char *sector = sectorData(difatSector);
+        for (size_t j = 0; j + 1 < entriesPerSector && fatSectors.size() < fatSectorCount; ++j) {
+            fatSectors.push_back(readU32(sector + j * 4));
+        }
+        difatSector = readU32(sector + (entriesPerSector - 1) * 4);
+    }
+    if (fatSectors.size() < fatSectorCount) {
+        invalidFile("missing FAT sectors");
+    }
+
+    fat.reserve(fatSectors.size() * entriesPerSector);
+    for (uint32_t sectorId : fatSectors) {
+        const char *sector = sectorData(sectorId);
+        for (size_t j = 0; j < entriesPerSector; ++j) {
+            fat.push_back(readU32(sector + j * 4));
+        }
+    }
+
+    // 目录项
+    std::string directory;
+    for (uint32_t sectorId : readChain(fat, firstDirectorySector, SIZE_MAX)) {
+        directory.append(sectorData(sectorId), sectorSize);
+    }
+    for (size_t pos = 0; pos + kDirectoryEntrySize <= directory.size();
+         pos += kDirectoryEntrySize) {
+        const char *raw = directory.data() + pos;
+        CompoundFileEntry entry;
+        entry.type = static_cast<uint8_t>(raw[0x42]);
+        if (entry.type == 0) {
+            continue;  // 未使用的目录项
+        }
+        entry.name = decodeEntryName(raw, std::min<size_t>(readU16(raw + 0x40), 64));
+        entry.startSector = readU32(raw + 0x74);
+        // 版本3文件的大小高32位可能未初始化
+        entry.size = sectorSize == 512 ? readU32(raw + 0x78) : readU64(raw + 0x78);
+        entries.push_back(std::move(entry));
+    }
+    if (entries.empty() || entries.front().type != kRootEntry) {
+        invalidFile("missing root entry");
+    }
+
+    // 迷你扇区分配表和迷你流（存放在根目录项指向的普通扇区链中）
+    for (uint32_t sectorId : readChain(fat, firstMiniFatSector, SIZE_MAX)) {
+        const char *sector = sectorData(sectorId);
+        for (size_t j = 0; j < entriesPerSector; ++j) {
+            miniFat.push_back(readU32(sector + j * 4));
+        }
+    }
+    const CompoundFileEntry &root = entries.front();
+    size_t miniStreamSectors = static_cast<size_t>((root.size + sectorSize - 1) / sectorSize);
+    for (uint32_t sectorId : readChain(fat, root.startSector, miniStreamSectors)) {
+        miniStream.append(sectorData(sectorId), sectorSize);
+    }
+}
+
+const CompoundFileEntry *CompoundFile::findStream(const std::string &name) const
+{
+    for (const auto &entry : entries) {
+        if (entry.type == kStreamEntry && equalsIgnoreCase(entry.name, name)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string CompoundFile::readStream(const std::string &name) const
+{
+    const CompoundFileEntry *entry = findStream(name);
+    if (!entry) {
+        throw std::runtime_error("Compound file stream not found: " + name);
+    }
+
+    std::string content;
+    if (entry->size < miniStreamCutoff) {
+        // 小流存放在迷你流中
+        size_t count = static_cast<size_t>((entry->size + miniSectorSize - 1) / miniSectorSize);
+        for (uint32_t sectorId : readChain(miniFat, entry->startSector, count)) {
+            size_t offset = static_cast<size_t>(sectorId) * miniSectorSize;
+            if (offset + miniSectorSize > miniStream.size()) {
+                invalidFile("mini sector out of range");
+            }
+            content.append(miniStream, offset, miniSectorSize);
+        }
+    } else {
+        size_t count = static_cast<size_t>((entry->size + sectorSize - 1) / sectorSize);
+        content.reserve(count * sectorSize);
+        for (uint32_t sectorId : readChain(fat, entry->startSector, count)) {
+            content.append(sectorData(sectorId), sectorSize);
+        }
+    }
+
+    if (content.size() < entry->size) {
+        invalidFile("stream shorter than declared size: " + name);
+    }
+    content.resize(static_cast<size_t>(entry->size));
+    return content;
+}
+
+std::vector<uint32_t> CompoundFile::readChain(const std::vector<uint32_t> &table, uint32_t start,
+                                              size_t maxLength) const
+{
+    std::vector<uint32_t> chain;
+    uint32_t sector = start;
+    // 个别写入程序用空闲标记表示空链
+    while (sector != kEndOfChain && sector != kFreeSector && chain.size() < maxLength) {
+        // 链长度超过表大小说明存在循环
+        if (sector > kMaxRegularSector || sector >= table.size() || chain.size() >= table.size()) {
+            invalidFile("broken sector chain");
+        }
+        chain.push_back(sector);
+        sector = table[sector];
+    }
+    return chain;
+}
+
+const char *CompoundFile::sectorData(uint32_t sector) const
+{
+    uint64_t offset = (static_cast<uint64_t>(sector) + 1) * sectorSize;
+    if (offset + sectorSize > buffer->size()) {
+        invalidFile("sector out of range");
+    }
+    return buffer->data() + offset;
+}
+
+}  // namespace neumann
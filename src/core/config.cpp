@@ -1,5 +1,6 @@
 #include "core/config.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -123,6 +124,11 @@ bool Config::loadFromFile(const std::string &filename)
             webRootDirectory = makeAbsolutePath(relPath);
         }
 
+        if (data.contains("batchRootDirectory")) {
+            std::string relPath = data["batchRootDirectory"].get<std::string>();
+            batchRootDirectory = relPath.empty() ? relPath : makeAbsolutePath(relPath);
+        }
+
         if (data.contains("defaultConfidenceLevel")) {
             defaultConfidenceLevel = data["defaultConfidenceLevel"].get<double>();
         }
@@ -131,6 +137,42 @@ bool Config::loadFromFile(const std::string &filename)
             defaultWebPort = data["defaultWebPort"].get<int>();
         }
 
+        if (data.contains("apiCompressionLevel")) {
+            setApiCompressionLevel(data["apiCompressionLevel"].get<int>());
+        }
+
+        if (data.contains("apiCompressionMinSize")) {
+            setApiCompressionMinSize(data["apiCompressionMinSize"].get<int>());
+        }
+
+        if (data.contains("apiMaxDataPoints")) {
+            setApiMaxDataPoints(data["apiMaxDataPoints"].get<int>());
+        }
+
+        if (data.contains("apiResponseCacheSize")) {
+            setApiResponseCacheSize(data["apiResponseCacheSize"].get<int>());
+        }
+
+        if (data.contains("webBindAddress")) {
+            webBindAddress = data["webBindAddress"].get<std::string>();
+        }
+
+        if (data.contains("webThreadCount")) {
+            setWebThreadCount(data["webThreadCount"].get<int>());
+        }
+
+        if (data.contains("webIdleTimeout")) {
+            setWebIdleTimeout(data["webIdleTimeout"].get<int>());
+        }
+
+        if (data.contains("webMaxRequestSize")) {
+            setWebMaxRequestSize(data["webMaxRequestSize"].get<int>());
+        }
+
+        if (data.contains("webUnixSocket")) {
+            webUnixSocket = data["webUnixSocket"].get<std::string>();
+        }
+
         if (data.contains("showWelcomeMessage")) {
             showWelcomeMessage = data["showWelcomeMessage"].get<bool>();
         }
@@ -147,6 +189,10 @@ bool Config::loadFromFile(const std::string &filename)
             autoSaveResults = data["autoSaveResults"].get<bool>();
         }
 
+        if (data.contains("batchWorkerProcesses")) {
+            setBatchWorkerProcesses(data["batchWorkerProcesses"].get<int>());
+        }
+
         std::cout << _("config.load_success") << ": " << filename << std::endl;
         return true;
     }
@@ -166,12 +212,24 @@ bool Config::saveToFile(const std::string &filename)
         // 将绝对路径转换为相对路径存储
         data["dataDirectory"] = makeRelativePath(dataDirectory);
         data["webRootDirectory"] = makeRelativePath(webRootDirectory);
+        data["batchRootDirectory"] =
+            batchRootDirectory.empty() ? batchRootDirectory : makeRelativePath(batchRootDirectory);
         data["defaultConfidenceLevel"] = defaultConfidenceLevel;
         data["defaultWebPort"] = defaultWebPort;
+        data["apiCompressionLevel"] = apiCompressionLevel;
+        data["apiCompressionMinSize"] = apiCompressionMinSize;
+        data["apiMaxDataPoints"] = apiMaxDataPoints;
+        data["apiResponseCacheSize"] = apiResponseCacheSize;
+        data["webBindAddress"] = webBindAddress;
+        data["webThreadCount"] = webThreadCount;
+        data["webIdleTimeout"] = webIdleTimeout;
+        data["webMaxRequestSize"] = webMaxRequestSize;
+        data["webUnixSocket"] = webUnixSocket;
         data["showWelcomeMessage"] = showWelcomeMessage;
         data["enableColorOutput"] = enableColorOutput;
         data["maxDataPoints"] = maxDataPoints;
         data["autoSaveResults"] = autoSaveResults;
+        data["batchWorkerProcesses"] = batchWorkerProcesses;
 
         std::ofstream file(filename);
         if (!file.is_open()) {
@@ -202,12 +260,23 @@ void Config::initializeDefaults()
     language = Language::CHINESE;
     dataDirectory = "data";
     webRootDirectory = "web";
+    batchRootDirectory = "";
     defaultConfidenceLevel = 0.95;
     defaultWebPort = 8080;
+    apiCompressionLevel = 6;
+    apiCompressionMinSize = 1024;
+    apiMaxDataPoints = 0;
+    apiResponseCacheSize = 32 * 1024 * 1024;
+    webBindAddress = "0.0.0.0";
+    webThreadCount = 0;
+    webIdleTimeout = 5;
+    webMaxRequestSize = 16 * 1024 * 1024;
+    webUnixSocket = "";
     showWelcomeMessage = true;
     enableColorOutput = true;
     maxDataPoints = 1000;
     autoSaveResults = true;
+    batchWorkerProcesses = 0;
 }
 
 // Getter方法
@@ -223,6 +292,10 @@ std::string Config::getWebRootDirectory() const
 {
     return webRootDirectory;
 }
+std::string Config::getBatchRootDirectory() const
+{
+    return batchRootDirectory;
+}
 double Config::getDefaultConfidenceLevel() const
 {
     return defaultConfidenceLevel;
@@ -231,6 +304,43 @@ int Config::getDefaultWebPort() const
 {
     return defaultWebPort;
 }
+int Config::getApiCompressionLevel() const
+{
+    return apiCompressionLevel;
+}
+int Config::getApiCompressionMinSize() const
+{
+    return apiCompressionMinSize;
+}
+int Config::getApiMaxDataPoints() const
+{
+    return apiMaxDataPoints;
+}
+
+int Config::getApiResponseCacheSize() const
+{
+    return apiResponseCacheSize;
+}
+std::string Config::getWebBindAddress() const
+{
+    return webBindAddress;
+}
+int Config::getWebThreadCount() const
+{
+    return webThreadCount;
+}
+int Config::getWebIdleTimeout() const
+{
+    return webIdleTimeout;
+}
+int Config::getWebMaxRequestSize() const
+{
+    return webMaxRequestSize;
+}
+std::string Config::getWebUnixSocket() const
+{
+    return webUnixSocket;
+}
 bool Config::getShowWelcomeMessage() const
 {
     return showWelcomeMessage;
@@ -247,6 +357,10 @@ bool Config::getAutoSaveResults() const
 {
     return autoSaveResults;
 }
+int Config::getBatchWorkerProcesses() const
+{
+    return batchWorkerProcesses;
+}
 std::string Config::getConfigFilePath() const
 {
     return configFilePath;
@@ -268,6 +382,10 @@ void Config::setWebRootDirectory(const std::string &path)
 {
     webRootDirectory = path;
 }
+void Config::setBatchRootDirectory(const std::string &path)
+{
+    batchRootDirectory = path;
+}
 void Config::setDefaultConfidenceLevel(double level)
 {
     defaultConfidenceLevel = level;
@@ -276,6 +394,45 @@ void Config::setDefaultWebPort(int port)
 {
     defaultWebPort = port;
 }
+void Config::setApiCompressionLevel(int level)
+{
+    apiCompressionLevel = std::clamp(level, 0, 9);
+}
+void Config::setApiCompressionMinSize(int bytes)
+{
+    apiCompressionMinSize = std::max(0, bytes);
+}
+void Config::setApiMaxDataPoints(int points)
+{
+    // 0表示由请求体上限推出；趋势测试至少需要4个数据点
+    apiMaxDataPoints = points <= 0 ? 0 : std::max(4, points);
+}
+
+void Config::setApiResponseCacheSize(int bytes)
+{
+    apiResponseCacheSize = std::max(0, bytes);
+}
+void Config::setWebBindAddress(const std::string &address)
+{
+    webBindAddress = address;
+}
+void Config::setWebThreadCount(int threads)
+{
+    webThreadCount = std::max(0, threads);
+}
+void Config::setWebIdleTimeout(int seconds)
+{
+    // Crow以8位整数保存空闲超时
+    webIdleTimeout = std::clamp(seconds, 1, 255);
+}
+void Config::setWebMaxRequestSize(int bytes)
+{
+    webMaxRequestSize = std::max(0, bytes);
+}
+void Config::setWebUnixSocket(const std::string &path)
+{
+    webUnixSocket = path;
+}
 void Config::setShowWelcomeMessage(bool show)
 {
     showWelcomeMessage = show;
@@ -292,6 +449,10 @@ void Config::setAutoSaveResults(bool autoSave)
 {
     autoSaveResults = autoSave;
 }
+void Config::setBatchWorkerProcesses(int processes)
+{
+    batchWorkerProcesses = std::max(0, processes);
+}
 
 void Config::setConfigFilePath(const std::string &path)
 {
@@ -0,0 +1,73 @@
+#include "core/content_encoding.h"
+
+#include "core/http_header.h"
+
+namespace neumann {
+
+ContentEncoding negotiateContentEncoding(const std::string &acceptEncoding)
+{
+    // 未出现的编码q值为-1，由"*"补充
+    double gzipQuality = -1.0;
+    double deflateQuality = -1.0;
+    double wildcardQuality = -1.0;
+
+    for (const auto &item : parseQualityList(acceptEncoding)) {
+        const std::string &coding = item.value;
+        double quality = item.quality;
+
+        if (coding == "gzip" || coding == "x-gzip") {
+            gzipQuality = quality;
+        } else if (coding == "deflate") {
+            deflateQuality = quality;
+        } else if (coding == "*") {
+            wildcardQuality = quality;
+        }
+    }
+
+    if (gzipQuality < 0.0) {
+        gzipQuality = wildcardQuality;
+    }
+    if (deflateQuality < 0.0) {
+        deflateQuality = wildcardQuality;
+    }
+
+    if (gzipQuality > 0.0 && gzipQuality >= deflateQuality) {
+        return ContentEncoding::GZIP;
+    }
+    if (deflateQuality > 0.0) {
+        return ContentEncoding::DEFLATE;
+    }
+    return ContentEncoding::IDENTITY;
+}
+
+const char *contentEncodingName(ContentEncoding encoding)
+{
+    switch (encoding) {
+        case ContentEncoding::GZIP:
+            return "gzip";
+        case ContentEncoding::DEFLATE:
+            return "deflate";
+        case ContentEncoding::IDENTITY:
+            break;
+    }
+    return "";
+}
+
+ContentEncoding compressBody(std::string &body, ContentEncoding encoding, size_t minSize,
+                             int level)
+{
+    if (encoding == ContentEncoding::IDENTITY || body.size() < minSize || level <= 0) {
+        return ContentEncoding::IDENTITY;
+    }
+
+    std::string compressed = encoding == ContentEncoding::GZIP
+                                 ? gzipCompress(body.data(), body.size(), level)
+                                 : zlibCompress(body.data(), body.size(), level);
+    if (compressed.size() >= body.size()) {
+        return ContentEncoding::IDENTITY;
+    }
+    body.swap(compressed);
+    return encoding;
+}
+
+}  // namespace neumann
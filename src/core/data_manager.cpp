@@ -11,6 +11,9 @@
 #include <sstream>
 
 #include "core/config.h"
+#include "core/error_handler.h"
+#include "core/neumann_calculator.h"
+#include "core/standard_values.h"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -35,7 +38,43 @@ DataManager &DataManager::getInstance()
     return instance;
 }
 
+void DataManager::setDataDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> statisticsLock(statisticsMutex);
+    std::lock_guard<std::mutex> cacheLock(cacheMutex);
+    dataDir = directory;
+    if (!fs::exists(dataDir)) {
+        fs::create_directories(dataDir);
+    }
+    loadedDataSets.clear();
+    statistics.clear();
+}
+
+const std::string &DataManager::getDataDirectory() const
+{
+    return dataDir;
+}
+
 DataSet DataManager::importFromCSV(const std::string &filename, bool hasHeader)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "无法打开CSV文件: " << filename << std::endl;
+
+        DataSet dataSet;
+        dataSet.name = fs::path(filename).stem().string();
+        dataSet.source = filename;
+        dataSet.createdAt = currentTimestamp();
+        return dataSet;
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return importFromCSVContent(content, filename, hasHeader);
+}
+
+DataSet DataManager::importFromCSVContent(const std::string &content, const std::string &filename,
+                                          bool hasHeader,
+                                          const CancellationToken *cancellationToken)
 {
     DataSet dataSet;
 
@@ -45,34 +84,32 @@ DataSet DataManager::importFromCSV(const std::string &filename, bool hasHeader)
     dataSet.source = filename;
 
     // 获取当前时间作为创建时间
-    auto now = std::chrono::system_clock::now();
-    auto timeT = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&timeT), "%Y-%m-%d %H:%M:%S");
-    dataSet.createdAt = ss.str();
+    dataSet.createdAt = currentTimestamp();
 
     try {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "无法打开CSV文件: " << filename << std::endl;
-            return dataSet;
-        }
-
-        std::string line;
+        // 直接在内容上切分行和单元格，不把整个内容复制到字符串流中
+        std::string_view input(content);
+        std::string_view line;
 
         // 跳过表头（如果有）
-        if (hasHeader && std::getline(file, line)) {
+        if (hasHeader && nextCSVToken(input, '\n', line)) {
             // 表头可以用作描述
-            dataSet.description = line;
+            dataSet.description = std::string(line);
         }
 
-        // 读取数据
-        while (std::getline(file, line)) {
-            std::stringstream lineStream(line);
-            std::string cell;
+        // 读取数据，每隔一定行数检查取消令牌
+        const size_t kCancellationCheckLines = 4096;
+        size_t lineCount = 0;
+        std::string_view field;
+        std::string cell;  // std::stod需要以空字符结尾的字符串，各单元格复用同一缓冲区
+        while (nextCSVToken(input, '\n', line)) {
+            if (cancellationToken && ++lineCount % kCancellationCheckLines == 0) {
+                cancellationToken->throwIfStopped(filename);
+            }
 
             // 假设CSV格式为: 时间点,数据点
-            if (std::getline(lineStream, cell, ',')) {
+            if (nextCSVToken(line, ',', field)) {
+                cell.assign(field.data(), field.size());
                 try {
                     double timePoint = std::stod(cell);
                     dataSet.timePoints.push_back(timePoint);
@@ -83,7 +120,8 @@ DataSet DataManager::importFromCSV(const std::string &filename, bool hasHeader)
                 }
             }
 
-            if (std::getline(lineStream, cell, ',')) {
+            if (nextCSVToken(line, ',', field)) {
+                cell.assign(field.data(), field.size());
                 try {
                     double dataPoint = std::stod(cell);
                     dataSet.dataPoints.push_back(dataPoint);
@@ -95,6 +133,9 @@ DataSet DataManager::importFromCSV(const std::string &filename, bool hasHeader)
             }
         }
     }
+    catch (const NeumannException &) {
+        throw;  // 取消或超时
+    }
     catch (const std::exception &e) {
         std::cerr << "导入CSV文件时出错: " << e.what() << std::endl;
     }
@@ -102,6 +143,17 @@ DataSet DataManager::importFromCSV(const std::string &filename, bool hasHeader)
     return dataSet;
 }
 
+bool DataManager::nextCSVToken(std::string_view &text, char delimiter, std::string_view &token)
+{
+    if (text.empty()) {
+        return false;
+    }
+    size_t end = text.find(delimiter);
+    token = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return true;
+}
+
 bool DataManager::exportToCSV(const DataSet &dataSet, const std::string &filename)
 {
     try {
@@ -155,7 +207,17 @@ bool DataManager::saveDataSet(const DataSet &dataSet)
         file << std::setw(4) << j << std::endl;
 
         // 添加到缓存
-        loadedDataSets[dataSet.name] = dataSet;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            loadedDataSets[dataSet.name] = dataSet;
+        }
+
+        // 更新已建立的统计
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        for (auto &item : statistics) {
+            removeSummary(item.second, dataSet.name);
+            addSummary(item.second, dataSet.name, summarize(dataSet, item.first));
+        }
 
         return true;
     }
@@ -168,9 +230,12 @@ bool DataManager::saveDataSet(const DataSet &dataSet)
 DataSet DataManager::loadDataSet(const std::string &name)
 {
     // 检查缓存
-    auto it = loadedDataSets.find(name);
-    if (it != loadedDataSets.end()) {
-        return it->second;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = loadedDataSets.find(name);
+        if (it != loadedDataSets.end()) {
+            return it->second;
+        }
     }
 
     DataSet dataSet;
@@ -202,6 +267,7 @@ DataSet DataManager::loadDataSet(const std::string &name)
         dataSet.dataPoints = j["dataPoints"].get<std::vector<double>>();
 
         // 添加到缓存
+        std::lock_guard<std::mutex> lock(cacheMutex);
         loadedDataSets[name] = dataSet;
 
         return dataSet;
@@ -249,7 +315,15 @@ bool DataManager::deleteDataSet(const std::string &name)
         }
 
         // 从缓存中删除
-        loadedDataSets.erase(name);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            loadedDataSets.erase(name);
+        }
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        for (auto &item : statistics) {
+            removeSummary(item.second, name);
+        }
 
         return true;
     }
@@ -259,4 +333,120 @@ bool DataManager::deleteDataSet(const std::string &name)
     }
 }
 
+DataSetStatistics DataManager::getStatistics(double confidenceLevel)
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    const StatisticsIndex &index = statisticsFor(confidenceLevel);
+
+    DataSetStatistics result = index.totals;
+    if (!index.minPGs.empty()) {
+        result.minPG = *index.minPGs.begin();
+        result.maxPG = *index.maxPGs.rbegin();
+    }
+    return result;
+}
+
+std::map<std::string, DataSetSummary> DataManager::getDataSetSummaries(double confidenceLevel)
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    return statisticsFor(confidenceLevel).summaries;
+}
+
+DataManager::StatisticsIndex &DataManager::statisticsFor(double confidenceLevel)
+{
+    uint64_t version = StandardValues::getInstance().getVersion();
+    auto it = statistics.find(confidenceLevel);
+    if (it != statistics.end() && it->second.standardValuesVersion == version) {
+        return it->second;
+    }
+
+    // 第一次查询该置信水平或标准值表已变化，重新测试所有数据集
+    StatisticsIndex index;
+    index.standardValuesVersion = version;
+    index.totals.confidenceLevel = confidenceLevel;
+    for (const auto &name : getDataSetNames()) {
+        addSummary(index, name, summarize(loadDataSet(name), confidenceLevel));
+    }
+    StatisticsIndex &stored = statistics[confidenceLevel];
+    stored = std::move(index);
+    return stored;
+}
+
+DataSetSummary DataManager::summarize(const DataSet &dataSet, double confidenceLevel)
+{
+    DataSetSummary summary;
+    summary.pointCount = dataSet.dataPoints.size();
+    if (dataSet.dataPoints.size() < 4 || dataSet.dataPoints.size() != dataSet.timePoints.size()) {
+        return summary;
+    }
+
+    NeumannCalculator calculator(confidenceLevel);
+    NeumannTestResults results = calculator.performTest(dataSet.dataPoints, dataSet.timePoints);
+    summary.tested = true;
+    summary.overallTrend = results.overallTrend;
+    summary.avgPG = results.avgPG;
+    summary.minPG = results.minPG;
+    summary.maxPG = results.maxPG;
+    return summary;
+}
+
+void DataManager::addSummary(StatisticsIndex &index, const std::string &name,
+                             const DataSetSummary &summary)
+{
+    index.summaries[name] = summary;
+    index.totals.totalDatasets++;
+    if (summary.tested) {
+        index.totals.testedDatasets++;
+        index.totals.datasetsWithTrend += summary.overallTrend ? 1 : 0;
+        index.totals.totalDataPoints += summary.pointCount;
+        index.totals.totalAvgPG += summary.avgPG;
+        index.minPGs.insert(summary.minPG);
+        index.maxPGs.insert(summary.maxPG);
+    }
+}
+
+void DataManager::removeSummary(StatisticsIndex &index, const std::string &name)
+{
+    auto it = index.summaries.find(name);
+    if (it == index.summaries.end()) {
+        return;
+    }
+
+    const DataSetSummary &summary = it->second;
+    index.totals.totalDatasets--;
+    if (summary.tested) {
+        index.totals.testedDatasets--;
+        index.totals.datasetsWithTrend -= summary.overallTrend ? 1 : 0;
+        index.totals.totalDataPoints -= summary.pointCount;
+        index.totals.totalAvgPG -= summary.avgPG;
+        index.minPGs.erase(index.minPGs.find(summary.minPG));
+        index.maxPGs.erase(index.maxPGs.find(summary.maxPG));
+    }
+    index.summaries.erase(it);
+
+    // 没有参与测试的数据集时清除累加误差
+    if (index.totals.testedDatasets == 0) {
+        index.totals.totalDataPoints = 0.0;
+        index.totals.totalAvgPG = 0.0;
+    }
+}
+
+std::string DataManager::currentTimestamp()
+{
+    auto now = std::chrono::system_clock::now();
+    auto timeT = std::chrono::system_clock::to_time_t(now);
+
+    // std::localtime返回共享的静态缓冲区，批量处理的多个线程会同时调用这里
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &timeT);
+#else
+    localtime_r(&timeT, &localTime);
+#endif
+
+    std::stringstream ss;
+    ss << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
 }  // namespace neumann
\ No newline at end of file
@@ -0,0 +1,664 @@
+#include "core/deflate.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "core/hash_utils.h"
+
+namespace neumann {
+
+namespace {
+
+const int kMaxCodeBits = 15;           // 字面量/长度和距离码的最大长度
+const int kMaxCodeLengthBits = 7;      // 码长码的最大长度
+const size_t kMinMatch = 3;            // 最短匹配长度
+const size_t kMaxMatch = 258;          // 最长匹配长度
+const size_t kWindowSize = 32 * 1024;  // 回溯窗口
+const size_t kMaxDistance = kWindowSize - 1;
+const int kHashBits = 15;
+const size_t kMaxBlockTokens = 16 * 1024;  // 每个块的符号数上限
+const size_t kMaxStoredBlock = 65535;      // 不压缩块的最大字节数
+const int kEndOfBlock = 256;
+
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385,
+                                    24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0,  8, 7,  9, 6,  10, 5,
+                                      11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+/**
+ * @brief 各压缩级别的匹配查找参数
+ */
+struct LevelParameters {
+    int maxChain;       // 每次查找的最大候选数
+    size_t niceLength;  // 找到这么长的匹配后不再继续查找
+    bool lazy;          // 是否延迟匹配：下一位置的匹配更长时先输出字面量
+};
+
+const LevelParameters kLevels[10] = {{0, 0, false},     {4, 8, false},     {8, 16, false},
+                                     {16, 32, false},   {16, 32, true},    {32, 64, true},
+                                     {128, 128, true},  {256, 258, true},  {1024, 258, true},
+                                     {4096, 258, true}};
+
+// 匹配长度对应的长度码序号（0-28）
+int lengthSymbol(size_t length)
+{
+    auto it = std::upper_bound(std::begin(kLengthBase), std::end(kLengthBase), length);
+    return static_cast<int>(it - std::begin(kLengthBase)) - 1;
+}
+
+// 匹配距离对应的距离码序号（0-29）
+int distanceSymbol(size_t distance)
+{
+    auto it = std::upper_bound(std::begin(kDistanceBase), std::end(kDistanceBase), distance);
+    return static_cast<int>(it - std::begin(kDistanceBase)) - 1;
+}
+
+// 按最低位在前写入比特流
+class BitWriter
+{
+public:
+    explicit BitWriter(std::string &out) : out(out) {}
+
+    void writeBits(uint32_t value, int count)
+    {
+        bitBuffer |= static_cast<uint64_t>(value) << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            out.push_back(static_cast<char>(bitBuffer));
+            bitBuffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    void alignToByte()
+    {
+        if (bitCount > 0) {
+            writeBits(0, 8 - bitCount);
+        }
+    }
+
+    // 已对齐到字节时直接追加原始字节
+    void appendBytes(const unsigned char *bytes, size_t count)
+    {
+        out.append(reinterpret_cast<const char *>(bytes), count);
+    }
+
+private:
+    std::string &out;
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+};
+
+/**
+ * @brief 根据频率构造长度受限的哈夫曼码长
+ *
+ * 超过最大长度时把频率减半后重建，直到满足限制。使用的符号少于2个时
+ * 补足2个长度为1的码，保证码表完整，兼容要求完整码表的解码器。
+ */
+void buildCodeLengths(const std::vector<uint32_t> &frequencies, int maxBits,
+                      std::vector<uint8_t> &lengths)
+{
+    const size_t symbolCount = frequencies.size();
+    lengths.assign(symbolCount, 0);
+
+    std::vector<uint32_t> weights(frequencies);
+    std::vector<size_t> used;
+    for (size_t i = 0; i < symbolCount; ++i) {
+        if (weights[i] != 0) {
+            used.push_back(i);
+        }
+    }
+    if (used.size() < 2) {
+        size_t first = used.empty() ? 0 : used[0];
+        size_t second = first == 0 ? 1 : 0;
+        lengths[first] = 1;
+        lengths[second] = 1;
+        return;
+    }
+
+    for (;;) {
+        // 节点：叶子为符号，内部节点记录子节点
+        struct Node {
+            uint64_t weight;
+            int left;
+            int right;
+        };
+        std::vector<Node> nodes;
+        nodes.reserve(used.size() * 2);
+        using Entry = std::pair<uint64_t, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        for (size_t symbol : used) {
+            nodes.push_back({weights[symbol], -1, static_cast<int>(symbol)});
+            queue.push({weights[symbol], static_cast<int>(nodes.size() - 1)});
+        }
+        while (queue.size() > 1) {
+            Entry a = queue.top();
+            queue.pop();
+            Entry b = queue.top();
+            queue.pop();
+            nodes.push_back({a.first + b.first, a.second, b.second});
+            queue.push({a.first + b.first, static_cast<int>(nodes.size() - 1)});
+        }
+
+        // 从根开始计算每个叶子的深度
+        int maxDepth = 0;
+        std::vector<std::pair<int, int>> stack = {{queue.top().second, 0}};
+        while (!stack.empty()) {
+            auto [index, depth] = stack.back();
+            stack.pop_back();
+            const Node &node = nodes[static_cast<size_t>(index)];
+            if (node.left < 0) {
+                lengths[static_cast<size_t>(node.right)] = static_cast<uint8_t>(depth);
+                maxDepth = std::max(maxDepth, depth);
+            } else {
+                stack.push_back({node.left, depth + 1});
+                stack.push_back({node.right, depth + 1});
+            }
+        }
+        if (maxDepth <= maxBits) {
+            return;
+        }
+
+        for (size_t symbol : used) {
+            weights[symbol] = (weights[symbol] + 1) / 2;
+        }
+    }
+}
+
+// 规范哈夫曼码，码字已按写入顺序（最低位在前）反转
+void buildCodes(const std::vector<uint8_t> &lengths, std::vector<uint16_t> &codes)
+{
+    uint16_t count[kMaxCodeBits + 1] = {};
+    for (uint8_t length : lengths) {
+        count[length]++;
+    }
+    count[0] = 0;
+
+    uint16_t next[kMaxCodeBits + 1] = {};
+    uint16_t code = 0;
+    for (int bits = 1; bits <= kMaxCodeBits; ++bits) {
+        code = static_cast<uint16_t>((code + count[bits - 1]) << 1);
+        next[bits] = code;
+    }
+
+    codes.assign(lengths.size(), 0);
+    for (size_t symbol = 0; symbol < lengths.size(); ++symbol) {
+        int length = lengths[symbol];
+        if (length == 0) {
+            continue;
+        }
+        uint16_t value = next[length]++;
+        uint16_t reversed = 0;
+        for (int bit = 0; bit < length; ++bit) {
+            reversed = static_cast<uint16_t>((reversed << 1) | ((value >> bit) & 1u));
+        }
+        codes[symbol] = reversed;
+    }
+}
+
+/**
+ * @brief LZ77匹配结果或字面量（distance为0时length为字面量字节）
+ */
+struct Token {
+    uint16_t length;
+    uint16_t distance;
+};
+
+/**
+ * @brief 码长序列的游程编码（符号16、17、18）
+ */
+struct CodeLengthSymbol {
+    uint8_t symbol;
+    uint8_t extra;
+};
+
+class DeflateEncoder
+{
+public:
+    DeflateEncoder(const char *data, size_t size, int level, std::string &out)
+        : data(reinterpret_cast<const unsigned char *>(data)),
+          size(size),
+          parameters(kLevels[std::clamp(level, 0, 9)]),
+          writer(out)
+    {
+    }
+
+    void encode()
+    {
+        if (parameters.maxChain == 0) {
+            writeStored(0, size, true);
+            return;
+        }
+
+        head.assign(size_t(1) << kHashBits, -1);
+        previous.assign(kWindowSize, -1);
+        tokens.reserve(kMaxBlockTokens);
+        resetFrequencies();
+
+        size_t position = 0;
+        Match pending;  // 延迟匹配时上一位置找到的匹配
+        bool hasPending = false;
+
+        while (position < size) {
+            Match current = findMatch(position);
+            insert(position);
+
+            if (hasPending) {
+                if (pending.length >= kMinMatch && pending.length >= current.length) {
+                    // 上一位置的匹配不比当前位置短，输出它并跳过已覆盖的位置
+                    emitMatch(pending);
+                    size_t end = position - 1 + pending.length;
+                    for (size_t p = position + 1; p < end; ++p) {
+                        insert(p);
+                    }
+                    position = end;
+                    hasPending = false;
+                    continue;
+                }
+                emitLiteral(data[position - 1]);
+                hasPending = false;
+            }
+
+            if (parameters.lazy && current.length < parameters.niceLength) {
+                pending = current;
+                hasPending = true;
+                position++;
+                continue;
+            }
+
+            if (current.length >= kMinMatch) {
+                emitMatch(current);
+                for (size_t p = position + 1; p < position + current.length; ++p) {
+                    insert(p);
+                }
+                position += current.length;
+            } else {
+                emitLiteral(data[position]);
+                position++;
+            }
+        }
+
+        if (hasPending) {
+            // 最后一个位置剩余的数据不足以构成匹配
+            emitLiteral(data[position - 1]);
+        }
+        flushBlock(true);
+        writer.alignToByte();
+    }
+
+private:
+    struct Match {
+        size_t length = 0;
+        size_t distance = 0;
+    };
+
+    uint32_t hashAt(size_t position) const
+    {
+        uint32_t value = data[position] | (uint32_t(data[position + 1]) << 8) |
+                         (uint32_t(data[position + 2]) << 16);
+        return (value * 2654435761u) >> (32 - kHashBits);
+    }
+
+    void insert(size_t position)
+    {
+        if (position + kMinMatch > size) {
+            return;
+        }
+        uint32_t hash = hashAt(position);
+        previous[position & (kWindowSize - 1)] = head[hash];
+        head[hash] = static_cast<int64_t>(position);
+    }
+
+    Match findMatch(size_t position) const
+    {
+        Match best;
+        if (position + kMinMatch > size) {
+            return best;
+        }
+
+        const size_t maxLength = std::min(kMaxMatch, size - position);
+        const unsigned char *current = data + position;
+        int64_t candidate = head[hashAt(position)];
+        int chain = parameters.maxChain;
+
+        while (candidate >= 0 && chain-- > 0) {
+            size_t distance = position - static_cast<size_t>(candidate);
+            if (distance > kMaxDistance) {
+                break;
+            }
+
+            // 先比较最佳长度处的字节，大多数候选在这里就被排除
+            const unsigned char *match = data + candidate;
+            if (match[best.length] == current[best.length] && match[0] == current[0]) {
+                size_t length = 0;
+                while (length < maxLength && match[length] == current[length]) {
+                    length++;
+                }
+                if (length > best.length) {
+                    best.length = length;
+                    best.distance = distance;
+                    if (length >= parameters.niceLength || length == maxLength) {
+                        break;
+                    }
+                }
+            }
+
+            int64_t next = previous[static_cast<size_t>(candidate) & (kWindowSize - 1)];
+            if (next >= candidate) {
+                break;  // 窗口中的槽位已被更新的位置覆盖
+            }
+            candidate = next;
+        }
+
+        if (best.length < kMinMatch) {
+            best.length = 0;
+        }
+        return best;
+    }
+
+    void resetFrequencies()
+    {
+        literalFrequencies.assign(286, 0);
+        distanceFrequencies.assign(30, 0);
+        literalFrequencies[kEndOfBlock] = 1;
+    }
+
+    void emitLiteral(unsigned char byte)
+    {
+        tokens.push_back({byte, 0});
+        literalFrequencies[byte]++;
+        blockEnd++;
+        if (tokens.size() >= kMaxBlockTokens) {
+            flushBlock(false);
+        }
+    }
+
+    void emitMatch(const Match &match)
+    {
+        tokens.push_back({static_cast<uint16_t>(match.length),
+                          static_cast<uint16_t>(match.distance)});
+        literalFrequencies[257 + lengthSymbol(match.length)]++;
+        distanceFrequencies[distanceSymbol(match.distance)]++;
+        blockEnd += match.length;
+        if (tokens.size() >= kMaxBlockTokens) {
+            flushBlock(false);
+        }
+    }
+
+    // 按给定码长计算所有符号的编码长度（比特）
+    uint64_t tokenBits(const std::vector<uint8_t> &literalLengths,
+                       const std::vector<uint8_t> &distanceLengths) const
+    {
+        uint64_t bits = literalLengths[kEndOfBlock];
+        for (size_t symbol = 0; symbol < 256; ++symbol) {
+            bits += uint64_t(literalFrequencies[symbol]) * literalLengths[symbol];
+        }
+        for (size_t i = 0; i < 29; ++i) {
+            bits += uint64_t(literalFrequencies[257 + i]) *
+                    (literalLengths[257 + i] + kLengthExtra[i]);
+        }
+        for (size_t i = 0; i < 30; ++i) {
+            bits += uint64_t(distanceFrequencies[i]) * (distanceLengths[i] + kDistanceExtra[i]);
+        }
+        return bits;
+    }
+
+    static void fixedLengths(std::vector<uint8_t> &literalLengths,
+                             std::vector<uint8_t> &distanceLengths)
+    {
+        literalLengths.assign(288, 0);
+        std::fill(literalLengths.begin(), literalLengths.begin() + 144, uint8_t(8));
+        std::fill(literalLengths.begin() + 144, literalLengths.begin() + 256, uint8_t(9));
+        std::fill(literalLengths.begin() + 256, literalLengths.begin() + 280, uint8_t(7));
+        std::fill(literalLengths.begin() + 280, literalLengths.end(), uint8_t(8));
+        distanceLengths.assign(30, 5);
+    }
+
+    // 把码长序列游程编码为符号0-18
+    static void encodeCodeLengths(const std::vector<uint8_t> &lengths,
+                                  std::vector<CodeLengthSymbol> &symbols)
+    {
+        symbols.clear();
+        size_t i = 0;
+        while (i < lengths.size()) {
+            uint8_t length = lengths[i];
+            size_t run = 1;
+            while (i + run < lengths.size() && lengths[i + run] == length) {
+                run++;
+            }
+
+            if (length == 0 && run >= 3) {
+                size_t count = std::min<size_t>(run, 138);
+                if (count >= 11) {
+                    symbols.push_back({18, static_cast<uint8_t>(count - 11)});
+                } else {
+                    symbols.push_back({17, static_cast<uint8_t>(count - 3)});
+                }
+                i += count;
+            } else if (length != 0 && run >= 4) {
+                symbols.push_back({length, 0});
+                size_t count = std::min<size_t>(run - 1, 6);
+                symbols.push_back({16, static_cast<uint8_t>(count - 3)});
+                i += 1 + count;
+            } else {
+                symbols.push_back({length, 0});
+                i++;
+            }
+        }
+    }
+
+    static int extraBitsOf(uint8_t symbol)
+    {
+        return symbol == 16 ? 2 : symbol == 17 ? 3 : symbol == 18 ? 7 : 0;
+    }
+
+    void flushBlock(bool last)
+    {
+        // 动态哈夫曼码
+        std::vector<uint8_t> literalLengths;
+        std::vector<uint8_t> distanceLengths;
+        buildCodeLengths(literalFrequencies, kMaxCodeBits, literalLengths);
+        buildCodeLengths(distanceFrequencies, kMaxCodeBits, distanceLengths);
+
+        size_t literalCount = 286;
+        while (literalCount > 257 && literalLengths[literalCount - 1] == 0) {
+            literalCount--;
+        }
+        size_t distanceCount = 30;
+        while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) {
+            distanceCount--;
+        }
+
+        std::vector<uint8_t> allLengths(literalLengths.begin(),
+                                        literalLengths.begin() + literalCount);
+        allLengths.insert(allLengths.end(), distanceLengths.begin(),
+                          distanceLengths.begin() + distanceCount);
+        std::vector<CodeLengthSymbol> codeLengthSymbols;
+        encodeCodeLengths(allLengths, codeLengthSymbols);
+
+        std::vector<uint32_t> codeLengthFrequencies(19, 0);
+        for (const auto &symbol : codeLengthSymbols) {
+            codeLengthFrequencies[symbol.symbol]++;
+        }
+        std::vector<uint8_t> codeLengthLengths;
+        buildCodeLengths(codeLengthFrequencies, kMaxCodeLengthBits, codeLengthLengths);
+        size_t codeLengthCount = 19;
+        while (codeLengthCount > 4 &&
+               codeLengthLengths[kCodeLengthOrder[codeLengthCount - 1]] == 0) {
+            codeLengthCount--;
+        }
+
+        uint64_t dynamicBits = 3 + 14 + 3 * codeLengthCount;
+        for (const auto &symbol : codeLengthSymbols) {
+            dynamicBits += codeLengthLengths[symbol.symbol] + extraBitsOf(symbol.symbol);
+        }
+        dynamicBits += tokenBits(literalLengths, distanceLengths);
+
+        // 固定哈夫曼码
+        std::vector<uint8_t> fixedLiteralLengths;
+        std::vector<uint8_t> fixedDistanceLengths;
+        fixedLengths(fixedLiteralLengths, fixedDistanceLengths);
+        uint64_t fixedBits = 3 + tokenBits(fixedLiteralLengths, fixedDistanceLengths);
+
+        // 不压缩：每65535字节一个块，块头对齐到字节后还有4字节长度
+        size_t blockSize = blockEnd - blockStart;
+        size_t storedBlocks =
+            std::max<size_t>(1, (blockSize + kMaxStoredBlock - 1) / kMaxStoredBlock);
+        uint64_t storedBits = storedBlocks * (3 + 7 + 32) + uint64_t(blockSize) * 8;
+
+        if (storedBits <= dynamicBits && storedBits <= fixedBits) {
+            writeStored(blockStart, blockEnd, last);
+        } else if (fixedBits <= dynamicBits) {
+            writer.writeBits(last ? 1 : 0, 1);
+            writer.writeBits(1, 2);
+            writeTokens(fixedLiteralLengths, fixedDistanceLengths);
+        } else {
+            writer.writeBits(last ? 1 : 0, 1);
+            writer.writeBits(2, 2);
+            writer.writeBits(static_cast<uint32_t>(literalCount - 257), 5);
+            writer.writeBits(static_cast<uint32_t>(distanceCount - 1), 5);
+            writer.writeBits(static_cast<uint32_t>(codeLengthCount - 4), 4);
+            for (size_t i = 0; i < codeLengthCount; ++i) {
+                writer.writeBits(codeLengthLengths[kCodeLengthOrder[i]], 3);
+            }
+            std::vector<uint16_t> codeLengthCodes;
+            buildCodes(codeLengthLengths, codeLengthCodes);
+            for (const auto &symbol : codeLengthSymbols) {
+                writer.writeBits(codeLengthCodes[symbol.symbol], codeLengthLengths[symbol.symbol]);
+                int extraBits = extraBitsOf(symbol.symbol);
+                if (extraBits > 0) {
+                    writer.writeBits(symbol.extra, extraBits);
+                }
+            }
+            writeTokens(literalLengths, distanceLengths);
+        }
+
+        tokens.clear();
+        resetFrequencies();
+        blockStart = blockEnd;
+    }
+
+    void writeTokens(const std::vector<uint8_t> &literalLengths,
+                     const std::vector<uint8_t> &distanceLengths)
+    {
+        std::vector<uint16_t> literalCodes;
+        std::vector<uint16_t> distanceCodes;
+        buildCodes(literalLengths, literalCodes);
+        buildCodes(distanceLengths, distanceCodes);
+
+        for (const Token &token : tokens) {
+            if (token.distance == 0) {
+                writer.writeBits(literalCodes[token.length], literalLengths[token.length]);
+                continue;
+            }
+            int lengthIndex = lengthSymbol(token.length);
+            writer.writeBits(literalCodes[257 + lengthIndex], literalLengths[257 + lengthIndex]);
+            if (kLengthExtra[lengthIndex] > 0) {
+                writer.writeBits(token.length - kLengthBase[lengthIndex],
+                                 kLengthExtra[lengthIndex]);
+            }
+            int distanceIndex = distanceSymbol(token.distance);
+            writer.writeBits(distanceCodes[distanceIndex], distanceLengths[distanceIndex]);
+            if (kDistanceExtra[distanceIndex] > 0) {
+                writer.writeBits(token.distance - kDistanceBase[distanceIndex],
+                                 kDistanceExtra[distanceIndex]);
+            }
+        }
+        writer.writeBits(literalCodes[kEndOfBlock], literalLengths[kEndOfBlock]);
+    }
+
+    void writeStored(size_t begin, size_t end, bool last)
+    {
+        do {
+            size_t length = std::min(end - begin, kMaxStoredBlock);
+            bool final = last && begin + length == end;
+            writer.writeBits(final ? 1 : 0, 1);
+            writer.writeBits(0, 2);
+            writer.alignToByte();
+            writer.writeBits(static_cast<uint32_t>(length), 16);
+            writer.writeBits(static_cast<uint32_t>(~length & 0xFFFF), 16);
+            writer.appendBytes(data + begin, length);
+            begin += length;
+        } while (begin < end);
+    }
+
+    const unsigned char *data;
+    const size_t size;
+    const LevelParameters parameters;
+    BitWriter writer;
+
+    std::vector<int64_t> head;      // 每个哈希值最近出现的位置
+    std::vector<int64_t> previous;  // 窗口内每个位置的上一个同哈希位置
+    std::vector<Token> tokens;      // 当前块的符号
+    std::vector<uint32_t> literalFrequencies;
+    std::vector<uint32_t> distanceFrequencies;
+    size_t blockStart = 0;  // 当前块覆盖的输入范围
+    size_t blockEnd = 0;
+};
+
+void appendU32LittleEndian(std::string &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+}  // namespace
+
+void deflateRaw(const char *data, size_t size, int level, std::string &out)
+{
+    DeflateEncoder(data, size, level, out).encode();
+}
+
+std::string gzipCompress(const char *data, size_t size, int level)
+{
+    // 头部：标识、压缩方法8、无标志、无修改时间、操作系统未知
+    std::string out = {'\x1f', '\x8b', '\x08', '\0', '\0', '\0', '\0', '\0', '\0', '\xff'};
+    out.reserve(size / 3 + 32);
+    deflateRaw(data, size, level, out);
+
+    Crc32 crc;
+    crc.update(data, size);
+    appendU32LittleEndian(out, crc.digest());
+    appendU32LittleEndian(out, static_cast<uint32_t>(size));
+    return out;
+}
+
+std::string zlibCompress(const char *data, size_t size, int level)
+{
+    // 头部：窗口32KB的DEFLATE，校验位使头部两字节按大端序可被31整除
+    std::string out = {'\x78', '\x9c'};
+    out.reserve(size / 3 + 16);
+    deflateRaw(data, size, level, out);
+
+    // 尾部为大端序的Adler-32
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t i = 0; i < size;) {
+        size_t chunk = std::min<size_t>(size - i, 5552);  // 保证累加不溢出的最大块长
+        for (size_t end = i + chunk; i < end; ++i) {
+            a += bytes[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int i = 3; i >= 0; --i) {
+        out.push_back(static_cast<char>(adler >> (8 * i)));
+    }
+    return out;
+}
+
+}  // namespace neumann
@@ -189,6 +189,15 @@ void ErrorHandler::initializeErrorMessages()
     errorMessages[ErrorCode::PERMISSION_DENIED] = "error.permission_denied";
     errorSuggestions[ErrorCode::PERMISSION_DENIED] = "suggestion.run_as_admin";
 
+    errorMessages[ErrorCode::OPERATION_CANCELLED] = "error.operation_cancelled";
+    errorSuggestions[ErrorCode::OPERATION_CANCELLED] = "suggestion.retry_operation";
+
+    errorMessages[ErrorCode::OPERATION_TIMEOUT] = "error.operation_timeout";
+    errorSuggestions[ErrorCode::OPERATION_TIMEOUT] = "suggestion.increase_time_limit";
+
+    errorMessages[ErrorCode::SERVICE_BUSY] = "error.service_busy";
+    errorSuggestions[ErrorCode::SERVICE_BUSY] = "suggestion.retry_later";
+
     // 未知错误
     errorMessages[ErrorCode::UNKNOWN_ERROR] = "error.unknown";
     errorSuggestions[ErrorCode::UNKNOWN_ERROR] = "suggestion.contact_support";
@@ -1,27 +1,134 @@
 #include "core/excel_reader.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <chrono>
+#include <charconv>
 #include <cmath>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
-#include <regex>
 #include <sstream>
+#include <thread>
+#include <tuple>
 
+#include "core/biff_reader.h"
+#include "core/compound_file.h"
 #include "core/data_manager.h"
 #include "core/error_handler.h"
 #include "core/i18n.h"
+#include "core/spreadsheet_xml.h"
+#include "core/workbook_cache.h"
+#include "core/zip_archive.h"
 
 namespace fs = std::filesystem;
 
 namespace neumann {
 
+namespace {
+
+const char* const kSharedStringsPath = "xl/sharedStrings.xml";
+
+// 解析共享字符串单元格中的索引
+bool parseSharedStringIndex(const CellEvent& cell, uint32_t& index)
+{
+    if (cell.type != CellType::SHARED_STRING) {
+        return false;
+    }
+    auto result = std::from_chars(cell.value.data(), cell.value.data() + cell.value.size(), index);
+    return result.ec == std::errc() && result.ptr == cell.value.data() + cell.value.size();
+}
+
+// 共享字符串引用取表中的文本，其他单元格或索引无效时保留原始值
+void resolveSharedString(const std::vector<std::string>& sharedStrings, const CellEvent& cell,
+                         std::string& value)
+{
+    uint32_t index = 0;
+    if (parseSharedStringIndex(cell, index) && index < sharedStrings.size()) {
+        value = sharedStrings[index];
+    } else {
+        value.assign(cell.value.data(), cell.value.size());
+    }
+}
+
+// 导入失败时转换为格式错误（在catch块中调用），取消和超时直接向上传递
+[[noreturn]] void rethrowImportError(const std::exception& e)
+{
+    auto neumannError = dynamic_cast<const NeumannException*>(&e);
+    if (neumannError && (neumannError->getErrorCode() == ErrorCode::OPERATION_CANCELLED ||
+                         neumannError->getErrorCode() == ErrorCode::OPERATION_TIMEOUT)) {
+        throw;
+    }
+
+    // 如果Excel解析失败，尝试降级处理
+    auto& i18n = I18n::getInstance();
+    std::string errorMsg = i18n.getText("excel.parse_failed") + ": " + e.what() + "\n" +
+                           i18n.getText("excel.fallback_suggestion");
+    THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, errorMsg);
+}
+
+// 打开xls工作簿，复合文档需要按扇区链随机访问，只能整体读入，因此结果放入工作簿缓存
+std::shared_ptr<const XlsWorkbook> openXlsWorkbook(const std::string& filename)
+{
+    auto& cache = WorkbookCache::getInstance();
+    if (auto workbook = cache.findXls(filename)) {
+        return workbook;
+    }
+
+    auto workbook = std::make_shared<XlsWorkbook>();
+    if (!WorkbookCache::statFile(filename, workbook->fileSize, workbook->modifiedTime)) {
+        THROW_ERROR(ErrorCode::FILE_NOT_FOUND, filename);
+    }
+    CompoundFile file = CompoundFile::openFile(filename);
+
+    // Excel 5.0/95使用名为Book的BIFF5流
+    if (file.findStream("Workbook")) {
+        workbook->stream = file.readStream("Workbook");
+    } else if (file.findStream("Book")) {
+        throw std::runtime_error(
+            "Only BIFF8 (Excel 97-2003) .xls workbooks are supported; please save as .xlsx");
+    } else {
+        throw std::runtime_error("Workbook stream not found in " + filename);
+    }
+    workbook->info = readBiffWorkbook(workbook->stream);
+
+    cache.store(filename, std::shared_ptr<const XlsWorkbook>(workbook));
+    return workbook;
+}
+
+// 查找工作表，未指定名称时使用第一个工作表
+const BiffSheetInfo* findXlsSheet(const BiffWorkbookInfo& info, const std::string& sheetName)
+{
+    for (const auto& sheet : info.sheets) {
+        if (sheetName.empty() || sheet.name == sheetName) {
+            return &sheet;
+        }
+    }
+    return nullptr;
+}
+
+// 列标签（A、B、...、Z、AA、...）
+std::string columnLabel(size_t column)
+{
+    std::string label;
+    for (size_t value = column + 1; value > 0; value = (value - 1) / 26) {
+        label.insert(label.begin(), static_cast<char>('A' + (value - 1) % 26));
+    }
+    return label;
+}
+
+}  // namespace
+
 ExcelReader::ExcelReader() {}
 
 ExcelReader::~ExcelReader() {}
 
+void ExcelReader::setCancellationToken(const CancellationToken& token)
+{
+    cancellationToken = token;
+}
+
 bool ExcelReader::isExcelFile(const std::string& filename)
 {
     fs::path filePath(filename);
@@ -50,10 +157,7 @@ DataSet ExcelReader::importFromExcel(const std::string& filename, const std::str
     } else if (ext == ".xlsx") {
         return importFromXlsx(filename, sheetName, hasHeader);
     } else if (ext == ".xls") {
-        // 对于.xls文件，提示用户转换为.xlsx或.csv
-        THROW_ERROR(
-            ErrorCode::INVALID_DATA_FORMAT,
-            "Legacy Excel format (.xls) is not supported. Please save as .xlsx or .csv format.");
+        return importFromXls(filename, sheetName, hasHeader);
     }
 
     THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "Unsupported file format");
@@ -65,350 +169,516 @@ DataSet ExcelReader::importFromXlsx(const std::string& filename, const std::stri
     DataSet dataSet;
 
     try {
-        // 尝试将xlsx文件作为ZIP文件解压并读取
-        std::string tempDir = extractXlsxToTemp(filename);
+        // xlsx是ZIP归档，只在内存中解压需要的成员
+        auto workbook = openWorkbook(filename);
 
         // 读取共享字符串表
-        auto sharedStrings = readSharedStrings(tempDir + "/xl/sharedStrings.xml");
+        auto sharedStrings = loadSharedStrings(filename, workbook);
 
         // 查找目标工作表
-        std::string worksheetPath = findWorksheet(tempDir, sheetName);
+        std::string worksheetPath = findWorksheet(*workbook, sheetName);
         if (worksheetPath.empty()) {
-            cleanupTempDir(tempDir);
             THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "Worksheet not found: " + sheetName);
         }
 
-        // 读取工作表数据
-        auto rawData = readWorksheetData(worksheetPath, sharedStrings);
-
-        // 清理临时目录
-        cleanupTempDir(tempDir);
-
-        if (rawData.empty()) {
-            THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "No data found in worksheet");
-        }
-
-        // 处理数据
-        dataSet = processWorksheetData(rawData, hasHeader);
+        // 边解压边解析工作表数据
+        const ZipArchive& archive = *workbook->archive;
+        auto readRows = [&](const CellResolver& resolveCell, const RowConsumer& onRow) {
+            return readWorksheetRows(archive, worksheetPath, resolveCell, onRow);
+        };
+        dataSet = processWorksheetData(readRows, *sharedStrings, hasHeader);
 
         // 设置基本信息
         dataSet.name = fs::path(filename).stem().string();
         dataSet.source = filename;
 
-        auto now = std::chrono::system_clock::now();
-        auto timeT = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&timeT), "%Y-%m-%d %H:%M:%S");
-        dataSet.createdAt = ss.str();
+        dataSet.createdAt = DataManager::currentTimestamp();
     }
     catch (const std::exception& e) {
-        // 如果Excel解析失败，尝试降级处理
-        auto& i18n = I18n::getInstance();
-        std::string errorMsg = i18n.getText("excel.parse_failed") + ": " + e.what() + "\n" +
-                               i18n.getText("excel.fallback_suggestion");
-        THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, errorMsg);
+        rethrowImportError(e);
     }
 
     return dataSet;
 }
 
-std::string ExcelReader::extractXlsxToTemp(const std::string& filename)
+std::vector<DataSet> ExcelReader::importAllSeries(const std::string& filename, bool hasHeader,
+                                                  int threadCount)
 {
-    // 创建临时目录
-    std::string tempDir =
-        fs::temp_directory_path().string() + "/neumann_excel_" +
-        std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    if (!fs::exists(filename)) {
+        THROW_ERROR(ErrorCode::FILE_NOT_FOUND, filename);
+    }
 
-    try {
-        fs::create_directories(tempDir);
+    std::string ext = fs::path(filename).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext != ".xlsx" && ext != ".xls") {
+        THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT,
+                    "Multi-series import requires an .xlsx or .xls workbook: " + filename);
+    }
 
-        // 使用系统命令解压ZIP文件（适用于大多数系统）
-        std::string command;
-#ifdef _WIN32
-        // Windows下使用PowerShell解压
-        command = "powershell -Command \"Expand-Archive -Path '" + filename +
-                  "' -DestinationPath '" + tempDir + "' -Force\"";
-#else
-        // Linux/macOS下使用unzip
-        command = "unzip -q '" + filename + "' -d '" + tempDir + "'";
-#endif
+    std::vector<DataSet> dataSets;
+    try {
+        std::string prefix = fs::path(filename).stem().string() + "/";
+        std::vector<std::pair<std::string, RowSource>> sheets;
+
+        if (ext == ".xlsx") {
+            auto workbook = openWorkbook(filename);
+            auto sharedStrings = loadSharedStrings(filename, workbook);
+            const ZipArchive& archive = *workbook->archive;
+            for (const auto& [sheetName, path] : workbook->worksheets) {
+                if (archive.hasEntry(path)) {
+                    sheets.emplace_back(sheetName, [this, &archive, path = path](
+                                                       const CellResolver& resolveCell,
+                                                       const RowConsumer& onRow) {
+                        return readWorksheetRows(archive, path, resolveCell, onRow);
+                    });
+                }
+            }
+            dataSets = decodeAllSeries(sheets, *sharedStrings, prefix, hasHeader, threadCount);
+        } else {
+            auto workbook = openXlsWorkbook(filename);
+            std::string_view stream = workbook->stream;
+            for (const auto& sheet : workbook->info.sheets) {
+                sheets.emplace_back(sheet.name, [this, stream, offset = sheet.offset](
+                                                    const CellResolver& resolveCell,
+                                                    const RowConsumer& onRow) {
+                    return readXlsRows(stream, offset, resolveCell, onRow);
+                });
+            }
+            dataSets = decodeAllSeries(sheets, workbook->info.sharedStrings, prefix, hasHeader,
+                                       threadCount);
+        }
 
-        int result = std::system(command.c_str());
-        if (result != 0) {
-            throw std::runtime_error("Failed to extract xlsx file");
+        std::string createdAt = DataManager::currentTimestamp();
+        for (auto& dataSet : dataSets) {
+            dataSet.source = filename;
+            dataSet.createdAt = createdAt;
         }
 
-        return tempDir;
+        if (dataSets.empty()) {
+            THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "No numeric columns found in workbook");
+        }
     }
     catch (const std::exception& e) {
-        // 清理可能创建的目录
-        try {
-            if (fs::exists(tempDir)) {
-                fs::remove_all(tempDir);
+        rethrowImportError(e);
+    }
+
+    return dataSets;
+}
+
+std::vector<DataSet> ExcelReader::decodeAllSeries(
+    const std::vector<std::pair<std::string, RowSource>>& sheets,
+    const std::vector<std::string>& sharedStrings, const std::string& prefix, bool hasHeader,
+    int threadCount)
+{
+    // 每个线程依次领取下一个工作表，结果按工作表顺序存放
+    std::vector<std::vector<DataSet>> sheetSeries(sheets.size());
+    std::vector<std::exception_ptr> sheetErrors(sheets.size());
+    std::atomic<size_t> nextSheet{0};
+    auto decodeSheets = [&]() {
+        for (size_t index = nextSheet++; index < sheets.size(); index = nextSheet++) {
+            const auto& [sheetName, readRows] = sheets[index];
+            try {
+                sheetSeries[index] = processWorksheetSeries(readRows, sharedStrings, hasHeader);
+                for (auto& dataSet : sheetSeries[index]) {
+                    dataSet.description = sheetName + ": " + dataSet.name;
+                    dataSet.name = prefix + sheetName + "/" + dataSet.name;
+                }
+            }
+            catch (...) {
+                sheetErrors[index] = std::current_exception();
             }
         }
-        catch (...) {
+    };
+
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    size_t workerCount = std::min(static_cast<size_t>(threadCount), sheets.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back(decodeSheets);
+    }
+    decodeSheets();  // 调用线程也参与解码
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<DataSet> dataSets;
+    for (size_t index = 0; index < sheets.size(); ++index) {
+        if (sheetErrors[index]) {
+            std::rethrow_exception(sheetErrors[index]);
+        }
+        for (auto& dataSet : sheetSeries[index]) {
+            dataSets.push_back(std::move(dataSet));
         }
-        throw;
     }
+    return dataSets;
 }
 
-std::vector<std::string> ExcelReader::readSharedStrings(const std::string& filePath)
+std::shared_ptr<const XlsxWorkbook> ExcelReader::openWorkbook(const std::string& filename)
 {
-    std::vector<std::string> sharedStrings;
-
-    if (!fs::exists(filePath)) {
-        return sharedStrings;  // 某些文件可能没有共享字符串
+    auto& cache = WorkbookCache::getInstance();
+    if (auto workbook = cache.find(filename)) {
+        return workbook;
     }
 
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        return sharedStrings;
+    // 先记录文件状态再读取，读取期间文件被修改时下次查找会发现不一致
+    auto workbook = std::make_shared<XlsxWorkbook>();
+    if (!WorkbookCache::statFile(filename, workbook->fileSize, workbook->modifiedTime)) {
+        THROW_ERROR(ErrorCode::FILE_NOT_FOUND, filename);
     }
+    workbook->archive = std::make_shared<const ZipArchive>(ZipArchive::openFile(filename));
+    workbook->worksheets = listWorksheets(*workbook->archive);
 
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-
-    // 简单的XML解析：查找<t>标签内容
-    std::regex tagRegex("<t[^>]*>(.*?)</t>");
-    std::smatch match;
-    std::string::const_iterator searchStart(content.cbegin());
+    cache.store(filename, workbook);
+    return workbook;
+}
 
-    while (std::regex_search(searchStart, content.cend(), match, tagRegex)) {
-        std::string text = match[1];
-        // 解码XML实体
-        text = decodeXmlEntities(text);
-        sharedStrings.push_back(text);
-        searchStart = match.suffix().first;
+std::shared_ptr<const std::vector<std::string>> ExcelReader::loadSharedStrings(
+    const std::string& filename, std::shared_ptr<const XlsxWorkbook>& workbook)
+{
+    if (workbook->sharedStrings) {
+        return workbook->sharedStrings;
     }
 
-    return sharedStrings;
+    // 缓存中的工作簿不可修改，加载后用包含共享字符串的副本替换
+    auto updated = std::make_shared<XlsxWorkbook>(*workbook);
+    updated->sharedStrings =
+        std::make_shared<const std::vector<std::string>>(readSharedStrings(*workbook->archive));
+    WorkbookCache::getInstance().store(filename, updated);
+
+    workbook = updated;
+    return updated->sharedStrings;
 }
 
-std::string ExcelReader::findWorksheet(const std::string& tempDir, const std::string& sheetName)
+void ExcelReader::parseArchiveXml(const ZipArchive& archive, const std::string& name,
+                                  XmlTokenizer& reader)
 {
-    // 如果没有指定工作表名，使用第一个工作表
-    if (sheetName.empty()) {
-        std::string defaultSheet = tempDir + "/xl/worksheets/sheet1.xml";
-        if (fs::exists(defaultSheet)) {
-            return defaultSheet;
-        }
+    bool complete = archive.streamEntry(name, [&](const char* data, size_t size) {
+        cancellationToken.throwIfStopped(name);
+        return reader.feed(data, size);
+    });
+    if (complete) {
+        reader.finish();
     }
+}
 
-    // 读取workbook.xml查找工作表信息
-    std::string workbookPath = tempDir + "/xl/workbook.xml";
-    if (!fs::exists(workbookPath)) {
-        return "";
-    }
+std::vector<std::string> ExcelReader::readSharedStrings(const ZipArchive& archive)
+{
+    std::vector<std::string> sharedStrings;
+    streamSharedStrings(archive, [&sharedStrings](std::string&& text) {
+        sharedStrings.push_back(std::move(text));
+        return true;
+    });
+    return sharedStrings;
+}
 
-    std::ifstream file(workbookPath);
-    if (!file.is_open()) {
-        return "";
+std::map<uint32_t, std::string> ExcelReader::readSharedStrings(const ZipArchive& archive,
+                                                               const std::set<uint32_t>& indices)
+{
+    std::map<uint32_t, std::string> sharedStrings;
+    if (indices.empty()) {
+        return sharedStrings;
     }
 
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-
-    // 查找工作表名称和ID的映射
-    std::regex sheetRegex("<sheet[^>]*name=\"([^\"]*)\"|rId=\"([^\"]*)\"[^>]*>");
-    std::smatch match;
-    std::string::const_iterator searchStart(content.cbegin());
-
-    int sheetIndex = 1;
-    while (std::regex_search(searchStart, content.cend(), match, sheetRegex)) {
-        if (sheetName.empty() || match[1] == sheetName) {
-            // 返回对应的工作表文件路径
-            std::string worksheetPath =
-                tempDir + "/xl/worksheets/sheet" + std::to_string(sheetIndex) + ".xml";
-            if (fs::exists(worksheetPath)) {
-                return worksheetPath;
-            }
+    uint32_t index = 0;
+    const uint32_t lastIndex = *indices.rbegin();
+    streamSharedStrings(archive, [&](std::string&& text) {
+        if (indices.count(index)) {
+            sharedStrings.emplace(index, std::move(text));
         }
-        sheetIndex++;
-        searchStart = match.suffix().first;
+        return index++ < lastIndex;
+    });
+    return sharedStrings;
+}
+
+void ExcelReader::streamSharedStrings(const ZipArchive& archive,
+                                      const std::function<bool(std::string&& text)>& onString)
+{
+    if (!archive.hasEntry(kSharedStringsPath)) {
+        return;  // 某些文件可能没有共享字符串
     }
 
-    return "";
+    SharedStringsXmlReader reader(onString);
+    parseArchiveXml(archive, kSharedStringsPath, reader);
 }
 
-std::vector<std::vector<std::string>> ExcelReader::readWorksheetData(
-    const std::string& worksheetPath, const std::vector<std::string>& sharedStrings)
+std::vector<std::pair<std::string, std::string>> ExcelReader::listWorksheets(
+    const ZipArchive& archive)
 {
-    std::vector<std::vector<std::string>> data;
+    std::vector<std::pair<std::string, std::string>> worksheets;
 
-    std::ifstream file(worksheetPath);
-    if (!file.is_open()) {
-        return data;
+    if (!archive.hasEntry("xl/workbook.xml")) {
+        return worksheets;
     }
 
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
+    // 关系表把工作表的r:id映射到归档中的成员路径
+    std::map<std::string, std::string> targets;
+    if (archive.hasEntry("xl/_rels/workbook.xml.rels")) {
+        RelationshipsXmlReader rels([&targets](std::string&& id, std::string&& target) {
+            // 目标可以是相对xl/目录的路径，也可以是以'/'开头的绝对路径
+            targets[std::move(id)] =
+                (!target.empty() && target[0] == '/') ? target.substr(1) : "xl/" + target;
+            return true;
+        });
+        parseArchiveXml(archive, "xl/_rels/workbook.xml.rels", rels);
+    }
 
-    // 解析行数据
-    std::regex rowRegex("<row[^>]*>(.*?)</row>");
-    std::smatch rowMatch;
-    std::string::const_iterator rowSearchStart(content.cbegin());
+    int sheetIndex = 0;
+    WorkbookXmlReader workbook([&](std::string&& name, std::string&& id) {
+        sheetIndex++;
+        if (name.empty()) {
+            return true;
+        }
 
-    while (std::regex_search(rowSearchStart, content.cend(), rowMatch, rowRegex)) {
-        std::string rowContent = rowMatch[1];
-        std::vector<std::string> rowData = parseCellsInRow(rowContent, sharedStrings);
+        // 没有关系表时按顺序对应sheetN.xml
+        auto target = targets.find(id);
+        std::string path = target != targets.end()
+                               ? target->second
+                               : "xl/worksheets/sheet" + std::to_string(sheetIndex) + ".xml";
+        worksheets.emplace_back(std::move(name), std::move(path));
+        return true;
+    });
+    parseArchiveXml(archive, "xl/workbook.xml", workbook);
+
+    return worksheets;
+}
 
-        if (!rowData.empty()) {
-            data.push_back(rowData);
+std::string ExcelReader::findWorksheet(const XlsxWorkbook& workbook, const std::string& sheetName)
+{
+    const ZipArchive& archive = *workbook.archive;
+    for (const auto& [name, path] : workbook.worksheets) {
+        if ((sheetName.empty() || name == sheetName) && archive.hasEntry(path)) {
+            return path;
         }
+    }
 
-        rowSearchStart = rowMatch.suffix().first;
+    // 如果没有指定工作表名，使用第一个工作表
+    if (sheetName.empty() && archive.hasEntry("xl/worksheets/sheet1.xml")) {
+        return "xl/worksheets/sheet1.xml";
     }
 
-    return data;
+    return "";
 }
 
-std::vector<std::string> ExcelReader::parseCellsInRow(const std::string& rowContent,
-                                                      const std::vector<std::string>& sharedStrings)
+bool ExcelReader::readWorksheetRows(const ZipArchive& archive, const std::string& worksheetPath,
+                                    const CellResolver& resolveCell, const RowConsumer& onRow)
 {
-    std::vector<std::string> rowData;
-
-    // 解析单元格
-    std::regex cellRegex("<c[^>]*>(.*?)</c>");
-    std::smatch cellMatch;
-    std::string::const_iterator cellSearchStart(rowContent.cbegin());
+    std::vector<std::string> row;
 
-    while (std::regex_search(cellSearchStart, rowContent.cend(), cellMatch, cellRegex)) {
-        std::string cellContent = cellMatch[0];  // 完整的cell标签
-        std::string cellValue = extractCellValue(cellContent, sharedStrings);
-        rowData.push_back(cellValue);
-        cellSearchStart = cellMatch.suffix().first;
+    WorksheetXmlReader reader(
+        [&](const CellEvent& cell) {
+            if (cell.column >= row.size()) {
+                row.resize(cell.column + 1);
+            }
+            resolveCell(cell, row[cell.column]);
+            return true;
+        },
+        [&](uint32_t) {
+            if (row.empty()) {
+                return true;
+            }
+            bool keepGoing = onRow(row);
+            row.clear();
+            return keepGoing;
+        });
+
+    bool complete = archive.streamEntry(worksheetPath, [&](const char* data, size_t size) {
+        cancellationToken.throwIfStopped(worksheetPath);
+        return reader.feed(data, size);
+    });
+    if (complete) {
+        reader.finish();
     }
-
-    return rowData;
+    return complete;
 }
 
-std::string ExcelReader::extractCellValue(const std::string& cellXml,
-                                          const std::vector<std::string>& sharedStrings)
+bool ExcelReader::readXlsRows(std::string_view stream, uint32_t offset,
+                              const CellResolver& resolveCell, const RowConsumer& onRow)
 {
-    // 检查单元格类型
-    bool isSharedString = cellXml.find("t=\"s\"") != std::string::npos;
+    std::vector<std::string> row;
+    size_t rowCount = 0;
+
+    return readBiffSheet(
+        stream, offset,
+        [&](const CellEvent& cell) {
+            if (cell.column >= row.size()) {
+                row.resize(cell.column + 1);
+            }
+            resolveCell(cell, row[cell.column]);
+            return true;
+        },
+        [&](uint32_t) {
+            // 记录已在内存中，每读取一批行检查一次取消令牌
+            if (++rowCount % 1024 == 0) {
+                cancellationToken.throwIfStopped("Workbook");
+            }
+            if (row.empty()) {
+                return true;
+            }
+            bool keepGoing = onRow(row);
+            row.clear();
+            return keepGoing;
+        });
+}
 
-    // 提取值
-    std::regex valueRegex("<v>(.*?)</v>");
-    std::smatch valueMatch;
+size_t ExcelReader::readDataRows(const RowSource& readRows,
+                                 const std::vector<std::string>& sharedStrings,
+                                 const LeadingRowsHandler& onLeadingRows,
+                                 const DataRowHandler& onRow)
+{
+    // detectColumnTypes只检查前20行，检测完成前缓存这些行
+    const size_t detectionRows = 20;
+    std::vector<std::vector<std::string>> leadingRows;
+    bool leadingRowsHandled = false;
+    size_t rowCount = 0;
+
+    auto handleLeadingRows = [&]() {
+        onLeadingRows(leadingRows);
+        leadingRowsHandled = true;
+        for (size_t i = 0; i < leadingRows.size(); ++i) {
+            onRow(leadingRows[i], i);
+        }
+        leadingRows.clear();
+    };
 
-    if (std::regex_search(cellXml, valueMatch, valueRegex)) {
-        std::string value = valueMatch[1];
+    auto resolveCell = [&sharedStrings](const CellEvent& cell, std::string& value) {
+        resolveSharedString(sharedStrings, cell, value);
+    };
 
-        if (isSharedString) {
-            // 共享字符串引用
-            try {
-                int index = std::stoi(value);
-                if (index >= 0 && index < static_cast<int>(sharedStrings.size())) {
-                    return sharedStrings[index];
-                }
-            }
-            catch (...) {
-                // 解析失败，返回原始值
+    readRows(resolveCell, [&](const std::vector<std::string>& row) {
+        if (leadingRowsHandled) {
+            onRow(row, rowCount);
+        } else {
+            leadingRows.push_back(row);
+            if (leadingRows.size() == detectionRows) {
+                handleLeadingRows();
             }
         }
+        rowCount++;
+        return true;
+    });
 
-        return value;
+    if (!leadingRowsHandled && rowCount > 0) {
+        handleLeadingRows();
     }
-
-    return "";
+    return rowCount;
 }
 
-DataSet ExcelReader::processWorksheetData(const std::vector<std::vector<std::string>>& rawData,
+DataSet ExcelReader::processWorksheetData(const RowSource& readRows,
+                                          const std::vector<std::string>& sharedStrings,
                                           bool hasHeader)
 {
     DataSet dataSet;
 
-    if (rawData.empty()) {
-        return dataSet;
-    }
-
     // 确定数据开始行
-    size_t dataStartRow = hasHeader ? 1 : 0;
-    if (dataStartRow >= rawData.size()) {
-        THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "No data rows found");
-    }
-
-    // 自动检测时间列和数据列
-    auto [timeCol, dataCol] = detectTimeAndDataColumns(rawData);
-
-    // 提取数据
-    for (size_t row = dataStartRow; row < rawData.size(); ++row) {
-        if (timeCol < static_cast<int>(rawData[row].size()) &&
-            dataCol < static_cast<int>(rawData[row].size())) {
-            double timeValue, dataValue;
+    const size_t dataStartRow = hasHeader ? 1 : 0;
+    int timeCol = 0;
+    int dataCol = 1;
+
+    auto detectColumns = [&](const std::vector<std::vector<std::string>>& leadingRows) {
+        // 自动检测时间列和数据列
+        std::tie(timeCol, dataCol) = detectTimeAndDataColumns(leadingRows);
+    };
+
+    auto appendRow = [&](const std::vector<std::string>& row, size_t rowIndex) {
+        if (rowIndex < dataStartRow || timeCol >= static_cast<int>(row.size()) ||
+            dataCol >= static_cast<int>(row.size())) {
+            return;
+        }
 
-            // 解析时间值
-            if (tryParseDouble(rawData[row][timeCol], timeValue)) {
-                dataSet.timePoints.push_back(timeValue);
-            } else {
-                // 如果时间列解析失败，使用行索引
-                dataSet.timePoints.push_back(static_cast<double>(row - dataStartRow));
-            }
+        double timeValue, dataValue;
 
-            // 解析数据值
-            if (tryParseDouble(rawData[row][dataCol], dataValue)) {
-                dataSet.dataPoints.push_back(dataValue);
-            } else {
-                // 跳过无效的数据行
-                if (!dataSet.timePoints.empty()) {
-                    dataSet.timePoints.pop_back();
-                }
-            }
+        // 解析数据值，跳过无效的数据行
+        if (!tryParseDouble(row[dataCol], dataValue)) {
+            return;
         }
-    }
 
-    // 如果时间点和数据点数量不匹配，生成默认时间点
-    if (dataSet.timePoints.size() != dataSet.dataPoints.size()) {
-        dataSet.timePoints.clear();
-        for (size_t i = 0; i < dataSet.dataPoints.size(); ++i) {
-            dataSet.timePoints.push_back(static_cast<double>(i));
+        // 解析时间值，失败时使用行索引
+        if (!tryParseDouble(row[timeCol], timeValue)) {
+            timeValue = static_cast<double>(rowIndex - dataStartRow);
         }
+
+        dataSet.timePoints.push_back(timeValue);
+        dataSet.dataPoints.push_back(dataValue);
+    };
+
+    size_t rowCount = readDataRows(readRows, sharedStrings, detectColumns, appendRow);
+
+    if (rowCount == 0) {
+        THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "No data found in worksheet");
+    }
+    if (dataStartRow >= rowCount) {
+        THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "No data rows found");
     }
 
     return dataSet;
 }
 
-std::string ExcelReader::decodeXmlEntities(const std::string& text)
+std::vector<DataSet> ExcelReader::processWorksheetSeries(
+    const RowSource& readRows, const std::vector<std::string>& sharedStrings, bool hasHeader)
 {
-    std::string result = text;
-
-    // 常见的XML实体解码
-    std::regex entityRegex("&(amp|lt|gt|quot|apos);");
-    std::smatch match;
+    const size_t dataStartRow = hasHeader ? 1 : 0;
+
+    // 第一个数值列作为时间列，其余数值列各自成为一个数据集；
+    // 只有一个数值列时它就是数据列，时间使用行索引
+    int timeCol = -1;
+    std::vector<size_t> dataColumns;
+    std::vector<DataSet> series;
+
+    auto detectColumns = [&](const std::vector<std::vector<std::string>>& leadingRows) {
+        std::vector<size_t> numericColumns;
+        for (const auto& [col, type] : detectColumnTypes(leadingRows)) {
+            if (type == "Numeric") {
+                numericColumns.push_back(static_cast<size_t>(col));
+            }
+        }
+        if (numericColumns.size() >= 2) {
+            timeCol = static_cast<int>(numericColumns.front());
+            numericColumns.erase(numericColumns.begin());
+        }
+        dataColumns = numericColumns;
+
+        // 数据集名称使用列标题，没有表头时使用列标签
+        series.resize(dataColumns.size());
+        for (size_t i = 0; i < dataColumns.size(); ++i) {
+            size_t col = dataColumns[i];
+            bool titled = hasHeader && !leadingRows.empty() && col < leadingRows[0].size() &&
+                          !leadingRows[0][col].empty();
+            series[i].name = titled ? leadingRows[0][col] : columnLabel(col);
+        }
+    };
 
-    while (std::regex_search(result, match, entityRegex)) {
-        std::string entity = match[1];
-        std::string replacement;
+    auto appendRow = [&](const std::vector<std::string>& row, size_t rowIndex) {
+        if (rowIndex < dataStartRow) {
+            return;
+        }
 
-        if (entity == "amp")
-            replacement = "&";
-        else if (entity == "lt")
-            replacement = "<";
-        else if (entity == "gt")
-            replacement = ">";
-        else if (entity == "quot")
-            replacement = "\"";
-        else if (entity == "apos")
-            replacement = "'";
+        // 解析时间值，失败时使用行索引
+        double timeValue = static_cast<double>(rowIndex - dataStartRow);
+        if (timeCol >= 0 && timeCol < static_cast<int>(row.size())) {
+            double value;
+            if (tryParseDouble(row[timeCol], value)) {
+                timeValue = value;
+            }
+        }
 
-        result = std::regex_replace(result, std::regex("&" + entity + ";"), replacement);
-    }
+        // 每列独立跳过无效的数据值
+        for (size_t i = 0; i < dataColumns.size(); ++i) {
+            double dataValue;
+            if (dataColumns[i] < row.size() && tryParseDouble(row[dataColumns[i]], dataValue)) {
+                series[i].timePoints.push_back(timeValue);
+                series[i].dataPoints.push_back(dataValue);
+            }
+        }
+    };
 
-    return result;
-}
+    readDataRows(readRows, sharedStrings, detectColumns, appendRow);
 
-void ExcelReader::cleanupTempDir(const std::string& tempDir)
-{
-    try {
-        if (fs::exists(tempDir)) {
-            fs::remove_all(tempDir);
-        }
-    }
-    catch (...) {
-        // 忽略清理错误
-    }
+    series.erase(std::remove_if(series.begin(), series.end(),
+                                [](const DataSet& dataSet) { return dataSet.dataPoints.empty(); }),
+                 series.end());
+    return series;
 }
 
 std::vector<std::string> ExcelReader::getSheetNames(const std::string& filename)
@@ -421,6 +691,8 @@ std::vector<std::string> ExcelReader::getSheetNames(const std::string& filename)
         return {"Sheet1"};
     } else if (ext == ".xlsx") {
         return getXlsxSheetNames(filename);
+    } else if (ext == ".xls") {
+        return getXlsSheetNames(filename);
     }
 
     return {};
@@ -431,32 +703,9 @@ std::vector<std::string> ExcelReader::getXlsxSheetNames(const std::string& filen
     std::vector<std::string> sheetNames;
 
     try {
-        std::string tempDir = extractXlsxToTemp(filename);
-
-        // 读取workbook.xml
-        std::string workbookPath = tempDir + "/xl/workbook.xml";
-        if (fs::exists(workbookPath)) {
-            std::ifstream file(workbookPath);
-            if (file.is_open()) {
-                std::string content((std::istreambuf_iterator<char>(file)),
-                                    std::istreambuf_iterator<char>());
-                file.close();
-
-                // 提取工作表名称
-                std::regex sheetRegex("<sheet[^>]*name=\"([^\"]*)\"|[^>]*>");
-                std::smatch match;
-                std::string::const_iterator searchStart(content.cbegin());
-
-                while (std::regex_search(searchStart, content.cend(), match, sheetRegex)) {
-                    if (match[1].matched) {
-                        sheetNames.push_back(match[1]);
-                    }
-                    searchStart = match.suffix().first;
-                }
-            }
+        for (const auto& worksheet : openWorkbook(filename)->worksheets) {
+            sheetNames.push_back(worksheet.first);
         }
-
-        cleanupTempDir(tempDir);
     }
     catch (...) {
         // 如果解析失败，返回默认名称
@@ -466,6 +715,51 @@ std::vector<std::string> ExcelReader::getXlsxSheetNames(const std::string& filen
     return sheetNames;
 }
 
+DataSet ExcelReader::importFromXls(const std::string& filename, const std::string& sheetName,
+                                   bool hasHeader)
+{
+    DataSet dataSet;
+
+    try {
+        auto workbook = openXlsWorkbook(filename);
+        const BiffSheetInfo* sheet = findXlsSheet(workbook->info, sheetName);
+        if (!sheet) {
+            THROW_ERROR(ErrorCode::INVALID_DATA_FORMAT, "Worksheet not found: " + sheetName);
+        }
+
+        auto readRows = [&](const CellResolver& resolveCell, const RowConsumer& onRow) {
+            return readXlsRows(workbook->stream, sheet->offset, resolveCell, onRow);
+        };
+        dataSet = processWorksheetData(readRows, workbook->info.sharedStrings, hasHeader);
+
+        dataSet.name = fs::path(filename).stem().string();
+        dataSet.source = filename;
+        dataSet.createdAt = DataManager::currentTimestamp();
+    }
+    catch (const std::exception& e) {
+        rethrowImportError(e);
+    }
+
+    return dataSet;
+}
+
+std::vector<std::string> ExcelReader::getXlsSheetNames(const std::string& filename)
+{
+    std::vector<std::string> sheetNames;
+
+    try {
+        for (const auto& sheet : openXlsWorkbook(filename)->info.sheets) {
+            sheetNames.push_back(sheet.name);
+        }
+    }
+    catch (...) {
+        // 与xlsx一致，解析失败时返回默认名称
+        sheetNames.push_back("Sheet1");
+    }
+
+    return sheetNames;
+}
+
 std::vector<std::vector<std::string>> ExcelReader::previewExcelData(const std::string& filename,
                                                                     const std::string& sheetName,
                                                                     int maxRows)
@@ -484,6 +778,8 @@ std::vector<std::vector<std::string>> ExcelReader::previewExcelData(const std::s
         return previewCsvData(filename, maxRows);
     } else if (ext == ".xlsx") {
         return previewXlsxData(filename, sheetName, maxRows);
+    } else if (ext == ".xls") {
+        return previewXlsData(filename, sheetName, maxRows);
     }
 
     return preview;
@@ -529,25 +825,60 @@ std::vector<std::vector<std::string>> ExcelReader::previewXlsxData(const std::st
                                                                    const std::string& sheetName,
                                                                    int maxRows)
 {
+    if (maxRows <= 0) {
+        return {};
+    }
+
     try {
-        std::string tempDir = extractXlsxToTemp(filename);
-        auto sharedStrings = readSharedStrings(tempDir + "/xl/sharedStrings.xml");
-        std::string worksheetPath = findWorksheet(tempDir, sheetName);
+        auto workbook = openWorkbook(filename);
+        const ZipArchive& archive = *workbook->archive;
+        std::string worksheetPath = findWorksheet(*workbook, sheetName);
 
         if (!worksheetPath.empty()) {
-            auto fullData = readWorksheetData(worksheetPath, sharedStrings);
-            cleanupTempDir(tempDir);
-
-            // 限制返回行数
+            // 共享字符串表已在缓存中时直接使用；否则先读取预览行，
+            // 共享字符串单元格暂时保留索引并记录位置
+            struct SharedStringCell {
+                size_t row;
+                size_t column;
+                uint32_t index;
+            };
+            std::vector<SharedStringCell> sharedStringCells;
+            std::set<uint32_t> indices;
             std::vector<std::vector<std::string>> preview;
-            int count = std::min(maxRows, static_cast<int>(fullData.size()));
-            for (int i = 0; i < count; ++i) {
-                preview.push_back(fullData[i]);
+
+            const auto* cachedStrings = workbook->sharedStrings.get();
+
+            auto resolveCell = [&](const CellEvent& cell, std::string& value) {
+                uint32_t index = 0;
+                if (!parseSharedStringIndex(cell, index)) {
+                    value.assign(cell.value.data(), cell.value.size());
+                } else if (cachedStrings) {
+                    value = index < cachedStrings->size()
+                                ? (*cachedStrings)[index]
+                                : std::string(cell.value.data(), cell.value.size());
+                } else {
+                    value.assign(cell.value.data(), cell.value.size());
+                    sharedStringCells.push_back({preview.size(), cell.column, index});
+                    indices.insert(index);
+                }
+            };
+
+            // 读够行数后停止解压和解析
+            readWorksheetRows(archive, worksheetPath, resolveCell,
+                              [&](const std::vector<std::string>& row) {
+                                  preview.push_back(row);
+                                  return static_cast<int>(preview.size()) < maxRows;
+                              });
+
+            auto sharedStrings = readSharedStrings(archive, indices);
+            for (const auto& cell : sharedStringCells) {
+                auto it = sharedStrings.find(cell.index);
+                if (it != sharedStrings.end()) {
+                    preview[cell.row][cell.column] = it->second;
+                }
             }
             return preview;
         }
-
-        cleanupTempDir(tempDir);
     }
     catch (...) {
         // 预览失败时返回空数据
@@ -556,6 +887,42 @@ std::vector<std::vector<std::string>> ExcelReader::previewXlsxData(const std::st
     return {};
 }
 
+std::vector<std::vector<std::string>> ExcelReader::previewXlsData(const std::string& filename,
+                                                                  const std::string& sheetName,
+                                                                  int maxRows)
+{
+    std::vector<std::vector<std::string>> preview;
+    if (maxRows <= 0) {
+        return preview;
+    }
+
+    try {
+        // 共享字符串表位于工作表之前的全局子流中，打开工作簿时已经读取
+        auto workbook = openXlsWorkbook(filename);
+        const BiffSheetInfo* sheet = findXlsSheet(workbook->info, sheetName);
+        if (!sheet) {
+            return preview;
+        }
+
+        const auto& sharedStrings = workbook->info.sharedStrings;
+        auto resolveCell = [&sharedStrings](const CellEvent& cell, std::string& value) {
+            resolveSharedString(sharedStrings, cell, value);
+        };
+
+        readXlsRows(workbook->stream, sheet->offset, resolveCell,
+                    [&](const std::vector<std::string>& row) {
+                        preview.push_back(row);
+                        return static_cast<int>(preview.size()) < maxRows;
+                    });
+    }
+    catch (...) {
+        // 预览失败时返回空数据
+        preview.clear();
+    }
+
+    return preview;
+}
+
 std::map<int, std::string> ExcelReader::detectColumnTypes(
     const std::vector<std::vector<std::string>>& data)
 {
@@ -672,29 +1039,8 @@ std::pair<int, int> ExcelReader::detectTimeAndDataColumns(
 
 bool ExcelReader::tryParseDouble(const std::string& str, double& result)
 {
-    if (str.empty()) {
-        return false;
-    }
-
-    // 去除空格
-    std::string cleanStr = str;
-    cleanStr.erase(0, cleanStr.find_first_not_of(" \t\r\n"));
-    cleanStr.erase(cleanStr.find_last_not_of(" \t\r\n") + 1);
-
-    if (cleanStr.empty()) {
-        return false;
-    }
-
-    try {
-        size_t pos;
-        result = std::stod(cleanStr, &pos);
-
-        // 确保整个字符串都被解析
-        return pos == cleanStr.length();
-    }
-    catch (...) {
-        return false;
-    }
+    // 与区域设置无关，允许首尾空白，要求整个字符串都被解析
+    return parseCellNumber(str, result);
 }
 
 }  // namespace neumann
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include "core/file_discovery.h"
+
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+// 匹配方括号字符类，成功时将p移动到']'之后
+bool matchCharClass(const char *&p, char c)
+{
+    const char *cursor = p + 1;
+    bool negate = false;
+    if (*cursor == '!' || *cursor == '^') {
+        negate = true;
+        ++cursor;
+    }
+
+    bool matched = false;
+    bool first = true;
+    while (*cursor && (first || *cursor != ']')) {
+        first = false;
+        if (cursor[1] == '-' && cursor[2] && cursor[2] != ']') {
+            if (c >= cursor[0] && c <= cursor[2]) {
+                matched = true;
+            }
+            cursor += 3;
+        } else {
+            if (c == *cursor) {
+                matched = true;
+            }
+            ++cursor;
+        }
+    }
+
+    if (*cursor != ']') {
+        // 没有闭合的方括号，按普通字符处理
+        if (c != '[') {
+            return false;
+        }
+        ++p;
+        return true;
+    }
+
+    p = cursor + 1;
+    return matched != negate;
+}
+
+bool matchGlobAt(const char *p, const char *s)
+{
+    while (*p) {
+        if (p[0] == '*' && p[1] == '*') {
+            // '**'匹配任意层级的路径，"**/"也可以匹配零层目录
+            const char *rest = p + 2;
+            if (*rest == '/' && matchGlobAt(rest + 1, s)) {
+                return true;
+            }
+            for (const char *t = s;; ++t) {
+                if (matchGlobAt(rest, t)) {
+                    return true;
+                }
+                if (!*t) {
+                    return false;
+                }
+            }
+        }
+
+        if (*p == '*') {
+            // '*'匹配单层路径内的任意字符
+            ++p;
+            for (const char *t = s;; ++t) {
+                if (matchGlobAt(p, t)) {
+                    return true;
+                }
+                if (!*t || *t == '/') {
+                    return false;
+                }
+            }
+        }
+
+        if (!*s) {
+            return false;
+        }
+
+        if (*p == '?') {
+            if (*s == '/') {
+                return false;
+            }
+            ++p;
+        } else if (*p == '[') {
+            if (*s == '/' || !matchCharClass(p, *s)) {
+                return false;
+            }
+        } else {
+            if (*p != *s) {
+                return false;
+            }
+            ++p;
+        }
+        ++s;
+    }
+
+    return *s == '\0';
+}
+
+std::string joinRelative(const std::string &parent, const std::string &name)
+{
+    return parent.empty() ? name : parent + "/" + name;
+}
+
+}  // namespace
+
+FileDiscovery::FileDiscovery(const std::string &rootDirectory, const FileDiscoveryOptions &options,
+                             FileFilter fileFilter)
+    : options(options), fileFilter(std::move(fileFilter)), discoveredCount(0)
+{
+    std::error_code ec;
+    if (!fs::is_directory(rootDirectory, ec)) {
+        return;
+    }
+
+    if (options.symlinkPolicy == SymlinkPolicy::FOLLOW_ALL) {
+        visitedDirectories.insert(fs::canonical(rootDirectory, ec).string());
+    }
+    pushDirectory(rootDirectory, "", 0);
+}
+
+bool FileDiscovery::next(std::string &filePath)
+{
+    while (!stack.empty()) {
+        fs::directory_entry entry;
+        if (!nextEntry(stack.back(), entry)) {
+            stack.pop_back();
+            continue;
+        }
+
+        const DirectoryFrame &frame = stack.back();
+        std::string relativePath =
+            joinRelative(frame.relativePath, entry.path().filename().generic_string());
+        // 排序时条目在缓存前已经过滤
+        if (!options.sortEntries && !isCandidate(entry, relativePath, frame.depth)) {
+            continue;
+        }
+
+        std::error_code ec;
+        if (entry.is_directory(ec)) {
+            int childDepth = frame.depth + 1;
+            if (options.symlinkPolicy == SymlinkPolicy::FOLLOW_ALL) {
+                // 跟随目录链接时可能形成环路，已访问过的目录不再进入
+                std::string canonicalPath = fs::canonical(entry.path(), ec).string();
+                if (ec || !visitedDirectories.insert(canonicalPath).second) {
+                    continue;
+                }
+            }
+
+            fs::path directory = entry.path();
+            pushDirectory(directory, relativePath, childDepth);
+            continue;
+        }
+
+        std::string candidate = entry.path().string();
+        if (fileFilter && !fileFilter(candidate)) {
+            continue;
+        }
+
+        filePath = std::move(candidate);
+        discoveredCount++;
+        return true;
+    }
+
+    return false;
+}
+
+size_t FileDiscovery::getDiscoveredCount() const
+{
+    return discoveredCount;
+}
+
+bool FileDiscovery::resolveUnderRoot(const std::string &rootDirectory, const std::string &path,
+                                     std::string &resolvedPath)
+{
+    std::error_code ec;
+    fs::path root = fs::weakly_canonical(fs::absolute(rootDirectory, ec), ec);
+    if (ec || path.empty()) {
+        return false;
+    }
+    fs::path candidate = fs::weakly_canonical(root / path, ec);
+    if (ec) {
+        return false;
+    }
+
+    // 逐段比较，避免"/data"误把"/database"当作子路径
+    auto mismatch = std::mismatch(root.begin(), root.end(), candidate.begin(), candidate.end());
+    if (mismatch.first != root.end()) {
+        return false;
+    }
+    resolvedPath = candidate.string();
+    return true;
+}
+
+bool FileDiscovery::matchGlob(const std::string &pattern, const std::string &path)
+{
+    return matchGlobAt(pattern.c_str(), path.c_str());
+}
+
+void FileDiscovery::pushDirectory(const fs::path &directory, const std::string &relativePath,
+                                  int depth)
+{
+    std::error_code ec;
+    fs::directory_iterator iterator(directory, fs::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        return;  // 无法访问的目录直接跳过
+    }
+
+    DirectoryFrame frame;
+    frame.relativePath = relativePath;
+    frame.depth = depth;
+    frame.position = 0;
+
+    if (options.sortEntries) {
+        // 只缓存并排序当前目录中通过过滤的条目，保证结果顺序稳定且内存不随整棵目录树增长
+        while (iterator != fs::directory_iterator()) {
+            const fs::directory_entry &entry = *iterator;
+            if (isCandidate(entry,
+                            joinRelative(relativePath, entry.path().filename().generic_string()),
+                            depth)) {
+                frame.entries.push_back(entry);
+            }
+            iterator.increment(ec);
+            if (ec) {
+                break;
+            }
+        }
+        std::sort(frame.entries.begin(), frame.entries.end(),
+                  [](const fs::directory_entry &a, const fs::directory_entry &b) {
+                      return a.path().filename() < b.path().filename();
+                  });
+    } else {
+        frame.iterator = std::move(iterator);
+    }
+
+    stack.push_back(std::move(frame));
+}
+
+bool FileDiscovery::nextEntry(DirectoryFrame &frame, fs::directory_entry &entry)
+{
+    if (options.sortEntries) {
+        if (frame.position >= frame.entries.size()) {
+            return false;
+        }
+        entry = frame.entries[frame.position++];
+        return true;
+    }
+
+    if (frame.iterator == fs::directory_iterator()) {
+        return false;
+    }
+
+    entry = *frame.iterator;
+    std::error_code ec;
+    frame.iterator.increment(ec);
+    if (ec) {
+        frame.iterator = fs::directory_iterator();
+    }
+    return true;
+}
+
+bool FileDiscovery::isCandidate(const fs::directory_entry &entry, const std::string &relativePath,
+                                int depth) const
+{
+    std::error_code ec;
+    bool isSymlink = entry.is_symlink(ec);
+    if (isSymlink && options.symlinkPolicy == SymlinkPolicy::SKIP) {
+        return false;
+    }
+
+    if (entry.is_directory(ec)) {
+        int childDepth = depth + 1;
+        if (!options.recursive || (options.maxDepth >= 0 && childDepth > options.maxDepth)) {
+            return false;
+        }
+        if (isSymlink && options.symlinkPolicy != SymlinkPolicy::FOLLOW_ALL) {
+            return false;
+        }
+        return !matchesAny(options.excludePatterns, relativePath);
+    }
+
+    if (!entry.is_regular_file(ec)) {
+        return false;
+    }
+    if (!options.includePatterns.empty() && !matchesAny(options.includePatterns, relativePath)) {
+        return false;
+    }
+    return !matchesAny(options.excludePatterns, relativePath);
+}
+
+bool FileDiscovery::matchesAny(const std::vector<std::string> &patterns,
+                               const std::string &relativePath)
+{
+    if (patterns.empty()) {
+        return false;
+    }
+
+    size_t slash = relativePath.find_last_of('/');
+    std::string name = slash == std::string::npos ? relativePath : relativePath.substr(slash + 1);
+
+    for (const auto &pattern : patterns) {
+        // 不含'/'的模式只匹配名称，其余模式匹配完整的相对路径
+        if (pattern.find('/') == std::string::npos) {
+            if (matchGlob(pattern, name)) {
+                return true;
+            }
+        } else {
+            std::string normalized = pattern;
+            if (normalized.compare(0, 2, "./") == 0) {
+                normalized.erase(0, 2);
+            } else if (!normalized.empty() && normalized[0] == '/') {
+                normalized.erase(0, 1);
+            }
+            if (matchGlob(normalized, relativePath)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+}  // namespace neumann
@@ -0,0 +1,71 @@
+#include "core/http_header.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace neumann {
+
+namespace {
+
+std::string trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+std::string toLowerAscii(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return text;
+}
+
+std::vector<std::string> splitHeaderList(const std::string &header)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= header.size()) {
+        size_t end = header.find(',', start);
+        if (end == std::string::npos) {
+            end = header.size();
+        }
+        std::string item = trim(header.substr(start, end - start));
+        if (!item.empty()) {
+            items.push_back(std::move(item));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+std::vector<QualityItem> parseQualityList(const std::string &header)
+{
+    std::vector<QualityItem> items;
+    for (const auto &item : splitHeaderList(header)) {
+        size_t semicolon = item.find(';');
+        QualityItem parsed;
+        parsed.value = toLowerAscii(trim(item.substr(0, semicolon)));
+        while (semicolon != std::string::npos) {
+            size_t next = item.find(';', semicolon + 1);
+            std::string parameter = trim(item.substr(semicolon + 1, next - semicolon - 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') &&
+                parameter[1] == '=') {
+                parsed.quality = std::strtod(parameter.c_str() + 2, nullptr);
+            }
+            semicolon = next;
+        }
+        if (!parsed.value.empty()) {
+            items.push_back(std::move(parsed));
+        }
+    }
+    return items;
+}
+
+}  // namespace neumann
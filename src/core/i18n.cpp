@@ -9,9 +9,12 @@ using json = nlohmann::json;
 
 namespace neumann {
 
-I18n::I18n() : currentLanguage(Language::CHINESE)
+I18n::I18n() : currentLanguage(Language::CHINESE), tables(nullptr)
 {
-    initializeBuiltinTranslations();
+    auto builtin = std::make_unique<TranslationTables>();
+    initializeBuiltinTranslations(*builtin);
+    tables.store(builtin.get(), std::memory_order_release);
+    snapshots.push_back(std::move(builtin));
 }
 
 I18n &I18n::getInstance()
@@ -32,8 +35,15 @@ Language I18n::getCurrentLanguage() const
 
 std::string I18n::getText(const std::string &key) const
 {
-    auto langIt = translations.find(currentLanguage);
-    if (langIt != translations.end()) {
+    return getText(key, currentLanguage.load());
+}
+
+std::string I18n::getText(const std::string &key, Language lang) const
+{
+    const TranslationTables *translations = tables.load(std::memory_order_acquire);
+
+    auto langIt = translations->find(lang);
+    if (langIt != translations->end()) {
         auto textIt = langIt->second.find(key);
         if (textIt != langIt->second.end()) {
             return textIt->second;
@@ -41,9 +51,9 @@ std::string I18n::getText(const std::string &key) const
     }
 
     // 如果当前语言没有找到，尝试英文作为后备
-    if (currentLanguage != Language::ENGLISH) {
-        auto englishIt = translations.find(Language::ENGLISH);
-        if (englishIt != translations.end()) {
+    if (lang != Language::ENGLISH) {
+        auto englishIt = translations->find(Language::ENGLISH);
+        if (englishIt != translations->end()) {
             auto textIt = englishIt->second.find(key);
             if (textIt != englishIt->second.end()) {
                 return textIt->second;
@@ -54,7 +64,7 @@ std::string I18n::getText(const std::string &key) const
 // 如果都没找到，输出调试信息（仅在调试模式下）
 #ifdef DEBUG
     std::cerr << "Translation not found for key: " << key
-              << ", current language: " << static_cast<int>(currentLanguage) << std::endl;
+              << ", language: " << static_cast<int>(lang) << std::endl;
 #endif
 
     // 如果都没找到，返回键本身
@@ -105,15 +115,22 @@ bool I18n::loadTranslations(const std::string &filename)
         json data;
         file >> data;
 
-        // 解析翻译数据
+        // 在当前翻译表的副本上合并，全部解析成功后再替换
+        std::lock_guard<std::mutex> lock(loadMutex);
+        auto translations =
+            std::make_unique<TranslationTables>(*tables.load(std::memory_order_acquire));
         for (auto &langItem : data.items()) {
             Language lang = stringToLanguage(langItem.key());
 
             for (auto &textItem : langItem.value().items()) {
-                translations[lang][textItem.key()] = textItem.value().get<std::string>();
+                (*translations)[lang][textItem.key()] = textItem.value().get<std::string>();
             }
         }
 
+        // 先保存所有权再发布，保存失败时当前表保持不变
+        const TranslationTables *snapshot = translations.get();
+        snapshots.push_back(std::move(translations));
+        tables.store(snapshot, std::memory_order_release);
         return true;
     }
     catch (const std::exception &e) {
@@ -147,7 +164,7 @@ Language I18n::stringToLanguage(const std::string &str)
     return Language::CHINESE;  // 默认中文
 }
 
-void I18n::initializeBuiltinTranslations()
+void I18n::initializeBuiltinTranslations(TranslationTables &translations)
 {
     // 中文翻译
     auto &zh = translations[Language::CHINESE];
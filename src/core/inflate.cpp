@@ -0,0 +1,397 @@
+#include "core/inflate.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace neumann {
+
+namespace {
+
+const int kMaxCodeBits = 15;           // DEFLATE哈夫曼码的最大长度
+const int kFastBits = 10;              // 查表解码的位数，更长的码逐位解码
+const size_t kWindowSize = 32 * 1024;  // 回溯距离上限
+const size_t kFlushSize = 64 * 1024;   // 超过窗口后每积累这么多输出交给回调一次
+
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385,
+                                    24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0,  8, 7,  9, 6,  10, 5,
+                                      11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+[[noreturn]] void corrupt(const char *message)
+{
+    throw std::runtime_error(std::string("Corrupt deflate data: ") + message);
+}
+
+// 规范哈夫曼码表：短码查表，长码按码长逐位比较
+struct HuffmanTable {
+    uint16_t count[kMaxCodeBits + 1] = {};  // 各码长的符号数
+    uint16_t symbol[288] = {};              // 按码排序的符号
+    uint16_t fast[1 << kFastBits] = {};     // (码长 << 9) | 符号，0表示需要逐位解码
+
+    void build(const uint8_t *lengths, int symbolCount)
+    {
+        std::fill(std::begin(count), std::end(count), uint16_t(0));
+        std::fill(std::begin(fast), std::end(fast), uint16_t(0));
+        for (int i = 0; i < symbolCount; ++i) {
+            count[lengths[i]]++;
+        }
+        count[0] = 0;
+
+        // 码字过多（超额订阅）的码表无法解码
+        int left = 1;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            left <<= 1;
+            left -= count[len];
+            if (left < 0) {
+                corrupt("over-subscribed code");
+            }
+        }
+
+        uint16_t offsets[kMaxCodeBits + 1] = {};
+        for (int len = 1; len < kMaxCodeBits; ++len) {
+            offsets[len + 1] = offsets[len] + count[len];
+        }
+        for (int i = 0; i < symbolCount; ++i) {
+            if (lengths[i] != 0) {
+                symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+
+        // 码字按最高位在前定义，比特流从最低位读取，查表下标需要反转
+        int code = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            for (int i = 0; i < count[len]; ++i, ++code, ++index) {
+                if (len > kFastBits) {
+                    continue;
+                }
+                int reversed = 0;
+                for (int bit = 0; bit < len; ++bit) {
+                    reversed |= ((code >> bit) & 1) << (len - 1 - bit);
+                }
+                uint16_t entry = static_cast<uint16_t>((len << 9) | symbol[index]);
+                for (int slot = reversed; slot < (1 << kFastBits); slot += 1 << len) {
+                    fast[slot] = entry;
+                }
+            }
+            code <<= 1;
+        }
+    }
+};
+
+class InflateState
+{
+public:
+    InflateState(const unsigned char *data, size_t size, const InflateSource *source,
+                 uint64_t maxOutput, const InflateConsumer &consumer)
+        : input(data), inputSize(size), source(source), maxOutput(maxOutput), consumer(consumer)
+    {
+        output.reserve(kWindowSize + kFlushSize + 258);
+    }
+
+    bool run()
+    {
+        bool lastBlock = false;
+        while (!lastBlock) {
+            lastBlock = getBits(1) != 0;
+            switch (getBits(2)) {
+                case 0:
+                    storedBlock();
+                    break;
+                case 1:
+                    fixedBlock();
+                    break;
+                case 2:
+                    dynamicBlock();
+                    break;
+                default:
+                    corrupt("invalid block type");
+            }
+            if (stopped) {
+                return false;
+            }
+        }
+        return flush(0);
+    }
+
+private:
+    void refill()
+    {
+        while (bitCount <= 56) {
+            uint64_t byte = 0;
+            if (inputPos < inputSize || nextInput()) {
+                byte = input[inputPos++];
+            } else {
+                paddingBits += 8;  // 输入末尾补零，真正读到补零位时报告截断
+            }
+            bitBuffer |= byte << bitCount;
+            bitCount += 8;
+        }
+    }
+
+    // 当前输入段用完后从source读取下一段
+    bool nextInput()
+    {
+        if (!source) {
+            return false;
+        }
+        inputPos = 0;
+        inputSize = (*source)(input);
+        if (inputSize == 0) {
+            source = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    void consume(int bits)
+    {
+        bitBuffer >>= bits;
+        bitCount -= bits;
+        if (bitCount < paddingBits) {
+            corrupt("unexpected end of stream");
+        }
+    }
+
+    uint32_t getBits(int bits)
+    {
+        if (bitCount < bits) {
+            refill();
+        }
+        uint32_t value = static_cast<uint32_t>(bitBuffer & ((uint64_t(1) << bits) - 1));
+        consume(bits);
+        return value;
+    }
+
+    int decode(const HuffmanTable &table)
+    {
+        if (bitCount < kMaxCodeBits) {
+            refill();
+        }
+
+        uint16_t entry = table.fast[bitBuffer & ((1u << kFastBits) - 1)];
+        if (entry != 0) {
+            consume(entry >> 9);
+            return entry & 0x1FF;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxCodeBits; ++len) {
+            code |= static_cast<int>((bitBuffer >> (len - 1)) & 1);
+            int count = table.count[len];
+            if (code - first < count) {
+                consume(len);
+                return table.symbol[index + (code - first)];
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        corrupt("invalid Huffman code");
+    }
+
+    void put(unsigned char byte)
+    {
+        output.push_back(byte);
+        produced++;
+    }
+
+    // 把输出交给回调，只保留最后keep个字节
+    bool flush(size_t keep)
+    {
+        size_t ready = output.size() - keep;
+        if (ready > 0) {
+            if (!consumer(reinterpret_cast<const char *>(output.data()), ready)) {
+                stopped = true;
+                return false;
+            }
+            output.erase(output.begin(), output.begin() + static_cast<std::ptrdiff_t>(ready));
+        }
+        return true;
+    }
+
+    void checkOutput()
+    {
+        if (produced > maxOutput) {
+            corrupt("output exceeds declared size");
+        }
+        if (output.size() >= kWindowSize + kFlushSize) {
+            flush(kWindowSize);
+        }
+    }
+
+    void storedBlock()
+    {
+        // 丢弃到字节边界
+        consume(bitCount & 7);
+        uint32_t length = getBits(16);
+        uint32_t complement = getBits(16);
+        if ((length ^ 0xFFFFu) != complement) {
+            corrupt("stored block length mismatch");
+        }
+        for (uint32_t i = 0; i < length && !stopped; ++i) {
+            put(static_cast<unsigned char>(getBits(8)));
+            checkOutput();
+        }
+    }
+
+    void fixedBlock()
+    {
+        static const HuffmanTable *tables = []() {
+            static HuffmanTable fixed[2];
+            uint8_t lengths[288];
+            for (int i = 0; i < 288; ++i) {
+                lengths[i] = i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8));
+            }
+            fixed[0].build(lengths, 288);
+            for (int i = 0; i < 30; ++i) {
+                lengths[i] = 5;
+            }
+            fixed[1].build(lengths, 30);
+            return fixed;
+        }();
+        codes(tables[0], tables[1]);
+    }
+
+    void dynamicBlock()
+    {
+        int literalCount = static_cast<int>(getBits(5)) + 257;
+        int distanceCount = static_cast<int>(getBits(5)) + 1;
+        int codeLengthCount = static_cast<int>(getBits(4)) + 4;
+        if (literalCount > 286 || distanceCount > 30) {
+            corrupt("too many codes");
+        }
+
+        uint8_t lengths[320] = {};
+        for (int i = 0; i < codeLengthCount; ++i) {
+            lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(getBits(3));
+        }
+        HuffmanTable codeLengthTable;
+        codeLengthTable.build(lengths, 19);
+
+        // 字面量/长度码与距离码的码长连续编码
+        int total = literalCount + distanceCount;
+        int index = 0;
+        std::fill(std::begin(lengths), std::end(lengths), uint8_t(0));
+        while (index < total) {
+            int symbol = decode(codeLengthTable);
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            int repeat = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    corrupt("repeat without previous length");
+                }
+                value = lengths[index - 1];
+                repeat = 3 + static_cast<int>(getBits(2));
+            } else if (symbol == 17) {
+                repeat = 3 + static_cast<int>(getBits(3));
+            } else {
+                repeat = 11 + static_cast<int>(getBits(7));
+            }
+            if (index + repeat > total) {
+                corrupt("too many lengths");
+            }
+            while (repeat-- > 0) {
+                lengths[index++] = value;
+            }
+        }
+
+        if (lengths[256] == 0) {
+            corrupt("missing end-of-block code");
+        }
+
+        HuffmanTable literalTable;
+        HuffmanTable distanceTable;
+        literalTable.build(lengths, literalCount);
+        distanceTable.build(lengths + literalCount, distanceCount);
+        codes(literalTable, distanceTable);
+    }
+
+    void codes(const HuffmanTable &literalTable, const HuffmanTable &distanceTable)
+    {
+        while (!stopped) {
+            int symbol = decode(literalTable);
+            if (symbol < 256) {
+                put(static_cast<unsigned char>(symbol));
+                checkOutput();
+                continue;
+            }
+            if (symbol == 256) {
+                return;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                corrupt("invalid length symbol");
+            }
+            size_t length = kLengthBase[symbol] + getBits(kLengthExtra[symbol]);
+
+            int distanceSymbol = decode(distanceTable);
+            if (distanceSymbol >= 30) {
+                corrupt("invalid distance symbol");
+            }
+            size_t distance =
+                kDistanceBase[distanceSymbol] + getBits(kDistanceExtra[distanceSymbol]);
+            if (distance > output.size()) {
+                corrupt("distance too far back");
+            }
+
+            // 源区间可能与目标重叠（重复模式），必须逐字节复制
+            size_t from = output.size() - distance;
+            for (size_t i = 0; i < length; ++i) {
+                output.push_back(output[from + i]);
+            }
+            produced += length;
+            checkOutput();
+        }
+    }
+
+    const unsigned char *input;
+    size_t inputSize;
+    size_t inputPos = 0;
+    const InflateSource *source;  // 为空时输入只有input
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+    int paddingBits = 0;
+
+    uint64_t maxOutput;
+    uint64_t produced = 0;
+    const InflateConsumer &consumer;
+    std::vector<unsigned char> output;  // 最近的输出，至少保留一个窗口供回溯
+    bool stopped = false;
+};
+
+}  // namespace
+
+bool inflateRaw(const unsigned char *data, size_t size, uint64_t maxOutput,
+                const InflateConsumer &consumer)
+{
+    InflateState state(data, size, nullptr, maxOutput, consumer);
+    return state.run();
+}
+
+bool inflateRaw(const InflateSource &source, uint64_t maxOutput, const InflateConsumer &consumer)
+{
+    InflateState state(nullptr, 0, &source, maxOutput, consumer);
+    return state.run();
+}
+
+}  // namespace neumann
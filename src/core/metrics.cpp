@@ -0,0 +1,293 @@
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "core/error_handler.h"
+
+namespace neumann {
+
+namespace {
+
+// 标签值中的反斜杠、双引号和换行需要转义
+std::string escapeLabelValue(const std::string &value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char ch : value) {
+        if (ch == '\\' || ch == '"') {
+            escaped += '\\';
+            escaped += ch;
+        } else if (ch == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+std::string formatLabels(const MetricLabels &labels)
+{
+    if (labels.empty()) {
+        return "";
+    }
+    std::string text = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (i > 0) {
+            text += ',';
+        }
+        text += labels[i].first + "=\"" + escapeLabelValue(labels[i].second) + "\"";
+    }
+    return text + "}";
+}
+
+std::string formatValue(double value)
+{
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    std::ostringstream stream;
+    stream.precision(17);
+    stream << value;
+    return stream.str();
+}
+
+}  // namespace
+
+size_t metricShardIndex()
+{
+    static std::atomic<size_t> nextShard(0);
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+Counter::Counter()
+{
+    for (Cell &cell : cells) {
+        cell.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const Cell &cell : cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Gauge::Gauge()
+{
+    for (Cell &cell : cells) {
+        cell.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+int64_t Gauge::value() const
+{
+    int64_t total = 0;
+    for (const Cell &cell : cells) {
+        total += cell.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Histogram(std::vector<double> bucketBounds)
+    : bounds(std::move(bucketBounds)),
+      linesPerShard((bounds.size() + 1 + kBucketsPerLine - 1) / kBucketsPerLine),
+      lines(new BucketLine[linesPerShard * kMetricShards])
+{
+    for (size_t i = 0; i < linesPerShard * kMetricShards; ++i) {
+        for (auto &count : lines[i].counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (SumCell &sum : sums) {
+        sum.value.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value)
+{
+    // 第一个不小于value的上界，都小于时落入+Inf桶
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    size_t shard = metricShardIndex();
+    BucketLine &line = lines[shard * linesPerShard + bucket / kBucketsPerLine];
+    line.counts[bucket % kBucketsPerLine].fetch_add(1, std::memory_order_relaxed);
+
+    // 线程多于分片数时同一分片可能被多个线程写入，比较交换失败时重试，结果仍然准确
+    std::atomic<double> &sum = sums[shard].value;
+    double current = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.buckets.assign(bounds.size() + 1, 0);
+    for (size_t shard = 0; shard < kMetricShards; ++shard) {
+        for (size_t bucket = 0; bucket < snapshot.buckets.size(); ++bucket) {
+            const BucketLine &line = lines[shard * linesPerShard + bucket / kBucketsPerLine];
+            snapshot.buckets[bucket] +=
+                line.counts[bucket % kBucketsPerLine].load(std::memory_order_relaxed);
+        }
+        snapshot.sum += sums[shard].value.load(std::memory_order_relaxed);
+    }
+    for (uint64_t count : snapshot.buckets) {
+        snapshot.count += count;
+    }
+    return snapshot;
+}
+
+std::vector<double> Histogram::latencyBuckets()
+{
+    return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+            0.05,   0.1,     0.25,   0.5,   1.0,    2.5,   5.0,  10.0};
+}
+
+std::vector<double> Histogram::sizeBuckets()
+{
+    std::vector<double> buckets;
+    for (double size = 64; size <= 16 * 1024 * 1024; size *= 4) {
+        buckets.push_back(size);
+    }
+    return buckets;
+}
+
+MetricsRegistry &MetricsRegistry::getInstance()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Series &MetricsRegistry::findSeries(const std::string &name,
+                                                     const std::string &help, MetricType type,
+                                                     const MetricLabels &labels)
+{
+    auto inserted = families.emplace(name, Family{help, type, {}});
+    Family &family = inserted.first->second;
+    if (family.type != type) {
+        THROW_ERROR(ErrorCode::SYSTEM_ERROR, "Metric registered with another type: " + name);
+    }
+
+    Series &series = family.series[formatLabels(labels)];
+    series.labels = labels;
+    return series;
+}
+
+Counter &MetricsRegistry::counter(const std::string &name, const std::string &help,
+                                  const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = findSeries(name, help, MetricType::COUNTER, labels);
+    if (!series.counter) {
+        series.counter = std::make_unique<Counter>();
+    }
+    return *series.counter;
+}
+
+Gauge &MetricsRegistry::gauge(const std::string &name, const std::string &help,
+                              const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = findSeries(name, help, MetricType::GAUGE, labels);
+    if (!series.gauge) {
+        series.gauge = std::make_unique<Gauge>();
+    }
+    return *series.gauge;
+}
+
+Histogram &MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                                      const std::vector<double> &bounds,
+                                      const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Series &series = findSeries(name, help, MetricType::HISTOGRAM, labels);
+    if (!series.histogram) {
+        // 同一指标的所有标签组合使用相同的分桶
+        const Family &family = families.at(name);
+        const std::vector<double> *familyBounds = &bounds;
+        for (const auto &existing : family.series) {
+            if (existing.second.histogram) {
+                familyBounds = &existing.second.histogram->getBounds();
+                break;
+            }
+        }
+        series.histogram = std::make_unique<Histogram>(*familyBounds);
+    }
+    return *series.histogram;
+}
+
+void MetricsRegistry::gaugeCallback(const std::string &name, const std::string &help,
+                                    std::function<double()> callback, const MetricLabels &labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    findSeries(name, help, MetricType::GAUGE, labels).callback = std::move(callback);
+}
+
+std::string MetricsRegistry::render() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string output;
+    for (const auto &familyItem : families) {
+        const std::string &name = familyItem.first;
+        const Family &family = familyItem.second;
+        const char *typeName = family.type == MetricType::COUNTER   ? "counter"
+                               : family.type == MetricType::GAUGE ? "gauge"
+                                                                  : "histogram";
+        output += "# HELP " + name + " " + family.help + "\n";
+        output += "# TYPE " + name + " " + typeName + "\n";
+
+        for (const auto &seriesItem : family.series) {
+            const std::string &labelText = seriesItem.first;
+            const Series &series = seriesItem.second;
+            if (series.counter) {
+                output += name + labelText + " " + std::to_string(series.counter->value()) + "\n";
+            } else if (series.callback) {
+                output += name + labelText + " " + formatValue(series.callback()) + "\n";
+            } else if (series.gauge) {
+                output += name + labelText + " " + std::to_string(series.gauge->value()) + "\n";
+            } else if (series.histogram) {
+                Histogram::Snapshot snapshot = series.histogram->snapshot();
+                const std::vector<double> &bounds = series.histogram->getBounds();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+                    cumulative += snapshot.buckets[i];
+                    MetricLabels bucketLabels = series.labels;
+                    bucketLabels.emplace_back(
+                        "le", i < bounds.size() ? formatValue(bounds[i]) : "+Inf");
+                    output += name + "_bucket" + formatLabels(bucketLabels) + " " +
+                              std::to_string(cumulative) + "\n";
+                }
+                output += name + "_sum" + labelText + " " + formatValue(snapshot.sum) + "\n";
+                output += name + "_count" + labelText + " " + std::to_string(snapshot.count) +
+                          "\n";
+            }
+        }
+    }
+    return output;
+}
+
+Counter &calculatorPointsCounter()
+{
+    static Counter &counter = MetricsRegistry::getInstance().counter(
+        "neumann_calculator_points_total", "Data points processed by the trend calculators");
+    return counter;
+}
+
+Counter &cacheLookupCounter(const std::string &cache, const std::string &result)
+{
+    return MetricsRegistry::getInstance().counter("neumann_cache_requests_total",
+                                                  "Cache lookups by cache and result",
+                                                  {{"cache", cache}, {"result", result}});
+}
+
+}  // namespace neumann
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <numeric>
 
+#include "core/metrics.h"
 #include "core/standard_values.h"
 
 namespace neumann {
@@ -30,6 +31,7 @@ NeumannTestResults NeumannCalculator::performTest(const std::vector<double> &dat
     if (data.size() < 4 || data.size() != timePoints.size()) {
         return results;
     }
+    calculatorPointsCounter().increment(data.size());
 
     double sumPG = 0.0;
     double minPG = std::numeric_limits<double>::max();
@@ -37,6 +39,8 @@ NeumannTestResults NeumannCalculator::performTest(const std::vector<double> &dat
 
     // 对每个可能的子集计算PG值和判断是否有趋势
     for (size_t i = 3; i < data.size(); ++i) {
+        // 每个测试点都要重新扫描前缀，大数据集上耗时很长，逐点检查是否需要停止
+        cancellationToken.throwIfStopped("Neumann test");
         double pgValue = calculatePG(data, i);
         bool trend = determineTrend(pgValue, i + 1);
 
@@ -104,6 +108,11 @@ double NeumannCalculator::getConfidenceLevel() const
     return confidenceLevel;
 }
 
+void NeumannCalculator::setCancellationToken(const CancellationToken &token)
+{
+    cancellationToken = token;
+}
+
 double NeumannCalculator::calculatePG(const std::vector<double> &data, size_t endIndex)
 {
     // 确保不会超出范围
@@ -0,0 +1,100 @@
+#include "core/online_neumann_calculator.h"
+
+#include <algorithm>
+
+#include "core/metrics.h"
+#include "core/standard_values.h"
+
+namespace neumann {
+
+OnlineNeumannCalculator::OnlineNeumannCalculator(double confidenceLevel)
+    : confidenceLevel(confidenceLevel)
+{
+}
+
+bool OnlineNeumannCalculator::addPoint(double value, NeumannResult &result)
+{
+    calculatorPointsCounter().increment();
+
+    // Welford方法更新均值和离差平方和
+    pointCount++;
+    double delta = value - mean;
+    mean += delta / pointCount;
+    squaredDeviations += delta * (value - mean);
+
+    if (pointCount > 1) {
+        double difference = lastValue - value;
+        squaredDifferences += difference * difference;
+    }
+    lastValue = value;
+
+    // 最少需要4个数据点才能进行测试
+    if (pointCount < 4) {
+        return false;
+    }
+
+    // 与NeumannCalculator::calculatePG相同，分母为0时PG取0
+    double pgValue = squaredDeviations == 0.0 ? 0.0 : squaredDifferences / squaredDeviations;
+    double wpThreshold =
+        StandardValues::getInstance().getWPValue(static_cast<int>(pointCount), confidenceLevel);
+
+    result.pgValue = pgValue;
+    result.hasTrend = pgValue <= wpThreshold;
+    result.confidenceLevel = confidenceLevel;
+    result.wpThreshold = wpThreshold;
+
+    if (resultCount == 0) {
+        minPG = pgValue;
+        maxPG = pgValue;
+    } else {
+        minPG = std::min(minPG, pgValue);
+        maxPG = std::max(maxPG, pgValue);
+    }
+    sumPG += pgValue;
+    resultCount++;
+
+    if (result.hasTrend) {
+        trendCount++;
+        trailingTrendCount++;
+    } else {
+        trailingTrendCount = 0;
+    }
+    return true;
+}
+
+void OnlineNeumannCalculator::reset(double level)
+{
+    *this = OnlineNeumannCalculator(level);
+}
+
+bool OnlineNeumannCalculator::hasOverallTrend() const
+{
+    if (resultCount < 2) {
+        return false;
+    }
+
+    // 末端连续有2个或更多趋势点，判断为存在显著趋势
+    if (trailingTrendCount >= 2) {
+        return true;
+    }
+
+    // 只有少量测试点时，超过一半的点显示趋势也判断为有趋势
+    return resultCount <= 3 && trendCount > resultCount / 2;
+}
+
+double OnlineNeumannCalculator::getMinPG() const
+{
+    return minPG;
+}
+
+double OnlineNeumannCalculator::getMaxPG() const
+{
+    return maxPG;
+}
+
+double OnlineNeumannCalculator::getAvgPG() const
+{
+    return resultCount == 0 ? 0.0 : sumPG / resultCount;
+}
+
+}  // namespace neumann
@@ -0,0 +1,156 @@
+#include "core/response_cache.h"
+
+#include <exception>
+
+#include "core/metrics.h"
+
+namespace neumann {
+
+ResponseCache::ResponseCache(size_t memoryLimit) : memoryLimit(memoryLimit) {}
+
+std::shared_ptr<const CachedResponse> ResponseCache::getOrCompute(
+    const std::string &key, const std::function<CachedResponse()> &compute)
+{
+    static const std::string noContent;
+    return getOrCompute(key, noContent, compute);
+}
+
+std::shared_ptr<const CachedResponse> ResponseCache::getOrCompute(
+    const std::string &key, const std::string &content,
+    const std::function<CachedResponse()> &compute)
+{
+    static Counter &hits = cacheLookupCounter("api_responses", "hit");
+    static Counter &misses = cacheLookupCounter("api_responses", "miss");
+    static Counter &coalesced = cacheLookupCounter("api_responses", "coalesced");
+
+    std::promise<std::shared_ptr<const CachedResponse>> promise;
+    bool collision = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (*it->second.content == content) {
+                usageOrder.splice(usageOrder.begin(), usageOrder, it->second.position);
+                hits.increment();
+                return it->second.response;
+            }
+            collision = true;
+        } else {
+            // 相同的请求正在计算，等待它的结果
+            auto running = pending.find(key);
+            if (running != pending.end()) {
+                if (*running->second.content == content) {
+                    auto result = running->second.result;
+                    lock.unlock();
+                    coalesced.increment();
+                    return result.get();
+                }
+                collision = true;
+            } else {
+                pending.emplace(key, Pending{&content, promise.get_future().share()});
+            }
+        }
+        misses.increment();
+    }
+
+    // 键相同而内容不同：单独计算，不影响已缓存或正在计算的请求
+    if (collision) {
+        return std::make_shared<const CachedResponse>(compute());
+    }
+
+    std::shared_ptr<const CachedResponse> response;
+    try {
+        response = std::make_shared<const CachedResponse>(compute());
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    // 在锁外复制请求内容
+    auto storedContent = std::make_shared<const std::string>(content);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.erase(key);
+        store(key, std::move(storedContent), response);
+    }
+    promise.set_value(response);
+    return response;
+}
+
+void ResponseCache::store(const std::string &key, std::shared_ptr<const std::string> content,
+                          std::shared_ptr<const CachedResponse> response)
+{
+    // 键、请求内容和响应各保存一份，另加节点和索引的开销
+    size_t bytes = key.capacity() + content->capacity() + response->contentType.capacity() +
+                   response->body.capacity() + response->contentEncoding.capacity() +
+                   sizeof(Entry) + sizeof(CachedResponse) + 64;
+    if (bytes > memoryLimit) {
+        return;
+    }
+
+    auto inserted = entries.emplace(key, Entry());
+    Entry &entry = inserted.first->second;
+    if (inserted.second) {
+        usageOrder.push_front(&inserted.first->first);
+        entry.position = usageOrder.begin();
+    } else {
+        // 已有相同的键时替换为新的结果
+        memoryUsage -= entry.memoryUsage;
+        usageOrder.splice(usageOrder.begin(), usageOrder, entry.position);
+    }
+    entry.content = std::move(content);
+    entry.response = std::move(response);
+    entry.memoryUsage = bytes;
+    memoryUsage += bytes;
+    evict();
+}
+
+void ResponseCache::evict()
+{
+    while (memoryUsage > memoryLimit && !usageOrder.empty()) {
+        auto it = entries.find(*usageOrder.back());
+        memoryUsage -= it->second.memoryUsage;
+        usageOrder.pop_back();
+        entries.erase(it);
+    }
+}
+
+void ResponseCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    usageOrder.clear();
+    entries.clear();
+    memoryUsage = 0;
+}
+
+void ResponseCache::setMemoryLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryLimit = bytes;
+    evict();
+}
+
+size_t ResponseCache::getMemoryLimit() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryLimit;
+}
+
+size_t ResponseCache::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryUsage;
+}
+
+size_t ResponseCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+}  // namespace neumann
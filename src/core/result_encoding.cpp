@@ -0,0 +1,164 @@
+#include "core/result_encoding.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <nlohmann/json.hpp>
+
+#include "core/http_header.h"
+
+using json = nlohmann::json;
+
+namespace neumann {
+
+const char *const kColumnarContentType = "application/vnd.neumann.columnar";
+
+namespace {
+
+const char kColumnarMagic[4] = {'N', 'T', 'R', '1'};
+const uint16_t kColumnarVersion = 1;
+const uint16_t kFlagOverallTrend = 0x01;
+const uint16_t kFlagInputEcho = 0x02;
+const size_t kColumnarHeaderSize = 48;
+
+// 测试结果从第4个数据点开始
+const size_t kFirstTestIndex = 3;
+
+// 按小端序写入，与主机字节序无关
+class LittleEndianWriter
+{
+public:
+    explicit LittleEndianWriter(std::string &out) : out(out) {}
+
+    void writeU8(uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+    void writeU16(uint16_t value)
+    {
+        writeU8(static_cast<uint8_t>(value));
+        writeU8(static_cast<uint8_t>(value >> 8));
+    }
+
+    void writeU32(uint32_t value)
+    {
+        writeU16(static_cast<uint16_t>(value));
+        writeU16(static_cast<uint16_t>(value >> 16));
+    }
+
+    void writeDouble(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        char bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<char>(bits >> (8 * i));
+        }
+        out.append(bytes, sizeof(bytes));
+    }
+
+    // 写入m个double组成的列，取值由getter给出
+    template <typename Getter>
+    void writeDoubleColumn(size_t count, Getter getter)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            writeDouble(getter(i));
+        }
+    }
+
+private:
+    std::string &out;
+};
+
+}  // namespace
+
+ResultEncoding negotiateResultEncoding(const std::string &acceptHeader)
+{
+    ResultEncoding best = ResultEncoding::JSON;
+    double bestQuality = 0.0;
+
+    for (const auto &range : parseQualityList(acceptHeader)) {
+        // 媒体类型的参数中只关心q值
+        const std::string &type = range.value;
+        double quality = range.quality;
+
+        ResultEncoding encoding;
+        if (type == kColumnarContentType || type == "application/octet-stream") {
+            encoding = ResultEncoding::COLUMNAR;
+        } else if (type == "application/json" || type == "application/*" || type == "*/*") {
+            encoding = ResultEncoding::JSON;
+        } else {
+            continue;
+        }
+        if (quality > bestQuality) {
+            best = encoding;
+            bestQuality = quality;
+        }
+    }
+
+    return best;
+}
+
+std::string encodeResultsJson(const NeumannTestResults &results, bool echoInput)
+{
+    json response = {{"success", true},
+                     {"overallTrend", results.overallTrend},
+                     {"minPG", results.minPG},
+                     {"maxPG", results.maxPG},
+                     {"avgPG", results.avgPG},
+                     {"results", json::array()}};
+    if (echoInput) {
+        response["data"] = results.data;
+        response["time"] = results.timePoints;
+    }
+
+    json &points = response["results"];
+    for (size_t i = 0; i < results.results.size(); ++i) {
+        size_t dataIndex = i + kFirstTestIndex;
+        points.push_back({{"dataPoint", results.data[dataIndex]},
+                          {"timePoint", results.timePoints[dataIndex]},
+                          {"pgValue", results.results[i].pgValue},
+                          {"wpThreshold", results.results[i].wpThreshold},
+                          {"hasTrend", results.results[i].hasTrend}});
+    }
+
+    return response.dump();
+}
+
+std::string encodeResultsColumnar(const NeumannTestResults &results, bool echoInput)
+{
+    const size_t pointCount = results.results.size();
+    const size_t inputCount = echoInput ? results.data.size() : 0;
+
+    std::string out;
+    out.reserve(kColumnarHeaderSize + (pointCount + inputCount) * 2 * sizeof(double) +
+                pointCount);
+    LittleEndianWriter writer(out);
+
+    uint16_t flags = 0;
+    if (results.overallTrend) {
+        flags |= kFlagOverallTrend;
+    }
+    if (echoInput) {
+        flags |= kFlagInputEcho;
+    }
+    out.append(kColumnarMagic, sizeof(kColumnarMagic));
+    writer.writeU16(kColumnarVersion);
+    writer.writeU16(flags);
+    writer.writeU32(static_cast<uint32_t>(pointCount));
+    writer.writeU32(static_cast<uint32_t>(inputCount));
+    writer.writeDouble(results.results.empty() ? 0.0 : results.results.front().confidenceLevel);
+    writer.writeDouble(results.minPG);
+    writer.writeDouble(results.maxPG);
+    writer.writeDouble(results.avgPG);
+
+    writer.writeDoubleColumn(pointCount, [&](size_t i) { return results.results[i].pgValue; });
+    writer.writeDoubleColumn(pointCount, [&](size_t i) { return results.results[i].wpThreshold; });
+    writer.writeDoubleColumn(inputCount, [&](size_t i) { return results.data[i]; });
+    writer.writeDoubleColumn(inputCount, [&](size_t i) { return results.timePoints[i]; });
+    for (const auto &result : results.results) {
+        writer.writeU8(result.hasTrend ? 1 : 0);
+    }
+
+    return out;
+}
+
+}  // namespace neumann
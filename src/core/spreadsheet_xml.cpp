@@ -0,0 +1,552 @@
+#include "core/spreadsheet_xml.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace neumann {
+
+namespace {
+
+bool isXmlSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+std::string_view trimXmlSpace(std::string_view text)
+{
+    while (!text.empty() && isXmlSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isXmlSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// 去掉命名空间前缀（部分工具写出x:row、x:c等带前缀的元素名）
+std::string_view localName(std::string_view name)
+{
+    size_t colon = name.find(':');
+    return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+bool startsWith(std::string_view text, std::string_view prefix)
+{
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+// 数据可能在标记的前缀中间截断（如"<!-"），需要等待更多数据才能判断
+bool isPartialPrefix(std::string_view text, std::string_view prefix)
+{
+    return text.size() < prefix.size() && startsWith(prefix, text);
+}
+
+bool parseUnsigned(std::string_view text, uint32_t &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+void appendUtf8(uint32_t codePoint, std::string &out)
+{
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+CellType parseCellType(std::string_view type)
+{
+    if (type == "s") {
+        return CellType::SHARED_STRING;
+    } else if (type == "inlineStr") {
+        return CellType::INLINE_STRING;
+    } else if (type == "str") {
+        return CellType::FORMULA_STRING;
+    } else if (type == "b") {
+        return CellType::BOOLEAN;
+    } else if (type == "e") {
+        return CellType::ERROR;
+    } else if (type == "d") {
+        return CellType::DATE;
+    }
+    return CellType::NUMBER;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// XmlTokenizer
+// ---------------------------------------------------------------------------
+
+bool XmlTokenizer::feed(const char *data, size_t size)
+{
+    bool stopped = false;
+    if (pending.empty()) {
+        // 常见情况：直接解析输入块，只复制末尾的不完整标签
+        std::string_view view(data, size);
+        size_t consumed = process(view, stopped);
+        if (!stopped) {
+            pending.assign(view.substr(consumed));
+        }
+    } else {
+        std::string buffer;
+        buffer.swap(pending);
+        buffer.append(data, size);
+        size_t consumed = process(buffer, stopped);
+        if (!stopped) {
+            pending.assign(buffer, consumed, std::string::npos);
+        }
+    }
+    return !stopped;
+}
+
+void XmlTokenizer::finish()
+{
+    if (!trimXmlSpace(pending).empty()) {
+        throw std::runtime_error("Unexpected end of XML document");
+    }
+    pending.clear();
+}
+
+size_t XmlTokenizer::process(std::string_view data, bool &stopped)
+{
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t open = data.find('<', pos);
+        if (open == std::string_view::npos) {
+            stopped = !onText(data.substr(pos));
+            return data.size();
+        }
+        if (open > pos && !onText(data.substr(pos, open - pos))) {
+            stopped = true;
+            return open;
+        }
+
+        std::string_view rest = data.substr(open);
+        if (rest.size() < 2) {
+            return open;
+        }
+
+        // 注释、CDATA、处理指令和文档类型声明
+        if (rest[1] == '!' || rest[1] == '?') {
+            if (isPartialPrefix(rest, "<!--") || isPartialPrefix(rest, "<![CDATA[")) {
+                return open;
+            }
+
+            std::string_view terminator = ">";
+            size_t contentStart = open + 2;
+            if (startsWith(rest, "<!--")) {
+                terminator = "-->";
+                contentStart = open + 4;
+            } else if (startsWith(rest, "<![CDATA[")) {
+                terminator = "]]>";
+                contentStart = open + 9;
+            } else if (rest[1] == '?') {
+                terminator = "?>";
+            }
+
+            size_t end = data.find(terminator, contentStart);
+            if (end == std::string_view::npos) {
+                return open;
+            }
+            pos = end + terminator.size();
+            if (terminator == "]]>" &&
+                !onCData(data.substr(contentStart, end - contentStart))) {
+                stopped = true;
+                return pos;
+            }
+            continue;
+        }
+
+        // 普通标签：引号中的'>'不结束标签
+        size_t end = open + 1;
+        char quote = 0;
+        for (; end < data.size(); ++end) {
+            char ch = data[end];
+            if (quote) {
+                if (ch == quote) {
+                    quote = 0;
+                }
+            } else if (ch == '"' || ch == '\'') {
+                quote = ch;
+            } else if (ch == '>') {
+                break;
+            }
+        }
+        if (end >= data.size()) {
+            return open;
+        }
+
+        std::string_view tag = data.substr(open + 1, end - open - 1);
+        pos = end + 1;
+
+        bool keepGoing = true;
+        if (!tag.empty() && tag[0] == '/') {
+            keepGoing = onEndTag(localName(trimXmlSpace(tag.substr(1))));
+        } else {
+            bool selfClosing = !tag.empty() && tag.back() == '/';
+            if (selfClosing) {
+                tag.remove_suffix(1);
+            }
+            size_t nameEnd = 0;
+            while (nameEnd < tag.size() && !isXmlSpace(tag[nameEnd])) {
+                nameEnd++;
+            }
+            keepGoing =
+                onStartTag(localName(tag.substr(0, nameEnd)), tag.substr(nameEnd), selfClosing);
+        }
+
+        if (!keepGoing) {
+            stopped = true;
+            return pos;
+        }
+    }
+    return pos;
+}
+
+// ---------------------------------------------------------------------------
+// WorksheetXmlReader
+// ---------------------------------------------------------------------------
+
+WorksheetXmlReader::WorksheetXmlReader(CellHandler onCell, RowEndHandler onRowEnd)
+    : onCell(std::move(onCell)), onRowEnd(std::move(onRowEnd))
+{
+}
+
+bool WorksheetXmlReader::onStartTag(std::string_view name, std::string_view attributes,
+                                    bool selfClosing)
+{
+    if (name == "c") {
+        std::string_view value;
+        cell.type = findXmlAttribute(attributes, "t", value) ? parseCellType(value)
+                                                             : CellType::NUMBER;
+        cell.row = currentRow;
+        cell.column = nextColumn;
+
+        // 省略了空单元格时依靠引用确定列位置
+        uint32_t column = 0;
+        uint32_t row = 0;
+        if (findXmlAttribute(attributes, "r", value) && parseCellReference(value, column, row)) {
+            cell.column = column;
+            if (row != 0) {
+                cell.row = row;
+            }
+        }
+        nextColumn = cell.column + 1;
+
+        inCell = !selfClosing;
+        rawValue.clear();
+        capturing = false;
+        phoneticDepth = 0;
+    } else if (name == "v" || name == "t") {
+        // <t>只出现在内联字符串<is>中
+        capturing = inCell && !selfClosing && phoneticDepth == 0;
+    } else if (name == "rPh") {
+        if (!selfClosing) {
+            phoneticDepth++;
+        }
+    } else if (name == "row") {
+        std::string_view value;
+        uint32_t row = 0;
+        currentRow = findXmlAttribute(attributes, "r", value) && parseUnsigned(value, row)
+                         ? row
+                         : currentRow + 1;
+        nextColumn = 0;
+        if (selfClosing) {
+            return onRowEnd(currentRow);
+        }
+    }
+    return true;
+}
+
+bool WorksheetXmlReader::onEndTag(std::string_view name)
+{
+    if (name == "v" || name == "t") {
+        capturing = false;
+    } else if (name == "rPh") {
+        if (phoneticDepth > 0) {
+            phoneticDepth--;
+        }
+    } else if (name == "c") {
+        if (!inCell) {
+            return true;
+        }
+        inCell = false;
+        if (rawValue.empty() && cell.type != CellType::INLINE_STRING) {
+            return true;  // 只有格式没有值的单元格
+        }
+
+        decodedValue.clear();
+        appendDecodedXml(rawValue, decodedValue);
+        cell.value = decodedValue;
+        return onCell(cell);
+    } else if (name == "row") {
+        return onRowEnd(currentRow);
+    }
+    return true;
+}
+
+bool WorksheetXmlReader::onText(std::string_view text)
+{
+    if (capturing) {
+        rawValue.append(text.data(), text.size());
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// SharedStringsXmlReader
+// ---------------------------------------------------------------------------
+
+SharedStringsXmlReader::SharedStringsXmlReader(StringHandler onString)
+    : onString(std::move(onString))
+{
+}
+
+bool SharedStringsXmlReader::onStartTag(std::string_view name, std::string_view,
+                                        bool selfClosing)
+{
+    if (name == "si") {
+        rawText.clear();
+        phoneticDepth = 0;
+        inItem = !selfClosing;
+        if (selfClosing) {
+            return onString(std::string());
+        }
+    } else if (name == "t") {
+        // 富文本由多个<r><t>组成，拼接所有片段；注音<rPh>中的文本不属于字符串内容
+        capturing = inItem && !selfClosing && phoneticDepth == 0;
+    } else if (name == "rPh") {
+        if (!selfClosing) {
+            phoneticDepth++;
+        }
+    }
+    return true;
+}
+
+bool SharedStringsXmlReader::onEndTag(std::string_view name)
+{
+    if (name == "t") {
+        capturing = false;
+    } else if (name == "rPh") {
+        if (phoneticDepth > 0) {
+            phoneticDepth--;
+        }
+    } else if (name == "si") {
+        inItem = false;
+        std::string text;
+        appendDecodedXml(rawText, text);
+        return onString(std::move(text));
+    }
+    return true;
+}
+
+bool SharedStringsXmlReader::onText(std::string_view text)
+{
+    if (capturing) {
+        rawText.append(text.data(), text.size());
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// RelationshipsXmlReader
+// ---------------------------------------------------------------------------
+
+RelationshipsXmlReader::RelationshipsXmlReader(RelationshipHandler onRelationship)
+    : onRelationship(std::move(onRelationship))
+{
+}
+
+bool RelationshipsXmlReader::onStartTag(std::string_view name, std::string_view attributes, bool)
+{
+    std::string_view id;
+    std::string_view target;
+    if (name != "Relationship" || !findXmlAttribute(attributes, "Id", id) ||
+        !findXmlAttribute(attributes, "Target", target)) {
+        return true;
+    }
+
+    std::string decodedId;
+    std::string decodedTarget;
+    appendDecodedXml(id, decodedId);
+    appendDecodedXml(target, decodedTarget);
+    return onRelationship(std::move(decodedId), std::move(decodedTarget));
+}
+
+// ---------------------------------------------------------------------------
+// WorkbookXmlReader
+// ---------------------------------------------------------------------------
+
+WorkbookXmlReader::WorkbookXmlReader(SheetHandler onSheet) : onSheet(std::move(onSheet)) {}
+
+bool WorkbookXmlReader::onStartTag(std::string_view name, std::string_view attributes, bool)
+{
+    if (name != "sheet") {
+        return true;
+    }
+
+    std::string_view sheetName;
+    std::string_view id;
+    std::string decodedName;
+    std::string decodedId;
+    if (findXmlAttribute(attributes, "name", sheetName)) {
+        appendDecodedXml(sheetName, decodedName);
+    }
+    if (findXmlAttribute(attributes, "r:id", id)) {
+        appendDecodedXml(id, decodedId);
+    }
+    return onSheet(std::move(decodedName), std::move(decodedId));
+}
+
+// ---------------------------------------------------------------------------
+// 辅助函数
+// ---------------------------------------------------------------------------
+
+void appendDecodedXml(std::string_view text, std::string &out)
+{
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t amp = text.find('&', pos);
+        if (amp == std::string_view::npos) {
+            out.append(text.data() + pos, text.size() - pos);
+            return;
+        }
+        out.append(text.data() + pos, amp - pos);
+
+        size_t semicolon = text.find(';', amp + 1);
+        if (semicolon == std::string_view::npos || semicolon - amp > 10) {
+            out.push_back('&');  // 不是实体，原样保留
+            pos = amp + 1;
+            continue;
+        }
+
+        std::string_view entity = text.substr(amp + 1, semicolon - amp - 1);
+        if (entity == "amp") {
+            out.push_back('&');
+        } else if (entity == "lt") {
+            out.push_back('<');
+        } else if (entity == "gt") {
+            out.push_back('>');
+        } else if (entity == "quot") {
+            out.push_back('"');
+        } else if (entity == "apos") {
+            out.push_back('\'');
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            // 数字字符引用：&#10; 或 &#x0A;
+            bool hex = entity[1] == 'x' || entity[1] == 'X';
+            std::string_view digits = entity.substr(hex ? 2 : 1);
+            uint32_t codePoint = 0;
+            auto result = std::from_chars(digits.data(), digits.data() + digits.size(), codePoint,
+                                          hex ? 16 : 10);
+            if (result.ec != std::errc() || result.ptr != digits.data() + digits.size() ||
+                codePoint > 0x10FFFF) {
+                out.append(text.data() + amp, semicolon - amp + 1);
+            } else {
+                appendUtf8(codePoint, out);
+            }
+        } else {
+            out.append(text.data() + amp, semicolon - amp + 1);
+        }
+        pos = semicolon + 1;
+    }
+}
+
+bool findXmlAttribute(std::string_view attributes, std::string_view name, std::string_view &value)
+{
+    size_t pos = 0;
+    while (pos < attributes.size()) {
+        while (pos < attributes.size() && isXmlSpace(attributes[pos])) {
+            pos++;
+        }
+        size_t nameStart = pos;
+        while (pos < attributes.size() && attributes[pos] != '=' && !isXmlSpace(attributes[pos])) {
+            pos++;
+        }
+        std::string_view attributeName = attributes.substr(nameStart, pos - nameStart);
+
+        while (pos < attributes.size() && (isXmlSpace(attributes[pos]) || attributes[pos] == '=')) {
+            pos++;
+        }
+        if (pos >= attributes.size() || (attributes[pos] != '"' && attributes[pos] != '\'')) {
+            return false;
+        }
+
+        char quote = attributes[pos++];
+        size_t valueEnd = attributes.find(quote, pos);
+        if (valueEnd == std::string_view::npos) {
+            return false;
+        }
+        if (attributeName == name) {
+            value = attributes.substr(pos, valueEnd - pos);
+            return true;
+        }
+        pos = valueEnd + 1;
+    }
+    return false;
+}
+
+bool parseCellReference(std::string_view reference, uint32_t &column, uint32_t &row)
+{
+    size_t pos = 0;
+    uint32_t letters = 0;
+    while (pos < reference.size() && pos < 3) {
+        char ch = reference[pos];
+        if (ch >= 'A' && ch <= 'Z') {
+            letters = letters * 26 + static_cast<uint32_t>(ch - 'A' + 1);
+        } else if (ch >= 'a' && ch <= 'z') {
+            letters = letters * 26 + static_cast<uint32_t>(ch - 'a' + 1);
+        } else {
+            break;
+        }
+        pos++;
+    }
+    if (letters == 0) {
+        return false;
+    }
+
+    row = 0;
+    if (pos < reference.size() && !parseUnsigned(reference.substr(pos), row)) {
+        return false;
+    }
+    column = letters - 1;
+    return true;
+}
+
+bool parseCellNumber(std::string_view text, double &value)
+{
+    text = trimXmlSpace(text);
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        return false;
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+#else
+    // 标准库未提供浮点from_chars时退回strtod（程序使用默认的"C"区域设置）
+    std::string copy(text);
+    char *end = nullptr;
+    value = std::strtod(copy.c_str(), &end);
+    return end == copy.c_str() + copy.size();
+#endif
+}
+
+}  // namespace neumann
@@ -288,6 +288,7 @@ bool StandardValues::loadFromFile(const std::string &filename)
 
         // 排序置信水平
         std::sort(confidenceLevels.begin(), confidenceLevels.end());
+        version++;
 
         std::cout << _("standard_values.load_success") << ": " << filename << std::endl;
         std::cout << "  " << _("standard_values.supported_confidence_levels") << ": "
@@ -454,6 +455,7 @@ bool StandardValues::importCustomConfidenceLevel(double confidenceLevel,
 
         // 添加到标准值表
         wpValues[confidenceLevel] = customValues;
+        version++;
 
         // 更新置信度列表
         auto it = std::find(confidenceLevels.begin(), confidenceLevels.end(), confidenceLevel);
@@ -503,6 +505,7 @@ bool StandardValues::removeConfidenceLevel(double confidenceLevel)
 
     // 从标准值表中移除
     wpValues.erase(it);
+    version++;
 
     // 从置信度列表中移除
     auto levelIt = std::find(confidenceLevels.begin(), confidenceLevels.end(), confidenceLevel);
@@ -629,6 +632,32 @@ bool StandardValues::saveToFile(const std::string &filename)
     }
 }
 
+uint64_t StandardValues::getVersion() const
+{
+    return version.load();
+}
+
+std::map<double, std::map<int, double>> StandardValues::getAllWPValues() const
+{
+    return wpValues;
+}
+
+void StandardValues::setAllWPValues(const std::map<double, std::map<int, double>> &values)
+{
+    wpValues = values;
+    confidenceLevels.clear();
+    minSampleSize = std::numeric_limits<int>::max();
+    maxSampleSize = 0;
+    for (const auto &level : wpValues) {
+        confidenceLevels.push_back(level.first);
+        for (const auto &entry : level.second) {
+            minSampleSize = std::min(minSampleSize, entry.first);
+            maxSampleSize = std::max(maxSampleSize, entry.first);
+        }
+    }
+    version++;
+}
+
 void StandardValues::setUserFilePath(const std::string &filePath)
 {
     currentFilePath = filePath;
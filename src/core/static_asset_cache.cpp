@@ -0,0 +1,201 @@
+#include "core/static_asset_cache.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "core/deflate.h"
+#include "core/hash_utils.h"
+#include "core/http_header.h"
+
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+// 文本类内容压缩后通常只剩几分之一，图片和字体等已经压缩过
+bool isCompressible(const std::string &contentType)
+{
+    return contentType.compare(0, 5, "text/") == 0 ||
+           contentType.compare(0, 22, "application/javascript") == 0 ||
+           contentType.compare(0, 16, "application/json") == 0 ||
+           contentType.compare(0, 13, "image/svg+xml") == 0;
+}
+
+}  // namespace
+
+StaticAssetCache::StaticAssetCache(const std::string &rootDirectory) : root(rootDirectory) {}
+
+StaticAssetCache::~StaticAssetCache()
+{
+    stopWatching();
+}
+
+bool StaticAssetCache::refresh()
+{
+    std::map<std::string, std::shared_ptr<const StaticAsset>> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        previous = assets;
+    }
+
+    // 在锁外扫描和读取文件，查找不会被阻塞
+    std::map<std::string, std::shared_ptr<const StaticAsset>> current;
+    bool changed = false;
+    std::error_code ec;
+    fs::recursive_directory_iterator it(root, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError)) {
+            continue;
+        }
+        uintmax_t fileSize = it->file_size(entryError);
+        fs::file_time_type modified = it->last_write_time(entryError);
+        if (entryError || fileSize > kMaxCachedFileSize) {
+            continue;
+        }
+
+        std::string relativePath = it->path().lexically_relative(root).generic_string();
+        auto existing = previous.find(relativePath);
+        if (existing != previous.end() && existing->second->modified == modified &&
+            existing->second->content.size() == fileSize) {
+            current.emplace(relativePath, existing->second);
+            continue;
+        }
+
+        if (auto asset = loadAsset(it->path(), relativePath)) {
+            current.emplace(relativePath, std::move(asset));
+            changed = true;
+        }
+    }
+    changed = changed || current.size() != previous.size();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    assets.swap(current);
+    return changed;
+}
+
+std::shared_ptr<const StaticAsset> StaticAssetCache::loadAsset(
+    const fs::path &filePath, const std::string &relativePath) const
+{
+    std::error_code ec;
+    fs::file_time_type modified = fs::last_write_time(filePath, ec);
+    std::ifstream file(filePath, std::ios::binary);
+    if (ec || !file) {
+        return nullptr;
+    }
+
+    auto asset = std::make_shared<StaticAsset>();
+    asset->path = relativePath;
+    asset->modified = modified;
+    asset->contentType = contentTypeFor(relativePath);
+    asset->content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    asset->etag = "\"" + Fnv1a64::hashHex(asset->content) + "\"";
+
+    if (asset->content.size() >= kMinCompressSize && isCompressible(asset->contentType)) {
+        std::string compressed = gzipCompress(asset->content.data(), asset->content.size(), 9);
+        // 压缩收益不足一成时直接发送原始内容
+        if (compressed.size() < asset->content.size() * 9 / 10) {
+            asset->gzipContent = std::move(compressed);
+            asset->gzipEtag = gzipEtagFor(asset->etag);
+        }
+    }
+    return asset;
+}
+
+std::shared_ptr<const StaticAsset> StaticAssetCache::find(const std::string &path) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = assets.find(path);
+    return it == assets.end() ? nullptr : it->second;
+}
+
+size_t StaticAssetCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return assets.size();
+}
+
+void StaticAssetCache::startWatching(std::chrono::milliseconds interval)
+{
+    stopWatching();
+
+    std::lock_guard<std::mutex> lock(watchMutex);
+    watching = true;
+    watchThread = std::thread([this, interval]() {
+        std::unique_lock<std::mutex> lock(watchMutex);
+        while (!watchCondition.wait_for(lock, interval, [this]() { return !watching; })) {
+            lock.unlock();
+            refresh();
+            lock.lock();
+        }
+    });
+}
+
+void StaticAssetCache::stopWatching()
+{
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        watching = false;
+    }
+    watchCondition.notify_all();
+    if (watchThread.joinable()) {
+        watchThread.join();
+    }
+}
+
+std::string StaticAssetCache::contentTypeFor(const std::string &path)
+{
+    static const std::map<std::string, std::string> types = {
+        {".html", "text/html; charset=utf-8"},
+        {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".js", "application/javascript; charset=utf-8"},
+        {".mjs", "application/javascript; charset=utf-8"},
+        {".json", "application/json; charset=utf-8"},
+        {".map", "application/json; charset=utf-8"},
+        {".svg", "image/svg+xml"},
+        {".txt", "text/plain; charset=utf-8"},
+        {".csv", "text/csv; charset=utf-8"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".ico", "image/x-icon"},
+        {".webp", "image/webp"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".pdf", "application/pdf"}};
+
+    auto it = types.find(toLowerAscii(fs::path(path).extension().string()));
+    return it == types.end() ? "text/plain; charset=utf-8" : it->second;
+}
+
+bool StaticAssetCache::etagMatches(const std::string &ifNoneMatch, const std::string &etag)
+{
+    // If-None-Match使用弱比较，忽略W/前缀
+    auto strip = [](const std::string &tag) {
+        return tag.compare(0, 2, "W/") == 0 ? tag.substr(2) : tag;
+    };
+
+    std::string target = strip(etag);
+    std::string gzipTarget = gzipEtagFor(target);
+    for (const auto &item : splitHeaderList(ifNoneMatch)) {
+        std::string tag = strip(item);
+        if (item == "*" || tag == target || tag == gzipTarget) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string StaticAssetCache::gzipEtagFor(const std::string &etag)
+{
+    // 在结束引号之前加后缀
+    if (etag.size() >= 2 && etag.back() == '"') {
+        return etag.substr(0, etag.size() - 1) + "-gz\"";
+    }
+    return etag + "-gz";
+}
+
+}  // namespace neumann
@@ -0,0 +1,139 @@
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace neumann {
+
+namespace {
+
+/**
+ * @brief parallelFor的共享状态
+ *
+ * 由调用线程和辅助任务共同持有：辅助任务可能在调用线程返回后才开始执行，
+ * 这时它只会发现没有剩余索引并立即退出，不再访问body。
+ */
+struct ParallelForState {
+    explicit ParallelForState(size_t count) : count(count) {}
+
+    // 领取并执行索引，直到没有剩余或出现异常
+    void run(const std::function<void(size_t)> &body)
+    {
+        for (size_t index = next++; index < count; index = next++) {
+            try {
+                body(index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;  // 放弃剩余的索引
+            }
+        }
+    }
+
+    const size_t count;
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t activeHelpers = 0;  // 正在执行的辅助任务数
+    std::exception_ptr error;
+};
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;  // 只在队列已清空时退出
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index)> &body)
+{
+    if (count == 0) {
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>(count);
+
+    // 调用线程自己也执行，只需要count - 1个辅助任务
+    size_t helperCount = std::min(threads.size(), count - 1);
+    for (size_t i = 0; i < helperCount; ++i) {
+        post([state, &body]() {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->next >= state->count) {
+                    return;  // 已经没有剩余的索引，调用线程可能已返回
+                }
+                state->activeHelpers++;
+            }
+            state->run(body);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (--state->activeHelpers == 0) {
+                state->finished.notify_all();
+            }
+        });
+    }
+
+    state->run(body);
+
+    // 等待已开始执行的辅助任务完成；尚未开始的任务不会再访问body
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->activeHelpers == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+}  // namespace neumann
@@ -0,0 +1,240 @@
+#include "core/workbook_cache.h"
+
+#include <filesystem>
+
+#include "core/metrics.h"
+
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+size_t stringMemory(const std::string &text)
+{
+    // 短字符串存放在对象内部，不额外分配
+    return sizeof(std::string) + (text.capacity() > 15 ? text.capacity() + 1 : 0);
+}
+
+}  // namespace
+
+WorkbookCache &WorkbookCache::getInstance()
+{
+    static WorkbookCache instance;
+    return instance;
+}
+
+std::shared_ptr<const XlsxWorkbook> WorkbookCache::find(const std::string &path)
+{
+    return findEntry(path, false).workbook;
+}
+
+std::shared_ptr<const XlsWorkbook> WorkbookCache::findXls(const std::string &path)
+{
+    return findEntry(path, true).xlsWorkbook;
+}
+
+WorkbookCache::Entry WorkbookCache::findEntry(const std::string &path, bool legacy)
+{
+    std::string key = makeKey(path);
+
+    // 在锁外读取文件状态
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    bool exists = statFile(path, fileSize, modifiedTime);
+
+    static Counter &hits = cacheLookupCounter("workbook", "hit");
+    static Counter &misses = cacheLookupCounter("workbook", "miss");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses.increment();
+        return Entry();
+    }
+
+    const Entry &entry = it->second;
+    if (!exists || entry.fileSize != fileSize || entry.modifiedTime != modifiedTime) {
+        eraseEntry(it);
+        misses.increment();
+        return Entry();
+    }
+
+    // 同一路径下保存的是另一种格式的工作簿
+    if (legacy ? !entry.xlsWorkbook : !entry.workbook) {
+        misses.increment();
+        return Entry();
+    }
+
+    // 持有锁时复制共享指针，返回后条目可能被其他线程替换或淘汰
+    usageOrder.splice(usageOrder.begin(), usageOrder, entry.position);
+    hits.increment();
+    return entry;
+}
+
+void WorkbookCache::store(const std::string &path, std::shared_ptr<const XlsxWorkbook> workbook)
+{
+    if (!workbook) {
+        return;
+    }
+
+    Entry entry;
+    entry.fileSize = workbook->fileSize;
+    entry.modifiedTime = workbook->modifiedTime;
+    entry.memoryUsage = estimateMemoryUsage(*workbook);
+    entry.workbook = std::move(workbook);
+    storeEntry(path, std::move(entry));
+}
+
+void WorkbookCache::store(const std::string &path, std::shared_ptr<const XlsWorkbook> workbook)
+{
+    if (!workbook) {
+        return;
+    }
+
+    Entry entry;
+    entry.fileSize = workbook->fileSize;
+    entry.modifiedTime = workbook->modifiedTime;
+    entry.memoryUsage = estimateMemoryUsage(*workbook);
+    entry.xlsWorkbook = std::move(workbook);
+    storeEntry(path, std::move(entry));
+}
+
+void WorkbookCache::storeEntry(const std::string &path, Entry entry)
+{
+    std::string key = makeKey(path);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        eraseEntry(it);
+    }
+    if (entry.memoryUsage > memoryLimit) {
+        return;
+    }
+
+    usageOrder.push_front(key);
+    entry.position = usageOrder.begin();
+    memoryUsage += entry.memoryUsage;
+    entries.emplace(key, std::move(entry));
+    evict();
+}
+
+void WorkbookCache::remove(const std::string &path)
+{
+    std::string key = makeKey(path);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        eraseEntry(it);
+    }
+}
+
+void WorkbookCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    usageOrder.clear();
+    memoryUsage = 0;
+}
+
+void WorkbookCache::setMemoryLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryLimit = bytes;
+    evict();
+}
+
+size_t WorkbookCache::getMemoryLimit() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryLimit;
+}
+
+size_t WorkbookCache::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryUsage;
+}
+
+size_t WorkbookCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+bool WorkbookCache::statFile(const std::string &path, uint64_t &fileSize, int64_t &modifiedTime)
+{
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto time = fs::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+
+    fileSize = static_cast<uint64_t>(size);
+    modifiedTime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+std::string WorkbookCache::makeKey(const std::string &path)
+{
+    std::error_code ec;
+    fs::path absolutePath = fs::absolute(path, ec);
+    if (ec) {
+        return path;
+    }
+    return absolutePath.lexically_normal().string();
+}
+
+size_t WorkbookCache::estimateMemoryUsage(const XlsxWorkbook &workbook)
+{
+    size_t bytes = sizeof(XlsxWorkbook);
+
+    if (workbook.archive) {
+        for (const auto &entry : workbook.archive->getEntries()) {
+            // 成员记录及其在名称索引中的副本
+            bytes += sizeof(ZipEntry) + 2 * stringMemory(entry.name) + sizeof(size_t);
+        }
+    }
+    for (const auto &[name, path] : workbook.worksheets) {
+        bytes += stringMemory(name) + stringMemory(path);
+    }
+    if (workbook.sharedStrings) {
+        for (const auto &text : *workbook.sharedStrings) {
+            bytes += stringMemory(text);
+        }
+    }
+    return bytes;
+}
+
+size_t WorkbookCache::estimateMemoryUsage(const XlsWorkbook &workbook)
+{
+    size_t bytes = sizeof(XlsWorkbook) + workbook.stream.capacity();
+    for (const auto &sheet : workbook.info.sheets) {
+        bytes += sizeof(BiffSheetInfo) + stringMemory(sheet.name);
+    }
+    for (const auto &text : workbook.info.sharedStrings) {
+        bytes += stringMemory(text);
+    }
+    return bytes;
+}
+
+void WorkbookCache::eraseEntry(std::unordered_map<std::string, Entry>::iterator it)
+{
+    memoryUsage -= it->second.memoryUsage;
+    usageOrder.erase(it->second.position);
+    entries.erase(it);
+}
+
+void WorkbookCache::evict()
+{
+    while (memoryUsage > memoryLimit && !usageOrder.empty()) {
+        eraseEntry(entries.find(usageOrder.back()));
+    }
+}
+
+}  // namespace neumann
@@ -0,0 +1,364 @@
+#include "core/zip_archive.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "core/hash_utils.h"
+#include "core/inflate.h"
+
+namespace fs = std::filesystem;
+
+namespace neumann {
+
+namespace {
+
+const uint32_t kLocalHeaderSignature = 0x04034b50;
+const uint32_t kCentralHeaderSignature = 0x02014b50;
+const uint32_t kEndOfCentralDirSignature = 0x06054b50;
+const uint32_t kZip64EndLocatorSignature = 0x07064b50;
+const uint32_t kZip64EndSignature = 0x06064b50;
+
+const size_t kLocalHeaderSize = 30;
+const size_t kCentralHeaderSize = 46;
+const size_t kEndOfCentralDirSize = 22;
+const size_t kZip64EndLocatorSize = 20;
+const size_t kZip64EndSize = 56;
+const size_t kMaxCommentSize = 0xFFFF;
+const size_t kStoredChunkSize = 64 * 1024;  // 存储方式成员交给回调的块大小
+const size_t kReadChunkSize = 256 * 1024;   // 从磁盘读取压缩数据的块大小
+const uint64_t kMaxReserveSize = 256ULL * 1024 * 1024;
+
+// ZIP中的整数均为小端序
+uint16_t readU16(const std::string &data, size_t offset)
+{
+    return static_cast<uint16_t>(static_cast<unsigned char>(data[offset]) |
+                                 (static_cast<unsigned char>(data[offset + 1]) << 8));
+}
+
+uint32_t readU32(const std::string &data, size_t offset)
+{
+    return static_cast<uint32_t>(readU16(data, offset)) |
+           (static_cast<uint32_t>(readU16(data, offset + 2)) << 16);
+}
+
+uint64_t readU64(const std::string &data, size_t offset)
+{
+    return static_cast<uint64_t>(readU32(data, offset)) |
+           (static_cast<uint64_t>(readU32(data, offset + 4)) << 32);
+}
+
+[[noreturn]] void invalidArchive(const std::string &message)
+{
+    throw std::runtime_error("Invalid ZIP archive: " + message);
+}
+
+// 从ZIP64扩展字段中读取被标记为0xFFFFFFFF的大小和偏移
+void applyZip64Extra(const std::string &directory, size_t extra, size_t extraEnd, ZipEntry &entry)
+{
+    while (extra + 4 <= extraEnd) {
+        uint16_t tag = readU16(directory, extra);
+        size_t fieldSize = readU16(directory, extra + 2);
+        size_t field = extra + 4;
+        if (field + fieldSize > extraEnd) {
+            return;
+        }
+
+        if (tag == 0x0001) {
+            size_t cursor = field;
+            auto take = [&](uint64_t &value) {
+                if (value == 0xFFFFFFFFu && cursor + 8 <= field + fieldSize) {
+                    value = readU64(directory, cursor);
+                    cursor += 8;
+                }
+            };
+            take(entry.uncompressedSize);
+            take(entry.compressedSize);
+            take(entry.localHeaderOffset);
+            return;
+        }
+        extra = field + fieldSize;
+    }
+}
+
+// 按块读取成员的压缩数据，提前停止解压时不读取剩余部分
+class EntryDataReader
+{
+public:
+    EntryDataReader(const std::string *buffer, const std::string &path, uint64_t offset,
+                    uint64_t size)
+        : buffer(buffer), path(path), offset(offset), remaining(size)
+    {
+        if (!buffer) {
+            // 每次读取单独打开文件，多个线程可以同时读取不同成员
+            file.open(path, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            file.seekg(static_cast<std::streamoff>(offset));
+        }
+    }
+
+    size_t next(const unsigned char *&data)
+    {
+        if (remaining == 0) {
+            return 0;
+        }
+
+        // 内存归档直接返回整段数据
+        if (buffer) {
+            data = reinterpret_cast<const unsigned char *>(buffer->data() + offset);
+            size_t size = static_cast<size_t>(remaining);
+            remaining = 0;
+            return size;
+        }
+
+        size_t size = static_cast<size_t>(std::min<uint64_t>(remaining, kReadChunkSize));
+        chunk.resize(size);
+        file.read(&chunk[0], static_cast<std::streamsize>(size));
+        if (static_cast<size_t>(file.gcount()) != size) {
+            throw std::runtime_error("Failed to read file: " + path);
+        }
+        remaining -= size;
+        data = reinterpret_cast<const unsigned char *>(chunk.data());
+        return size;
+    }
+
+private:
+    const std::string *buffer;
+    std::string path;
+    uint64_t offset;
+    uint64_t remaining;
+    std::ifstream file;
+    std::string chunk;
+};
+
+}  // namespace
+
+ZipArchive ZipArchive::openFile(const std::string &path)
+{
+    ZipArchive archive;
+    archive.path = path;
+
+    std::error_code ec;
+    archive.archiveSize = fs::file_size(path, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    archive.readCentralDirectory();
+    return archive;
+}
+
+ZipArchive ZipArchive::fromBuffer(std::string data)
+{
+    ZipArchive archive;
+    archive.buffer = std::make_shared<const std::string>(std::move(data));
+    archive.archiveSize = archive.buffer->size();
+    archive.readCentralDirectory();
+    return archive;
+}
+
+std::string ZipArchive::readRange(uint64_t offset, uint64_t size) const
+{
+    if (offset > archiveSize || size > archiveSize - offset) {
+        invalidArchive("unexpected end of archive");
+    }
+
+    if (buffer) {
+        return buffer->substr(static_cast<size_t>(offset), static_cast<size_t>(size));
+    }
+
+    // 每次读取单独打开文件，多个线程可以同时读取不同成员
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    std::string data(static_cast<size_t>(size), '\0');
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(&data[0], static_cast<std::streamsize>(size));
+    if (static_cast<uint64_t>(file.gcount()) != size) {
+        throw std::runtime_error("Failed to read file: " + path);
+    }
+    return data;
+}
+
+void ZipArchive::readCentralDirectory()
+{
+    // 中央目录结束记录位于文件末尾，之后最多跟随64KB的注释
+    uint64_t tailSize = std::min<uint64_t>(archiveSize, kEndOfCentralDirSize + kMaxCommentSize);
+    if (tailSize < kEndOfCentralDirSize) {
+        invalidArchive("file too small");
+    }
+    uint64_t tailOffset = archiveSize - tailSize;
+    std::string tail = readRange(tailOffset, tailSize);
+
+    size_t end = tail.size() - kEndOfCentralDirSize + 1;
+    bool found = false;
+    while (end-- > 0) {
+        if (readU32(tail, end) == kEndOfCentralDirSignature) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        invalidArchive("end of central directory not found");
+    }
+
+    uint64_t entryCount = readU16(tail, end + 10);
+    uint64_t directorySize = readU32(tail, end + 12);
+    uint64_t directoryOffset = readU32(tail, end + 16);
+
+    // ZIP64：字段溢出时实际值保存在ZIP64结束记录中
+    uint64_t endOffset = tailOffset + end;
+    if ((entryCount == 0xFFFF || directorySize == 0xFFFFFFFFu ||
+         directoryOffset == 0xFFFFFFFFu) &&
+        endOffset >= kZip64EndLocatorSize) {
+        std::string locator = readRange(endOffset - kZip64EndLocatorSize, kZip64EndLocatorSize);
+        if (readU32(locator, 0) == kZip64EndLocatorSignature) {
+            std::string record = readRange(readU64(locator, 8), kZip64EndSize);
+            if (readU32(record, 0) != kZip64EndSignature) {
+                invalidArchive("bad ZIP64 end of central directory");
+            }
+            entryCount = readU64(record, 32);
+            directorySize = readU64(record, 40);
+            directoryOffset = readU64(record, 48);
+        }
+    }
+
+    std::string directory = readRange(directoryOffset, directorySize);
+    entries.reserve(static_cast<size_t>(
+        std::min<uint64_t>(entryCount, directory.size() / kCentralHeaderSize)));
+
+    size_t pos = 0;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (pos + kCentralHeaderSize > directory.size() ||
+            readU32(directory, pos) != kCentralHeaderSignature) {
+            invalidArchive("bad central directory entry");
+        }
+
+        ZipEntry entry;
+        entry.flags = readU16(directory, pos + 8);
+        entry.method = readU16(directory, pos + 10);
+        entry.crc32 = readU32(directory, pos + 16);
+        entry.compressedSize = readU32(directory, pos + 20);
+        entry.uncompressedSize = readU32(directory, pos + 24);
+        size_t nameLength = readU16(directory, pos + 28);
+        size_t extraLength = readU16(directory, pos + 30);
+        size_t commentLength = readU16(directory, pos + 32);
+        entry.localHeaderOffset = readU32(directory, pos + 42);
+
+        size_t name = pos + kCentralHeaderSize;
+        size_t next = name + nameLength + extraLength + commentLength;
+        if (next > directory.size()) {
+            invalidArchive("bad central directory entry");
+        }
+
+        entry.name = directory.substr(name, nameLength);
+        // 个别工具使用反斜杠作为路径分隔符
+        std::replace(entry.name.begin(), entry.name.end(), '\\', '/');
+        applyZip64Extra(directory, name + nameLength, name + nameLength + extraLength, entry);
+
+        entryIndex.emplace(entry.name, entries.size());
+        entries.push_back(std::move(entry));
+        pos = next;
+    }
+}
+
+const ZipEntry *ZipArchive::findEntry(const std::string &name) const
+{
+    auto it = entryIndex.find(name);
+    if (it != entryIndex.end()) {
+        return &entries[it->second];
+    }
+
+    auto equalsIgnoreCase = [](const std::string &a, const std::string &b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) ==
+                          std::tolower(static_cast<unsigned char>(y));
+               });
+    };
+    for (const auto &entry : entries) {
+        if (equalsIgnoreCase(entry.name, name)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string ZipArchive::readEntry(const std::string &name) const
+{
+    std::string content;
+    const ZipEntry *entry = findEntry(name);
+    if (entry) {
+        content.reserve(static_cast<size_t>(std::min(entry->uncompressedSize, kMaxReserveSize)));
+    }
+
+    streamEntry(name, [&content](const char *data, size_t size) {
+        content.append(data, size);
+        return true;
+    });
+    return content;
+}
+
+bool ZipArchive::streamEntry(const std::string &name, const ChunkConsumer &consumer) const
+{
+    const ZipEntry *entry = findEntry(name);
+    if (!entry) {
+        throw std::runtime_error("ZIP entry not found: " + name);
+    }
+    if (entry->flags & 0x0001) {
+        throw std::runtime_error("Encrypted ZIP entry is not supported: " + name);
+    }
+
+    // 本地文件头中的文件名和扩展字段长度可能与中央目录不同，数据偏移以本地文件头为准
+    std::string header = readRange(entry->localHeaderOffset, kLocalHeaderSize);
+    if (readU32(header, 0) != kLocalHeaderSignature) {
+        invalidArchive("bad local header for " + name);
+    }
+    uint64_t dataOffset = entry->localHeaderOffset + kLocalHeaderSize + readU16(header, 26) +
+                          readU16(header, 28);
+    if (dataOffset > archiveSize || entry->compressedSize > archiveSize - dataOffset) {
+        invalidArchive("unexpected end of archive");
+    }
+    EntryDataReader reader(buffer.get(), path, dataOffset, entry->compressedSize);
+
+    Crc32 crc;
+    uint64_t total = 0;
+    auto verify = [&](const char *data, size_t size) {
+        crc.update(data, size);
+        total += size;
+        return consumer(data, size);
+    };
+
+    bool complete = true;
+    if (entry->method == 0) {
+        const unsigned char *data = nullptr;
+        for (size_t size = reader.next(data); complete && size > 0; size = reader.next(data)) {
+            for (size_t offset = 0; offset < size; offset += kStoredChunkSize) {
+                size_t length = std::min(kStoredChunkSize, size - offset);
+                if (!verify(reinterpret_cast<const char *>(data) + offset, length)) {
+                    complete = false;
+                    break;
+                }
+            }
+        }
+    } else if (entry->method == 8) {
+        complete = inflateRaw([&reader](const unsigned char *&data) { return reader.next(data); },
+                              entry->uncompressedSize, verify);
+    } else {
+        throw std::runtime_error("Unsupported ZIP compression method " +
+                                 std::to_string(entry->method) + ": " + name);
+    }
+
+    if (complete && (total != entry->uncompressedSize || crc.digest() != entry->crc32)) {
+        invalidArchive("checksum mismatch in " + name);
+    }
+    return complete;
+}
+
+}  // namespace neumann
@@ -1,12 +1,21 @@
 #include "web/web_server.h"
 
 // 标准库头文件
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 
 // 第三方库
 #define CROW_MAIN
@@ -15,14 +24,25 @@
 #include <nlohmann/json.hpp>
 
 // 项目头文件
+#include "core/analysis_request.h"
+#include "core/batch_job_service.h"
 #include "core/batch_processor.h"
 #include "core/config.h"
+#include "core/content_encoding.h"
 #include "core/data_manager.h"
 #include "core/data_visualization.h"
 #include "core/excel_reader.h"
+#include "core/file_discovery.h"
+#include "core/hash_utils.h"
 #include "core/i18n.h"
+#include "core/metrics.h"
 #include "core/neumann_calculator.h"
+#include "core/online_neumann_calculator.h"
+#include "core/response_cache.h"
+#include "core/result_encoding.h"
 #include "core/standard_values.h"
+#include "core/static_asset_cache.h"
+#include "core/thread_pool.h"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -30,18 +50,252 @@ namespace fs = std::filesystem;
 namespace neumann { namespace web {
 
 // PIMPL实现类
+namespace {
+
+// 带路径参数的API路由前缀，指标中把参数替换为占位符以限制标签数量
+const char *const kParameterizedRoutes[] = {
+    "/api/batch/status/", "/api/batch/cancel/",       "/api/dataset/delete/",
+    "/api/dataset/",      "/api/language/",           "/api/confidence_level/",
+    "/api/translations/", "/api/svg_files/"};
+
+std::string routeLabel(const std::string &url, int status)
+{
+    if (url.compare(0, 5, "/api/") != 0) {
+        return url == "/" ? url : "/<path>";
+    }
+    for (const char *prefix : kParameterizedRoutes) {
+        size_t length = std::char_traits<char>::length(prefix);
+        if (url.size() > length && url.compare(0, length, prefix) == 0) {
+            return std::string(prefix) + "<string>";
+        }
+    }
+    // 不存在的API路径不单独统计
+    return status == 404 ? "unmatched" : url;
+}
+
+}  // namespace
+
+/**
+ * @brief 记录每个路由的请求数、耗时和数据大小
+ *
+ * 按路由查找指标的结果缓存在线程局部的表中，之后的记录只更新当前线程的分片，不加锁。
+ */
+struct RequestMetrics {
+    struct context {
+        std::chrono::steady_clock::time_point start;
+    };
+
+    struct RouteMetrics {
+        Histogram *duration;
+        Histogram *requestSize;
+        Histogram *responseSize;
+    };
+
+    Gauge &inFlight = MetricsRegistry::getInstance().gauge(
+        "neumann_http_requests_in_flight", "HTTP requests currently being handled");
+
+    void before_handle(crow::request &, crow::response &, context &ctx)
+    {
+        inFlight.increment();
+        ctx.start = std::chrono::steady_clock::now();
+    }
+
+    void after_handle(crow::request &req, crow::response &res, context &ctx)
+    {
+        double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - ctx.start).count();
+        inFlight.decrement();
+
+        std::string route = routeLabel(req.url, res.code);
+        const RouteMetrics &metrics = routeMetrics(route);
+        metrics.duration->observe(seconds);
+        metrics.requestSize->observe(static_cast<double>(req.body.size()));
+        metrics.responseSize->observe(static_cast<double>(res.body.size()));
+        requestCounter(route, crow::method_name(req.method), res.code).increment();
+    }
+
+private:
+    static const RouteMetrics &routeMetrics(const std::string &route)
+    {
+        thread_local std::unordered_map<std::string, RouteMetrics> cache;
+        auto it = cache.find(route);
+        if (it == cache.end()) {
+            auto &registry = MetricsRegistry::getInstance();
+            MetricLabels labels = {{"route", route}};
+            RouteMetrics metrics;
+            metrics.duration = &registry.histogram("neumann_http_request_duration_seconds",
+                                                   "HTTP request latency",
+                                                   Histogram::latencyBuckets(), labels);
+            metrics.requestSize =
+                &registry.histogram("neumann_http_request_size_bytes", "HTTP request body size",
+                                    Histogram::sizeBuckets(), labels);
+            metrics.responseSize =
+                &registry.histogram("neumann_http_response_size_bytes",
+                                    "HTTP response body size", Histogram::sizeBuckets(), labels);
+            it = cache.emplace(route, metrics).first;
+        }
+        return it->second;
+    }
+
+    static Counter &requestCounter(const std::string &route, const std::string &method,
+                                   int status)
+    {
+        thread_local std::unordered_map<std::string, Counter *> cache;
+        std::string code = std::to_string(status);
+        std::string key = route + ' ' + method + ' ' + code;
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            Counter &counter = MetricsRegistry::getInstance().counter(
+                "neumann_http_requests_total", "HTTP requests by route, method and status",
+                {{"route", route}, {"method", method}, {"status", code}});
+            it = cache.emplace(key, &counter).first;
+        }
+        return *it->second;
+    }
+};
+
+/**
+ * @brief 拒绝请求体超过限制的请求
+ *
+ * Crow在解析完请求后才调用中间件，这里避免过大的请求进入处理函数。
+ */
+struct RequestSizeLimit {
+    struct context {};
+
+    size_t maxSize = 0;  // 0表示不限制
+
+    void before_handle(crow::request &req, crow::response &res, context &)
+    {
+        if (maxSize > 0 && req.body.size() > maxSize) {
+            json error = {{"success", false},
+                          {"error", "请求体过大，最大允许" + std::to_string(maxSize) + "字节"}};
+            res.code = 413;
+            res.set_header("Content-Type", "application/json");
+            res.end(error.dump());
+        }
+    }
+
+    void after_handle(crow::request &, crow::response &, context &) {}
+};
+
 class WebServerImpl
 {
 public:
     WebServerImpl(int port, const std::string &webRootDir)
-        : app(), port(port), webRootDir(webRootDir)
+        : app(),
+          port(port),
+          webRootDir(webRootDir),
+          assets(webRootDir),
+          assetHits(cacheLookupCounter("static_assets", "hit")),
+          assetMisses(cacheLookupCounter("static_assets", "miss")),
+          responses(static_cast<size_t>(Config::getInstance().getApiResponseCacheSize()))
     {
     }
 
-    crow::SimpleApp app;
+    // 指标中间件在前，被拒绝的请求也会被统计
+    crow::App<RequestMetrics, RequestSizeLimit> app;
     int port;
     std::string webRootDir;
     std::thread serverThread;
+
+    // 启动时加载的静态文件
+    StaticAssetCache assets;
+    Counter &assetHits;
+    Counter &assetMisses;
+
+    // 相同分析请求的合并计算和结果缓存
+    ResponseCache responses;
+
+    /**
+     * @brief 分析请求中data或time数组的最大长度
+     *
+     * apiMaxDataPoints为0时由请求体上限推出：每个数值连同分隔符至少占2字节，
+     * 通过请求体大小检查的请求不会再因为点数被拒绝。
+     */
+    size_t maxAnalysisPoints()
+    {
+        int configured = Config::getInstance().getApiMaxDataPoints();
+        if (configured > 0) {
+            return static_cast<size_t>(configured);
+        }
+        size_t maxSize = app.get_middleware<RequestSizeLimit>().maxSize;
+        return maxSize > 0 ? maxSize / 2 : std::numeric_limits<size_t>::max();
+    }
+
+    /**
+     * @brief 合并同时到达的相同分析请求，并复用缓存的结果
+     *
+     * 键包含路由、响应格式、标准值表的版本和请求体的长度及哈希，标准值变化后旧结果不再命中；
+     * 命中时缓存再与保存的请求体逐字节比较，哈希碰撞的请求不会得到其他请求的结果。
+     * 未压缩的结果和按Accept-Encoding压缩后的结果分别缓存，命中时不再重复压缩。
+     */
+    crow::response analysisResponse(const crow::request &req, const std::string &variant,
+                                    const std::function<CachedResponse()> &compute)
+    {
+        // 请求体可能有数MB，键中只放摘要，请求体只在未命中时复制
+        Fnv1a64 bodyHash;
+        bodyHash.update(req.body);
+        std::string key = req.url + '\n' + variant + '\n' +
+                          std::to_string(StandardValues::getInstance().getVersion()) + '\n' +
+                          std::to_string(req.body.size()) + ':' + bodyHash.hexDigest();
+
+        std::shared_ptr<const CachedResponse> cached;
+        ContentEncoding encoding =
+            negotiateContentEncoding(req.get_header_value("Accept-Encoding"));
+        if (encoding == ContentEncoding::IDENTITY) {
+            cached = responses.getOrCompute(key, req.body, compute);
+        } else {
+            // 压缩后的结果由未压缩的结果得到，不同编码的请求共享一次计算
+            std::string encodedKey = key + '\n' + contentEncodingName(encoding);
+            cached = responses.getOrCompute(encodedKey, req.body, [&]() {
+                CachedResponse response = *responses.getOrCompute(key, req.body, compute);
+                Config &config = Config::getInstance();
+                ContentEncoding used = compressBody(
+                    response.body, encoding, static_cast<size_t>(config.getApiCompressionMinSize()),
+                    config.getApiCompressionLevel());
+                response.contentEncoding = contentEncodingName(used);
+                return response;
+            });
+        }
+
+        crow::response response(cached->body);
+        response.set_header("Content-Type", cached->contentType);
+        if (!cached->contentEncoding.empty()) {
+            response.set_header("Content-Encoding", cached->contentEncoding);
+        }
+        response.add_header("Vary", "Accept-Encoding");
+        return response;
+    }
+
+    // 每个实时推送通道的增量计算器
+    std::mutex streamMutex;
+    std::map<crow::websocket::connection *, std::shared_ptr<OnlineNeumannCalculator>> streams;
+
+    std::shared_ptr<OnlineNeumannCalculator> findStream(crow::websocket::connection *connection)
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        auto it = streams.find(connection);
+        return it == streams.end() ? nullptr : it->second;
+    }
+
+    // 按客户端的Accept-Encoding压缩较大的API响应体
+    static crow::response compressedResponse(const crow::request &req, std::string body,
+                                             const std::string &contentType = "application/json")
+    {
+        Config &config = Config::getInstance();
+        ContentEncoding encoding =
+            compressBody(body, negotiateContentEncoding(req.get_header_value("Accept-Encoding")),
+                         static_cast<size_t>(config.getApiCompressionMinSize()),
+                         config.getApiCompressionLevel());
+
+        crow::response response(std::move(body));
+        response.set_header("Content-Type", contentType);
+        if (encoding != ContentEncoding::IDENTITY) {
+            response.set_header("Content-Encoding", contentEncodingName(encoding));
+        }
+        response.add_header("Vary", "Accept-Encoding");
+        return response;
+    }
 };
 
 WebServer::WebServer(int port, const std::string &webRootDir)
@@ -65,6 +319,9 @@ WebServer::WebServer(int port, const std::string &webRootDir)
         std::cerr << "警告: 未找到Web界面文件: " << indexFile << std::endl;
     }
 
+    // 把静态文件读入内存并预压缩，请求时不再访问文件系统
+    impl->assets.refresh();
+
     // 初始化路由
     initializeRoutes();
 }
@@ -83,16 +340,44 @@ void WebServer::start(bool background)
         return;
     }
 
-    std::cout << "启动Web服务器，监听端口: " << port << std::endl;
-    std::cout << "Web界面访问URL: " << getUrl() << std::endl;
+    auto &app = impl->app;
+    app.get_middleware<RequestSizeLimit>().maxSize = options.maxRequestSize;
+
+    unsigned int threads = options.threadCount > 0
+                               ? static_cast<unsigned int>(options.threadCount)
+                               : std::max(1u, std::thread::hardware_concurrency());
+    app.concurrency(static_cast<uint16_t>(std::min(threads, 1024u)))
+        .timeout(static_cast<uint8_t>(std::clamp(options.idleTimeout, 1, 255)));
+
+    if (!options.unixSocketPath.empty()) {
+#ifdef _WIN32
+        std::cerr << "警告: 当前平台不支持Unix域套接字，改为监听TCP端口" << std::endl;
+        options.unixSocketPath.clear();
+#else
+        // 删除上次运行遗留的套接字文件，否则无法绑定
+        std::error_code ec;
+        if (fs::is_socket(options.unixSocketPath, ec)) {
+            fs::remove(options.unixSocketPath, ec);
+        }
+        app.local_socket_path(options.unixSocketPath);
+        std::cout << "启动Web服务器，监听Unix域套接字: " << options.unixSocketPath << std::endl;
+#endif
+    }
+    if (options.unixSocketPath.empty()) {
+        app.bindaddr(options.bindAddress).port(static_cast<uint16_t>(port));
+        std::cout << "启动Web服务器，监听地址: " << options.bindAddress << ":" << port << std::endl;
+        std::cout << "Web界面访问URL: " << getUrl() << std::endl;
+    }
+    std::cout << "工作线程数: " << threads << std::endl;
 
+    // 前台运行时run()一直阻塞到stop()，需要先标记为运行中，信号处理才能停止服务器
+    running = true;
     if (background) {
-        impl->serverThread = std::thread([this]() { impl->app.port(port).multithreaded().run(); });
+        impl->serverThread = std::thread([this]() { impl->app.run(); });
     } else {
-        impl->app.port(port).run();
+        impl->app.run();
+        running = false;
     }
-
-    running = true;
 }
 
 void WebServer::stop()
@@ -111,6 +396,20 @@ void WebServer::stop()
     running = false;
 }
 
+void WebServer::setAssetReloadInterval(int milliseconds)
+{
+    if (milliseconds > 0) {
+        impl->assets.startWatching(std::chrono::milliseconds(milliseconds));
+    } else {
+        impl->assets.stopWatching();
+    }
+}
+
+void WebServer::setServerOptions(const ServerOptions &serverOptions)
+{
+    options = serverOptions;
+}
+
 bool WebServer::isRunning() const
 {
     return running;
@@ -118,13 +417,24 @@ bool WebServer::isRunning() const
 
 std::string WebServer::getUrl() const
 {
-    return "http://localhost:" + std::to_string(port);
+    if (!options.unixSocketPath.empty()) {
+        return "unix:" + options.unixSocketPath;
+    }
+    // 监听所有地址时通过本机访问
+    std::string host = options.bindAddress;
+    if (host.empty() || host == "0.0.0.0" || host == "::") {
+        host = "localhost";
+    } else if (host.find(':') != std::string::npos) {
+        host = "[" + host + "]";
+    }
+    return "http://" + host + ":" + std::to_string(port);
 }
 
 void WebServer::initializeRoutes()
 {
     // 先注册API端点
     registerApiEndpoints();
+    registerStreamEndpoints();
 
     // 默认路由
     CROW_ROUTE(impl->app, "/")
@@ -137,7 +447,41 @@ void WebServer::initializeRoutes()
 
     // 静态文件服务（放在最后，避免拦截API请求）
     CROW_ROUTE(impl->app, "/<path>")
-    ([this](const std::string &path) {
+    ([this](const crow::request &req, const std::string &path) {
+        std::shared_ptr<const StaticAsset> asset = impl->assets.find(path);
+        if (!asset && (path.empty() || fs::is_directory(impl->webRootDir + "/" + path))) {
+            asset = impl->assets.find("neumann_trend_test.html");
+        }
+
+        (asset ? impl->assetHits : impl->assetMisses).increment();
+        if (asset) {
+            // 只预压缩了gzip，协商结果为deflate时发送原始内容
+            bool gzip = !asset->gzipContent.empty() &&
+                        negotiateContentEncoding(req.get_header_value("Accept-Encoding")) ==
+                            ContentEncoding::GZIP;
+
+            // 每次请求都用ETag验证，内容未变时只返回304；两种编码使用不同的强ETag
+            crow::response response;
+            response.set_header("ETag", gzip ? asset->gzipEtag : asset->etag);
+            response.set_header("Cache-Control", "no-cache");
+            response.add_header("Vary", "Accept-Encoding");
+            if (StaticAssetCache::etagMatches(req.get_header_value("If-None-Match"),
+                                              asset->etag)) {
+                response.code = 304;
+                return response;
+            }
+
+            response.set_header("Content-Type", asset->contentType);
+            if (gzip) {
+                response.set_header("Content-Encoding", "gzip");
+                response.body = asset->gzipContent;
+            } else {
+                response.body = asset->content;
+            }
+            return response;
+        }
+
+        // 未缓存的文件（超过缓存大小上限或启动后新增）直接从磁盘读取
         std::string filePath = impl->webRootDir + "/" + path;
 
         if (path.empty() || fs::is_directory(filePath)) {
@@ -148,18 +492,7 @@ void WebServer::initializeRoutes()
             return crow::response(404);
         }
 
-        std::string contentType = "text/plain";
-        std::string extension = fs::path(filePath).extension().string();
-
-        if (extension == ".html") {
-            contentType = "text/html";
-        } else if (extension == ".css") {
-            contentType = "text/css";
-        } else if (extension == ".js") {
-            contentType = "application/javascript";
-        } else if (extension == ".json") {
-            contentType = "application/json";
-        }
+        std::string contentType = StaticAssetCache::contentTypeFor(filePath);
 
         std::ifstream file(filePath, std::ios::binary);
         if (!file) {
@@ -184,10 +517,59 @@ void WebServer::registerApiEndpoints()
         return response.dump();
     });
 
-    // 核心测试API
+    // 运行指标（Prometheus文本格式），队列长度在采集时读取
+    MetricsRegistry::getInstance().gaugeCallback(
+        "neumann_batch_jobs_queued", "Batch jobs waiting for a worker", []() {
+            return static_cast<double>(BatchJobService::getInstance().getQueuedJobCount());
+        });
+
+    CROW_ROUTE(impl->app, "/api/metrics")
+    ([](const crow::request &req) {
+        return WebServerImpl::compressedResponse(req, MetricsRegistry::getInstance().render(),
+                                                 "text/plain; version=0.0.4; charset=utf-8");
+    });
+
+    // 核心测试API，按Accept头返回JSON或列式二进制
     CROW_ROUTE(impl->app, "/api/neumann_test")
+        .methods("POST"_method)([this](const crow::request &req) {
+            std::string accept = req.get_header_value("Accept");
+            std::string variant = std::to_string(static_cast<int>(negotiateResultEncoding(accept)));
+            crow::response response = impl->analysisResponse(req, variant, [&]() {
+                CachedResponse result;
+                result.body = handleNeumannTestRequest(req.body, accept, result.contentType);
+                return result;
+            });
+            response.add_header("Vary", "Accept");
+            return response;
+        });
+
+    // 一次请求分析多个序列
+    CROW_ROUTE(impl->app, "/api/neumann_test/batch")
+        .methods("POST"_method)([this](const crow::request &req) {
+            return impl->analysisResponse(req, "json", [&]() {
+                return CachedResponse{"application/json", handleNeumannBatchRequest(req.body), ""};
+            });
+        });
+
+    // 异步批量作业：提交后立即返回作业ID，通过轮询获取进度和结果
+    CROW_ROUTE(impl->app, "/api/batch/process")
         .methods("POST"_method)(
-            [this](const crow::request &req) { return handleNeumannTestRequest(req.body); });
+            [this](const crow::request &req) { return handleBatchProcessRequest(req.body); });
+
+    CROW_ROUTE(impl->app, "/api/batch/status/<string>")
+    ([this](const crow::request &req, const std::string &jobId) {
+        json request = {{"jobId", jobId}};
+        if (const char *offset = req.url_params.get("offset")) {
+            request["offset"] = std::strtoull(offset, nullptr, 10);
+        }
+        return WebServerImpl::compressedResponse(req, handleBatchStatusRequest(request.dump()));
+    });
+
+    CROW_ROUTE(impl->app, "/api/batch/cancel/<string>")
+        .methods("POST"_method)([this](const std::string &jobId) {
+            json request = {{"jobId", jobId}};
+            return handleBatchCancelRequest(request.dump());
+        });
 
     // 数据集管理
     CROW_ROUTE(impl->app, "/api/datasets")
@@ -198,7 +580,9 @@ void WebServer::registerApiEndpoints()
     });
 
     CROW_ROUTE(impl->app, "/api/dataset/<string>")
-    ([this](const std::string &name) { return handleDataSetLoadRequestByName(name); });
+    ([this](const crow::request &req, const std::string &name) {
+        return WebServerImpl::compressedResponse(req, handleDataSetLoadRequestByName(name));
+    });
 
     CROW_ROUTE(impl->app, "/api/dataset/delete/<string>")
     ([this](const std::string &name) {
@@ -234,7 +618,9 @@ void WebServer::registerApiEndpoints()
 
     // 标准值
     CROW_ROUTE(impl->app, "/api/standard_values")
-    ([this]() { return handleStandardValuesGetRequest(); });
+    ([this](const crow::request &req) {
+        return WebServerImpl::compressedResponse(req, handleStandardValuesGetRequest());
+    });
 
     // 翻译
     CROW_ROUTE(impl->app, "/api/translations/<string>")
@@ -254,13 +640,21 @@ void WebServer::registerApiEndpoints()
 
 // 简化的API处理函数
 
-std::string WebServer::handleNeumannTestRequest(const std::string &requestBody)
+std::string WebServer::handleNeumannTestRequest(const std::string &requestBody,
+                                                const std::string &acceptHeader,
+                                                std::string &contentType)
 {
+    // 错误响应始终为JSON
+    contentType = "application/json";
+
     try {
-        json request = json::parse(requestBody);
-        std::vector<double> dataPoints = request["data"].get<std::vector<double>>();
-        std::vector<double> timePoints = request["time"].get<std::vector<double>>();
-        double confidenceLevel = request.value("confidenceLevel", 0.95);
+        // 不构建JSON文档树，数组直接解析到数值缓冲区
+        AnalysisRequest request = parseAnalysisRequest(requestBody, impl->maxAnalysisPoints());
+        const std::vector<double> &dataPoints = request.dataPoints;
+        const std::vector<double> &timePoints = request.timePoints;
+        double confidenceLevel = request.confidenceLevel;
+        // 客户端已有输入数据时可以关闭回显，减小响应
+        bool echoInput = request.echo;
 
         if (dataPoints.size() < 4) {
             json error = {{"success", false}, {"error", "需要至少4个数据点"}};
@@ -275,21 +669,213 @@ std::string WebServer::handleNeumannTestRequest(const std::string &requestBody)
         NeumannCalculator calculator(confidenceLevel);
         NeumannTestResults results = calculator.performTest(dataPoints, timePoints);
 
-        json response = {{"success", true},        {"data", dataPoints},
-                         {"time", timePoints},     {"overallTrend", results.overallTrend},
-                         {"minPG", results.minPG}, {"maxPG", results.maxPG},
-                         {"avgPG", results.avgPG}, {"results", json::array()}};
+        if (negotiateResultEncoding(acceptHeader) == ResultEncoding::COLUMNAR) {
+            contentType = kColumnarContentType;
+            return encodeResultsColumnar(results, echoInput);
+        }
+        return encodeResultsJson(results, echoInput);
+    }
+    catch (const std::exception &e) {
+        json error = {{"success", false}, {"error", std::string("处理请求时出错: ") + e.what()}};
+        return error.dump();
+    }
+}
+
+void WebServer::registerStreamEndpoints()
+{
+    // 每个连接是一个序列的通道，客户端推送新的观测值，服务器返回增量结果
+    CROW_WEBSOCKET_ROUTE(impl->app, "/api/neumann_test/stream")
+        .onopen([this](crow::websocket::connection &connection) {
+            std::lock_guard<std::mutex> lock(impl->streamMutex);
+            impl->streams[&connection] = std::make_shared<OnlineNeumannCalculator>();
+        })
+        .onmessage([this](crow::websocket::connection &connection, const std::string &message,
+                          bool /*isBinary*/) {
+            auto calculator = impl->findStream(&connection);
+            if (!calculator) {
+                return;
+            }
+            connection.send_text(handleStreamMessage(*calculator, message));
+        })
+        // 不同版本的Crow在关闭回调中是否传入关闭码不同，用参数包兼容两者
+        .onclose([this](crow::websocket::connection &connection, const std::string & /*reason*/,
+                        auto... /*code*/) {
+            std::lock_guard<std::mutex> lock(impl->streamMutex);
+            impl->streams.erase(&connection);
+        });
+}
+
+std::string WebServer::handleStreamMessage(OnlineNeumannCalculator &calculator,
+                                           const std::string &message)
+{
+    try {
+        json request = json::parse(message);
+
+        double confidenceLevel = request.value("confidenceLevel", calculator.getConfidenceLevel());
+        if (request.value("reset", false) || calculator.getPointCount() == 0) {
+            calculator.reset(confidenceLevel);
+        }
+
+        std::vector<double> values;
+        std::vector<double> times;
+        if (request.contains("value")) {
+            values.push_back(request["value"].get<double>());
+            if (request.contains("time")) {
+                times.push_back(request["time"].get<double>());
+            }
+        } else if (request.contains("data")) {
+            values = request["data"].get<std::vector<double>>();
+            times = request.value("time", std::vector<double>());
+        }
+        if (!times.empty() && times.size() != values.size()) {
+            json error = {{"success", false}, {"error", "时间点数量必须与数据点数量一致"}};
+            return error.dump();
+        }
+
+        // 只返回新增测试点的结果，未给出时间点时使用数据点的序号
+        json points = json::array();
+        for (size_t i = 0; i < values.size(); ++i) {
+            size_t index = calculator.getPointCount();
+            double timePoint = times.empty() ? static_cast<double>(index) : times[i];
+            NeumannResult result;
+            if (calculator.addPoint(values[i], result)) {
+                points.push_back({{"index", index},
+                                  {"dataPoint", values[i]},
+                                  {"timePoint", timePoint},
+                                  {"pgValue", result.pgValue},
+                                  {"wpThreshold", result.wpThreshold},
+                                  {"hasTrend", result.hasTrend}});
+            }
+        }
+
+        json response = {{"success", true},
+                         {"confidenceLevel", calculator.getConfidenceLevel()},
+                         {"pointCount", calculator.getPointCount()},
+                         {"overallTrend", calculator.hasOverallTrend()},
+                         {"minPG", calculator.getMinPG()},
+                         {"maxPG", calculator.getMaxPG()},
+                         {"avgPG", calculator.getAvgPG()},
+                         {"results", std::move(points)}};
+        return response.dump();
+    }
+    catch (const std::exception &e) {
+        json error = {{"success", false}, {"error", std::string("处理消息时出错: ") + e.what()}};
+        return error.dump();
+    }
+}
+
+std::string WebServer::handleNeumannBatchRequest(const std::string &requestBody)
+{
+    try {
+        json request = json::parse(requestBody);
+
+        // 序列数组，或共用时间列的列式矩阵
+        std::vector<DataSet> series;
+        if (request.contains("series")) {
+            for (const auto &item : request["series"]) {
+                DataSet dataSet;
+                dataSet.name = item.value("name", "series" + std::to_string(series.size() + 1));
+                dataSet.dataPoints = item.at("data").get<std::vector<double>>();
+                if (item.contains("time")) {
+                    dataSet.timePoints = item["time"].get<std::vector<double>>();
+                }
+                series.push_back(std::move(dataSet));
+            }
+        } else if (request.contains("matrix")) {
+            const json &matrix = request["matrix"];
+            std::vector<double> timePoints = matrix.value("time", std::vector<double>());
+            std::vector<std::string> names = matrix.value("names", std::vector<std::string>());
+            for (const auto &column : matrix.at("columns")) {
+                DataSet dataSet;
+                size_t index = series.size();
+                dataSet.name = index < names.size() ? names[index]
+                                                    : "series" + std::to_string(index + 1);
+                dataSet.dataPoints = column.get<std::vector<double>>();
+                dataSet.timePoints = timePoints;
+                series.push_back(std::move(dataSet));
+            }
+        } else {
+            json error = {{"success", false}, {"error", "请求中缺少series或matrix"}};
+            return error.dump();
+        }
+
+        // 未给出时间点时使用0, 1, 2, ...
+        for (auto &dataSet : series) {
+            if (dataSet.timePoints.empty()) {
+                dataSet.timePoints.resize(dataSet.dataPoints.size());
+                std::iota(dataSet.timePoints.begin(), dataSet.timePoints.end(), 0.0);
+            }
+        }
 
-        for (size_t i = 0; i < results.results.size(); ++i) {
-            size_t dataIndex = i + 3;
-            json result = {{"dataPoint", results.data[dataIndex]},
-                           {"timePoint", results.timePoints[dataIndex]},
-                           {"pgValue", results.results[i].pgValue},
-                           {"wpThreshold", results.results[i].wpThreshold},
-                           {"hasTrend", results.results[i].hasTrend}};
-            response["results"].push_back(result);
+        std::vector<double> confidenceLevels =
+            request.value("confidenceLevels",
+                          std::vector<double>{request.value("confidenceLevel", 0.95)});
+        if (confidenceLevels.empty()) {
+            json error = {{"success", false}, {"error", "置信水平列表不能为空"}};
+            return error.dump();
+        }
+        bool detail = request.value("detail", false);
+
+        // 每个序列和置信水平的组合是一个任务，分布到共享线程池中并行计算
+        const size_t levelCount = confidenceLevels.size();
+        std::vector<NeumannTestResults> results(series.size() * levelCount);
+        ThreadPool::shared().parallelFor(results.size(), [&](size_t task) {
+            const DataSet &dataSet = series[task / levelCount];
+            if (dataSet.dataPoints.size() >= 4 &&
+                dataSet.timePoints.size() == dataSet.dataPoints.size()) {
+                NeumannCalculator calculator(confidenceLevels[task % levelCount]);
+                results[task] = calculator.performTest(dataSet.dataPoints, dataSet.timePoints);
+            }
+        });
+
+        json items = json::array();
+        for (size_t i = 0; i < series.size(); ++i) {
+            const DataSet &dataSet = series[i];
+            json item = {{"name", dataSet.name}, {"points", dataSet.dataPoints.size()}};
+
+            // 单个序列无效时只记录错误，不影响其他序列
+            if (dataSet.dataPoints.size() < 4) {
+                item["error"] = "需要至少4个数据点";
+            } else if (dataSet.timePoints.size() != dataSet.dataPoints.size()) {
+                item["error"] = "时间点数量必须与数据点数量一致";
+            } else {
+                json levels = json::array();
+                for (size_t level = 0; level < levelCount; ++level) {
+                    const NeumannTestResults &result = results[i * levelCount + level];
+                    size_t trendPoints = std::count_if(
+                        result.results.begin(), result.results.end(),
+                        [](const NeumannResult &point) { return point.hasTrend; });
+                    json summary = {{"confidenceLevel", confidenceLevels[level]},
+                                    {"overallTrend", result.overallTrend},
+                                    {"minPG", result.minPG},
+                                    {"maxPG", result.maxPG},
+                                    {"avgPG", result.avgPG},
+                                    {"trendPoints", trendPoints}};
+
+                    // 逐点结果按列给出，第i个值对应第i+4个数据点
+                    if (detail) {
+                        json pgValues = json::array();
+                        json wpThresholds = json::array();
+                        json hasTrend = json::array();
+                        for (const auto &point : result.results) {
+                            pgValues.push_back(point.pgValue);
+                            wpThresholds.push_back(point.wpThreshold);
+                            hasTrend.push_back(point.hasTrend);
+                        }
+                        summary["pgValues"] = std::move(pgValues);
+                        summary["wpThresholds"] = std::move(wpThresholds);
+                        summary["hasTrend"] = std::move(hasTrend);
+                    }
+                    levels.push_back(std::move(summary));
+                }
+                item["levels"] = std::move(levels);
+            }
+            items.push_back(std::move(item));
         }
 
+        json response = {{"success", true},
+                         {"confidenceLevels", confidenceLevels},
+                         {"series", std::move(items)}};
         return response.dump();
     }
     catch (const std::exception &e) {
@@ -479,17 +1065,13 @@ std::string WebServer::handleTranslationsGetRequest(const std::string &language)
 {
     try {
         auto &i18n = I18n::getInstance();
-        Language originalLang = i18n.getCurrentLanguage();
         Language requestedLang = (language == "zh") ? Language::CHINESE : Language::ENGLISH;
 
-        // 临时切换语言获取翻译
-        i18n.setLanguage(requestedLang);
-
         json translations;
 
-        // 应用标题和描述
-        translations["app.title"] = i18n.getText("app.title");
-        translations["app.description"] = i18n.getText("app.description");
+        // 应用标题和描述（按请求的语言查找，不切换全局语言）
+        translations["app.title"] = i18n.getText("app.title", requestedLang);
+        translations["app.description"] = i18n.getText("app.description", requestedLang);
 
         // 标签页
         translations["tab.test"] = (language == "zh") ? "测试" : "Test";
@@ -664,9 +1246,6 @@ std::string WebServer::handleTranslationsGetRequest(const std::string &language)
         translations["message.sample_loaded"] =
             (language == "zh") ? "样本数据加载成功" : "Sample data loaded successfully";
 
-        // 恢复原始语言
-        i18n.setLanguage(originalLang);
-
         json response = {{"success", true}, {"language", language}, {"translations", translations}};
         return response.dump();
     }
@@ -679,43 +1258,15 @@ std::string WebServer::handleTranslationsGetRequest(const std::string &language)
 std::string WebServer::handleStatisticsRequest()
 {
     try {
-        auto &dataManager = DataManager::getInstance();
-        auto datasetNames = dataManager.getDataSetNames();
-
-        int totalDatasets = datasetNames.size();
-        int datasetsWithTrend = 0;
-        double totalDataPoints = 0;
-        double totalPGValue = 0;
-        int totalTests = 0;
-
-        for (const auto &name : datasetNames) {
-            try {
-                auto dataset = dataManager.loadDataSet(name);
-
-                if (dataset.dataPoints.size() >= 4) {
-                    NeumannCalculator calculator(0.95);
-                    auto results = calculator.performTest(dataset.dataPoints, dataset.timePoints);
-
-                    if (results.overallTrend) {
-                        datasetsWithTrend++;
-                    }
-
-                    totalDataPoints += dataset.dataPoints.size();
-                    totalPGValue += results.avgPG;
-                    totalTests++;
-                }
-            }
-            catch (...) {
-                // 跳过无法处理的数据集
-            }
-        }
+        // 统计在保存和删除数据集时增量维护，这里不再加载和测试每个数据集
+        DataSetStatistics statistics = DataManager::getInstance().getStatistics(0.95);
 
         json response = {{"success", true},
                          {"statistics",
-                          {{"totalDatasets", totalDatasets},
-                           {"datasetsWithTrend", datasetsWithTrend},
-                           {"avgDataPoints", totalTests > 0 ? totalDataPoints / totalTests : 0},
-                           {"avgPGValue", totalTests > 0 ? totalPGValue / totalTests : 0}}}};
+                          {{"totalDatasets", statistics.totalDatasets},
+                           {"datasetsWithTrend", statistics.datasetsWithTrend},
+                           {"avgDataPoints", statistics.avgDataPoints()},
+                           {"avgPGValue", statistics.avgPGValue()}}}};
 
         return response.dump();
     }
@@ -870,16 +1421,129 @@ std::string WebServer::handleExportSVGRequest(const std::string & /*requestBody*
     return response.dump();
 }
 
-std::string WebServer::handleBatchProcessRequest(const std::string & /*requestBody*/)
+std::string WebServer::handleBatchProcessRequest(const std::string &requestBody)
 {
-    json response = {{"success", false}, {"error", "功能尚未实现"}};
-    return response.dump();
+    try {
+        json request = json::parse(requestBody);
+
+        BatchJobRequest jobRequest;
+        jobRequest.directory = request.value("directory", "");
+        jobRequest.files = request.value("files", std::vector<std::string>());
+        jobRequest.confidenceLevel = request.value("confidenceLevel", 0.95);
+        jobRequest.discoveryOptions.recursive = request.value("recursive", false);
+        jobRequest.workerProcesses = Config::getInstance().getBatchWorkerProcesses();
+        if (jobRequest.directory.empty() && jobRequest.files.empty()) {
+            json error = {{"success", false}, {"error", "请求中缺少directory或files"}};
+            return error.dump();
+        }
+
+        // 任何客户端都能提交作业，只允许访问批量根目录（默认为数据目录）之内的路径。
+        // 相对路径相对于根目录，遍历目录时不跟随符号链接，避免经由链接访问根目录之外的文件
+        Config &config = Config::getInstance();
+        std::string batchRoot = config.getBatchRootDirectory();
+        if (batchRoot.empty()) {
+            batchRoot = config.getDataDirectory();
+        }
+        std::vector<std::string *> requestedPaths;
+        if (!jobRequest.directory.empty()) {
+            requestedPaths.push_back(&jobRequest.directory);
+        }
+        for (auto &file : jobRequest.files) {
+            requestedPaths.push_back(&file);
+        }
+        for (std::string *path : requestedPaths) {
+            if (!FileDiscovery::resolveUnderRoot(batchRoot, *path, *path)) {
+                json error = {{"success", false}, {"error", "路径不在批量处理根目录内: " + *path}};
+                return error.dump();
+            }
+        }
+        jobRequest.discoveryOptions.symlinkPolicy = SymlinkPolicy::SKIP;
+        if (!jobRequest.directory.empty() && !fs::is_directory(jobRequest.directory)) {
+            json error = {{"success", false}, {"error", "目录不存在: " + jobRequest.directory}};
+            return error.dump();
+        }
+
+        BatchJobService &service = BatchJobService::getInstance();
+        std::string jobId = service.submit(jobRequest);
+
+        BatchJobStatus status;
+        service.getStatus(jobId, status);
+        json response = {{"success", true},
+                         {"jobId", jobId},
+                         {"state", BatchJobService::stateName(status.state)}};
+        return response.dump();
+    }
+    catch (const std::exception &e) {
+        json error = {{"success", false}, {"error", std::string("提交批量作业失败: ") + e.what()}};
+        return error.dump();
+    }
 }
 
-std::string WebServer::handleBatchStatusRequest(const std::string & /*requestBody*/)
+std::string WebServer::handleBatchStatusRequest(const std::string &requestBody)
 {
-    json response = {{"success", false}, {"error", "功能尚未实现"}};
-    return response.dump();
+    try {
+        json request = json::parse(requestBody);
+        std::string jobId = request.value("jobId", "");
+        size_t offset = request.value("offset", static_cast<size_t>(0));
+
+        BatchJobStatus status;
+        if (!BatchJobService::getInstance().getStatus(jobId, status, offset)) {
+            json error = {{"success", false}, {"error", "作业不存在: " + jobId}};
+            return error.dump();
+        }
+
+        // 只返回offset之后的结果，客户端每次轮询传入已收到的结果数
+        json results = json::array();
+        for (const auto &result : status.results) {
+            results.push_back({{"filename", result.filename},
+                               {"status", result.status},
+                               {"errorMessage", result.errorMessage},
+                               {"dataPointCount", result.dataPointCount},
+                               {"overallTrend", result.testResults.overallTrend},
+                               {"minPG", result.testResults.minPG},
+                               {"maxPG", result.testResults.maxPG},
+                               {"avgPG", result.testResults.avgPG},
+                               {"processingTime", result.processingTime}});
+        }
+
+        json response = {{"success", true},
+                         {"jobId", status.id},
+                         {"state", BatchJobService::stateName(status.state)},
+                         {"processedFiles", status.processedFiles},
+                         {"totalFiles", status.totalFiles},
+                         {"elapsedSeconds", status.elapsedSeconds},
+                         {"filesPerSecond", status.filesPerSecond},
+                         {"resultCount", status.resultCount},
+                         {"offset", offset},
+                         {"results", std::move(results)}};
+        if (!status.errorMessage.empty()) {
+            response["error"] = status.errorMessage;
+        }
+        return response.dump();
+    }
+    catch (const std::exception &e) {
+        json error = {{"success", false}, {"error", std::string("查询批量作业失败: ") + e.what()}};
+        return error.dump();
+    }
+}
+
+std::string WebServer::handleBatchCancelRequest(const std::string &requestBody)
+{
+    try {
+        json request = json::parse(requestBody);
+        std::string jobId = request.value("jobId", "");
+
+        if (!BatchJobService::getInstance().cancel(jobId)) {
+            json error = {{"success", false}, {"error", "作业不存在或已结束: " + jobId}};
+            return error.dump();
+        }
+        json response = {{"success", true}, {"jobId", jobId}};
+        return response.dump();
+    }
+    catch (const std::exception &e) {
+        json error = {{"success", false}, {"error", std::string("取消批量作业失败: ") + e.what()}};
+        return error.dump();
+    }
 }
 
 std::string WebServer::handleCSVImportRequest(const std::string & /*requestBody*/)
@@ -0,0 +1,901 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#include "core/batch_job_service.h"
+#include "core/batch_manifest.h"
+#include "core/batch_processor.h"
+#include "core/batch_result_sink.h"
+#include "core/error_handler.h"
+#include "core/thread_pool.h"
+
+using namespace neumann;
+namespace fs = std::filesystem;
+
+namespace {
+
+// 在系统临时目录下创建测试用的数据文件目录，析构时删除
+struct TempDataDir {
+    fs::path path;
+
+    explicit TempDataDir(const std::string &name)
+        : path(fs::temp_directory_path() / ("neumann_test_" + name))
+    {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+
+    ~TempDataDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    std::string write(const std::string &filename, const std::string &content) const
+    {
+        fs::path filePath = path / filename;
+        fs::create_directories(filePath.parent_path());
+        std::ofstream file(filePath, std::ios::binary);
+        file << content;
+        return filePath.string();
+    }
+};
+
+const char *kTrendCsv = "time,value\n0,100\n1,110\n2,120\n3,130\n4,140\n5,150\n";
+const char *kNoTrendCsv = "0,100\n1,105\n2,102\n3,108\n4,103\n5,106\n";
+
+// 轮询直到作业结束，超时返回最后一次的状态
+BatchJobStatus waitForJob(const BatchJobService &service, const std::string &id)
+{
+    BatchJobStatus status;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (service.getStatus(id, status) && std::chrono::steady_clock::now() < deadline) {
+        if (status.state != BatchJobState::QUEUED && status.state != BatchJobState::RUNNING) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return status;
+}
+
+}  // namespace
+
+TEST_CASE("Batch pipeline matches single-file processing", "[batch_processor]")
+{
+    TempDataDir dir("pipeline");
+    std::vector<std::string> files;
+    for (int i = 0; i < 12; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv",
+                                  i % 2 == 0 ? kTrendCsv : kNoTrendCsv));
+    }
+    files.push_back(dir.write("short.csv", "0,1\n1,2\n"));
+    files.push_back((dir.path / "missing.csv").string());
+    files.push_back(dir.write("notes.txt", "not data"));
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.readWorkers = 3;
+    options.parseWorkers = 2;
+    options.computeWorkers = 2;
+    options.parseQueueCapacity = 1;
+    processor.setPipelineOptions(options);
+
+    int lastCompleted = 0;
+    auto results = processor.processFiles(
+        files, [&](int current, int, const std::string &) { lastCompleted = current; });
+
+    REQUIRE(results.size() == files.size());
+    REQUIRE(lastCompleted == static_cast<int>(files.size()));
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        BatchProcessResult expected = processor.processSingleFile(files[i]);
+        REQUIRE(results[i].filename == expected.filename);
+        REQUIRE(results[i].status == expected.status);
+        REQUIRE(results[i].errorMessage == expected.errorMessage);
+        if (expected.status == "success") {
+            REQUIRE(results[i].testResults.overallTrend == expected.testResults.overallTrend);
+            REQUIRE(results[i].testResults.avgPG == Catch::Approx(expected.testResults.avgPG));
+        }
+    }
+
+    REQUIRE(results[0].status == "success");
+    REQUIRE(results[0].testResults.overallTrend);
+    REQUIRE_FALSE(results[1].testResults.overallTrend);
+    REQUIRE(results[12].status == "error");
+    REQUIRE(results[13].errorMessage == "File not found");
+    REQUIRE(results[14].status == "skipped");
+}
+
+TEST_CASE("Exceptions from progress callbacks stop the pipeline", "[batch_processor]")
+{
+    TempDataDir dir("callback_error");
+    std::vector<std::string> files;
+    for (int i = 0; i < 40; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.readWorkers = 2;
+    options.parseWorkers = 2;
+    options.computeWorkers = 2;
+    options.resultQueueCapacity = 1;
+    processor.setPipelineOptions(options);
+
+    // 回调抛出的异常传给调用者，工作线程已全部退出
+    REQUIRE_THROWS_AS(processor.processFiles(files,
+                                             [](int current, int, const std::string &) {
+                                                 if (current == 2) {
+                                                     throw std::runtime_error("stop");
+                                                 }
+                                             }),
+                      std::runtime_error);
+
+    // 只取消了那一次运行，处理器可以继续使用
+    REQUIRE_FALSE(processor.getCancellationToken().isStopRequested());
+    auto results = processor.processFiles(files);
+    REQUIRE(results.size() == files.size());
+    REQUIRE(results.back().status == "success");
+}
+
+TEST_CASE("Exceptions from progress callbacks stop data set analysis", "[batch_processor]")
+{
+    std::vector<DataSet> dataSets(64);
+    for (size_t i = 0; i < dataSets.size(); ++i) {
+        dataSets[i].name = "series_" + std::to_string(i);
+        dataSets[i].dataPoints = {100, 110, 120, 130, 140, 150};
+        dataSets[i].timePoints = {0, 1, 2, 3, 4, 5};
+    }
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.computeWorkers = 4;
+    processor.setPipelineOptions(options);
+
+    REQUIRE_THROWS_AS(processor.analyzeDataSets(dataSets,
+                                                [](int current, int, const std::string &) {
+                                                    if (current == 1) {
+                                                        throw std::runtime_error("stop");
+                                                    }
+                                                }),
+                      std::runtime_error);
+    REQUIRE_FALSE(processor.getCancellationToken().isStopRequested());
+    REQUIRE(processor.analyzeDataSets(dataSets).back().status == "success");
+}
+
+TEST_CASE("Glob patterns for file discovery", "[file_discovery]")
+{
+    REQUIRE(FileDiscovery::matchGlob("*.csv", "data.csv"));
+    REQUIRE_FALSE(FileDiscovery::matchGlob("*.csv", "lot1/data.csv"));
+    REQUIRE(FileDiscovery::matchGlob("**/*.csv", "data.csv"));
+    REQUIRE(FileDiscovery::matchGlob("**/*.csv", "lot1/assay/data.csv"));
+    REQUIRE(FileDiscovery::matchGlob("lot?/*.csv", "lot7/data.csv"));
+    REQUIRE(FileDiscovery::matchGlob("lot[0-3]/**", "lot2/a/b.csv"));
+    REQUIRE_FALSE(FileDiscovery::matchGlob("lot[!0-3]/**", "lot2/a/b.csv"));
+}
+
+TEST_CASE("Paths are resolved and confined to a root directory", "[file_discovery]")
+{
+    TempDataDir dir("resolve_root");
+    std::string file = dir.write("lot1/a.csv", kTrendCsv);
+    TempDataDir outside("resolve_root_outside");
+    std::string secret = outside.write("secret.csv", kTrendCsv);
+    std::string root = dir.path.string();
+
+    std::string resolved;
+    REQUIRE(FileDiscovery::resolveUnderRoot(root, "lot1/a.csv", resolved));
+    REQUIRE(fs::equivalent(resolved, file));
+    REQUIRE(FileDiscovery::resolveUnderRoot(root, file, resolved));
+    REQUIRE(FileDiscovery::resolveUnderRoot(root, "lot1/../lot1/missing.csv", resolved));
+    REQUIRE(fs::path(resolved).filename() == "missing.csv");
+    REQUIRE(FileDiscovery::resolveUnderRoot(root, ".", resolved));
+
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, "", resolved));
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, "..", resolved));
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, "lot1/../../x.csv", resolved));
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, secret, resolved));
+    // 名称以根目录名开头的兄弟目录不在根目录内
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, root + "_outside/secret.csv", resolved));
+
+#ifndef _WIN32
+    // 指向根目录之外的符号链接
+    fs::create_symlink(secret, dir.path / "link.csv");
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, "link.csv", resolved));
+    fs::create_directory_symlink(outside.path, dir.path / "linked_dir");
+    REQUIRE_FALSE(FileDiscovery::resolveUnderRoot(root, "linked_dir/secret.csv", resolved));
+#endif
+}
+
+TEST_CASE("Recursive directory discovery streams into the pipeline", "[file_discovery]")
+{
+    TempDataDir dir("discovery");
+    dir.write("a.csv", kTrendCsv);
+    dir.write("lot1/b.csv", kTrendCsv);
+    dir.write("lot1/deep/c.csv", kNoTrendCsv);
+    dir.write("archive/old.csv", kTrendCsv);
+    dir.write("lot1/skip_me.csv", kTrendCsv);
+    dir.write("lot1/readme.txt", "ignored");
+
+    BatchProcessor processor;
+
+    SECTION("Top level only by default")
+    {
+        auto results = processor.processDirectory(dir.path.string());
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].filename == "a.csv");
+    }
+
+    SECTION("Recursive with exclude patterns and depth limit")
+    {
+        FileDiscoveryOptions options;
+        options.recursive = true;
+        options.excludePatterns = {"archive", "skip_*"};
+        options.sortEntries = true;
+        processor.setDiscoveryOptions(options);
+
+        auto results = processor.processDirectory(dir.path.string());
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].filename == "a.csv");
+        REQUIRE(results[1].filename == "b.csv");
+        REQUIRE(results[2].filename == "c.csv");
+
+        options.maxDepth = 1;
+        processor.setDiscoveryOptions(options);
+        REQUIRE(processor.processDirectory(dir.path.string()).size() == 2);
+    }
+
+    SECTION("Include patterns")
+    {
+        FileDiscoveryOptions options;
+        options.recursive = true;
+        options.includePatterns = {"lot1/**/*.csv"};
+
+        // 默认按文件系统的顺序流式产出，排序只改变顺序
+        for (bool sortEntries : {false, true}) {
+            options.sortEntries = sortEntries;
+            FileDiscovery discovery(dir.path.string(), options);
+
+            std::vector<std::string> found;
+            std::string filePath;
+            while (discovery.next(filePath)) {
+                found.push_back(fs::path(filePath).filename().string());
+            }
+            if (!sortEntries) {
+                std::sort(found.begin(), found.end());
+            }
+            REQUIRE(found == std::vector<std::string>{"b.csv", "c.csv", "skip_me.csv"});
+            REQUIRE(discovery.getDiscoveredCount() == 3);
+        }
+    }
+}
+
+TEST_CASE("Incremental runs reuse unchanged results from the manifest", "[batch_processor]")
+{
+    TempDataDir dir("incremental");
+    dir.write("data/a.csv", kTrendCsv);
+    dir.write("data/b.csv", kNoTrendCsv);
+    std::string changedPath = dir.write("data/c.csv", kTrendCsv);
+    std::string removedPath = dir.write("data/d.csv", kNoTrendCsv);
+    std::string manifestPath = (dir.path / "out" / "manifest.json").string();
+    std::string dataDir = (dir.path / "data").string();
+
+    BatchProcessor processor;
+    processor.setManifestPath(manifestPath);
+    FileDiscoveryOptions discoveryOptions;
+    discoveryOptions.sortEntries = true;
+    processor.setDiscoveryOptions(discoveryOptions);
+
+    auto first = processor.processDirectory(dataDir);
+    REQUIRE(first.size() == 4);
+    for (const auto &result : first) {
+        REQUIRE(result.status == "success");
+        REQUIRE_FALSE(result.reused);
+    }
+
+    // 修改一个文件、删除一个文件，并让一个文件只改变修改时间
+    dir.write("data/c.csv", std::string(kNoTrendCsv) + "6,104\n");
+    fs::remove(removedPath);
+    fs::last_write_time(dir.path / "data" / "a.csv",
+                        fs::last_write_time(dir.path / "data" / "a.csv") + std::chrono::hours(1));
+
+    auto second = processor.processDirectory(dataDir);
+    REQUIRE(second.size() == 3);
+    REQUIRE(second[0].reused);
+    REQUIRE(second[1].reused);
+    REQUIRE_FALSE(second[2].reused);
+
+    // 复用的结果与首次计算的汇总一致
+    REQUIRE(second[0].filename == "a.csv");
+    REQUIRE(second[0].testResults.overallTrend == first[0].testResults.overallTrend);
+    REQUIRE(second[0].testResults.avgPG == Catch::Approx(first[0].testResults.avgPG));
+    REQUIRE(second[1].dataPointCount == first[1].dataPointCount);
+    REQUIRE(second[2].dataPointCount == 7);
+    REQUIRE(second[2].testResults.avgPG ==
+            Catch::Approx(processor.processSingleFile(changedPath).testResults.avgPG));
+
+    BatchManifest manifest;
+    REQUIRE(manifest.load(manifestPath));
+    REQUIRE(manifest.size() == 3);
+
+    // 置信度变化后需要重新计算
+    processor.setConfidenceLevel(0.99);
+    for (const auto &result : processor.processDirectory(dataDir)) {
+        REQUIRE_FALSE(result.reused);
+    }
+}
+
+TEST_CASE("Streaming sinks write each result as it completes", "[batch_processor]")
+{
+    TempDataDir dir("sinks");
+    std::vector<std::string> files;
+    for (int i = 0; i < 8; ++i) {
+        files.push_back(dir.write("data/s" + std::to_string(i) + ".csv",
+                                  i % 2 == 0 ? kTrendCsv : kNoTrendCsv));
+    }
+    files.push_back(dir.write("data/short.csv", "0,1\n"));
+
+    BatchProcessor processor;
+    std::vector<BatchProcessResult> expected = processor.processFiles(files);
+    BatchProcessStats expectedStats = BatchProcessor::generateStatistics(expected);
+
+    SECTION("JSON Lines")
+    {
+        std::string outputPath = (dir.path / "results.jsonl").string();
+        JsonLinesResultSink sink(outputPath);
+        BatchProcessStats stats = processor.processFiles(files, sink);
+
+        REQUIRE(stats.totalFiles == expectedStats.totalFiles);
+        REQUIRE(stats.successfulFiles == expectedStats.successfulFiles);
+        REQUIRE(stats.filesWithTrend == expectedStats.filesWithTrend);
+
+        std::ifstream input(outputPath);
+        std::set<size_t> indices;
+        std::string line;
+        while (std::getline(input, line)) {
+            auto row = nlohmann::json::parse(line);
+            size_t index = row.at("index").get<size_t>();
+            indices.insert(index);
+            REQUIRE(row.at("filename") == expected[index].filename);
+            REQUIRE(row.at("status") == expected[index].status);
+            if (expected[index].status == "success") {
+                REQUIRE(row.at("dataPoints") == expected[index].dataPointCount);
+                REQUIRE(row.at("avgPG").get<double>() ==
+                        Catch::Approx(expected[index].testResults.avgPG));
+            }
+        }
+        REQUIRE(indices.size() == files.size());
+    }
+
+    SECTION("CSV stream matches export of collected results")
+    {
+        BatchPipelineOptions options;
+        options.readWorkers = 1;
+        options.parseWorkers = 1;
+        options.computeWorkers = 1;
+        processor.setPipelineOptions(options);
+
+        std::string streamedPath = (dir.path / "streamed.csv").string();
+        std::string exportedPath = (dir.path / "exported.csv").string();
+        CsvResultSink sink(streamedPath);
+        processor.processFiles(files, sink);
+        REQUIRE(BatchProcessor::exportResultsToCSV(expected, exportedPath));
+
+        // 处理时间每次不同，只比较行数和每行的文件名、状态
+        auto readRows = [](const std::string &path) {
+            std::ifstream input(path);
+            std::vector<std::string> rows;
+            std::string line;
+            while (std::getline(input, line)) {
+                size_t second = line.find(',', line.find(',') + 1);
+                rows.push_back(line.substr(0, second));
+            }
+            return rows;
+        };
+        REQUIRE(readRows(streamedPath) == readRows(exportedPath));
+        REQUIRE(readRows(streamedPath).size() == files.size() + 1);
+    }
+}
+
+#ifndef _WIN32
+TEST_CASE("Multi-process batch mode matches in-process results", "[batch_processor]")
+{
+    TempDataDir dir("sharded");
+    std::vector<std::string> files;
+    for (int i = 0; i < 10; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv",
+                                  i % 3 == 0 ? kNoTrendCsv : kTrendCsv));
+    }
+    files.push_back(dir.write("short.csv", "0,1\n1,2\n"));
+    files.push_back((dir.path / "missing.csv").string());
+    files.push_back(dir.write("broken.json", "{ not json"));
+
+    BatchProcessor processor;
+    auto expected = processor.processFiles(files);
+
+    BatchPipelineOptions options;
+    options.workerProcesses = 3;
+    processor.setPipelineOptions(options);
+
+    int lastCompleted = 0;
+    auto results = processor.processFiles(
+        files, [&](int current, int, const std::string &) { lastCompleted = current; });
+
+    REQUIRE(results.size() == expected.size());
+    REQUIRE(lastCompleted == static_cast<int>(files.size()));
+    for (size_t i = 0; i < files.size(); ++i) {
+        REQUIRE(results[i].filename == expected[i].filename);
+        REQUIRE(results[i].status == expected[i].status);
+        REQUIRE(results[i].errorMessage == expected[i].errorMessage);
+        REQUIRE(results[i].dataPointCount == expected[i].dataPointCount);
+        REQUIRE(results[i].testResults.data == expected[i].testResults.data);
+        REQUIRE(results[i].testResults.results.size() == expected[i].testResults.results.size());
+        if (expected[i].status == "success") {
+            REQUIRE(results[i].testResults.avgPG == expected[i].testResults.avgPG);
+            REQUIRE(results[i].testResults.overallTrend == expected[i].testResults.overallTrend);
+        }
+    }
+
+    // 目录模式同样按发现顺序返回
+    auto directoryResults = processor.processDirectory(dir.path.string());
+    REQUIRE(directoryResults.size() == 12);
+}
+#endif
+
+TEST_CASE("Per-stage timings are recorded with microsecond resolution", "[batch_processor]")
+{
+    TempDataDir dir("timings");
+    std::vector<std::string> files;
+    for (int i = 0; i < 5; ++i) {
+        files.push_back(dir.write("s" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+    files.push_back((dir.path / "missing.csv").string());
+
+    BatchProcessor processor;
+    auto results = processor.processFiles(files);
+
+    for (size_t i = 0; i < 5; ++i) {
+        const BatchStageTimings &timings = results[i].timings;
+        REQUIRE(results[i].processingTime > 0.0);
+        REQUIRE(timings.openMicros > 0.0);
+        REQUIRE(timings.sniffMicros > 0.0);
+        REQUIRE(timings.parseMicros > 0.0);
+        REQUIRE(timings.computeMicros > 0.0);
+        REQUIRE(results[i].processingTime * 1e6 ==
+                Catch::Approx(timings.openMicros + timings.sniffMicros + timings.parseMicros +
+                              timings.computeMicros));
+    }
+
+    // 提前返回的错误路径同样有耗时
+    REQUIRE(results[5].status == "error");
+    REQUIRE(results[5].timings.openMicros > 0.0);
+    REQUIRE(results[5].processingTime > 0.0);
+    REQUIRE(results[5].timings.computeMicros == 0.0);
+
+    BatchProcessStats stats = BatchProcessor::generateStatistics(results);
+    REQUIRE(stats.computeTimes.count() == files.size());
+    TimingPercentiles compute = stats.computeTimes.summary();
+    REQUIRE(compute.p50 <= compute.p90);
+    REQUIRE(compute.p90 <= compute.p99);
+    REQUIRE(compute.p99 <= compute.max);
+    REQUIRE(compute.max > 0.0);
+}
+
+TEST_CASE("Timing histogram percentiles", "[batch_processor]")
+{
+    TimingHistogram histogram;
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.record(static_cast<double>(i));
+    }
+
+    // 对数分桶的相对误差约为5%
+    REQUIRE(histogram.percentile(0.50) == Catch::Approx(500.0).epsilon(0.06));
+    REQUIRE(histogram.percentile(0.90) == Catch::Approx(900.0).epsilon(0.06));
+    REQUIRE(histogram.percentile(0.99) == Catch::Approx(990.0).epsilon(0.06));
+    REQUIRE(histogram.summary().max == 1000.0);
+    REQUIRE(TimingHistogram().percentile(0.5) == 0.0);
+}
+
+TEST_CASE("Cancellation tokens and deadlines", "[batch_processor]")
+{
+    CancellationToken token;
+    REQUIRE(token.getState() == CancellationToken::State::ACTIVE);
+
+    // 子令牌的截止时间不影响父令牌，父令牌取消会传递给子令牌
+    CancellationToken child = token.withDeadline(CancellationToken::Clock::now());
+    REQUIRE(child.getState() == CancellationToken::State::TIMED_OUT);
+    REQUIRE(token.getState() == CancellationToken::State::ACTIVE);
+
+    CancellationToken longChild =
+        token.withDeadline(CancellationToken::Clock::now() + std::chrono::hours(1));
+    REQUIRE_FALSE(longChild.isStopRequested());
+
+    CancellationToken copy = token;
+    copy.cancel();
+    REQUIRE(token.getState() == CancellationToken::State::CANCELLED);
+    REQUIRE(longChild.getState() == CancellationToken::State::CANCELLED);
+    REQUIRE_THROWS_AS(longChild.throwIfStopped("test"), NeumannException);
+}
+
+TEST_CASE("Cancelled and timed out batches report every file", "[batch_processor]")
+{
+    TempDataDir dir("cancellation");
+    std::vector<std::string> files;
+    for (int i = 0; i < 6; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    BatchProcessor processor;
+
+    SECTION("cancelled before start")
+    {
+        CancellationToken token;
+        token.cancel();
+        processor.setCancellationToken(token);
+
+        auto results = processor.processFiles(files);
+        REQUIRE(results.size() == files.size());
+        for (const auto &result : results) {
+            REQUIRE(result.status == "cancelled");
+        }
+
+        BatchProcessStats stats = BatchProcessor::generateStatistics(results);
+        REQUIRE(stats.cancelledFiles == static_cast<int>(files.size()));
+        REQUIRE(stats.successfulFiles == 0);
+
+        // 目录模式取消后不再继续遍历
+        REQUIRE(processor.processDirectory(dir.path.string()).empty());
+    }
+
+    SECTION("batch deadline exceeded")
+    {
+        CancellationToken token;
+        token.setDeadline(CancellationToken::Clock::now());
+        processor.setCancellationToken(token);
+
+        auto results = processor.processFiles(files);
+        REQUIRE(results.size() == files.size());
+        for (const auto &result : results) {
+            REQUIRE(result.status == "timeout");
+            REQUIRE(result.errorMessage == "Batch deadline exceeded");
+        }
+        REQUIRE(BatchProcessor::generateStatistics(results).timeoutFiles ==
+                static_cast<int>(files.size()));
+    }
+
+    SECTION("per-file time budget")
+    {
+        // 足够大的文件，解析时间远超1毫秒预算
+        std::string large = "time,value\n";
+        for (int i = 0; i < 200000; ++i) {
+            large += std::to_string(i) + "," + std::to_string(100 + i) + "\n";
+        }
+        std::vector<std::string> mixed = {dir.write("large.csv", large)};
+
+        BatchPipelineOptions options;
+        options.fileTimeBudget = std::chrono::milliseconds(1);
+        processor.setPipelineOptions(options);
+
+        auto results = processor.processFiles(mixed);
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].status == "timeout");
+        REQUIRE(results[0].errorMessage == "File time budget exceeded");
+        REQUIRE(results[0].dataPointCount == 0);
+    }
+
+    SECTION("per-file time budget interrupts parsing and computation")
+    {
+        // 解析很快但趋势测试是平方复杂度，完整计算需要远超预算的时间
+        std::string csv = "time,value\n";
+        std::string json = "{\"dataPoints\":[";
+        for (int i = 0; i < 50000; ++i) {
+            csv += std::to_string(i) + "," + std::to_string(100 + i % 7) + "\n";
+            json += (i > 0 ? "," : "") + std::to_string(100 + i % 7);
+        }
+        json += "]}";
+        std::vector<std::string> large = {dir.write("large.csv", csv),
+                                          dir.write("large.json", json)};
+
+        BatchPipelineOptions options;
+        options.fileTimeBudget = std::chrono::milliseconds(200);
+        processor.setPipelineOptions(options);
+
+        auto results = processor.processFiles(large);
+        REQUIRE(results.size() == 2);
+        for (const auto &result : results) {
+            REQUIRE(result.status == "timeout");
+            REQUIRE(result.errorMessage == "File time budget exceeded");
+            REQUIRE(result.processingTime < 2.0);
+        }
+    }
+}
+
+#ifndef _WIN32
+TEST_CASE("Multi-process batch mode enforces cancellation", "[batch_processor]")
+{
+    TempDataDir dir("sharded_cancellation");
+    std::vector<std::string> files;
+    for (int i = 0; i < 4; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.workerProcesses = 2;
+    processor.setPipelineOptions(options);
+
+    CancellationToken token;
+    token.cancel();
+    processor.setCancellationToken(token);
+
+    auto results = processor.processFiles(files);
+    REQUIRE(results.size() == files.size());
+    for (const auto &result : results) {
+        REQUIRE(result.status == "cancelled");
+    }
+}
+#endif
+
+#ifdef __linux__
+namespace {
+
+// 当前进程仍在运行（不是僵尸）的子进程
+std::vector<pid_t> childProcesses()
+{
+    std::vector<pid_t> children;
+    for (const auto &entry : fs::directory_iterator("/proc")) {
+        std::ifstream statFile(entry.path() / "stat");
+        std::string stat;
+        if (!std::getline(statFile, stat)) {
+            continue;
+        }
+        // 格式为"pid (comm) state ppid ..."，comm中可能含有空格
+        std::istringstream fields(stat.substr(stat.rfind(')') + 1));
+        char state = 0;
+        pid_t parent = 0;
+        fields >> state >> parent;
+        if (parent == getpid() && state != 'Z') {
+            children.push_back(static_cast<pid_t>(std::stol(entry.path().filename().string())));
+        }
+    }
+    return children;
+}
+
+// 结束当前进程的所有子进程，并等到它们的套接字都已关闭（进程变为僵尸）
+void killChildProcesses()
+{
+    for (pid_t child : childProcesses()) {
+        kill(child, SIGKILL);
+        auto statPath = fs::path("/proc") / std::to_string(child) / "stat";
+        while (true) {
+            std::ifstream statFile(statPath);
+            std::string stat;
+            if (!std::getline(statFile, stat) || stat[stat.rfind(')') + 2] == 'Z') {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Multi-process batch workers run a fresh copy of the program", "[batch_processor]")
+{
+    TempDataDir dir("sharded_exec");
+    std::vector<std::string> files;
+    for (int i = 0; i < 4; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.workerProcesses = 2;
+    processor.setPipelineOptions(options);
+
+    // 工作进程不是fork出的副本，而是以工作进程参数重新执行的程序
+    std::vector<std::string> commandLines;
+    auto results = processor.processFiles(files, [&](int current, int, const std::string &) {
+        if (current != 1) {
+            return;
+        }
+        for (pid_t child : childProcesses()) {
+            std::ifstream cmdline(fs::path("/proc") / std::to_string(child) / "cmdline");
+            commandLines.emplace_back(std::istreambuf_iterator<char>(cmdline),
+                                      std::istreambuf_iterator<char>());
+        }
+    });
+
+    REQUIRE(results.size() == files.size());
+    REQUIRE(commandLines.size() == 2);
+    for (const auto &commandLine : commandLines) {
+        REQUIRE(commandLine.find("--batch-shard-worker") != std::string::npos);
+    }
+}
+
+TEST_CASE("Multi-process batch mode re-dispatches files after a failed write",
+          "[batch_processor]")
+{
+    TempDataDir dir("sharded_write_failure");
+    std::vector<std::string> files;
+    for (int i = 0; i < 4; ++i) {
+        files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    BatchProcessor processor;
+    BatchPipelineOptions options;
+    options.workerProcesses = 1;
+    processor.setPipelineOptions(options);
+
+    // 第一个文件完成后结束唯一的工作进程，下一次分派时写入失败
+    int lastCompleted = 0;
+    int lastTotal = 0;
+    auto results = processor.processFiles(files, [&](int current, int total, const std::string &) {
+        if (current == 1 && lastCompleted == 0) {
+            killChildProcesses();
+        }
+        lastCompleted = current;
+        lastTotal = total;
+    });
+
+    REQUIRE(results.size() == files.size());
+    for (const auto &result : results) {
+        REQUIRE(result.status == "success");
+    }
+    REQUIRE(lastCompleted == static_cast<int>(files.size()));
+    REQUIRE(lastTotal == static_cast<int>(files.size()));
+}
+#endif
+
+TEST_CASE("Thread pool runs tasks and parallel loops", "[thread_pool]")
+{
+    ThreadPool pool(3);
+    REQUIRE(pool.size() == 3);
+
+    auto future = pool.submit([]() { return 6 * 7; });
+    REQUIRE(future.get() == 42);
+
+    // 每个索引恰好执行一次
+    std::vector<int> visits(1000, 0);
+    pool.parallelFor(visits.size(), [&visits](size_t index) { visits[index]++; });
+    REQUIRE(std::all_of(visits.begin(), visits.end(), [](int count) { return count == 1; }));
+
+    // 线程池中的任务再嵌套parallelFor，线程全部占满时也不会死锁
+    std::atomic<int> total{0};
+    pool.parallelFor(6, [&](size_t) {
+        pool.parallelFor(10, [&total](size_t) { total++; });
+    });
+    REQUIRE(total == 60);
+
+    // 异常在调用线程中重新抛出
+    REQUIRE_THROWS_AS(pool.parallelFor(100,
+                                       [](size_t index) {
+                                           if (index == 50) {
+                                               throw std::runtime_error("failed");
+                                           }
+                                       }),
+                      std::runtime_error);
+
+    pool.parallelFor(0, [](size_t) { FAIL("no index expected"); });
+}
+
+TEST_CASE("Batch job service runs jobs asynchronously", "[batch_job_service]")
+{
+    TempDataDir dir("jobs");
+    BatchJobRequest request;
+    for (int i = 0; i < 5; ++i) {
+        request.files.push_back(dir.write("series_" + std::to_string(i) + ".csv",
+                                          i % 2 == 0 ? kTrendCsv : kNoTrendCsv));
+    }
+    request.files.push_back((dir.path / "missing.csv").string());
+
+    BatchJobService service(1, 4, 2);
+
+    std::string id = service.submit(request);
+    BatchJobStatus status = waitForJob(service, id);
+    REQUIRE(status.id == id);
+    REQUIRE(status.state == BatchJobState::COMPLETED);
+    REQUIRE(status.processedFiles == 6);
+    REQUIRE(status.totalFiles == 6);
+    REQUIRE(status.resultCount == 6);
+    REQUIRE(status.results.size() == 6);
+    REQUIRE(status.filesPerSecond > 0.0);
+
+    // 单个文件的错误记录在结果中，作业本身仍然完成
+    size_t errors = std::count_if(status.results.begin(), status.results.end(),
+                                  [](const BatchProcessResult &r) { return r.status == "error"; });
+    REQUIRE(errors == 1);
+
+    // 增量轮询只返回偏移之后的结果
+    REQUIRE(service.getStatus(id, status, 4));
+    REQUIRE(status.resultCount == 6);
+    REQUIRE(status.results.size() == 2);
+    REQUIRE(service.getStatus(id, status, 10));
+    REQUIRE(status.results.empty());
+
+    // 已结束的作业不能取消
+    REQUIRE_FALSE(service.cancel(id));
+    REQUIRE_FALSE(service.cancel("batch-unknown"));
+    REQUIRE_FALSE(service.getStatus("batch-unknown", status));
+
+    // 目录作业，不存在的目录使作业失败
+    BatchJobRequest directoryRequest;
+    directoryRequest.directory = dir.path.string();
+    std::string directoryId = service.submit(directoryRequest);
+    REQUIRE(waitForJob(service, directoryId).resultCount == 5);
+
+    directoryRequest.directory = (dir.path / "missing").string();
+    std::string failedId = service.submit(directoryRequest);
+    status = waitForJob(service, failedId);
+    REQUIRE(status.state == BatchJobState::FAILED);
+    REQUIRE_FALSE(status.errorMessage.empty());
+    REQUIRE(std::string(BatchJobService::stateName(status.state)) == "failed");
+
+    // 只保留最近结束的2个作业
+    REQUIRE_FALSE(service.getStatus(id, status));
+    REQUIRE(service.getStatus(directoryId, status));
+
+    REQUIRE_THROWS_AS(service.submit(BatchJobRequest()), NeumannException);
+}
+
+TEST_CASE("Batch job service bounds the queue and cancels jobs", "[batch_job_service]")
+{
+    TempDataDir dir("job_cancellation");
+    BatchJobRequest request;
+    for (int i = 0; i < 200; ++i) {
+        request.files.push_back(dir.write("series_" + std::to_string(i) + ".csv", kTrendCsv));
+    }
+
+    SECTION("full queue")
+    {
+        BatchJobService service(1, 0);
+        try {
+            service.submit(request);
+            FAIL("queue should be full");
+        }
+        catch (const NeumannException &e) {
+            REQUIRE(e.getErrorCode() == ErrorCode::SERVICE_BUSY);
+        }
+    }
+
+    SECTION("cancel running and queued jobs")
+    {
+        BatchJobService service(1, 4);
+        std::string first = service.submit(request);
+        std::string second = service.submit(request);
+
+        bool firstCancelled = service.cancel(first);
+        REQUIRE(service.cancel(second));
+
+        BatchJobStatus status = waitForJob(service, second);
+        REQUIRE(status.state == BatchJobState::CANCELLED);
+        REQUIRE(status.resultCount < request.files.size());
+
+        status = waitForJob(service, first);
+        REQUIRE(status.state ==
+                (firstCancelled ? BatchJobState::CANCELLED : BatchJobState::COMPLETED));
+    }
+
+    SECTION("destructor cancels unfinished jobs")
+    {
+        BatchJobService service(1, 4);
+        service.submit(request);
+        service.submit(request);
+    }
+}
@@ -0,0 +1,901 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/batch_processor.h"
+#include "core/biff_reader.h"
+#include "core/compound_file.h"
+#include "core/deflate.h"
+#include "core/error_handler.h"
+#include "core/excel_reader.h"
+#include "core/hash_utils.h"
+#include "core/inflate.h"
+#include "core/metrics.h"
+#include "core/spreadsheet_xml.h"
+#include "core/workbook_cache.h"
+#include "core/zip_archive.h"
+
+using namespace neumann;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ZIP成员：compressed为空时以存储方式写入，否则写入给定的DEFLATE数据
+struct ZipMember {
+    std::string name;
+    std::string content;
+    std::string compressed;
+};
+
+void appendU16(std::string &out, uint32_t value)
+{
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void appendU32(std::string &out, uint32_t value)
+{
+    appendU16(out, value & 0xFFFF);
+    appendU16(out, value >> 16);
+}
+
+// 构造最小的ZIP归档
+std::string buildZip(const std::vector<ZipMember> &members)
+{
+    std::string archive;
+    std::string directory;
+    for (const auto &member : members) {
+        Crc32 crc;
+        crc.update(member.content.data(), member.content.size());
+        bool deflated = !member.compressed.empty();
+        const std::string &data = deflated ? member.compressed : member.content;
+
+        auto appendHeaderFields = [&](std::string &out) {
+            appendU16(out, deflated ? 8 : 0);  // 压缩方法
+            appendU32(out, 0);                 // 修改时间和日期
+            appendU32(out, crc.digest());
+            appendU32(out, static_cast<uint32_t>(data.size()));
+            appendU32(out, static_cast<uint32_t>(member.content.size()));
+            appendU16(out, static_cast<uint32_t>(member.name.size()));
+            appendU16(out, 0);  // 扩展字段长度
+        };
+
+        uint32_t offset = static_cast<uint32_t>(archive.size());
+        appendU32(archive, 0x04034b50);
+        appendU16(archive, 20);
+        appendU16(archive, 0);
+        appendHeaderFields(archive);
+        archive += member.name;
+        archive += data;
+
+        appendU32(directory, 0x02014b50);
+        appendU16(directory, 20);
+        appendU16(directory, 20);
+        appendU16(directory, 0);
+        appendHeaderFields(directory);
+        appendU16(directory, 0);  // 注释长度
+        appendU16(directory, 0);  // 磁盘号
+        appendU16(directory, 0);  // 内部属性
+        appendU32(directory, 0);  // 外部属性
+        appendU32(directory, offset);
+        directory += member.name;
+    }
+
+    uint32_t directoryOffset = static_cast<uint32_t>(archive.size());
+    archive += directory;
+    appendU32(archive, 0x06054b50);
+    appendU16(archive, 0);
+    appendU16(archive, 0);
+    appendU16(archive, static_cast<uint32_t>(members.size()));
+    appendU16(archive, static_cast<uint32_t>(members.size()));
+    appendU32(archive, static_cast<uint32_t>(directory.size()));
+    appendU32(archive, directoryOffset);
+    appendU16(archive, 0);
+    return archive;
+}
+
+std::string toBytes(const std::vector<unsigned char> &bytes)
+{
+    return std::string(bytes.begin(), bytes.end());
+}
+
+// "0,100\n1,103\n...6,118\n" 的动态哈夫曼编码
+const std::vector<unsigned char> kDynamicBlock = {
+    0x0d, 0xc4, 0xb1, 0x11, 0x00, 0x30, 0x08, 0x03, 0xb1, 0xfe, 0x67, 0xa1,
+    0xc0, 0x10, 0xb8, 0x64, 0xff, 0xc5, 0x62, 0x15, 0xca, 0x50, 0x26, 0xf2,
+    0x4d, 0xf9, 0xa5, 0xfd, 0xe3, 0x84, 0x54, 0x8c, 0x1f, 0xd6, 0x5f, 0x3e};
+const char *kDynamicText = "0,100\n1,103\n2,106\n3,109\n4,112\n5,115\n6,118\n";
+
+// "abcabcabcabcabcabcabcabc hello hello hello" 的固定哈夫曼编码
+const std::vector<unsigned char> kFixedBlock = {0x4b, 0x4c, 0x4a, 0x4e, 0xc4, 0x86, 0x14, 0x32,
+                                                0x52, 0x73, 0x72, 0xf2, 0x91, 0x49, 0x00};
+const char *kFixedText = "abcabcabcabcabcabcabcabc hello hello hello";
+
+std::string inflateAll(const std::string &compressed, uint64_t maxOutput = 1 << 20)
+{
+    std::string output;
+    inflateRaw(reinterpret_cast<const unsigned char *>(compressed.data()), compressed.size(),
+               maxOutput, [&output](const char *data, size_t size) {
+                   output.append(data, size);
+                   return true;
+               });
+    return output;
+}
+
+// 以固定大小的块输入工作表XML，收集"行:列:值"形式的单元格
+std::vector<std::string> collectCells(const std::string &xml, size_t chunkSize)
+{
+    std::vector<std::string> cells;
+    WorksheetXmlReader reader(
+        [&cells](const CellEvent &cell) {
+            std::string type = cell.type == CellType::SHARED_STRING   ? "s"
+                               : cell.type == CellType::INLINE_STRING ? "i"
+                                                                      : "";
+            cells.push_back(std::to_string(cell.row) + ":" + std::to_string(cell.column) + ":" +
+                            type + std::string(cell.value));
+            return true;
+        },
+        [&cells](uint32_t row) {
+            cells.push_back("end" + std::to_string(row));
+            return true;
+        });
+    for (size_t pos = 0; pos < xml.size(); pos += chunkSize) {
+        std::string chunk = xml.substr(pos, chunkSize);
+        reader.feed(chunk.data(), chunk.size());
+    }
+    reader.finish();
+    return cells;
+}
+
+
+// BIFF记录：类型、长度和数据
+std::string biffRecord(uint16_t type, const std::string &data)
+{
+    std::string record;
+    appendU16(record, type);
+    appendU16(record, static_cast<uint32_t>(data.size()));
+    return record + data;
+}
+
+// BOF记录，dataType为0x0005（工作簿全局）或0x0010（工作表）
+std::string biffBof(uint16_t dataType, uint16_t version = 0x0600)
+{
+    std::string data;
+    appendU16(data, version);
+    appendU16(data, dataType);
+    appendU32(data, 0);
+    appendU32(data, 0);
+    appendU32(data, 0);
+    return biffRecord(0x0809, data);
+}
+
+std::string biffCell(uint16_t type, uint16_t row, uint16_t column, const std::string &value)
+{
+    std::string data;
+    appendU16(data, row);
+    appendU16(data, column);
+    appendU16(data, 15);  // 格式索引
+    return biffRecord(type, data + value);
+}
+
+std::string doubleBytes(double value)
+{
+    std::string bytes(8, '\0');
+    std::memcpy(&bytes[0], &value, sizeof(value));
+    return bytes;
+}
+
+std::string u32Bytes(uint32_t value)
+{
+    std::string bytes;
+    appendU32(bytes, value);
+    return bytes;
+}
+
+// 构造只含一个Workbook流的版本3复合文档（流不小于4096字节，存放在普通扇区中）
+std::string buildCompoundFile(const std::string &streamName, std::string stream)
+{
+    const size_t sectorSize = 512;
+    stream.resize(std::max<size_t>(stream.size(), 4096), '\0');
+    size_t streamSectors = (stream.size() + sectorSize - 1) / sectorSize;
+
+    std::string header;
+    header += toBytes({0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1});
+    header.append(16, '\0');
+    appendU16(header, 0x3E);    // 次版本
+    appendU16(header, 3);       // 主版本
+    appendU16(header, 0xFFFE);  // 字节序
+    appendU16(header, 9);       // 扇区大小 2^9
+    appendU16(header, 6);       // 迷你扇区大小 2^6
+    header.append(10, '\0');
+    appendU32(header, 1);           // FAT扇区数
+    appendU32(header, 1);           // 目录起始扇区
+    appendU32(header, 0);           // 事务签名
+    appendU32(header, 4096);        // 迷你流阈值
+    appendU32(header, 0xFFFFFFFE);  // 迷你FAT起始扇区
+    appendU32(header, 0);           // 迷你FAT扇区数
+    appendU32(header, 0xFFFFFFFE);  // DIFAT起始扇区
+    appendU32(header, 0);           // DIFAT扇区数
+    appendU32(header, 0);           // 第一个FAT扇区
+    header.resize(sectorSize, '\xFF');
+
+    // 扇区0为FAT，扇区1为目录，流从扇区2开始
+    std::string fat;
+    appendU32(fat, 0xFFFFFFFD);
+    appendU32(fat, 0xFFFFFFFE);
+    for (size_t i = 0; i < streamSectors; ++i) {
+        appendU32(fat, i + 1 < streamSectors ? static_cast<uint32_t>(i + 3) : 0xFFFFFFFE);
+    }
+    fat.resize(sectorSize, '\xFF');
+
+    auto directoryEntry = [](const std::string &name, uint8_t type, uint32_t start,
+                             uint32_t size) {
+        std::string entry;
+        for (char ch : name) {
+            appendU16(entry, static_cast<unsigned char>(ch));
+        }
+        entry.resize(64, '\0');
+        appendU16(entry, static_cast<uint32_t>((name.size() + 1) * 2));
+        entry.push_back(static_cast<char>(type));
+        entry.push_back(1);  // 黑色节点
+        appendU32(entry, 0xFFFFFFFF);
+        appendU32(entry, 0xFFFFFFFF);
+        appendU32(entry, type == 5 ? 1 : 0xFFFFFFFF);
+        entry.resize(0x74, '\0');
+        appendU32(entry, start);
+        appendU32(entry, size);
+        appendU32(entry, 0);
+        return entry;
+    };
+    std::string directory = directoryEntry("Root Entry", 5, 0xFFFFFFFE, 0) +
+                            directoryEntry(streamName, 2, 2, static_cast<uint32_t>(stream.size()));
+    directory.resize(sectorSize, '\0');
+
+    stream.resize(streamSectors * sectorSize, '\0');
+    return header + fat + directory + stream;
+}
+
+// 构造BIFF8工作簿流：全局子流之后依次是各工作表子流
+std::string buildBiffWorkbook(const std::vector<std::pair<std::string, std::string>> &sheets,
+                              const std::string &sharedStrings)
+{
+    auto buildGlobals = [&](const std::vector<uint32_t> &offsets) {
+        std::string globals = biffBof(0x0005);
+        for (size_t i = 0; i < sheets.size(); ++i) {
+            std::string data = u32Bytes(offsets[i]);
+            data.push_back(0);  // 可见
+            data.push_back(0);  // 工作表
+            // 名称包含非ASCII字符时使用UTF-16存放
+            std::u16string name;
+            for (size_t pos = 0; pos < sheets[i].first.size(); ++pos) {
+                unsigned char ch = static_cast<unsigned char>(sheets[i].first[pos]);
+                if (ch == 0xC3) {
+                    name.push_back(static_cast<char16_t>(0xC0 | (sheets[i].first[++pos] & 0x3F)));
+                } else {
+                    name.push_back(ch);
+                }
+            }
+            bool wide = name.size() != sheets[i].first.size();
+            data.push_back(static_cast<char>(name.size()));
+            data.push_back(wide ? 1 : 0);
+            for (char16_t ch : name) {
+                if (wide) {
+                    appendU16(data, ch);
+                } else {
+                    data.push_back(static_cast<char>(ch));
+                }
+            }
+            globals += biffRecord(0x0085, data);
+        }
+        // 图表工作表不含单元格数据
+        globals += biffRecord(0x0085, u32Bytes(0) + std::string("\x00\x02\x05\x00Chart", 9));
+        return globals + sharedStrings + biffRecord(0x000A, "");
+    };
+
+    std::vector<uint32_t> offsets(sheets.size());
+    uint32_t offset = static_cast<uint32_t>(buildGlobals(offsets).size());
+    std::string substreams;
+    for (size_t i = 0; i < sheets.size(); ++i) {
+        offsets[i] = offset + static_cast<uint32_t>(substreams.size());
+        substreams += biffBof(0x0010) + sheets[i].second + biffRecord(0x000A, "");
+    }
+    return buildGlobals(offsets) + substreams;
+}
+
+}  // namespace
+
+TEST_CASE("Worksheet tokenizer emits cells across chunk boundaries", "[excel_reader]")
+{
+    const std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<x:worksheet xmlns:x=\"main\"><!-- comment with <c> --><x:sheetData>"
+        "<x:row r=\"2\" spans=\"1:3\"><x:c r=\"A2\" s=\"1\"/>"
+        "<x:c r=\"B2\" t=\"s\"><x:v>7</x:v></x:c>"
+        "<x:c r=\"D2\"><x:f>B2*2</x:f><x:v>1.5e3</x:v></x:c></x:row>"
+        "<x:row><x:c t=\"inlineStr\"><x:is><x:r><x:t>a &amp; b</x:t></x:r>"
+        "<x:rPh><x:t>skip</x:t></x:rPh>"
+        "<x:r><x:t xml:space=\"preserve\"> &#x4E2D;&#25991;</x:t></x:r>"
+        "</x:is></x:c><x:c><x:v><![CDATA[<42>]]></x:v></x:c></x:row>"
+        "</x:sheetData></x:worksheet>";
+
+    const std::vector<std::string> expected = {
+        "2:1:s7", "2:3:1.5e3", "end2", "3:0:ia & b \xE4\xB8\xAD\xE6\x96\x87", "3:1:<42>",
+        "end3"};
+
+    // 任意分块边界（包括切开标签、实体和CDATA）都得到相同结果
+    for (size_t chunkSize : {size_t(1), size_t(2), size_t(7), size_t(64), xml.size()}) {
+        INFO("chunk size " << chunkSize);
+        REQUIRE(collectCells(xml, chunkSize) == expected);
+    }
+
+    // 回调要求停止后不再产生事件
+    int cells = 0;
+    WorksheetXmlReader reader([&cells](const CellEvent &) { return ++cells < 2; },
+                              [](uint32_t) { return true; });
+    REQUIRE_FALSE(reader.feed(xml.data(), xml.size()));
+    REQUIRE(cells == 2);
+
+    // 文档在标签中间截断
+    WorksheetXmlReader truncated([](const CellEvent &) { return true; },
+                                 [](uint32_t) { return true; });
+    truncated.feed("<row><c r=\"A1", 13);
+    REQUIRE_THROWS_AS(truncated.finish(), std::runtime_error);
+}
+
+TEST_CASE("Shared strings, cell references and numbers parse without regex", "[excel_reader]")
+{
+    std::vector<std::string> strings;
+    SharedStringsXmlReader reader([&strings](std::string &&text) {
+        strings.push_back(std::move(text));
+        return true;
+    });
+    std::string xml =
+        "<sst count=\"3\"><si><t>plain</t></si><si/>"
+        "<si><r><rPr><b/></rPr><t>rich</t></r><r><t> &lt;text&gt;</t></r>"
+        "<rPh sb=\"0\" eb=\"1\"><t>phonetic</t></rPh></si></sst>";
+    for (char ch : xml) {
+        reader.feed(&ch, 1);
+    }
+    reader.finish();
+    REQUIRE(strings == std::vector<std::string>{"plain", "", "rich <text>"});
+
+    // 工作簿和关系表同样按标签解析，属性值解码实体
+    std::vector<std::string> sheets;
+    WorkbookXmlReader workbook([&sheets](std::string &&name, std::string &&id) {
+        sheets.push_back(name + "=" + id);
+        return true;
+    });
+    xml = "<x:workbook><x:sheets><x:sheet name=\"A &amp; B\" r:id=\"rId3\"/>"
+          "<x:sheet sheetId=\"2\"/></x:sheets></x:workbook>";
+    workbook.feed(xml.data(), xml.size());
+    workbook.finish();
+    REQUIRE(sheets == std::vector<std::string>{"A & B=rId3", "="});
+
+    std::vector<std::string> relationships;
+    RelationshipsXmlReader rels([&relationships](std::string &&id, std::string &&target) {
+        relationships.push_back(id + "=" + target);
+        return true;
+    });
+    xml = "<Relationships><Relationship Target='a.xml' Id='rId1'/>"
+          "<Relationship Id=\"rId2\"/></Relationships>";
+    rels.feed(xml.data(), xml.size());
+    rels.finish();
+    REQUIRE(relationships == std::vector<std::string>{"rId1=a.xml"});
+
+    uint32_t column = 0, row = 0;
+    REQUIRE(parseCellReference("A1", column, row));
+    REQUIRE((column == 0 && row == 1));
+    REQUIRE(parseCellReference("AB12", column, row));
+    REQUIRE((column == 27 && row == 12));
+    REQUIRE(parseCellReference("XFD1048576", column, row));
+    REQUIRE((column == 16383 && row == 1048576));
+    REQUIRE_FALSE(parseCellReference("12", column, row));
+    REQUIRE_FALSE(parseCellReference("A1B", column, row));
+
+    double value = 0;
+    REQUIRE(parseCellNumber("42", value));
+    REQUIRE(value == 42);
+    REQUIRE(parseCellNumber(" -1.25E-2 ", value));
+    REQUIRE(value == -0.0125);
+    REQUIRE(parseCellNumber("+3", value));
+    REQUIRE(value == 3);
+    REQUIRE_FALSE(parseCellNumber("", value));
+    REQUIRE_FALSE(parseCellNumber("12abc", value));
+    REQUIRE_FALSE(parseCellNumber("1,5", value));
+
+    std::string decoded;
+    appendDecodedXml("&quot;a&apos; &amp;amp; &unknown; &#65;&", decoded);
+    REQUIRE(decoded == "\"a' &amp; &unknown; A&");
+}
+
+TEST_CASE("Inflate decodes stored, fixed and dynamic blocks", "[zip]")
+{
+    REQUIRE(inflateAll(toBytes(kFixedBlock)) == kFixedText);
+    REQUIRE(inflateAll(toBytes(kDynamicBlock)) == kDynamicText);
+
+    // 多个存储块，输出超过回溯窗口后分块交给回调
+    std::string expected;
+    std::string compressed;
+    for (int block = 0; block < 3; ++block) {
+        std::string data(60000, static_cast<char>('a' + block));
+        compressed.push_back(block == 2 ? 1 : 0);
+        appendU16(compressed, static_cast<uint32_t>(data.size()));
+        appendU16(compressed, static_cast<uint32_t>(~data.size() & 0xFFFF));
+        compressed += data;
+        expected += data;
+    }
+
+    int chunks = 0;
+    std::string output;
+    bool complete = inflateRaw(reinterpret_cast<const unsigned char *>(compressed.data()),
+                               compressed.size(), expected.size(),
+                               [&](const char *data, size_t size) {
+                                   chunks++;
+                                   output.append(data, size);
+                                   return true;
+                               });
+    REQUIRE(complete);
+    REQUIRE(output == expected);
+    REQUIRE(chunks > 1);
+
+    // 回调提前停止
+    complete = inflateRaw(reinterpret_cast<const unsigned char *>(compressed.data()),
+                          compressed.size(), expected.size(),
+                          [](const char *, size_t) { return false; });
+    REQUIRE_FALSE(complete);
+
+    // 截断和超出声明大小的数据报错
+    std::string truncated = toBytes(kDynamicBlock).substr(0, 20);
+    REQUIRE_THROWS_AS(inflateAll(truncated), std::runtime_error);
+    REQUIRE_THROWS_AS(inflateAll(toBytes(kFixedBlock), 10), std::runtime_error);
+}
+
+TEST_CASE("Deflate output round-trips through inflate", "[zip]")
+{
+    // 重复的文本、不可压缩的字节、长游程、空输入和跨越多个块的输入
+    std::string text;
+    for (int i = 0; i < 5000; ++i) {
+        text += "{\"pgValue\":" + std::to_string(i % 97) + ",\"hasTrend\":false},";
+    }
+    std::string noise(70000, '\0');
+    uint32_t state = 12345;
+    for (auto &ch : noise) {
+        state = state * 1103515245u + 12345u;
+        ch = static_cast<char>(state >> 24);
+    }
+    std::vector<std::string> inputs = {text, noise, std::string(100000, 'x'), "", "abc"};
+
+    for (int level : {0, 1, 6, 9}) {
+        for (const auto &input : inputs) {
+            std::string compressed;
+            deflateRaw(input.data(), input.size(), level, compressed);
+            REQUIRE(inflateAll(compressed, input.size()) == input);
+        }
+    }
+
+    // 文本压缩到原来的一小部分，不可压缩的数据只增加块头
+    std::string compressed;
+    deflateRaw(text.data(), text.size(), kDefaultDeflateLevel, compressed);
+    REQUIRE(compressed.size() < text.size() / 5);
+    compressed.clear();
+    deflateRaw(noise.data(), noise.size(), kDefaultDeflateLevel, compressed);
+    REQUIRE(compressed.size() <= noise.size() + 64);
+
+    // gzip的头部和尾部的CRC-32与长度
+    std::string gzip = gzipCompress(text.data(), text.size());
+    REQUIRE(gzip.compare(0, 3, "\x1f\x8b\x08") == 0);
+    Crc32 crc;
+    crc.update(text.data(), text.size());
+    uint32_t storedCrc = 0;
+    uint32_t storedSize = 0;
+    for (int i = 3; i >= 0; --i) {
+        storedCrc = (storedCrc << 8) | static_cast<unsigned char>(gzip[gzip.size() - 8 + i]);
+        storedSize = (storedSize << 8) | static_cast<unsigned char>(gzip[gzip.size() - 4 + i]);
+    }
+    REQUIRE(storedCrc == crc.digest());
+    REQUIRE(storedSize == text.size());
+    REQUIRE(inflateAll(gzip.substr(10, gzip.size() - 18)) == text);
+
+    // zlib头部可被31整除
+    std::string zlib = zlibCompress(text.data(), text.size());
+    REQUIRE(((static_cast<unsigned char>(zlib[0]) << 8) | static_cast<unsigned char>(zlib[1])) %
+                31 ==
+            0);
+    REQUIRE(inflateAll(zlib.substr(2, zlib.size() - 6)) == text);
+}
+
+TEST_CASE("ZIP archive reads members into memory", "[zip]")
+{
+    std::string archiveData = buildZip({{"docs/readme.txt", "stored content", ""},
+                                        {"data.csv", kDynamicText, toBytes(kDynamicBlock)}});
+
+    ZipArchive archive = ZipArchive::fromBuffer(archiveData);
+    REQUIRE(archive.getEntries().size() == 2);
+    REQUIRE(archive.readEntry("docs/readme.txt") == "stored content");
+    REQUIRE(archive.readEntry("data.csv") == kDynamicText);
+    REQUIRE(archive.hasEntry("DATA.CSV"));
+    REQUIRE_FALSE(archive.hasEntry("missing.txt"));
+    REQUIRE_THROWS_AS(archive.readEntry("missing.txt"), std::runtime_error);
+
+    // 内容被篡改时CRC校验失败
+    std::string tampered = archiveData;
+    tampered[tampered.find("stored content")] = 'S';
+    REQUIRE_THROWS_AS(ZipArchive::fromBuffer(tampered).readEntry("docs/readme.txt"),
+                      std::runtime_error);
+
+    REQUIRE_THROWS_AS(ZipArchive::fromBuffer("not a zip file"), std::runtime_error);
+}
+
+TEST_CASE("Excel reader imports xlsx without extracting to disk", "[excel_reader]")
+{
+    fs::path path = fs::temp_directory_path() / "neumann_test_workbook.xlsx";
+
+    std::string rows;
+    for (int i = 0; i < 6; ++i) {
+        int row = i + 2;
+        rows += "<row r=\"" + std::to_string(row) + "\"><c r=\"A" + std::to_string(row) +
+                "\"><v>" + std::to_string(i) + "</v></c><c r=\"B" + std::to_string(row) +
+                "\"><v>" + std::to_string(100 + i * 10) + "</v></c></row>";
+    }
+
+    std::string xlsx = buildZip(
+        {{"[Content_Types].xml", "<?xml version=\"1.0\"?><Types/>", ""},
+         {"xl/workbook.xml",
+          "<workbook><sheets><sheet name=\"Summary\" sheetId=\"1\" r:id=\"rId1\"/>"
+          "<sheet name=\"Data &amp; Trend\" sheetId=\"2\" r:id=\"rId2\"/></sheets></workbook>",
+          ""},
+         {"xl/_rels/workbook.xml.rels",
+          "<Relationships><Relationship Id=\"rId1\" Target=\"worksheets/summary.xml\"/>"
+          "<Relationship Id=\"rId2\" Target=\"/xl/worksheets/data.xml\"/></Relationships>",
+          ""},
+         {"xl/sharedStrings.xml", "<sst><si><t>time</t></si><si><t>value</t></si></sst>", ""},
+         {"xl/worksheets/summary.xml", "<worksheet><sheetData/></worksheet>", ""},
+         {"xl/worksheets/data.xml",
+          "<worksheet><sheetData><row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c>"
+          "<c r=\"B1\" t=\"s\"><v>1</v></c></row>" +
+              rows + "</sheetData></worksheet>",
+          ""}});
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << xlsx;
+    }
+
+    ExcelReader reader;
+    REQUIRE(reader.getSheetNames(path.string()) ==
+            std::vector<std::string>{"Summary", "Data & Trend"});
+
+    DataSet dataSet = reader.importFromExcel(path.string(), "Data & Trend", true);
+    REQUIRE(dataSet.dataPoints == std::vector<double>{100, 110, 120, 130, 140, 150});
+    REQUIRE(dataSet.timePoints == std::vector<double>{0, 1, 2, 3, 4, 5});
+
+    auto preview = reader.previewExcelData(path.string(), "Data & Trend", 3);
+    REQUIRE(preview.size() == 3);
+    REQUIRE(preview[0] == std::vector<std::string>{"time", "value"});
+
+    fs::remove(path);
+}
+
+TEST_CASE("Excel preview stops reading after the requested rows", "[excel_reader]")
+{
+    fs::path path = fs::temp_directory_path() / "neumann_test_preview.xlsx";
+
+    // 共享字符串和工作表末尾的数据被篡改：完整读取会校验失败，预览不应读到这些部分
+    std::string strings = "<sst><si><t>time</t></si><si><t>value</t></si>";
+    for (int i = 0; i < 1000; ++i) {
+        strings += "<si><t>unused " + std::to_string(i) + "</t></si>";
+    }
+    strings += "<si><t>TAIL</t></si></sst>";
+
+    std::string sheet = "<worksheet><sheetData><row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c>"
+                        "<c r=\"C1\" t=\"s\"><v>1</v></c></row>";
+    for (int row = 2; row < 5000; ++row) {
+        sheet += "<row r=\"" + std::to_string(row) + "\"><c r=\"A" + std::to_string(row) +
+                 "\"><v>" + std::to_string(row) + "</v></c><c r=\"C" + std::to_string(row) +
+                 "\"><v>" + std::to_string(row * 2) + "</v></c></row>";
+    }
+    sheet += "<row r=\"5000\"><c r=\"A5000\"><v>TAIL</v></c></row></sheetData></worksheet>";
+
+    std::string xlsx = buildZip({{"xl/workbook.xml",
+                                  "<workbook><sheets><sheet name=\"Data\" sheetId=\"1\"/>"
+                                  "</sheets></workbook>",
+                                  ""},
+                                 {"xl/sharedStrings.xml", strings, ""},
+                                 {"xl/worksheets/sheet1.xml", sheet, ""}});
+    xlsx[xlsx.find("TAIL")] = 'X';
+    xlsx[xlsx.find("TAIL")] = 'X';
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << xlsx;
+    }
+
+    ExcelReader reader;
+    auto preview = reader.previewExcelData(path.string(), "Data", 3);
+    REQUIRE(preview.size() == 3);
+    REQUIRE(preview[0] == std::vector<std::string>{"time", "", "value"});
+    REQUIRE(preview[2] == std::vector<std::string>{"3", "", "6"});
+
+    // 完整导入会读到被篡改的数据
+    REQUIRE_THROWS_AS(reader.importFromExcel(path.string(), "Data", true), NeumannException);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Workbook cache reuses parsed workbooks until the file changes", "[excel_reader]")
+{
+    fs::path path = fs::temp_directory_path() / "neumann_test_cached.xlsx";
+    auto writeWorkbook = [&path](const std::string &sheetName, int rowCount) {
+        std::string sheet = "<worksheet><sheetData><row><c t=\"s\"><v>0</v></c>"
+                            "<c t=\"s\"><v>1</v></c></row>";
+        for (int i = 0; i < rowCount; ++i) {
+            sheet += "<row><c><v>" + std::to_string(i) + "</v></c><c><v>" +
+                     std::to_string(i * 3) + "</v></c></row>";
+        }
+        sheet += "</sheetData></worksheet>";
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << buildZip({{"xl/workbook.xml",
+                           "<workbook><sheets><sheet name=\"" + sheetName +
+                               "\" sheetId=\"1\"/></sheets></workbook>",
+                           ""},
+                          {"xl/sharedStrings.xml",
+                           "<sst><si><t>time</t></si><si><t>value</t></si></sst>", ""},
+                          {"xl/worksheets/sheet1.xml", sheet, ""}});
+    };
+
+    auto &cache = WorkbookCache::getInstance();
+    cache.clear();
+    writeWorkbook("First", 5);
+
+    ExcelReader reader;
+    REQUIRE(reader.getSheetNames(path.string()) == std::vector<std::string>{"First"});
+    auto cached = cache.find(path.string());
+    REQUIRE(cached);
+    REQUIRE_FALSE(cached->sharedStrings);
+
+    // 预览和导入复用同一个ZIP目录，导入后共享字符串表也进入缓存
+    REQUIRE(reader.previewExcelData(path.string(), "First", 2)[0] ==
+            std::vector<std::string>{"time", "value"});
+    REQUIRE(reader.importFromExcel(path.string(), "First", true).dataPoints.size() == 5);
+    auto withStrings = cache.find(path.string());
+    REQUIRE(withStrings->archive == cached->archive);
+    REQUIRE(withStrings->sharedStrings);
+    REQUIRE(*withStrings->sharedStrings == std::vector<std::string>{"time", "value"});
+    REQUIRE(reader.previewExcelData(path.string(), "First", 1)[0] ==
+            std::vector<std::string>{"time", "value"});
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.getMemoryUsage() > 0);
+
+    // 按xls格式查找同一路径不会命中xlsx条目
+    Counter &misses = cacheLookupCounter("workbook", "miss");
+    uint64_t missesBefore = misses.value();
+    REQUIRE_FALSE(cache.findXls(path.string()));
+    REQUIRE(misses.value() == missesBefore + 1);
+    REQUIRE(cache.find(path.string()) == withStrings);
+
+    // 文件内容变化后重新解析
+    writeWorkbook("Second", 7);
+    REQUIRE(reader.getSheetNames(path.string()) == std::vector<std::string>{"Second"});
+    REQUIRE(reader.importFromExcel(path.string(), "Second", true).dataPoints.size() == 7);
+
+    // 超过内存上限的工作簿不缓存
+    size_t limit = cache.getMemoryLimit();
+    cache.setMemoryLimit(0);
+    REQUIRE(cache.size() == 0);
+    reader.getSheetNames(path.string());
+    REQUIRE(cache.size() == 0);
+    cache.setMemoryLimit(limit);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Every numeric column of every sheet becomes its own series", "[excel_reader]")
+{
+    fs::path path = fs::temp_directory_path() / "neumann_test_lots.xlsx";
+
+    // 每行：批号、时间、两个检测项；第二个工作表只有一个检测项，第三个工作表没有数值
+    auto makeSheet = [](int assays, double slope) {
+        std::string sheet = "<worksheet><sheetData><row><c t=\"inlineStr\"><is><t>lot</t></is></c>"
+                            "<c t=\"inlineStr\"><is><t>day</t></is></c>";
+        for (int assay = 0; assay < assays; ++assay) {
+            sheet += "<c t=\"inlineStr\"><is><t>assay " + std::to_string(assay + 1) +
+                     "</t></is></c>";
+        }
+        sheet += "</row>";
+        for (int day = 0; day < 8; ++day) {
+            sheet += "<row><c t=\"inlineStr\"><is><t>L" + std::to_string(day) +
+                     "</t></is></c><c><v>" + std::to_string(day * 7) + "</v></c>";
+            for (int assay = 0; assay < assays; ++assay) {
+                double value = 100 + slope * day * (assay + 1) + (day % 3);
+                sheet += "<c><v>" + std::to_string(value) + "</v></c>";
+            }
+            sheet += "</row>";
+        }
+        return sheet + "</sheetData></worksheet>";
+    };
+
+    std::string xlsx = buildZip(
+        {{"xl/workbook.xml",
+          "<workbook><sheets><sheet name=\"Lot A\" sheetId=\"1\"/><sheet name=\"Lot B\" "
+          "sheetId=\"2\"/><sheet name=\"Notes\" sheetId=\"3\"/></sheets></workbook>",
+          ""},
+         {"xl/worksheets/sheet1.xml", makeSheet(2, 5.0), ""},
+         {"xl/worksheets/sheet2.xml", makeSheet(1, 0.0), ""},
+         {"xl/worksheets/sheet3.xml",
+          "<worksheet><sheetData><row><c t=\"inlineStr\"><is><t>note</t></is></c></row>"
+          "</sheetData></worksheet>",
+          ""}});
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << xlsx;
+    }
+
+    ExcelReader reader;
+    auto series = reader.importAllSeries(path.string(), true, 4);
+    REQUIRE(series.size() == 3);
+    REQUIRE(series[0].name == "neumann_test_lots/Lot A/assay 1");
+    REQUIRE(series[1].name == "neumann_test_lots/Lot A/assay 2");
+    REQUIRE(series[2].name == "neumann_test_lots/Lot B/assay 1");
+    for (const auto &dataSet : series) {
+        REQUIRE(dataSet.dataPoints.size() == 8);
+        REQUIRE(dataSet.timePoints == std::vector<double>{0, 7, 14, 21, 28, 35, 42, 49});
+        REQUIRE(dataSet.source == path.string());
+    }
+    REQUIRE(series[1].dataPoints[1] == 111);
+
+    // 整个工作簿一次调用完成分析
+    BatchProcessor processor(0.95);
+    int progressCalls = 0;
+    auto results = processor.processWorkbook(
+        path.string(), [&](int, int total, const std::string &) {
+            progressCalls++;
+            REQUIRE(total == 3);
+        });
+    REQUIRE(results.size() == 3);
+    REQUIRE(progressCalls == 3);
+    for (size_t i = 0; i < results.size(); ++i) {
+        REQUIRE(results[i].status == "success");
+        REQUIRE(results[i].filename == series[i].name);
+        REQUIRE(results[i].dataPointCount == 8);
+    }
+    REQUIRE(results[0].testResults.overallTrend);
+    REQUIRE_FALSE(results[2].testResults.overallTrend);
+
+    auto missing = processor.processWorkbook((fs::temp_directory_path() / "missing.xlsx").string());
+    REQUIRE(missing.size() == 1);
+    REQUIRE(missing[0].status == "error");
+
+    fs::remove(path);
+}
+
+TEST_CASE("Legacy xls workbooks are read from BIFF8 records", "[excel_reader]")
+{
+    fs::path path = fs::temp_directory_path() / "neumann_test_legacy.xls";
+    const char *sheetName = "Donn\xC3\xA9" "es";
+
+    // 共享字符串表："time"和"value"，后者在CONTINUE记录处切开并改为UTF-16存放
+    std::string sst = u32Bytes(4) + u32Bytes(2);
+    appendU16(sst, 4);
+    sst += std::string("\x00time", 5);
+    appendU16(sst, 5);
+    sst += std::string("\x00va", 3);
+    std::string continued("\x01", 1);
+    for (char ch : std::string("lue")) {
+        appendU16(continued, static_cast<unsigned char>(ch));
+    }
+    std::string sharedStrings = biffRecord(0x00FC, sst) + biffRecord(0x003C, continued);
+
+    auto rk = [](uint32_t value) { return u32Bytes(value); };
+    std::string xf("\x0F\x00", 2);        // MULRK中每个单元格的格式索引
+    std::string formulaTail(6, '\0');  // 公式的选项和表达式（不读取）
+    std::string cells =
+        biffCell(0x00FD, 0, 0, u32Bytes(0)) + biffCell(0x00FD, 0, 1, u32Bytes(1)) +
+        biffCell(0x027E, 1, 0, rk((0 << 2) | 0x02)) + biffCell(0x0203, 1, 1, doubleBytes(100)) +
+        // 公式的字符串结果在随后的STRING记录中
+        biffCell(0x0006, 1, 2, std::string("\x00\x00\x00\x00\x00\x00\xFF\xFF", 8) + formulaTail) +
+        biffRecord(0x0207, std::string("\x02\x00\x00ok", 5)) +
+        biffCell(0x027E, 2, 0, rk((1 << 2) | 0x02)) +
+        biffCell(0x027E, 2, 1, rk((11000 << 2) | 0x03)) +  // 整数11000除以100
+        biffRecord(0x00BD, std::string("\x03\x00\x00\x00", 4) + xf + rk((2 << 2) | 0x02) + xf +
+                               rk((120 << 2) | 0x02) + std::string("\x01\x00", 2)) +
+        biffCell(0x027E, 4, 0, rk((3 << 2) | 0x02)) + biffCell(0x0006, 4, 1, doubleBytes(130) +
+                                                                 formulaTail) +
+        biffCell(0x027E, 5, 0, rk((4 << 2) | 0x02)) + biffCell(0x027E, 5, 1, rk(0x40618000)) +
+        biffCell(0x027E, 6, 0, rk((5 << 2) | 0x02)) +
+        biffCell(0x0204, 6, 1, std::string("\x03\x00\x00", 3) + "150") +
+        biffCell(0x0205, 6, 2, std::string("\x07\x01", 2));
+
+    std::string workbook = buildBiffWorkbook({{sheetName, cells}, {"Summary", ""}}, sharedStrings);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << buildCompoundFile("Workbook", workbook);
+    }
+
+    ExcelReader reader;
+    REQUIRE(reader.getSheetNames(path.string()) ==
+            std::vector<std::string>{sheetName, "Summary"});
+
+    // 获取工作表名称后Workbook流已缓存，之后的预览和导入不再读取复合文档
+    auto cached = WorkbookCache::getInstance().findXls(path.string());
+    REQUIRE(cached);
+    REQUIRE(cached->info.sheets.size() == 2);
+
+    DataSet dataSet = reader.importFromExcel(path.string(), sheetName, true);
+    REQUIRE(dataSet.dataPoints == std::vector<double>{100, 110, 120, 130, 140, 150});
+    REQUIRE(dataSet.timePoints == std::vector<double>{0, 1, 2, 3, 4, 5});
+    REQUIRE(dataSet.name == "neumann_test_legacy");
+
+    auto preview = reader.previewExcelData(path.string(), sheetName, 2);
+    REQUIRE(preview.size() == 2);
+    REQUIRE(preview[0] == std::vector<std::string>{"time", "value"});
+    REQUIRE(preview[1] == std::vector<std::string>{"0", "100", "ok"});
+
+    auto series = reader.importAllSeries(path.string(), true, 2);
+    REQUIRE(series.size() == 1);
+    REQUIRE(series[0].name == "neumann_test_legacy/" + std::string(sheetName) + "/value");
+    REQUIRE(series[0].dataPoints.size() == 6);
+    REQUIRE(WorkbookCache::getInstance().findXls(path.string()) == cached);
+
+    // 批量处理读取第一个工作表
+    BatchProcessor processor(0.95);
+    auto result = processor.processSingleFile(path.string());
+    REQUIRE(result.status == "success");
+    REQUIRE(result.dataPointCount == 6);
+
+    // 空工作表没有数据
+    REQUIRE_THROWS_AS(reader.importFromExcel(path.string(), "Summary", true), NeumannException);
+
+    // Excel 5.0/95的BIFF5工作簿和加密工作簿给出明确的错误
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << buildCompoundFile("Book", biffBof(0x0005, 0x0500) + biffRecord(0x000A, ""));
+    }
+    REQUIRE_THROWS_AS(reader.importFromExcel(path.string(), "", true), NeumannException);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << buildCompoundFile("Workbook", biffBof(0x0005) + biffRecord(0x002F, "") +
+                                                  biffRecord(0x000A, ""));
+    }
+    REQUIRE_THROWS_AS(reader.importFromExcel(path.string(), "", true), NeumannException);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Compound file reader follows sector chains", "[excel_reader]")
+{
+    std::string content;
+    for (int i = 0; i < 1500; ++i) {
+        content += static_cast<char>('a' + i % 26);
+    }
+    content += std::string(5000, 'z');
+    CompoundFile file = CompoundFile::fromBuffer(buildCompoundFile("Workbook", content));
+    REQUIRE(file.findStream("WORKBOOK") != nullptr);
+    REQUIRE(file.findStream("Book") == nullptr);
+    REQUIRE(file.readStream("Workbook") == content);
+
+    REQUIRE_FALSE(CompoundFile::hasSignature("PK\x03\x04"));
+    REQUIRE_THROWS_AS(CompoundFile::fromBuffer(std::string(1024, '\0')), std::runtime_error);
+
+    // 扇区链指向文件之外
+    std::string broken = buildCompoundFile("Workbook", content);
+    broken.resize(broken.size() - 1024);
+    REQUIRE_THROWS_AS(CompoundFile::fromBuffer(broken).readStream("Workbook"),
+                      std::runtime_error);
+
+    // 头部中的FAT扇区数和指向自身的DIFAT链在分配内存之前被拒绝
+    auto patchU32 = [](std::string &data, size_t offset, uint32_t value) {
+        for (size_t i = 0; i < 4; ++i) {
+            data[offset + i] = static_cast<char>(value >> (8 * i));
+        }
+    };
+    std::string cyclic = buildCompoundFile("Workbook", content);
+    patchU32(cyclic, 0x2C, 0xFFFFFFFFu);  // FAT扇区数
+    patchU32(cyclic, 0x44, 0);            // 第一个DIFAT扇区
+    patchU32(cyclic, 0x48, 0xFFFFFFFFu);  // DIFAT扇区数
+    REQUIRE_THROWS_AS(CompoundFile::fromBuffer(cyclic), std::runtime_error);
+    patchU32(cyclic, 0x2C, 1);
+    REQUIRE_THROWS_AS(CompoundFile::fromBuffer(cyclic), std::runtime_error);
+}
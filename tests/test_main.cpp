@@ -0,0 +1,13 @@
+#include <catch2/catch_session.hpp>
+
+#include "core/batch_processor.h"
+
+int main(int argc, char *argv[])
+{
+    // 多进程批量处理的测试以工作进程模式重新执行本程序
+    int exitCode = 0;
+    if (neumann::BatchProcessor::runShardWorkerIfRequested(argc, argv, exitCode)) {
+        return exitCode;
+    }
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/error_handler.h"
+#include "core/metrics.h"
+#include "core/neumann_calculator.h"
+
+using namespace neumann;
+
+namespace {
+
+bool contains(const std::string &text, const std::string &part)
+{
+    return text.find(part) != std::string::npos;
+}
+
+}  // namespace
+
+TEST_CASE("Metrics are recorded from many threads", "[metrics]")
+{
+    MetricsRegistry registry;
+    Counter &requests = registry.counter("test_requests_total", "Requests", {{"route", "/a"}});
+    Gauge &inFlight = registry.gauge("test_in_flight", "In flight");
+    Histogram &latency = registry.histogram("test_latency_seconds", "Latency", {0.1, 1.0});
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) {
+                requests.increment();
+                inFlight.increment();
+                latency.observe(i % 4 == 0 ? 0.05 : 0.5);
+                inFlight.decrement();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(requests.value() == 80000);
+    REQUIRE(inFlight.value() == 0);
+    Histogram::Snapshot snapshot = latency.snapshot();
+    REQUIRE(snapshot.count == 80000);
+    REQUIRE(snapshot.buckets == std::vector<uint64_t>{20000, 60000, 0});
+    REQUIRE(snapshot.sum > 20000 * 0.05 + 60000 * 0.5 - 1e-6);
+    REQUIRE(snapshot.sum < 20000 * 0.05 + 60000 * 0.5 + 1e-6);
+
+    // 相同名称和标签返回同一个指标
+    REQUIRE(&registry.counter("test_requests_total", "Requests", {{"route", "/a"}}) == &requests);
+    REQUIRE(&registry.counter("test_requests_total", "Requests", {{"route", "/b"}}) != &requests);
+    REQUIRE_THROWS_AS(registry.gauge("test_requests_total", "Requests"), NeumannException);
+}
+
+TEST_CASE("Metrics are rendered in the Prometheus text format", "[metrics]")
+{
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", "Requests", {{"route", "/api/\"x\""}}).increment(3);
+    registry.histogram("test_size_bytes", "Sizes", {64, 1024}).observe(100);
+    size_t queued = 2;
+    registry.gaugeCallback("test_queued", "Queued", [&queued]() { return queued; });
+    queued = 5;
+
+    std::string text = registry.render();
+    REQUIRE(contains(text, "# HELP test_requests_total Requests\n"));
+    REQUIRE(contains(text, "# TYPE test_requests_total counter\n"));
+    REQUIRE(contains(text, "test_requests_total{route=\"/api/\\\"x\\\"\"} 3\n"));
+    REQUIRE(contains(text, "# TYPE test_size_bytes histogram\n"));
+    REQUIRE(contains(text, "test_size_bytes_bucket{le=\"64\"} 0\n"));
+    REQUIRE(contains(text, "test_size_bytes_bucket{le=\"1024\"} 1\n"));
+    REQUIRE(contains(text, "test_size_bytes_bucket{le=\"+Inf\"} 1\n"));
+    REQUIRE(contains(text, "test_size_bytes_sum 100\n"));
+    REQUIRE(contains(text, "test_size_bytes_count 1\n"));
+    REQUIRE(contains(text, "# TYPE test_queued gauge\ntest_queued 5\n"));
+}
+
+TEST_CASE("Calculator throughput is counted", "[metrics]")
+{
+    Counter &points = calculatorPointsCounter();
+    uint64_t before = points.value();
+
+    NeumannCalculator calculator(0.95);
+    calculator.performTest({1.0, 2.0, 3.0, 4.0, 5.0, 6.0});
+    REQUIRE(points.value() == before + 6);
+
+    // 共享的计数器注册在固定的指标名下
+    REQUIRE(&points == &MetricsRegistry::getInstance().counter(
+                           "neumann_calculator_points_total",
+                           "Data points processed by the trend calculators"));
+    REQUIRE(&cacheLookupCounter("workbook", "hit") ==
+            &MetricsRegistry::getInstance().counter(
+                "neumann_cache_requests_total", "Cache lookups by cache and result",
+                {{"cache", "workbook"}, {"result", "hit"}}));
+}
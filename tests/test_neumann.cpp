@@ -1,8 +1,22 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
+#include "core/analysis_request.h"
+#include "core/config.h"
+#include "core/error_handler.h"
+#include "core/data_manager.h"
 #include "core/neumann_calculator.h"
+#include "core/online_neumann_calculator.h"
+#include "core/result_encoding.h"
 #include "core/standard_values.h"
 
 using namespace neumann;
@@ -105,4 +119,344 @@ TEST_CASE("Edge cases for Neumann calculator", "[neumann_calculator]")
         // 更高置信水平的W(P)值应该更大
         REQUIRE(results2.results[0].wpThreshold > results1.results[0].wpThreshold);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Neumann calculator stops when its token is cancelled", "[neumann_calculator]")
+{
+    std::vector<double> data = {100, 110, 120, 130, 140, 150};
+    NeumannCalculator calculator;
+    CancellationToken token;
+    calculator.setCancellationToken(token);
+    REQUIRE(calculator.performTest(data).results.size() == 3);
+
+    token.cancel();
+    try {
+        calculator.performTest(data);
+        FAIL("performTest should stop after cancellation");
+    }
+    catch (const NeumannException &e) {
+        REQUIRE(e.getErrorCode() == ErrorCode::OPERATION_CANCELLED);
+    }
+}
+
+TEST_CASE("Online calculator matches the batch calculation", "[online_neumann_calculator]")
+{
+    std::vector<std::vector<double>> series = {
+        {100, 110, 120, 130, 140, 150},
+        {100, 105, 102, 108, 103, 106},
+        {5, 5, 5, 5, 5},
+        {1e6 + 0.1, 1e6 + 0.3, 1e6 + 0.2, 1e6 + 0.5, 1e6 + 0.4, 1e6 + 0.7, 1e6 + 0.9, 1e6 + 0.8},
+        {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3, 2, 3, 8, 4}};
+
+    for (double level : {0.95, 0.99}) {
+        for (const auto &data : series) {
+            NeumannCalculator calculator(level);
+            NeumannTestResults expected = calculator.performTest(data);
+
+            OnlineNeumannCalculator online(level);
+            std::vector<NeumannResult> results;
+            for (double value : data) {
+                NeumannResult result;
+                if (online.addPoint(value, result)) {
+                    results.push_back(result);
+                }
+            }
+
+            REQUIRE(online.getPointCount() == data.size());
+            REQUIRE(results.size() == expected.results.size());
+            for (size_t i = 0; i < results.size(); ++i) {
+                REQUIRE(results[i].pgValue ==
+                        Catch::Approx(expected.results[i].pgValue).margin(1e-9));
+                REQUIRE(results[i].hasTrend == expected.results[i].hasTrend);
+                REQUIRE(results[i].wpThreshold == expected.results[i].wpThreshold);
+            }
+            REQUIRE(online.hasOverallTrend() == expected.overallTrend);
+            REQUIRE(online.getMinPG() == Catch::Approx(expected.minPG).margin(1e-9));
+            REQUIRE(online.getMaxPG() == Catch::Approx(expected.maxPG).margin(1e-9));
+            REQUIRE(online.getAvgPG() == Catch::Approx(expected.avgPG).margin(1e-9));
+        }
+    }
+
+    // 重置后从头开始
+    OnlineNeumannCalculator online;
+    NeumannResult result;
+    for (double value : {100.0, 110.0, 120.0, 130.0}) {
+        online.addPoint(value, result);
+    }
+    online.reset(0.99);
+    REQUIRE(online.getPointCount() == 0);
+    REQUIRE(online.getResultCount() == 0);
+    REQUIRE(online.getConfidenceLevel() == 0.99);
+    REQUIRE_FALSE(online.addPoint(100.0, result));
+    REQUIRE(online.getAvgPG() == 0.0);
+}
+
+TEST_CASE("Test results encode as JSON or columnar binary", "[result_encoding]")
+{
+    NeumannCalculator calculator;
+    std::vector<double> data = {100, 110, 120, 130, 140, 150};
+    std::vector<double> timePoints = {0, 2, 5, 10, 15, 20};
+    auto results = calculator.performTest(data, timePoints);
+
+    SECTION("Accept header negotiation")
+    {
+        REQUIRE(negotiateResultEncoding("") == ResultEncoding::JSON);
+        REQUIRE(negotiateResultEncoding("*/*") == ResultEncoding::JSON);
+        REQUIRE(negotiateResultEncoding("application/vnd.neumann.columnar") ==
+                ResultEncoding::COLUMNAR);
+        REQUIRE(negotiateResultEncoding("application/json, application/octet-stream") ==
+                ResultEncoding::JSON);
+        REQUIRE(negotiateResultEncoding("application/json;q=0.5, Application/Octet-Stream") ==
+                ResultEncoding::COLUMNAR);
+        REQUIRE(negotiateResultEncoding("application/octet-stream;q=0, */*") ==
+                ResultEncoding::JSON);
+        REQUIRE(negotiateResultEncoding("text/html") == ResultEncoding::JSON);
+    }
+
+    SECTION("JSON keeps the per-point objects and can omit the input")
+    {
+        auto response = nlohmann::json::parse(encodeResultsJson(results));
+        REQUIRE(response["data"].get<std::vector<double>>() == data);
+        REQUIRE(response["results"].size() == 3);
+        REQUIRE(response["results"][0]["dataPoint"] == 130);
+        REQUIRE(response["results"][0]["timePoint"] == 10);
+        REQUIRE(response["overallTrend"] == true);
+
+        auto compact = nlohmann::json::parse(encodeResultsJson(results, false));
+        REQUIRE_FALSE(compact.contains("data"));
+        REQUIRE_FALSE(compact.contains("time"));
+        REQUIRE(compact["results"] == response["results"]);
+    }
+
+    SECTION("Columnar layout")
+    {
+        std::string encoded = encodeResultsColumnar(results);
+        auto readU32 = [&](size_t offset) {
+            const auto *bytes = reinterpret_cast<const unsigned char *>(encoded.data() + offset);
+            return static_cast<uint32_t>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+                                         (static_cast<uint32_t>(bytes[3]) << 24));
+        };
+        auto readDouble = [&](size_t offset) {
+            uint64_t bits = readU32(offset) | (static_cast<uint64_t>(readU32(offset + 4)) << 32);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        };
+
+        REQUIRE(encoded.compare(0, 4, "NTR1") == 0);
+        REQUIRE((readU32(4) & 0xFFFF) == 1);
+        REQUIRE((readU32(4) >> 16) == 0x03);  // 存在趋势，附带输入
+        REQUIRE(readU32(8) == 3);
+        REQUIRE(readU32(12) == 6);
+        REQUIRE(readDouble(16) == 0.95);
+        REQUIRE(readDouble(24) == results.minPG);
+
+        // 2个测试点列、2个输入列和hasTrend列
+        REQUIRE(encoded.size() == 48 + 3 * 2 * 8 + 6 * 2 * 8 + 3);
+        REQUIRE(readDouble(48) == results.results[0].pgValue);
+        REQUIRE(readDouble(48 + 3 * 8 + 2 * 8) == results.results[2].wpThreshold);
+        REQUIRE(readDouble(48 + 2 * 3 * 8 + 3 * 8) == 130);
+        REQUIRE(readDouble(48 + 2 * 3 * 8 + 6 * 8 + 5 * 8) == 20);
+        REQUIRE(encoded.back() == (results.results[2].hasTrend ? 1 : 0));
+
+        std::string compact = encodeResultsColumnar(results, false);
+        REQUIRE(compact.size() == 48 + 3 * 2 * 8 + 3);
+        REQUIRE(compact[6] == 0x01);
+    }
+}
+
+TEST_CASE("Analysis requests are parsed into numeric buffers", "[analysis_request]")
+{
+    SECTION("Fields are read and unknown values skipped")
+    {
+        AnalysisRequest request = parseAnalysisRequest(
+            R"({"meta":{"data":[1,[2]],"time":"x"},"data":[1,-2,3.5,4e2],)"
+            R"("confidenceLevel":0.9,"echo":false,"tags":[true,null,{"a":[]}],)"
+            R"("time":[0,1,2,3]})");
+        REQUIRE(request.dataPoints == std::vector<double>{1, -2, 3.5, 400});
+        REQUIRE(request.timePoints == std::vector<double>{0, 1, 2, 3});
+        REQUIRE(request.confidenceLevel == 0.9);
+        REQUIRE_FALSE(request.echo);
+
+        // 默认值和可省略的time
+        AnalysisRequest defaults = parseAnalysisRequest(R"({"data":[5,6]})");
+        REQUIRE(defaults.dataPoints == std::vector<double>{5, 6});
+        REQUIRE(defaults.timePoints.empty());
+        REQUIRE(defaults.confidenceLevel == 0.95);
+        REQUIRE(defaults.echo);
+
+        // 重复的字段以最后一次为准，与DOM解析一致
+        AnalysisRequest repeated = parseAnalysisRequest(R"({"data":[1,2,3],"data":[4]})");
+        REQUIRE(repeated.dataPoints == std::vector<double>{4});
+
+        // 名称中的转义按JSON解码
+        AnalysisRequest escaped = parseAnalysisRequest(R"({ "d\u0061ta" : [ 7 , 8 ] })");
+        REQUIRE(escaped.dataPoints == std::vector<double>{7, 8});
+    }
+
+    SECTION("Matches the DOM parser on a large request")
+    {
+        nlohmann::json document;
+        std::vector<double> data;
+        std::vector<double> timePoints;
+        for (int i = 0; i < 10000; ++i) {
+            data.push_back(i * 0.37 - 1e3);
+            timePoints.push_back(i);
+        }
+        document["data"] = data;
+        document["time"] = timePoints;
+        AnalysisRequest request = parseAnalysisRequest(document.dump());
+        REQUIRE(request.dataPoints == data);
+        REQUIRE(request.timePoints == timePoints);
+    }
+
+    SECTION("Invalid requests are rejected")
+    {
+        auto errorCode = [](const std::string &body, size_t maxPoints = 100) {
+            try {
+                parseAnalysisRequest(body, maxPoints);
+            }
+            catch (const NeumannException &e) {
+                return e.getErrorCode();
+            }
+            return ErrorCode::SUCCESS;
+        };
+        REQUIRE(errorCode(R"({"data":[1,2)") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1,2]} x)") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"([1,2,3])") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"time":[1,2]})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1,"2"]})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1,[2]]})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":1})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[01]})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1],"tags":[1,]})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1],"name":"a)") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1],"echo":1})") == ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1],"confidenceLevel":"0.9"})") ==
+                ErrorCode::DATA_PARSING_ERROR);
+        REQUIRE(errorCode(R"({"data":[1,2,3]})", 3) == ErrorCode::SUCCESS);
+        REQUIRE(errorCode(R"({"data":[1,2,3,4]})", 3) == ErrorCode::DATA_OUT_OF_RANGE);
+        REQUIRE(errorCode(R"({"data":[1],"time":[1,2,3,4]})", 3) == ErrorCode::DATA_OUT_OF_RANGE);
+    }
+}
+
+namespace {
+
+// 把配置和数据管理器的数据目录临时指向唯一的空目录，结束时恢复并删除该目录
+struct ScopedDataDirectory {
+    std::filesystem::path path;
+    std::string previousConfigDirectory;
+    std::string previousManagerDirectory;
+
+    explicit ScopedDataDirectory(const std::string &name)
+        : previousConfigDirectory(Config::getInstance().getDataDirectory()),
+          previousManagerDirectory(DataManager::getInstance().getDataDirectory())
+    {
+        std::random_device random;
+        path = std::filesystem::temp_directory_path() /
+               ("neumann_" + name + "_" + std::to_string(random()));
+        std::filesystem::create_directories(path);
+        Config::getInstance().setDataDirectory(path.string());
+        DataManager::getInstance().setDataDirectory(path.string());
+    }
+
+    ~ScopedDataDirectory()
+    {
+        Config::getInstance().setDataDirectory(previousConfigDirectory);
+        DataManager::getInstance().setDataDirectory(previousManagerDirectory);
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    ScopedDataDirectory(const ScopedDataDirectory &) = delete;
+    ScopedDataDirectory &operator=(const ScopedDataDirectory &) = delete;
+};
+
+}  // namespace
+
+TEST_CASE("Dataset statistics are maintained incrementally", "[data_manager]")
+{
+    ScopedDataDirectory dataDir("statistics");
+    auto &dataManager = DataManager::getInstance();
+
+    auto makeDataSet = [](const std::string &name, std::vector<double> data) {
+        DataSet dataSet;
+        dataSet.name = name;
+        dataSet.dataPoints = data;
+        for (size_t i = 0; i < data.size(); ++i) {
+            dataSet.timePoints.push_back(static_cast<double>(i));
+        }
+        return dataSet;
+    };
+    DataSet rising = makeDataSet("stats_rising", {1, 2, 3, 4, 5, 6, 7, 8});
+    DataSet noisy = makeDataSet("stats_noisy", {5.1, 4.8, 5.3, 4.9, 5.2, 4.7, 5.0});
+    DataSet tiny = makeDataSet("stats_tiny", {1, 2, 3});
+    REQUIRE(dataManager.saveDataSet(rising));
+    REQUIRE(dataManager.saveDataSet(tiny));
+
+    DataSetStatistics statistics = dataManager.getStatistics(0.95);
+    REQUIRE(statistics.totalDatasets == 2);
+    REQUIRE(statistics.testedDatasets == 1);
+
+    // 查询之后的保存和删除增量更新统计
+    REQUIRE(dataManager.saveDataSet(noisy));
+    NeumannCalculator calculator(0.95);
+    NeumannTestResults risingResults = calculator.performTest(rising.dataPoints);
+    NeumannTestResults noisyResults = calculator.performTest(noisy.dataPoints);
+
+    statistics = dataManager.getStatistics(0.95);
+    REQUIRE(statistics.totalDatasets == 3);
+    REQUIRE(statistics.testedDatasets == 2);
+    REQUIRE(statistics.datasetsWithTrend ==
+            int(risingResults.overallTrend) + int(noisyResults.overallTrend));
+    REQUIRE(statistics.avgDataPoints() == Catch::Approx(7.5));
+    REQUIRE(statistics.avgPGValue() ==
+            Catch::Approx((risingResults.avgPG + noisyResults.avgPG) / 2));
+    REQUIRE(statistics.minPG == Catch::Approx(std::min(risingResults.minPG, noisyResults.minPG)));
+    REQUIRE(statistics.maxPG == Catch::Approx(std::max(risingResults.maxPG, noisyResults.maxPG)));
+    REQUIRE(dataManager.getDataSetSummaries(0.95).at("stats_noisy").pointCount == 7);
+
+    REQUIRE(dataManager.deleteDataSet("stats_rising"));
+    statistics = dataManager.getStatistics(0.95);
+    REQUIRE(statistics.totalDatasets == 2);
+    REQUIRE(statistics.testedDatasets == 1);
+    REQUIRE(statistics.minPG == Catch::Approx(noisyResults.minPG));
+    REQUIRE(statistics.maxPG == Catch::Approx(noisyResults.maxPG));
+
+    // 覆盖保存时替换原有的摘要
+    REQUIRE(dataManager.saveDataSet(makeDataSet("stats_noisy", {1, 2, 3, 4, 5, 6, 7, 8})));
+    statistics = dataManager.getStatistics(0.95);
+    REQUIRE(statistics.totalDatasets == 2);
+    REQUIRE(statistics.avgDataPoints() == Catch::Approx(8));
+    REQUIRE(statistics.avgPGValue() == Catch::Approx(risingResults.avgPG));
+
+    REQUIRE(dataManager.deleteDataSet("stats_noisy"));
+    REQUIRE(dataManager.deleteDataSet("stats_tiny"));
+    statistics = dataManager.getStatistics(0.95);
+    REQUIRE(statistics.totalDatasets == 0);
+    REQUIRE(statistics.avgPGValue() == 0.0);
+}
+
+TEST_CASE("CSV content is split like std::getline", "[data_manager]")
+{
+    auto split = [](std::string_view text, char delimiter) {
+        std::vector<std::string> tokens;
+        std::string_view token;
+        while (DataManager::nextCSVToken(text, delimiter, token)) {
+            tokens.emplace_back(token);
+        }
+        return tokens;
+    };
+    REQUIRE(split("", ',').empty());
+    REQUIRE(split("a,,b", ',') == std::vector<std::string>{"a", "", "b"});
+    REQUIRE(split("a,", ',') == std::vector<std::string>{"a"});
+    REQUIRE(split(",", ',') == std::vector<std::string>{""});
+    REQUIRE(split("1\n\n2\n", '\n') == std::vector<std::string>{"1", "", "2"});
+
+    auto &dataManager = DataManager::getInstance();
+    DataSet dataSet = dataManager.importFromCSVContent(
+        "time,value\r\n0,1.5\r\n\r\n1,2.5\nbad,3\n2,4", "lot.csv", true);
+    REQUIRE(dataSet.name == "lot");
+    REQUIRE(dataSet.description == "time,value\r");
+    REQUIRE(dataSet.timePoints == std::vector<double>{0, 1, 2});
+    REQUIRE(dataSet.dataPoints == std::vector<double>{1.5, 2.5, 4});
+}
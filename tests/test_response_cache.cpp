@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/response_cache.h"
+
+using namespace neumann;
+
+TEST_CASE("Identical concurrent requests are computed once", "[response_cache]")
+{
+    ResponseCache cache;
+    std::atomic<int> computations(0);
+    std::atomic<bool> release(false);
+
+    std::vector<std::thread> threads;
+    std::vector<std::string> bodies(8);
+    for (size_t t = 0; t < bodies.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            auto response = cache.getOrCompute("request", [&]() {
+                ++computations;
+                while (!release) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                return CachedResponse{"application/json", "{\"result\":1}", ""};
+            });
+            bodies[t] = response->body;
+        });
+    }
+
+    // 等第一个计算开始后再稍等，让其余请求都进入等待
+    while (computations == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(computations == 1);
+    for (const auto &body : bodies) {
+        REQUIRE(body == "{\"result\":1}");
+    }
+
+    // 之后的相同请求直接命中缓存
+    cache.getOrCompute("request", [&]() {
+        ++computations;
+        return CachedResponse{"application/json", "{}", ""};
+    });
+    REQUIRE(computations == 1);
+    REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("Response cache evicts the least recently used entries", "[response_cache]")
+{
+    ResponseCache cache;
+    auto compute = [](const std::string &body) {
+        return [body]() { return CachedResponse{"text/plain", body, ""}; };
+    };
+    cache.getOrCompute("a", compute(std::string(1000, 'a')));
+    cache.getOrCompute("b", compute(std::string(1000, 'b')));
+    size_t perEntry = cache.getMemoryUsage() / 2;
+
+    // 只够保存两项，访问a后再加入c应淘汰b
+    cache.setMemoryLimit(perEntry * 2 + perEntry / 2);
+    cache.getOrCompute("a", compute("unused"));
+    cache.getOrCompute("c", compute(std::string(1000, 'c')));
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.getMemoryUsage() <= cache.getMemoryLimit());
+    REQUIRE(cache.getOrCompute("a", compute("new"))->body == std::string(1000, 'a'));
+    REQUIRE(cache.getOrCompute("b", compute("new"))->body == "new");
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.getMemoryUsage() == 0);
+}
+
+TEST_CASE("Failed computations are not cached", "[response_cache]")
+{
+    ResponseCache cache;
+    REQUIRE_THROWS_AS(cache.getOrCompute("request",
+                                         []() -> CachedResponse {
+                                             throw std::runtime_error("failed");
+                                         }),
+                      std::runtime_error);
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.getOrCompute("request", []() { return CachedResponse{"", "ok", ""}; })->body ==
+            "ok");
+
+    // 内存上限为0时只合并请求，不保存结果
+    ResponseCache uncached(0);
+    int computations = 0;
+    for (int i = 0; i < 3; ++i) {
+        uncached.getOrCompute("request", [&]() {
+            ++computations;
+            return CachedResponse{"", "ok", ""};
+        });
+    }
+    REQUIRE(computations == 3);
+    REQUIRE(uncached.size() == 0);
+}
+
+TEST_CASE("Derived responses can be computed from a cached response", "[response_cache]")
+{
+    // 与Web服务器缓存压缩结果的方式相同：派生的键在计算时查找基础键
+    ResponseCache cache;
+    int computations = 0;
+    auto base = [&]() {
+        ++computations;
+        return CachedResponse{"application/json", "{\"result\":1}", ""};
+    };
+    auto derived = [&]() {
+        CachedResponse response = *cache.getOrCompute("request", base);
+        response.contentEncoding = "gzip";
+        return response;
+    };
+
+    REQUIRE(cache.getOrCompute("request\ngzip", derived)->contentEncoding == "gzip");
+    REQUIRE(cache.getOrCompute("request\ngzip", derived)->contentEncoding == "gzip");
+    REQUIRE(cache.getOrCompute("request", base)->contentEncoding.empty());
+    REQUIRE(computations == 1);
+    REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("Requests whose keys collide do not share responses", "[response_cache]")
+{
+    // 键相同（模拟摘要碰撞）而请求内容不同
+    ResponseCache cache;
+    int computations = 0;
+    auto compute = [&](const std::string &body) {
+        return [&computations, body]() {
+            ++computations;
+            return CachedResponse{"text/plain", body, ""};
+        };
+    };
+
+    REQUIRE(cache.getOrCompute("digest", "first", compute("first"))->body == "first");
+    REQUIRE(cache.getOrCompute("digest", "second", compute("second"))->body == "second");
+    REQUIRE(computations == 2);
+
+    // 碰撞的请求不替换已缓存的结果
+    REQUIRE(cache.getOrCompute("digest", "first", compute("unused"))->body == "first");
+    REQUIRE(computations == 2);
+    REQUIRE(cache.size() == 1);
+}
@@ -0,0 +1,264 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/content_encoding.h"
+#include "core/http_header.h"
+#include "core/i18n.h"
+#include "core/inflate.h"
+#include "core/static_asset_cache.h"
+
+using namespace neumann;
+namespace fs = std::filesystem;
+
+namespace {
+
+// 在系统临时目录下创建Web资源目录，析构时删除
+struct TempWebRoot {
+    fs::path path;
+
+    explicit TempWebRoot(const std::string &name)
+        : path(fs::temp_directory_path() / ("neumann_web_" + name))
+    {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+
+    ~TempWebRoot()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    void write(const std::string &filename, const std::string &content) const
+    {
+        fs::path filePath = path / filename;
+        fs::create_directories(filePath.parent_path());
+        std::ofstream file(filePath, std::ios::binary);
+        file << content;
+    }
+};
+
+// 解压去掉头部和尾部后的原始DEFLATE数据
+std::string inflateBody(const std::string &data, size_t headerSize, size_t trailerSize)
+{
+    std::string output;
+    inflateRaw(reinterpret_cast<const unsigned char *>(data.data()) + headerSize,
+               data.size() - headerSize - trailerSize, 1 << 24,
+               [&output](const char *chunk, size_t size) {
+                   output.append(chunk, size);
+                   return true;
+               });
+    return output;
+}
+
+std::string gunzip(const std::string &gzip)
+{
+    // 跳过10字节的头部和8字节的尾部
+    return inflateBody(gzip, 10, 8);
+}
+
+}  // namespace
+
+TEST_CASE("Static asset cache serves files from memory", "[static_assets]")
+{
+    TempWebRoot root("assets");
+    std::string html = "<html><body>";
+    for (int i = 0; i < 200; ++i) {
+        html += "<p>row " + std::to_string(i) + "</p>";
+    }
+    html += "</body></html>";
+    root.write("index.html", html);
+    root.write("js/app.js", "console.log(1);");
+    root.write("logo.png", std::string(1024, '\x89'));
+
+    StaticAssetCache cache(root.path.string());
+    REQUIRE(cache.refresh());
+    REQUIRE(cache.size() == 3);
+    REQUIRE_FALSE(cache.refresh());
+
+    auto page = cache.find("index.html");
+    REQUIRE(page);
+    REQUIRE(page->content == html);
+    REQUIRE(page->contentType == "text/html; charset=utf-8");
+    REQUIRE(page->etag.front() == '"');
+    REQUIRE_FALSE(page->gzipContent.empty());
+    REQUIRE(page->gzipContent.size() < html.size() / 2);
+    REQUIRE(gunzip(page->gzipContent) == html);
+    REQUIRE(page->gzipEtag == StaticAssetCache::gzipEtagFor(page->etag));
+    REQUIRE(page->gzipEtag != page->etag);
+
+    // 小文件和已压缩的格式不再压缩
+    auto script = cache.find("js/app.js");
+    REQUIRE(script);
+    REQUIRE(script->contentType == "application/javascript; charset=utf-8");
+    REQUIRE(script->gzipContent.empty());
+    REQUIRE(cache.find("logo.png")->gzipContent.empty());
+
+    REQUIRE_FALSE(cache.find("missing.html"));
+    REQUIRE_FALSE(cache.find("../index.html"));
+
+    // 内容变化后ETag随之变化，删除的文件被移除，未变化的文件复用原有快照
+    root.write("index.html", html + "<!-- changed -->");
+    fs::last_write_time(root.path / "index.html", page->modified + std::chrono::seconds(2));
+    fs::remove(root.path / "logo.png");
+    REQUIRE(cache.refresh());
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.find("index.html")->etag != page->etag);
+    REQUIRE(cache.find("js/app.js") == script);
+    REQUIRE(page->content == html);  // 旧快照不受影响
+}
+
+TEST_CASE("Static asset cache watches for changes", "[static_assets]")
+{
+    TempWebRoot root("watch");
+    root.write("index.html", "v1");
+
+    StaticAssetCache cache(root.path.string());
+    cache.refresh();
+    cache.startWatching(std::chrono::milliseconds(10));
+
+    root.write("extra.css", "body {}");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!cache.find("extra.css") && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    cache.stopWatching();
+
+    auto style = cache.find("extra.css");
+    REQUIRE(style);
+    REQUIRE(style->contentType == "text/css; charset=utf-8");
+}
+
+TEST_CASE("Conditional and encoding headers are parsed", "[static_assets]")
+{
+    REQUIRE(splitHeaderList(" a, ,b ,") == std::vector<std::string>{"a", "b"});
+    REQUIRE(splitHeaderList("").empty());
+
+    auto items = parseQualityList("br;q=1.0, GZIP ; level=1; Q=0.5, text/html;q=x, ;q=1");
+    REQUIRE(items.size() == 3);
+    REQUIRE(items[0].value == "br");
+    REQUIRE(items[0].quality == 1.0);
+    REQUIRE(items[1].value == "gzip");
+    REQUIRE(items[1].quality == 0.5);
+    REQUIRE(items[2].value == "text/html");
+    REQUIRE(items[2].quality == 0.0);
+
+    REQUIRE(StaticAssetCache::etagMatches("\"abc\"", "\"abc\""));
+    REQUIRE(StaticAssetCache::etagMatches("\"x\", W/\"abc\"", "\"abc\""));
+    REQUIRE(StaticAssetCache::etagMatches("*", "\"abc\""));
+    REQUIRE_FALSE(StaticAssetCache::etagMatches("\"abd\"", "\"abc\""));
+    REQUIRE_FALSE(StaticAssetCache::etagMatches("", "\"abc\""));
+    REQUIRE(StaticAssetCache::gzipEtagFor("\"abc\"") == "\"abc-gz\"");
+    REQUIRE(StaticAssetCache::etagMatches("W/\"abc-gz\"", "\"abc\""));
+    REQUIRE_FALSE(StaticAssetCache::etagMatches("\"abd-gz\"", "\"abc\""));
+
+    REQUIRE(StaticAssetCache::contentTypeFor("a/b/Chart.SVG") == "image/svg+xml");
+    REQUIRE(StaticAssetCache::contentTypeFor("README") == "text/plain; charset=utf-8");
+}
+
+TEST_CASE("API response encoding is negotiated", "[content_encoding]")
+{
+    REQUIRE(negotiateContentEncoding("gzip, deflate, br") == ContentEncoding::GZIP);
+    REQUIRE(negotiateContentEncoding("deflate") == ContentEncoding::DEFLATE);
+    REQUIRE(negotiateContentEncoding("gzip;q=0.5, deflate;q=0.8") == ContentEncoding::DEFLATE);
+    REQUIRE(negotiateContentEncoding("deflate, gzip") == ContentEncoding::GZIP);
+    REQUIRE(negotiateContentEncoding("*") == ContentEncoding::GZIP);
+    REQUIRE(negotiateContentEncoding("*;q=0.5, gzip;q=0") == ContentEncoding::DEFLATE);
+    REQUIRE(negotiateContentEncoding("GZIP ; Q=1") == ContentEncoding::GZIP);
+    REQUIRE(negotiateContentEncoding("") == ContentEncoding::IDENTITY);
+    REQUIRE(negotiateContentEncoding("br, identity") == ContentEncoding::IDENTITY);
+    REQUIRE(negotiateContentEncoding("gzip;q=0, deflate;q=0") == ContentEncoding::IDENTITY);
+
+    REQUIRE(std::string(contentEncodingName(ContentEncoding::GZIP)) == "gzip");
+    REQUIRE(std::string(contentEncodingName(ContentEncoding::DEFLATE)) == "deflate");
+    REQUIRE(std::string(contentEncodingName(ContentEncoding::IDENTITY)).empty());
+}
+
+TEST_CASE("Large API responses are compressed", "[content_encoding]")
+{
+    std::string json = "{\"data\":[";
+    for (int i = 0; i < 500; ++i) {
+        json += (i ? "," : "") + std::to_string(i * 0.25);
+    }
+    json += "]}";
+
+    std::string gzipBody = json;
+    REQUIRE(compressBody(gzipBody, ContentEncoding::GZIP, 1024) == ContentEncoding::GZIP);
+    REQUIRE(gzipBody.size() < json.size() / 2);
+    REQUIRE(gunzip(gzipBody) == json);
+
+    // HTTP的deflate编码为zlib格式：2字节头部和4字节Adler-32尾部
+    std::string deflateBody = json;
+    REQUIRE(compressBody(deflateBody, ContentEncoding::DEFLATE, 1024, 1) ==
+            ContentEncoding::DEFLATE);
+    REQUIRE(inflateBody(deflateBody, 2, 4) == json);
+
+    // 小响应、压缩级别为0或客户端不接受压缩时保持原样
+    std::string small = "{\"success\":true}";
+    REQUIRE(compressBody(small, ContentEncoding::GZIP, 1024) == ContentEncoding::IDENTITY);
+    REQUIRE(small == "{\"success\":true}");
+    std::string body = json;
+    REQUIRE(compressBody(body, ContentEncoding::GZIP, 1024, 0) == ContentEncoding::IDENTITY);
+    REQUIRE(compressBody(body, ContentEncoding::IDENTITY, 0) == ContentEncoding::IDENTITY);
+    REQUIRE(body == json);
+
+    // 压缩后没有变小的内容不压缩
+    std::string random;
+    unsigned state = 12345;
+    for (int i = 0; i < 2048; ++i) {
+        state = state * 1103515245 + 12345;
+        random.push_back(static_cast<char>(state >> 16));
+    }
+    std::string incompressible = random;
+    REQUIRE(compressBody(incompressible, ContentEncoding::GZIP, 0) == ContentEncoding::IDENTITY);
+    REQUIRE(incompressible == random);
+}
+
+TEST_CASE("Translations are looked up per request language", "[i18n]")
+{
+    I18n &i18n = I18n::getInstance();
+    Language original = i18n.getCurrentLanguage();
+
+    REQUIRE(i18n.getText("menu.exit", Language::CHINESE) == "退出");
+    REQUIRE(i18n.getText("menu.exit", Language::ENGLISH) == "Exit");
+    REQUIRE(i18n.getText("missing.key", Language::CHINESE) == "missing.key");
+    REQUIRE(i18n.getCurrentLanguage() == original);
+
+    TempWebRoot root("i18n");
+    root.write("translations.json",
+               R"({"zh": {"test.i18n_reload": "重新加载"}, "en": {"test.i18n_reload": "Reloaded"}})");
+
+    // 查找与切换当前语言、重新加载翻译并发进行
+    std::atomic<bool> mismatch(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&i18n, &mismatch, t]() {
+            Language lang = t % 2 ? Language::ENGLISH : Language::CHINESE;
+            const char *expected = t % 2 ? "Exit" : "退出";
+            for (int i = 0; i < 2000; ++i) {
+                if (i18n.getText("menu.exit", lang) != expected) {
+                    mismatch = true;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 20; ++i) {
+        i18n.setLanguage(i % 2 ? Language::ENGLISH : Language::CHINESE);
+        REQUIRE(i18n.loadTranslations((root.path / "translations.json").string()));
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    i18n.setLanguage(original);
+
+    REQUIRE_FALSE(mismatch);
+    REQUIRE(i18n.getText("test.i18n_reload", Language::ENGLISH) == "Reloaded");
+    REQUIRE(i18n.getText("test.i18n_reload", Language::CHINESE) == "重新加载");
+    REQUIRE(i18n.getText("menu.exit", Language::ENGLISH) == "Exit");
+}